@@ -69,6 +69,10 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
                                                      "YUV writing is skipped if omitted")
   ("SkipFrames,s", m_iSkipFrame, 0, "number of frames to skip before random access")
   ("OutputBitDepth,d", m_outputBitDepth, 0u, "bit depth of YUV output file (use 0 for native depth)")
+  ("LoopFilterThreads", m_iLoopFilterThreads, 0, "0: deblock each picture after decoding it, N: deblock LCU rows on N threads, "
+                                                  "starting while the picture is decoded, then run ALF on the LCU rows (same output)")
+  ("FrameThreads", m_iFrameThreads, 0, "0: decode one picture after the other, N: decode up to N pictures at the same time, "
+                                       "each waiting for the reference rows it predicts from (same output, LoopFilterThreads is then ignored)")
   ("SEIpictureDigest", m_pictureDigestEnabled, true, "Control handling of picture_digest SEI messages\n"
                                               "\t1: check\n"
                                               "\t0: ignore")
@@ -97,6 +101,16 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
     fprintf(stderr, "No input file specifed, aborting\n");
     return false;
   }
+  if (m_iLoopFilterThreads < 0)
+  {
+    fprintf(stderr, "LoopFilterThreads must not be negative, aborting\n");
+    return false;
+  }
+  if (m_iFrameThreads < 0)
+  {
+    fprintf(stderr, "FrameThreads must not be negative, aborting\n");
+    return false;
+  }
 
   return true;
 }
@@ -56,6 +56,8 @@ protected:
   char*         m_pchReconFile;                       ///< output reconstruction file name
   Int           m_iSkipFrame;                         ///< counter for frames prior to the random access point to skip
   UInt          m_outputBitDepth;                     ///< bit depth used for writing output
+  Int           m_iLoopFilterThreads;                 ///< number of threads running the deblocking filter and ALF, 0: sequential
+  Int           m_iFrameThreads;                      ///< number of pictures decoded at the same time, 0: one after the other
 
   bool m_pictureDigestEnabled; ///< enable(1)/disable(0) acting on SEI picture_digest message
   
@@ -80,15 +80,13 @@ Void TAppDecTop::decode()
   UInt                uiPOC;
   TComList<TComPic*>* pcListPic = NULL;
 
-  ifstream bitstreamFile(m_pchBitstreamFile, ifstream::in | ifstream::binary);
-  if (!bitstreamFile)
+  MappedInputByteStream bytestream;
+  if (!bytestream.open(m_pchBitstreamFile))
   {
     fprintf(stderr, "\nfailed to open bitstream file `%s' for reading\n", m_pchBitstreamFile);
     exit(EXIT_FAILURE);
   }
 
-  InputByteStream bytestream(bitstreamFile);
-
   // create & initialize internal classes
   xCreateDecLib();
   xInitDecLib  ();
@@ -97,20 +95,26 @@ Void TAppDecTop::decode()
   // main decoder loop
   bool recon_opened = false; // reconstruction file not yet opened. (must be performed after SPS is seen)
 
-  while (!!bitstreamFile)
+  bool bEof = false;
+  bool bNewPicture = false;
+  uint8_t* pucNalUnit = NULL;
+  unsigned uiNumBytes = 0;
+  while (!bEof || bNewPicture)
   {
-    /* location serves to work around a design fault in the decoder, whereby
-     * the process of reading a new slice that is the first slice of a new frame
-     * requires the TDecTop::decode() method to be called again with the same
-     * nal unit. */
-    streampos location = bitstreamFile.tellg();
-    AnnexBStats stats = AnnexBStats();
-    vector<uint8_t> nalUnit;
-    byteStreamNALUnit(bytestream, nalUnit, stats);
+    /* the first slice of a new picture has to be passed to TDecTop::decode()
+     * again once the previous picture is finished.  It is kept as the one
+     * NAL unit of lookahead instead of extracting the next one. */
+    if (!bNewPicture)
+    {
+      AnnexBStats stats = AnnexBStats();
+      bEof = bytestream.readNALUnit(pucNalUnit, uiNumBytes, stats);
+      /* perform anti-emulation prevention, in place and once only */
+      uiNumBytes = convertPayloadToRBSP(pucNalUnit, uiNumBytes);
+    }
 
     // call actual decoding function
-    bool bNewPicture = false;
-    if (nalUnit.empty())
+    bNewPicture = false;
+    if (uiNumBytes == 0)
       /* this can happen if the following occur:
        *  - empty input file
        *  - two back-to-back start_code_prefixes
@@ -120,22 +124,14 @@ Void TAppDecTop::decode()
     else
     {
       InputNALUnit nalu;
-      read(nalu, nalUnit);
+      read(nalu, pucNalUnit, uiNumBytes);
       bNewPicture = m_cTDecTop.decode(nalu, m_iSkipFrame, m_iPOCLastDisplay);
-      if (bNewPicture)
-      {
-        bitstreamFile.clear();
-        /* location points to the current nalunit payload[1] due to the
-         * need for the annexB parser to read three extra bytes.
-         * [1] except for the first NAL unit in the file
-         *     (but bNewPicture doesn't happen then) */
-        bitstreamFile.seekg(location-streamoff(3));
-        bytestream.reset();
-      }
+      delete nalu.m_Bitstream;
     }
-    if (bNewPicture || !bitstreamFile)
+    if (bNewPicture || bEof)
     {
-      m_cTDecTop.executeDeblockAndAlf(uiPOC, pcListPic, m_iSkipFrame, m_iPOCLastDisplay);
+      // the pictures still in flight are decoded at the end of the bitstream
+      m_cTDecTop.executeDeblockAndAlf(uiPOC, pcListPic, m_iSkipFrame, m_iPOCLastDisplay, bEof && !bNewPicture);
     }
 
     if( pcListPic )
@@ -184,6 +180,8 @@ Void TAppDecTop::xDestroyDecLib()
 Void TAppDecTop::xInitDecLib()
 {
   // initialize decoder class
+  m_cTDecTop.setLoopFilterThreads(m_iLoopFilterThreads);
+  m_cTDecTop.setFrameThreads(m_iFrameThreads);
   m_cTDecTop.init();
   m_cTDecTop.setPictureDigestEnabled(m_pictureDigestEnabled);
 }
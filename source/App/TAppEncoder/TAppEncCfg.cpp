@@ -39,6 +39,7 @@
 #include <cassert>
 #include <cstring>
 #include <string>
+#include <sstream>
 #include "TAppEncCfg.h"
 #include "../../App/TAppCommon/program_options_lite.h"
 
@@ -103,6 +104,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   string cfg_BitstreamFile;
   string cfg_ReconFile;
   string cfg_dQPFile;
+#if JCT_ARC
+  string cfg_PicResolutions;
+#endif
   po::Options opts;
   opts.addOptions()
   ("help", do_help, false, "this help text")
@@ -134,6 +138,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 #if JCT_ARC
   ("ResSwitchFrameNum",m_uiResSwitchFrameNum,    0u, "Frame number at which resolution change occurs (default 0)")
   ("ResSwitchType",m_uiResSwitchType,    0u, "Type of resolution switch: 0 = low to high predicted; 1 = high to low predicted ; 2=low to high IDR, 3=high to low predicted")
+  ("ResSwitchLevel",m_uiResSwitchLevel,  1u, "Rung of the resolution ladder used as the low resolution of the switch")
+  ("ResSwitchMaxBitrate",m_iResSwitchMaxBitrate, 0, "Bitrate cap in bits per second, when non-zero the ladder rung is chosen per GOP from the measured rate (default 0 = off)")
+  ("PicResolutions",cfg_PicResolutions, string("1 1/2"), "Resolution ladder as scaling ratios from the source size, largest first (e.g. \"1 3/4 2/3 1/2\")")
   ("IntraQPOffset", m_iIntraQPOffset, 0, "Additional QP offset to apply to intra pictures")
 #endif
   /* Unit definition parameters */
@@ -232,6 +239,11 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
     ("SliceArgument",        m_iSliceArgument,       0, "if SliceMode==1 SliceArgument represents max # of LCUs. if SliceMode==2 SliceArgument represents max # of bytes.")
     ("EntropySliceMode",     m_iEntropySliceMode,    0, "0: Disable all entropy slice limits, 1: Enforce max # of LCUs, 2: Enforce constraint based entropy slices")
     ("EntropySliceArgument", m_iEntropySliceArgument,0, "if EntropySliceMode==1 SliceArgument represents max # of LCUs. if EntropySliceMode==2 EntropySliceArgument represents max # of bins.")
+    ("WaveFrontThreads",     m_iWaveFrontThreads,    0, "0: compress LCUs in raster order, N: compress LCU rows in wavefront order on N threads (the output does not depend on N)")
+    ("FrameThreads",         m_iFrameThreads,        0, "0: compress pictures in coding order, N: compress up to N pictures of a GOP that do not reference each other at the same time (same output)")
+    ("SIMD",                 m_iSIMDLevel,          -1, "distortion, interpolation and transform kernels, -1: best supported by the CPU, 0: C, 1: SSE4.1, 2: AVX2 (same output)")
+    ("SubPelCache",          m_bUseSubPelCache,  false, "interpolate the quarter-pel planes of each reference picture once for fractional ME (same output, 15 luma planes per reference)")
+    ("CacheBins",            m_bCacheBins,       false, "record the CABAC bins of each LCU during compression and write them without coding the CUs again (same output, without dQP)")
 #if MTK_NONCROSS_INLOOP_FILTER
     ("LFCrossSliceBoundaryFlag", m_bLFCrossSliceBoundaryFlag, true)
 #endif
@@ -252,6 +264,8 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
                                               "\t1: use MD5\n"
                                               "\t0: disable")
   ("FEN", m_bUseFastEnc, false, "fast encoder setting")
+  ("EarlyTerm", m_iEarlyTerm, 0, "early termination of the CU mode and split decisions in inter slices, 0: off, 1: skip-based, 2: skip-, depth- and cost-based")
+  ("FastIntra", m_bUseFastIntra, false, "select the luma intra modes with a coarse-to-fine search over the angles, and RD check only those close to the best")
   
   /* Compatability with old style -1 FOO or -0 FOO options. */
   ("1", doOldStyleCmdlineOn, "turn option <name> on")
@@ -282,6 +296,12 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   m_pchBitstreamFile = cfg_BitstreamFile.empty() ? NULL : strdup(cfg_BitstreamFile.c_str());
   m_pchReconFile = cfg_ReconFile.empty() ? NULL : strdup(cfg_ReconFile.c_str());
   m_pchdQPFile = cfg_dQPFile.empty() ? NULL : strdup(cfg_dQPFile.c_str());
+#if JCT_ARC
+  if ( !xParsePicResolutions( cfg_PicResolutions ) )
+  {
+    m_iNumPicResolutions = 0;
+  }
+#endif
   
   if (m_iRateGOPSize == -1)
   {
@@ -368,6 +388,47 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 
 Bool confirmPara(Bool bflag, const char* message);
 
+#if JCT_ARC
+/** Parse the resolution ladder.
+ * Each rung is a ratio "num/den" (or a plain integer) of the source size. The first rung must be 1 and the ratios
+ * must strictly decrease.
+ */
+Bool TAppEncCfg::xParsePicResolutions( const std::string& rcLadder )
+{
+  istringstream cStream( rcLadder );
+  string        cRung;
+
+  m_iNumPicResolutions = 0;
+  while ( cStream >> cRung )
+  {
+    if ( m_iNumPicResolutions >= NUM_PIC_RESOLUTIONS )
+    {
+      return false;
+    }
+    Int iNum = 0;
+    Int iDen = 1;
+    Char cDummy;
+    if ( sscanf( cRung.c_str(), "%d/%d%c", &iNum, &iDen, &cDummy ) != 2 && sscanf( cRung.c_str(), "%d%c", &iNum, &cDummy ) != 1 )
+    {
+      return false;
+    }
+    if ( iNum <= 0 || iDen <= 0 || iNum > iDen )
+    {
+      return false;
+    }
+    if ( m_iNumPicResolutions == 0 ? iNum != iDen
+                                   : iNum * m_aiPicResolutionDen[m_iNumPicResolutions-1] >= m_aiPicResolutionNum[m_iNumPicResolutions-1] * iDen )
+    {
+      return false;
+    }
+    m_aiPicResolutionNum[m_iNumPicResolutions] = iNum;
+    m_aiPicResolutionDen[m_iNumPicResolutions] = iDen;
+    m_iNumPicResolutions++;
+  }
+  return m_iNumPicResolutions > 0;
+}
+#endif
+
 Void TAppEncCfg::xCheckParameter()
 {
   bool check_failed = false; /* abort if there is a fatal configuration problem */
@@ -382,6 +443,10 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_iFrameToBeEncoded <= 0,                                                   "Total Number Of Frames encoded must be more than 1" );
 #if JCT_ARC
   xConfirmPara( m_uiResSwitchType >= 4,                                                     "Resolution switch type must be 0 or 1" );
+  xConfirmPara( m_iNumPicResolutions < 1,                                                   "PicResolutions must list between 1 and NUM_PIC_RESOLUTIONS decreasing ratios num/den, starting with 1" );
+  xConfirmPara( m_uiResSwitchLevel >= (UInt)m_iNumPicResolutions,                           "ResSwitchLevel must be a rung of the resolution ladder" );
+  xConfirmPara( m_iResSwitchMaxBitrate < 0,                                                 "ResSwitchMaxBitrate must not be negative" );
+  xConfirmPara( m_iResSwitchMaxBitrate > 0 && m_uiResSwitchType >= 2,                       "Rate-driven resolution switching does not insert IDR pictures, ResSwitchType must be 0 or 1" );
 #endif
   xConfirmPara( m_iGOPSize < 1 ,                                                            "GOP Size must be more than 1" );
   xConfirmPara( m_iGOPSize > 1 &&  m_iGOPSize % 2,                                          "GOP Size must be a multiple of 2, if GOP Size is greater than 1" );
@@ -444,6 +509,15 @@ Void TAppEncCfg::xCheckParameter()
   }
   
   xConfirmPara( m_iSymbolMode < 0 || m_iSymbolMode > 1,                                     "SymbolMode must be equal to 0 or 1" );
+  xConfirmPara( m_iWaveFrontThreads < 0,                                                    "WaveFrontThreads must not be negative" );
+  xConfirmPara( m_iWaveFrontThreads > 0 && ( m_iSymbolMode == 0 || !m_bUseSBACRD ),         "Wavefront compression requires SBAC based RD estimation" );
+  xConfirmPara( m_iWaveFrontThreads > 0 && ( m_iSliceMode != 0 || m_iEntropySliceMode != 0 ), "Wavefront compression requires a single slice per picture" );
+  xConfirmPara( m_iFrameThreads < 0,                                                        "FrameThreads must not be negative" );
+  xConfirmPara( m_iFrameThreads > 0 && m_iWaveFrontThreads > 0,                             "FrameThreads and WaveFrontThreads cannot be combined" );
+  xConfirmPara( m_iFrameThreads > 0 && ( m_iSymbolMode == 0 || !m_bUseSBACRD ),             "Picture-parallel compression requires SBAC based RD estimation" );
+  xConfirmPara( m_iFrameThreads > 0 && ( m_iSliceMode != 0 || m_iEntropySliceMode != 0 ),   "Picture-parallel compression requires a single slice per picture" );
+  xConfirmPara( m_iSIMDLevel < -1 || m_iSIMDLevel > 2,                                       "SIMD must be in the range -1 to 2" );
+  xConfirmPara( m_iFrameThreads > 0 && m_uiDeltaQpRD > 0,                                   "Picture-parallel compression cannot be combined with DeltaQpRD" );
   
 #if DCM_COMB_LIST
   xConfirmPara( m_bUseLComb==false && m_bUseLDC==false,         "LComb can only be 0 if LowDelayCoding is 1" );
@@ -553,8 +627,22 @@ Void TAppEncCfg::xPrintParameter()
   printf("Internal Format              : %dx%d %dHz\n", m_iSourceWidth, m_iSourceHeight, m_iFrameRate );
   printf("Frame index                  : %u - %d (%d frames)\n", m_FrameSkip, m_FrameSkip+m_iFrameToBeEncoded-1, m_iFrameToBeEncoded );
 #if JCT_ARC
-  printf("Resolution switch at frame   : %u\n", m_uiResSwitchFrameNum);
-  printf("Resolution switch type       : %u\n", m_uiResSwitchType);
+  if ( m_iResSwitchMaxBitrate > 0 )
+  {
+    printf("Resolution switch            : rate-driven, cap %d bps\n", m_iResSwitchMaxBitrate);
+  }
+  else
+  {
+    printf("Resolution switch at frame   : %u\n", m_uiResSwitchFrameNum);
+    printf("Resolution switch type       : %u\n", m_uiResSwitchType);
+    printf("Resolution switch level      : %u\n", m_uiResSwitchLevel);
+  }
+  printf("Resolution ladder            :");
+  for ( Int i = 0; i < m_iNumPicResolutions; i++ )
+  {
+    printf(" %d/%d", m_aiPicResolutionNum[i], m_aiPicResolutionDen[i]);
+  }
+  printf("\n");
 #endif
   printf("Number of Ref. frames (P)    : %d\n", m_iNumOfReference);
   printf("Number of Ref. frames (B_L0) : %d\n", m_iNumOfReferenceB_L0);
@@ -617,6 +705,8 @@ Void TAppEncCfg::xPrintParameter()
   printf("LCMod:%d ", m_bLCMod         );
 #endif
   printf("FEN:%d ", m_bUseFastEnc         );
+  printf("ETM:%d ", m_iEarlyTerm          );
+  printf("FIS:%d ", m_bUseFastIntra       );
   printf("RQT:%d ", 1     );
   printf("MRG:%d ", m_bUseMRG             ); // SOPH: Merge Mode
 #if LM_CHROMA 
@@ -635,6 +725,11 @@ Void TAppEncCfg::xPrintParameter()
   {
     printf("(%d) ", m_iEntropySliceArgument);
   }
+  printf("WPP:%d ", m_iWaveFrontThreads);
+  printf("FPP:%d ", m_iFrameThreads);
+  printf("SIMD:%d ", m_iSIMDLevel);
+  printf("SPC:%d ", m_bUseSubPelCache);
+  printf("CBN:%d ", m_bCacheBins);
 #if CONSTRAINED_INTRA_PRED
   printf("CIP:%d ", m_bUseConstrainedIntraPred);
 #endif
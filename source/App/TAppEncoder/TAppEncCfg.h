@@ -61,6 +61,11 @@ protected:
 #if JCT_ARC
   UInt      m_uiResSwitchFrameNum;                            ///< frame number at which resolution changes
   UInt      m_uiResSwitchType;                                ///< resolution switch type: 0=low to high, 1=high to low
+  UInt      m_uiResSwitchLevel;                               ///< ladder rung used as the low resolution of the switch
+  Int       m_iResSwitchMaxBitrate;                           ///< bitrate cap of the rate-driven resolution switching (0: off)
+  Int       m_iNumPicResolutions;                             ///< number of rungs of the resolution ladder
+  Int       m_aiPicResolutionNum[NUM_PIC_RESOLUTIONS];        ///< scaling ratio numerator of each rung
+  Int       m_aiPicResolutionDen[NUM_PIC_RESOLUTIONS];        ///< scaling ratio denominator of each rung
   Int       m_iIntraQPOffset;                                 ///< offset to apply to the normal Intra QP value
 #endif
   Int       m_iFrameToBeEncoded;                              ///< number of encoded frames
@@ -172,11 +177,18 @@ protected:
   Int       m_iSearchRange;                                   ///< ME search range
   Int       m_bipredSearchRange;                              ///< ME search range for bipred refinement
   Bool      m_bUseFastEnc;                                    ///< flag for using fast encoder setting
+  Int       m_iEarlyTerm;                                     ///< level of early termination of the CU decisions
+  Bool      m_bUseFastIntra;                                  ///< flag for the hierarchical intra mode search
   
   Int       m_iSliceMode;           ///< 0: Disable all Recon slice limits, 1 : Maximum number of largest coding units per slice, 2: Maximum number of bytes in a slice
   Int       m_iSliceArgument;       ///< If m_iSliceMode==1, m_iSliceArgument=max. # of largest coding units. If m_iSliceMode==2, m_iSliceArgument=max. # of bytes.
   Int       m_iEntropySliceMode;    ///< 0: Disable all entropy slice limits, 1 : Maximum number of largest coding units per slice, 2: Constraint based entropy slice
   Int       m_iEntropySliceArgument;///< If m_iEntropySliceMode==1, m_iEntropySliceArgument=max. # of largest coding units. If m_iEntropySliceMode==2, m_iEntropySliceArgument=max. # of bins.
+  Int       m_iWaveFrontThreads;    ///< number of threads compressing LCU rows in wavefront order, 0: sequential
+  Int       m_iFrameThreads;        ///< number of threads compressing independent pictures of a GOP, 0: sequential
+  Int       m_iSIMDLevel;           ///< instruction set of the distortion, interpolation and transform kernels, -1: best supported
+  Bool      m_bUseSubPelCache;      ///< flag for interpolating the quarter-pel planes of reference pictures once
+  Bool      m_bCacheBins;           ///< flag for writing the LCU bins recorded during compression
 
 #if MTK_NONCROSS_INLOOP_FILTER
   Bool m_bLFCrossSliceBoundaryFlag;  ///< 0: Cross-slice-boundary in-loop filtering 1: non-cross-slice-boundary in-loop filtering
@@ -193,6 +205,9 @@ protected:
   // internal member functions
   Void  xSetGlobal      ();                                   ///< set global variables
   Void  xCheckParameter ();                                   ///< check validity of configuration values
+#if JCT_ARC
+  Bool  xParsePicResolutions( const std::string& rcLadder );  ///< parse the resolution ladder, e.g. "1 3/4 2/3 1/2"
+#endif
   Void  xPrintParameter ();                                   ///< print configuration values
   Void  xPrintUsage     ();                                   ///< print usage
   
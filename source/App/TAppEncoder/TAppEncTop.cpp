@@ -71,6 +71,13 @@ Void TAppEncTop::xInitLibCfg()
 #if JCT_ARC
   m_cTEncTop.setResSwitchFrameNum            ( m_uiResSwitchFrameNum );
   m_cTEncTop.setResSwitchType                ( m_uiResSwitchType );
+  m_cTEncTop.setResSwitchLevel               ( m_uiResSwitchLevel );
+  m_cTEncTop.setResSwitchMaxBitrate          ( m_iResSwitchMaxBitrate );
+  m_cTEncTop.setNumPicResolutions            ( m_iNumPicResolutions );
+  for ( Int i = 0; i < m_iNumPicResolutions; i++ )
+  {
+    m_cTEncTop.setPicResolution              ( i, m_aiPicResolutionNum[i], m_aiPicResolutionDen[i] );
+  }
 #endif
   m_cTEncTop.setFrameToBeEncoded             ( m_iFrameToBeEncoded );
   
@@ -138,6 +145,8 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setUseNRF                       ( m_bUseNRF      );
   m_cTEncTop.setUseBQP                       ( m_bUseBQP      );
   m_cTEncTop.setUseFastEnc                   ( m_bUseFastEnc  );
+  m_cTEncTop.setEarlyTerm                    ( m_iEarlyTerm   );
+  m_cTEncTop.setUseFastIntra                 ( m_bUseFastIntra );
   m_cTEncTop.setUseMRG                       ( m_bUseMRG      ); // SOPH:
 
 #if LM_CHROMA 
@@ -163,6 +172,13 @@ Void TAppEncTop::xInitLibCfg()
   //====== Entropy Slice ========
   m_cTEncTop.setEntropySliceMode        ( m_iEntropySliceMode         );
   m_cTEncTop.setEntropySliceArgument    ( m_iEntropySliceArgument     );
+
+  //====== Wavefront ========
+  m_cTEncTop.setWaveFrontThreads        ( m_iWaveFrontThreads         );
+  m_cTEncTop.setFrameThreads            ( m_iFrameThreads             );
+  m_cTEncTop.setSIMDLevel               ( m_iSIMDLevel                );
+  m_cTEncTop.setUseSubPelCache          ( m_bUseSubPelCache           );
+  m_cTEncTop.setCacheBins               ( m_bCacheBins                );
 #if MTK_NONCROSS_INLOOP_FILTER
   if(m_iSliceMode == 0 )
   {
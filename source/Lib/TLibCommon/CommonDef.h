@@ -191,6 +191,10 @@ template <typename T> inline T Clip(T x) { return std::min<T>(T(g_uiIBDI_MAX), s
 
 // Early-skip threshold (encoder)
 #define EARLY_SKIP_THRES            1.50        ///< if RD < thres*avg[BestSkipRD]
+#define EARLY_TERM_MIN_NUM          4           ///< CUs of a depth seen in the LCU row before their statistics are used
+
+// Fast intra mode decision (encoder)
+#define FAST_INTRA_RD_THRES         1.10        ///< RD check of the intra modes with Hadamard cost < thres*best
 
 const int g_iShift8x8    = 2;
 const int g_iShift16x16  = 2;
@@ -55,7 +55,6 @@ class ContextModel
 {
 public:
   ContextModel  ()                        { m_ucState = 0;             }
-  ~ContextModel ()                        {}
   
   UChar getState  ()                { return ( m_ucState >> 1 ); }                    ///< get current state
   UChar getMps    ()                { return ( m_ucState  & 1 ); }                    ///< get curret MPS
@@ -43,6 +43,7 @@
 
 ContextModel3DBuffer::ContextModel3DBuffer( UInt uiSizeZ, UInt uiSizeY, UInt uiSizeX ) :
 m_pcContextModel( NULL ),
+m_bOwnBuffer( true ),
 m_uiSizeX( uiSizeX ),
 m_uiSizeY( uiSizeY ),
 m_uiSizeZ( uiSizeZ )
@@ -52,10 +53,29 @@ m_uiSizeZ( uiSizeZ )
   m_pcContextModel = new ContextModel[ uiSizeZ * m_uiSizeY * m_uiSizeX ];
 }
 
+/**
+ - place the 3D buffer in a context array shared with other buffers
+ .
+ \param  pcBasePtr       first free context model of the shared array
+ \param  riCount         number of context models used in the shared array, advanced by the size of the buffer
+ */
+ContextModel3DBuffer::ContextModel3DBuffer( UInt uiSizeZ, UInt uiSizeY, UInt uiSizeX, ContextModel* pcBasePtr, Int& riCount ) :
+m_pcContextModel( pcBasePtr ),
+m_bOwnBuffer( false ),
+m_uiSizeX( uiSizeX ),
+m_uiSizeY( uiSizeY ),
+m_uiSizeZ( uiSizeZ )
+{
+  riCount += uiSizeZ * uiSizeY * uiSizeX;
+}
+
 ContextModel3DBuffer::~ContextModel3DBuffer()
 {
   // delete 3D buffer
-  delete [] m_pcContextModel;
+  if ( m_bOwnBuffer )
+  {
+    delete [] m_pcContextModel;
+  }
   m_pcContextModel = NULL;
 }
 
@@ -58,12 +58,14 @@ class ContextModel3DBuffer
 {
 protected:
   ContextModel* m_pcContextModel;                                         ///< array of context models
+  Bool          m_bOwnBuffer;                                             ///< the array was allocated by the buffer itself
   const UInt    m_uiSizeX;                                                ///< X size of 3D buffer
   const UInt    m_uiSizeY;                                                ///< Y size of 3D buffer
   const UInt    m_uiSizeZ;                                                ///< Z size of 3D buffer
   
 public:
   ContextModel3DBuffer  ( UInt uiSizeZ, UInt uiSizeY, UInt uiSizeX );
+  ContextModel3DBuffer  ( UInt uiSizeZ, UInt uiSizeY, UInt uiSizeX, ContextModel* pcBasePtr, Int& riCount );
   ~ContextModel3DBuffer ();
   
   // access functions
@@ -43,6 +43,8 @@
 // Constants
 // ====================================================================================================================
 
+#define MAX_NUM_CTX_MOD            1024       ///< maximum number of context models held by one entropy coder
+
 #define NUM_SPLIT_FLAG_CTX            3       ///< number of context models for split flag
 #define NUM_SKIP_FLAG_CTX             3       ///< number of context models for skip flag
 
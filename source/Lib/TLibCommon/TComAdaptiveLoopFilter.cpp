@@ -36,6 +36,7 @@
 */
 
 #include "TComAdaptiveLoopFilter.h"
+#include "TComAdaptiveLoopFilterSIMD.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -326,6 +327,14 @@ TComAdaptiveLoopFilter::TComAdaptiveLoopFilter() :
   for (int i=0; i<NUM_ALF_CLASS_METHOD; ++i){
     m_varImgMethods[i] = NULL;
   }
+  m_cLumaKernel.bValid = false;
+  m_uiLCUHeight   = 0;
+  m_pcThreadPool  = NULL;
+  m_uiRowCtrlIdx  = 0;
+#if MTK_NONCROSS_INLOOP_FILTER
+  m_pcRowSlice    = NULL;
+#endif
+  setSIMDLevel( SIMD_AUTO );
 }
 
 Void TComAdaptiveLoopFilter:: xError(const char *text, int code)
@@ -495,10 +504,17 @@ Void TComAdaptiveLoopFilter::create( Int iPicWidth, Int iPicHeight, UInt uiMaxCU
   m_pcTempPicYuv->create( iPicWidth, iPicHeight, uiMaxCUWidth, uiMaxCUHeight, uiMaxCUDepth );
   m_img_height = iPicHeight;
   m_img_width = iPicWidth;
+  m_uiLCUHeight = uiMaxCUHeight;
+  m_cRows.create( ( iPicHeight + uiMaxCUHeight - 1 ) / uiMaxCUHeight );
 #if !MQT_BA_RA
   initMatrix_imgpel(&m_imgY_var, m_img_height, m_img_width); 
 #endif
+#if MQT_BA_RA
+  // the last column group summed by calcVar() reads VAR_SIZE_W columns past the gradients, keep it within the row
+  initMatrix_int(&m_imgY_temp, m_img_height+2*VAR_SIZE+3, m_img_width+2*VAR_SIZE+3+VAR_SIZE_W);
+#else
   initMatrix_int(&m_imgY_temp, m_img_height+2*VAR_SIZE+3, m_img_width+2*VAR_SIZE+3);
+#endif
 #if MQT_BA_RA
 
   initMatrix_int(&m_imgY_ver, m_img_height+2*VAR_SIZE+3, m_img_width+2*VAR_SIZE+3);
@@ -551,6 +567,7 @@ Void TComAdaptiveLoopFilter::destroy()
   destroyMatrix_int(m_filterCoeffPrevSelected);
   destroyMatrix_int(m_filterCoeffTmp);
   destroyMatrix_int(m_filterCoeffSymTmp);
+  m_cRows.destroy();
 }
 
 // ====================================================================================================================
@@ -770,15 +787,20 @@ Void TComAdaptiveLoopFilter::predictALFCoeffChroma( ALFParam* pAlfParam )
 /**
  \param pcPic         picture (TComPic) class (input/output)
  \param pcAlfParam    ALF parameter
+ \param pcThreadPool  threads sharing the LCU rows of the picture, NULL to filter on the calling thread
  \todo   for temporal buffer, it uses residual picture buffer, which may not be safe. Make it be safer.
  */
-Void TComAdaptiveLoopFilter::ALFProcess(TComPic* pcPic, ALFParam* pcAlfParam)
+Void TComAdaptiveLoopFilter::ALFProcess(TComPic* pcPic, ALFParam* pcAlfParam, TComThreadPool* pcThreadPool)
 {
   if(!pcAlfParam->alf_flag)
   {
     return;
   }
   
+  m_pcThreadPool  = pcThreadPool;
+  m_pcRowPic      = pcPic;
+  m_pcRowAlfParam = pcAlfParam;
+  
   TComPicYuv* pcPicYuvRec    = pcPic->getPicYuvRec();
   TComPicYuv* pcPicYuvExtRec = m_pcTempPicYuv;
 #if MTK_NONCROSS_INLOOP_FILTER
@@ -823,6 +845,125 @@ Void TComAdaptiveLoopFilter::ALFProcess(TComPic* pcPic, ALFParam* pcAlfParam)
     predictALFCoeffChroma(pcAlfParam);
     xALFChroma( pcAlfParam, pcPicYuvExtRec, pcPicYuvRec);
   }
+  m_pcThreadPool = NULL;
+}
+
+#if MTK_NONCROSS_INLOOP_FILTER && MQT_BA_RA
+/** Prepare ALFProcessRow() to filter the LCU rows of a picture one at a time, on the calling thread.
+ * Only for pictures whose filtering crosses the slice boundaries.
+ \param pcPic         picture (TComPic) class, its LCU rows are final up to ALF when given to ALFProcessRow()
+ \param pcAlfParam    ALF parameter
+ */
+Void TComAdaptiveLoopFilter::ALFStartRows(TComPic* pcPic, ALFParam* pcAlfParam)
+{
+  assert(!m_bUseNonCrossALF);
+  m_pcThreadPool  = NULL;
+  m_pcRowPic      = pcPic;
+  m_pcRowAlfParam = pcAlfParam;
+  m_uiRowCtrlIdx  = 0;
+  if(!pcAlfParam->alf_flag)
+  {
+    return;
+  }
+  
+  m_pcTempPicYuv->setBorderExtension(false);
+  xInitLuma(pcAlfParam, (imgpel*)m_pcTempPicYuv->getLumaAddr(), (imgpel*)pcPic->getPicYuvRec()->getLumaAddr(), m_pcTempPicYuv->getStride());
+  if(pcAlfParam->chroma_idc)
+  {
+    predictALFCoeffChroma(pcAlfParam);
+  }
+  m_pcRowPicDec  = m_pcTempPicYuv;
+  m_pcRowPicRest = pcPic->getPicYuvRec();
+}
+
+/** Take one more LCU row of the picture and filter the rows that can be.
+ * The row is copied with its margins, the classification of a row reads the gradients of the row below and the
+ * filters read up to half their length below the row, so a row is filtered once the next one is taken.
+ \param iRow  LCU row, the rows being given in order
+ \returns number of LCU rows from the top whose filtering is complete
+ */
+Int TComAdaptiveLoopFilter::ALFProcessRow(Int iRow)
+{
+  Int iNumRows = ( m_img_height + m_uiLCUHeight - 1 ) / m_uiLCUHeight;
+  if(!m_pcRowAlfParam->alf_flag)
+  {
+    return iRow+1;
+  }
+  
+  Int iPelY      = iRow * m_uiLCUHeight;
+  Int iRowHeight = min<Int>( m_uiLCUHeight, m_img_height - iPelY );
+  m_pcRowPicRest->copyToPicRows      ( m_pcRowPicDec, iPelY, iRowHeight );
+  m_pcRowPicDec ->extendPicBorderRows( iPelY, iRowHeight );
+  
+#if TSB_ALF_HEADER
+  if(m_pcRowAlfParam->cu_control_flag)
+  {
+    UInt uiWidthInCU = m_pcRowPic->getFrameWidthInCU();
+    for(UInt uiCUAddr = iRow * uiWidthInCU; uiCUAddr < ( iRow + 1 ) * uiWidthInCU; uiCUAddr++)
+    {
+      setAlfCtrlFlags(m_pcRowAlfParam, m_pcRowPic->getCU(uiCUAddr), 0, 0, m_uiRowCtrlIdx);
+    }
+  }
+#endif
+  if(m_uiVarGenMethod != ALF_RA)
+  {
+    m_eRowJob = ROW_JOB_VAR_GRADIENT;
+    xFilterRow(iRow);
+  }
+  
+  Int iLastRow = iRow == iNumRows-1 ? iRow : iRow-1;
+  for(Int i = max(iRow-1, 0); i <= iLastRow; i++)
+  {
+    if(m_uiVarGenMethod != ALF_RA)
+    {
+      m_eRowJob = ROW_JOB_VAR_CLASS;
+      xFilterRow(i);
+    }
+    m_eRowJob = m_pcRowAlfParam->cu_control_flag ? ROW_JOB_LUMA_CU : ROW_JOB_LUMA;
+    xFilterRow(i);
+    
+    m_eRowJob = ROW_JOB_CHROMA;
+    if((m_pcRowAlfParam->chroma_idc>>1)&0x01)
+    {
+      m_iRowColor = 0;
+      xFilterRow(i);
+    }
+    if(m_pcRowAlfParam->chroma_idc&0x01)
+    {
+      m_iRowColor = 1;
+      xFilterRow(i);
+    }
+  }
+  
+  if(iLastRow == iNumRows-1)
+  {
+    m_cLumaKernel.bValid = false;
+  }
+  return iLastRow+1;
+}
+#endif
+
+/** Select the kernel of the luma and chroma filters.
+ * \param iLevel requested SIMDLevel, see TComAdaptiveLoopFilterSIMD::initFilterFunc()
+ * \returns level actually used
+ */
+Int TComAdaptiveLoopFilter::setSIMDLevel( Int iLevel )
+{
+  m_fpFilter = NULL;
+  
+  return TComAdaptiveLoopFilterSIMD::initFilterFunc( &m_fpFilter, iLevel );
+}
+
+/** Filter the LCU rows handed out by m_cRows with the current row job.
+ * \param iThreadIdx index of the thread, unused
+ */
+Void TComAdaptiveLoopFilter::runTask( Int iThreadIdx )
+{
+  Int iRow;
+  while ( ( iRow = m_cRows.claimRow() ) >= 0 )
+  {
+    xFilterRow( iRow );
+  }
 }
 
 // ====================================================================================================================
@@ -832,12 +973,10 @@ Void TComAdaptiveLoopFilter::ALFProcess(TComPic* pcPic, ALFParam* pcAlfParam)
 // --------------------------------------------------------------------------------------------------------------------
 // ALF for luma
 // --------------------------------------------------------------------------------------------------------------------
-Void TComAdaptiveLoopFilter::xALFLuma_qc(TComPic* pcPic, ALFParam* pcAlfParam, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest)
+/** Filter coefficients, classification method and row job pointers of the luma of a picture.
+ */
+Void TComAdaptiveLoopFilter::xInitLuma(ALFParam* pcAlfParam, imgpel* pDec, imgpel* pRest, Int LumaStride)
 {
-  Int    LumaStride = pcPicDec->getStride();
-  imgpel* pDec = (imgpel*)pcPicDec->getLumaAddr();
-  imgpel* pRest = (imgpel*)pcPicRest->getLumaAddr();
-  
   //Decode and reconst filter coefficients
   DecFilter_qc(pDec,pcAlfParam,LumaStride);
   //set maskImg using cu adaptive one.
@@ -847,22 +986,48 @@ Void TComAdaptiveLoopFilter::xALFLuma_qc(TComPic* pcPic, ALFParam* pcAlfParam, T
   m_imgY_var       = m_varImgMethods[m_uiVarGenMethod];
 #endif
 
+  xInitLumaKernel(&m_cLumaKernel, pcAlfParam->realfiltNo, LumaStride);
+  m_pRowDec    = pDec;
+  m_pRowRest   = pRest;
+  m_iRowStride = LumaStride;
+
 #if MTK_NONCROSS_INLOOP_FILTER
   memset(m_imgY_temp[0],0,sizeof(int)*(m_img_height+2*VAR_SIZE)*(m_img_width+2*VAR_SIZE));
+#endif
+}
+
+Void TComAdaptiveLoopFilter::xALFLuma_qc(TComPic* pcPic, ALFParam* pcAlfParam, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest)
+{
+  Int    LumaStride = pcPicDec->getStride();
+  imgpel* pDec = (imgpel*)pcPicDec->getLumaAddr();
+  imgpel* pRest = (imgpel*)pcPicRest->getLumaAddr();
+  
+  xInitLuma(pcAlfParam, pDec, pRest, LumaStride);
+
+#if MTK_NONCROSS_INLOOP_FILTER
   if(!m_bUseNonCrossALF)
   {
+#if MQT_BA_RA
+    // the classification reads the gradients of the next LCU row, all of them are computed first
+    if(m_uiVarGenMethod != ALF_RA)
+    {
+      xRunRows(ROW_JOB_VAR_GRADIENT);
+      xRunRows(ROW_JOB_VAR_CLASS);
+    }
+#else
     calcVar(0, 0, m_imgY_var, pDec, FILTER_LENGTH/2, VAR_SIZE, m_img_height, m_img_width, LumaStride);
 #endif
+#endif
 
 
   if(pcAlfParam->cu_control_flag)
   {
-    xCUAdaptive_qc(pcPic, pcAlfParam, pRest, pDec, LumaStride);
+    xRunRows(ROW_JOB_LUMA_CU);
   }  
   else
   {
     //then do whole frame filtering
-    filterFrame(pRest, pDec, pcAlfParam->realfiltNo, LumaStride);
+    xRunRows(ROW_JOB_LUMA);
   }
 #if MTK_NONCROSS_INLOOP_FILTER
   }
@@ -883,11 +1048,14 @@ Void TComAdaptiveLoopFilter::xALFLuma_qc(TComPic* pcPic, ALFParam* pcAlfParam, T
 #if MQT_BA_RA
       }
 #endif
-      xFilterOneSlice(pSlice, pDec, pRest, LumaStride, pcAlfParam);
+      // the next slice extends its borders into pDec, so the slices are filtered one after the other
+      m_pcRowSlice = pSlice;
+      xRunRows(ROW_JOB_LUMA_SLICE);
 
     }
   }
 #endif
+  m_cLumaKernel.bValid = false;
 
 }
 
@@ -1024,87 +1192,13 @@ Void TComAdaptiveLoopFilter::calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pa
     return;
   }
 
-  static Int shift_h     = (Int)(log((double)VAR_SIZE_H)/log(2.0));
-  static Int shift_w     = (Int)(log((double)VAR_SIZE_W)/log(2.0));
-
 #if MTK_NONCROSS_INLOOP_FILTER
-  Int start_height = ypos;
-  Int start_width  = xpos;
-  Int end_height   = ypos + img_height;
-  Int end_width    = xpos + img_width;
+  xCalcVarGradients(ypos, ypos + img_height + (VAR_SIZE<<1), xpos, imgY_pad, pad_size, fl, img_width, img_stride);
+  xCalcVarClasses  (ypos, ypos + img_height, xpos, imgY_var, img_width);
 #else
-  Int start_height = 0;
-  Int start_width = 0;
-  Int end_height = img_height;
-  Int end_width = img_width;
+  xCalcVarGradients(0, img_height + (VAR_SIZE<<1), 0, imgY_pad, pad_size, fl, img_width, img_stride);
+  xCalcVarClasses  (0, img_height, 0, imgY_var, img_width);
 #endif
-  Int i, j;
-  Int *p_imgY_temp;
-#if FULL_NBIT
-  Int shift= (11+ g_uiBitIncrement + g_uiBitDepth - 8);
-#else
-  Int shift= (11+ g_uiBitIncrement);
-#endif
-  Int fl2plusOne= (VAR_SIZE<<1)+1; //3
-  Int pad_offset = pad_size-fl-1;
-  Int var_max= NO_VAR_BINS-1;
-  Int mult_fact_int_tab[4]= {1,114,41,21};
-  Int mult_fact_int = mult_fact_int_tab[VAR_SIZE];
-  Int avg_var;
-  Int vertical, horizontal;
-  Int direction;
-  Int step1 = NO_VAR_BINS/3 - 1;
-  Int th[NO_VAR_BINS] = {0, 1, 2, 2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4}; 
-
-  for(i = 1+start_height; i < end_height + fl2plusOne; i++)
-  {
-    Int yoffset = (pad_offset+i-pad_size) * img_stride + pad_offset-pad_size;
-    imgpel *p_imgY_pad = &imgY_pad[yoffset];
-    imgpel *p_imgY_pad_up   = &imgY_pad[yoffset + img_stride];
-    imgpel *p_imgY_pad_down = &imgY_pad[yoffset - img_stride];
-    p_imgY_temp = (Int*)&m_imgY_temp[i-1][start_width];
-    for(j = 1+start_width; j < end_width +fl2plusOne; j++)  
-    {
-      vertical = abs((p_imgY_pad[j]<<1) - p_imgY_pad_down[j] - p_imgY_pad_up[j]);
-      horizontal = abs((p_imgY_pad[j]<<1) - p_imgY_pad[j+1] - p_imgY_pad[j-1]);
-      m_imgY_ver[i-1][j-1] = vertical;
-      m_imgY_hor[i-1][j-1] = horizontal;
-      *(p_imgY_temp++) = vertical + horizontal;
-    }
-
-    for(j = 1+start_width; j < end_width + fl2plusOne; j=j+4)  
-    {
-      m_imgY_temp [i-1][j] =  (m_imgY_temp [i-1][j-1] + m_imgY_temp [i-1][j+4])
-        + ((m_imgY_temp [i-1][j] + m_imgY_temp [i-1][j+3]) << 1)
-        + ((m_imgY_temp [i-1][j+1] + m_imgY_temp [i-1][j+2]) * 3);
-      m_imgY_ver[i-1][j] = m_imgY_ver[i-1][j] + m_imgY_ver[i-1][j+1] + m_imgY_ver[i-1][j+2] + m_imgY_ver[i-1][j+3];      
-      m_imgY_hor[i-1][j] = m_imgY_hor[i-1][j] + m_imgY_hor[i-1][j+1] + m_imgY_hor[i-1][j+2] + m_imgY_hor[i-1][j+3];    
-    }
-  }
-
-  for(i = 1+start_height; i < end_height + 1; i=i+4)
-  {
-    for(j = 1+start_width; j < end_width + 1; j=j+4)  
-    {
-      m_imgY_temp [i-1][j-1] =  (m_imgY_temp [i-1][j]+m_imgY_temp [i+4][j])
-        + ((m_imgY_temp [i][j]+m_imgY_temp [i+3][j]) << 1)
-        + ((m_imgY_temp [i+1][j]+m_imgY_temp [i+2][j]) * 3);
-
-      m_imgY_ver[i-1][j-1] = m_imgY_ver[i][j] + m_imgY_ver[i+1][j] + m_imgY_ver[i+2][j] + m_imgY_ver[i+3][j];  
-      m_imgY_hor[i-1][j-1] = m_imgY_hor[i][j] + m_imgY_hor[i+1][j] + m_imgY_hor[i+2][j] + m_imgY_hor[i+3][j];    
-      avg_var = m_imgY_temp [i-1][j-1]>>(shift_h + shift_w);
-      avg_var = (imgpel) Clip_post(var_max, (avg_var * mult_fact_int)>>shift);
-      avg_var = th[avg_var];
-
-      direction = 0;
-      if (m_imgY_ver[i-1][j-1] > 2*m_imgY_hor[i-1][j-1]) direction = 1; //vertical
-      if (m_imgY_hor[i-1][j-1] > 2*m_imgY_ver[i-1][j-1]) direction = 2; //horizontal
-
-      avg_var = Clip_post(step1, (Int) avg_var ) + (step1+1)*direction; 
-      imgY_var[(i - 1)>>shift_h][(j - 1)>>shift_w] = avg_var;   
-    }
-  }
-
 #else
 
   int i, j, ii, jj;
@@ -1250,6 +1344,97 @@ Void TComAdaptiveLoopFilter::calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pa
 #endif
 }
 
+#if MQT_BA_RA
+/** Gradients of the rows [iStartRow, iEndRow) of m_imgY_temp, m_imgY_ver and m_imgY_hor, summed over groups of 4 columns.
+ * The rows of a region of calcVar() extend 2*VAR_SIZE rows below it; disjoint row ranges can be computed concurrently.
+ */
+Void TComAdaptiveLoopFilter::xCalcVarGradients(Int iStartRow, Int iEndRow, Int xpos, imgpel *imgY_pad, Int pad_size, Int fl, Int img_width, Int img_stride)
+{
+  Int start_width  = xpos;
+  Int end_width    = xpos + img_width;
+  Int i, j;
+  Int *p_imgY_temp;
+  Int fl2plusOne= (VAR_SIZE<<1)+1; //3
+  Int pad_offset = pad_size-fl-1;
+  Int vertical, horizontal;
+
+  for(i = 1+iStartRow; i < iEndRow + 1; i++)
+  {
+    Int yoffset = (pad_offset+i-pad_size) * img_stride + pad_offset-pad_size;
+    imgpel *p_imgY_pad = &imgY_pad[yoffset];
+    imgpel *p_imgY_pad_up   = &imgY_pad[yoffset + img_stride];
+    imgpel *p_imgY_pad_down = &imgY_pad[yoffset - img_stride];
+    p_imgY_temp = (Int*)&m_imgY_temp[i-1][start_width];
+    for(j = 1+start_width; j < end_width +fl2plusOne; j++)  
+    {
+      vertical = abs((p_imgY_pad[j]<<1) - p_imgY_pad_down[j] - p_imgY_pad_up[j]);
+      horizontal = abs((p_imgY_pad[j]<<1) - p_imgY_pad[j+1] - p_imgY_pad[j-1]);
+      m_imgY_ver[i-1][j-1] = vertical;
+      m_imgY_hor[i-1][j-1] = horizontal;
+      *(p_imgY_temp++) = vertical + horizontal;
+    }
+
+    for(j = 1+start_width; j < end_width + fl2plusOne; j=j+4)  
+    {
+      m_imgY_temp [i-1][j] =  (m_imgY_temp [i-1][j-1] + m_imgY_temp [i-1][j+4])
+        + ((m_imgY_temp [i-1][j] + m_imgY_temp [i-1][j+3]) << 1)
+        + ((m_imgY_temp [i-1][j+1] + m_imgY_temp [i-1][j+2]) * 3);
+      m_imgY_ver[i-1][j] = m_imgY_ver[i-1][j] + m_imgY_ver[i-1][j+1] + m_imgY_ver[i-1][j+2] + m_imgY_ver[i-1][j+3];      
+      m_imgY_hor[i-1][j] = m_imgY_hor[i-1][j] + m_imgY_hor[i-1][j+1] + m_imgY_hor[i-1][j+2] + m_imgY_hor[i-1][j+3];    
+    }
+  }
+}
+
+/** Classes of the 4x4 blocks in the rows [iStartRow, iEndRow) from the gradients of xCalcVarGradients().
+ * Only the first column of each group is written, the other ones are read; disjoint row ranges can be classified
+ * concurrently once the gradients of all of them are available.
+ */
+Void TComAdaptiveLoopFilter::xCalcVarClasses(Int iStartRow, Int iEndRow, Int xpos, imgpel **imgY_var, Int img_width)
+{
+  static Int shift_h     = (Int)(log((double)VAR_SIZE_H)/log(2.0));
+  static Int shift_w     = (Int)(log((double)VAR_SIZE_W)/log(2.0));
+
+  Int start_width  = xpos;
+  Int end_width    = xpos + img_width;
+  Int i, j;
+#if FULL_NBIT
+  Int shift= (11+ g_uiBitIncrement + g_uiBitDepth - 8);
+#else
+  Int shift= (11+ g_uiBitIncrement);
+#endif
+  Int var_max= NO_VAR_BINS-1;
+  Int mult_fact_int_tab[4]= {1,114,41,21};
+  Int mult_fact_int = mult_fact_int_tab[VAR_SIZE];
+  Int avg_var;
+  Int direction;
+  Int step1 = NO_VAR_BINS/3 - 1;
+  Int th[NO_VAR_BINS] = {0, 1, 2, 2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4}; 
+
+  for(i = 1+iStartRow; i < iEndRow + 1; i=i+4)
+  {
+    for(j = 1+start_width; j < end_width + 1; j=j+4)  
+    {
+      m_imgY_temp [i-1][j-1] =  (m_imgY_temp [i-1][j]+m_imgY_temp [i+4][j])
+        + ((m_imgY_temp [i][j]+m_imgY_temp [i+3][j]) << 1)
+        + ((m_imgY_temp [i+1][j]+m_imgY_temp [i+2][j]) * 3);
+
+      m_imgY_ver[i-1][j-1] = m_imgY_ver[i][j] + m_imgY_ver[i+1][j] + m_imgY_ver[i+2][j] + m_imgY_ver[i+3][j];  
+      m_imgY_hor[i-1][j-1] = m_imgY_hor[i][j] + m_imgY_hor[i+1][j] + m_imgY_hor[i+2][j] + m_imgY_hor[i+3][j];    
+      avg_var = m_imgY_temp [i-1][j-1]>>(shift_h + shift_w);
+      avg_var = (imgpel) Clip_post(var_max, (avg_var * mult_fact_int)>>shift);
+      avg_var = th[avg_var];
+
+      direction = 0;
+      if (m_imgY_ver[i-1][j-1] > 2*m_imgY_hor[i-1][j-1]) direction = 1; //vertical
+      if (m_imgY_hor[i-1][j-1] > 2*m_imgY_ver[i-1][j-1]) direction = 2; //horizontal
+
+      avg_var = Clip_post(step1, (Int) avg_var ) + (step1+1)*direction; 
+      imgY_var[(i - 1)>>shift_h][(j - 1)>>shift_w] = avg_var;   
+    }
+  }
+}
+#endif
+
 
 #if MQT_BA_RA
 
@@ -1304,154 +1489,6 @@ Void TComAdaptiveLoopFilter::createRegionIndexMap(imgpel **imgYVar, Int imgWidth
 
 }
 
-Void TComAdaptiveLoopFilter::filterFrame(imgpel *imgYRecPost, imgpel *imgYRec, int filtNo, int stride)
-{
-  Int varStepSizeWidth = VAR_SIZE_W;
-  Int varStepSizeHeight = VAR_SIZE_H;
-  Int shiftHeight = (Int)(log((double)varStepSizeHeight)/log(2.0));
-
-  Int i, j, pixelInt;
-  imgpel *pImgYVar,*pImgYPad;
-  Int maxVal=g_uiIBDI_MAX;
-  imgpel *pImgYPad1,*pImgYPad2,*pImgYPad3,*pImgYPad4,*pImgYPad5,*pImgYPad6;
-  Int lastCoef= MAX_SQR_FILT_LENGTH-1;
-  Int *coef = m_filterCoeffPrevSelected[0];
-  Int numBitsMinus1= NUM_BITS-1;
-  Int offset = (1<<(NUM_BITS-2));
-
-  switch(filtNo)
-  {
-  case 2:
-    for (i = 0; i < m_img_height; i++)
-    {
-      pImgYVar = m_imgY_var[i>>shiftHeight];
-      pImgYPad = imgYRec + i*stride;
-      {
-        pImgYPad1 = imgYRec + (i+1)*stride;
-        pImgYPad2 = imgYRec + (i-1)*stride;
-        pImgYPad3 = imgYRec + (i+2)*stride;
-        pImgYPad4 = imgYRec + (i-2)*stride;
-        pImgYPad5 = imgYRec + (i+3)*stride;
-        pImgYPad6 = imgYRec + (i-3)*stride;
-      }
-
-      for (j = 0; j < m_img_width; j++)
-      {
-        if (j%varStepSizeWidth==0) coef = m_filterCoeffPrevSelected[*(pImgYVar++)];
-        pixelInt=coef[lastCoef];
-
-        pixelInt += coef[22]* (pImgYPad3[j]+pImgYPad4[j]);
-
-        pixelInt += coef[30]* (pImgYPad1[j+1]+pImgYPad2[j-1]);
-        pixelInt += coef[31]* (pImgYPad1[j]  +pImgYPad2[j]);
-        pixelInt += coef[32]* (pImgYPad1[j-1]+pImgYPad2[j+1]);
-
-        pixelInt += coef[38]* (pImgYPad[j-2]+pImgYPad[j+2]);
-        pixelInt += coef[39]* (pImgYPad[j-1]+pImgYPad[j+1]);
-        pixelInt += coef[40]* (pImgYPad[j]);
-
-        pixelInt=(Int)((pixelInt+offset) >> (numBitsMinus1));
-        imgYRecPost[i*stride + j]=max(0, min(pixelInt,maxVal));
-      }
-    }
-    break;
-
-  case 1:
-    for (i = 0; i < m_img_height; i++)
-    {
-      pImgYVar = m_imgY_var[i>>shiftHeight];
-      pImgYPad = imgYRec + i*stride;
-      {
-        pImgYPad1 = imgYRec + (i+1)*stride;
-        pImgYPad2 = imgYRec + (i-1)*stride;
-        pImgYPad3 = imgYRec + (i+2)*stride;
-        pImgYPad4 = imgYRec + (i-2)*stride;
-        pImgYPad5 = imgYRec + (i+3)*stride;
-        pImgYPad6 = imgYRec + (i-3)*stride;
-      }
-
-      for (j = 0; j < m_img_width; j++)
-      {
-        if (j%varStepSizeWidth==0) coef = m_filterCoeffPrevSelected[*(pImgYVar++)];
-        pixelInt=coef[lastCoef];
-
-        pixelInt += coef[13]* (imgYRec[(i+3)*stride + j]+imgYRec[(i-3)*stride + j]);
-
-        pixelInt += coef[21]* (pImgYPad3[j+1]+pImgYPad4[j-1]);
-        pixelInt += coef[22]* (pImgYPad3[j]+pImgYPad4[j]);
-        pixelInt += coef[23]* (pImgYPad3[j-1]+pImgYPad4[j+1]);
-
-        pixelInt += coef[29]* (pImgYPad1[j+2]+pImgYPad2[j-2]);
-        pixelInt += coef[30]* (pImgYPad1[j+1]+pImgYPad2[j-1]);
-        pixelInt += coef[31]* (pImgYPad1[j]+pImgYPad2[j]);
-        pixelInt += coef[32]* (pImgYPad1[j-1]+pImgYPad2[j+1]);
-        pixelInt += coef[33]* (pImgYPad1[j-2]+pImgYPad2[j+2]);
-
-        pixelInt += coef[37]* (pImgYPad[j+3]+pImgYPad[j-3]);
-        pixelInt += coef[38]* (pImgYPad[j+2]+pImgYPad[j-2]);
-        pixelInt += coef[39]* (pImgYPad[j+1]+pImgYPad[j-1]);
-        pixelInt += coef[40]* (pImgYPad[j]);
-
-        pixelInt=(Int)((pixelInt+offset) >> (numBitsMinus1));
-        imgYRecPost[i*stride + j]=max(0, min(pixelInt,maxVal));
-      }
-    }
-    break;
-
-  case 0:
-    for (i = 0; i < m_img_height; i++)
-    {
-      pImgYVar = m_imgY_var[i>>shiftHeight];
-      pImgYPad = imgYRec + i*stride;
-      {
-        pImgYPad1 = imgYRec + (i+1)*stride;
-        pImgYPad2 = imgYRec + (i-1)*stride;
-        pImgYPad3 = imgYRec + (i+2)*stride;
-        pImgYPad4 = imgYRec + (i-2)*stride;
-        pImgYPad5 = imgYRec + (i+3)*stride;
-        pImgYPad6 = imgYRec + (i-3)*stride;
-      }
-
-      for (j = 0; j < m_img_width; j++)
-      {
-        if (j%varStepSizeWidth==0) coef = m_filterCoeffPrevSelected[*(pImgYVar++)];
-        pixelInt=coef[lastCoef];
-
-#if !TI_ALF_MAX_VSIZE_7
-        pixelInt += coef[4]* (imgYRec[(i+4)*stride + j]+imgYRec[(i-4)*stride + j]);
-#endif        
-        pixelInt += coef[12]* (pImgYPad5[j+1]+pImgYPad6[j-1]);
-        pixelInt += coef[13]* (pImgYPad5[j]+pImgYPad6[j]);
-        pixelInt += coef[14]* (pImgYPad5[j-1]+pImgYPad6[j+1]);
-
-        pixelInt += coef[20]* (pImgYPad3[j+2]+pImgYPad4[j-2]);
-        pixelInt += coef[21]* (pImgYPad3[j+1]+pImgYPad4[j-1]);
-        pixelInt += coef[22]* (pImgYPad3[j]+pImgYPad4[j]);
-        pixelInt += coef[23]* (pImgYPad3[j-1]+pImgYPad4[j+1]);
-        pixelInt += coef[24]* (pImgYPad3[j-2]+pImgYPad4[j+2]);
-
-        pixelInt += coef[28]* (pImgYPad1[j+3]+pImgYPad2[j-3]);
-        pixelInt += coef[29]* (pImgYPad1[j+2]+pImgYPad2[j-2]);
-        pixelInt += coef[30]* (pImgYPad1[j+1]+pImgYPad2[j-1]);
-        pixelInt += coef[31]* (pImgYPad1[j]+pImgYPad2[j]);
-        pixelInt += coef[32]* (pImgYPad1[j-1]+pImgYPad2[j+1]);
-        pixelInt += coef[33]* (pImgYPad1[j-2]+pImgYPad2[j+2]);
-        pixelInt += coef[34]* (pImgYPad1[j-3]+pImgYPad2[j+3]);
-
-        pixelInt += coef[36]* (pImgYPad[j+4]+pImgYPad[j-4]);
-        pixelInt += coef[37]* (pImgYPad[j+3]+pImgYPad[j-3]);
-        pixelInt += coef[38]* (pImgYPad[j+2]+pImgYPad[j-2]);
-        pixelInt += coef[39]* (pImgYPad[j+1]+pImgYPad[j-1]);
-        pixelInt += coef[40]* (pImgYPad[j]);
-
-        pixelInt=(Int)((pixelInt+offset) >> (numBitsMinus1));
-        imgYRecPost[i*stride + j]=max(0, min(pixelInt,maxVal));
-      }
-    }
-    break;
-  }
-}
-
 Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgYRecPost, imgpel *imgYRec, int filtNo, int startHeight, int endHeight, int startWidth, int endWidth, int stride)
 {
   Int varStepSizeWidth = VAR_SIZE_W;
@@ -1467,6 +1504,14 @@ Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgYRecPost, imgpel *imgYRec
   Int numBitsMinus1= NUM_BITS-1;
   Int offset = (1<<(NUM_BITS-2));
 
+  // the kernel takes whole groups of VAR_SIZE_W samples sharing one class
+  if ( m_fpFilter && m_cLumaKernel.bValid && ( startWidth % varStepSizeWidth ) == 0 && ( ( endWidth - startWidth ) % varStepSizeWidth ) == 0 )
+  {
+    m_fpFilter( (Pel*)imgYRec + startHeight*stride + startWidth, stride, (Pel*)imgYRecPost + startHeight*stride + startWidth, stride,
+                endWidth - startWidth, endHeight - startHeight, &m_cLumaKernel, m_imgY_var, startWidth, startHeight );
+    return;
+  }
+
   switch(filtNo)
   {
   case 2:
@@ -1601,60 +1646,6 @@ Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgYRecPost, imgpel *imgYRec
 }
 #else
 
-Void TComAdaptiveLoopFilter::filterFrame(imgpel *imgY_rec_post, imgpel *imgY_rec, int filtNo, int Stride)
-{
-  int i, j, ii, jj, pixelInt,m=0;
-  imgpel *p_imgY_var,*p_imgY_pad;
-  int max_val=g_uiIBDI_MAX;
-  int fl=FILTER_LENGTH/2;
-  int *pattern=m_pattern9x9Sym;
-  int fl_temp;
-  int last_coef= MAX_SQR_FILT_LENGTH-1;
-  imgpel *im1,*im2;
-  int *coef;
-  int num_bits_minus_1= NUM_BITS-1;
-  int offset = (1<<(NUM_BITS-2));
-  int *pattern_fix=m_patternTab_filt[filtNo];
-  fl_temp=m_flTab[filtNo];
-#if TI_ALF_MAX_VSIZE_7
-  Int fl_tempV = ALFFlHToFlV(fl_temp);
-#endif
-  
-  // Filter
-  for (i = fl; i < m_img_height+fl; i++)
-  {
-    p_imgY_var = m_imgY_var[i-fl];
-    p_imgY_pad = imgY_rec + (i-fl)*Stride;
-    for (j = fl; j < m_img_width+fl; j++)
-    {
-      coef = m_filterCoeffPrevSelected[*(p_imgY_var++)];
-      pixelInt=coef[last_coef];
-      pattern=pattern_fix;
-
-#if TI_ALF_MAX_VSIZE_7
-      for (ii = -fl_tempV, m = fl_temp - fl_tempV; ii < 0; ii++, m++)
-#else
-      for (ii = -fl_temp, m = 0; ii < 0; ii++, m++)
-#endif
-      {
-        im1= &(imgY_rec[(i-fl+ii)*Stride + j-fl-m]);
-        im2= &(imgY_rec[(i-fl-ii)*Stride + j-fl+m]);
-        for (jj=-m; jj<=m; jj++)
-          pixelInt+=((*(im1++)+ *(im2--))*coef[*(pattern++)]);
-      }
-
-      im1= &(p_imgY_pad[(j-fl)-fl_temp]);
-      im2= &(p_imgY_pad[(j-fl)+fl_temp]);
-      for (jj=0; jj<fl_temp; jj++)
-        pixelInt+=((*(im1++)+ *(im2--))*coef[*(pattern++)]);
-
-      pixelInt+=(p_imgY_pad[j-fl]*coef[*(pattern++)]);
-      pixelInt=(int)((pixelInt+offset) >> (num_bits_minus_1));
-      imgY_rec_post[(i-fl)*Stride + j-fl]=max(0, min(pixelInt,max_val));
-    }
-  }
-}
-
 Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgY_rec_post, imgpel *imgY_rec, int filtNo, int start_height, int end_height, int start_width, int end_width, int Stride)
 {
   int i, j, ii, jj, pixelInt,m=0;
@@ -1769,8 +1760,11 @@ Void TComAdaptiveLoopFilter::xALFChroma(ALFParam* pcAlfParam, TComPicYuv* pcPicD
   if((pcAlfParam->chroma_idc>>1)&0x01)
   {
 #if MTK_NONCROSS_INLOOP_FILTER
+    m_pcRowPicDec  = pcPicDec;
+    m_pcRowPicRest = pcPicRest;
+    m_iRowColor    = 0;
     if(!m_bUseNonCrossALF)
-      xFrameChroma(0, 0, (m_img_height>>1), (m_img_width>>1), pcPicDec, pcPicRest, pcAlfParam->coeff_chroma, pcAlfParam->tap_chroma, 0);
+      xRunRows(ROW_JOB_CHROMA);
     else
     {
       Int iStride   = pcPicRest->getCStride();
@@ -1782,7 +1776,8 @@ Void TComAdaptiveLoopFilter::xALFChroma(ALFParam* pcAlfParam, TComPicYuv* pcPicD
         CAlfSlice* pSlice = &(m_pSlice[s]);
         pSlice->copySliceChroma(pDec, pRest, iStride);
         pSlice->extendSliceBorderChroma(pDec, iStride, (UInt)EXTEND_NUM_PEL_C);
-        xFrameChromaforOneSlice(pSlice, ALF_Cb, pcPicDec, pcPicRest, pcAlfParam->coeff_chroma, pcAlfParam->tap_chroma);
+        m_pcRowSlice = pSlice;
+        xRunRows(ROW_JOB_CHROMA_SLICE);
       }
     }
 #else
@@ -1793,8 +1788,11 @@ Void TComAdaptiveLoopFilter::xALFChroma(ALFParam* pcAlfParam, TComPicYuv* pcPicD
   if(pcAlfParam->chroma_idc&0x01)
   {
 #if MTK_NONCROSS_INLOOP_FILTER
+    m_pcRowPicDec  = pcPicDec;
+    m_pcRowPicRest = pcPicRest;
+    m_iRowColor    = 1;
     if(!m_bUseNonCrossALF)
-      xFrameChroma(0, 0, (m_img_height>>1), (m_img_width>>1), pcPicDec, pcPicRest, pcAlfParam->coeff_chroma, pcAlfParam->tap_chroma, 1);
+      xRunRows(ROW_JOB_CHROMA);
     else
     {
       Int iStride   = pcPicRest->getCStride();
@@ -1805,7 +1803,8 @@ Void TComAdaptiveLoopFilter::xALFChroma(ALFParam* pcAlfParam, TComPicYuv* pcPicD
         CAlfSlice* pSlice = &(m_pSlice[s]);
         pSlice->copySliceChroma(pDec, pRest, iStride);
         pSlice->extendSliceBorderChroma(pDec, iStride, (UInt)EXTEND_NUM_PEL_C);
-        xFrameChromaforOneSlice(pSlice, ALF_Cr, pcPicDec, pcPicRest, pcAlfParam->coeff_chroma, pcAlfParam->tap_chroma);
+        m_pcRowSlice = pSlice;
+        xRunRows(ROW_JOB_CHROMA_SLICE);
       }
     }
 #else
@@ -1854,19 +1853,21 @@ Void TComAdaptiveLoopFilter::xFrameChroma( TComPicYuv* pcPicDec, TComPicYuv* pcP
     pDec = pcPicDec->getCbAddr();
     pRest = pcPicRest->getCbAddr();
   }
-#if MTK_NONCROSS_INLOOP_FILTER
-  if(m_bUseNonCrossALF)
-  {
-    pDec  += ( ypos*iDecStride  + xpos);
-    pRest += ( ypos*iRestStride + xpos);
-  }
-  else
+#if MTK_NONCROSS_INLOOP_FILTER
+  pDec  += ( ypos*iDecStride  + xpos);
+  pRest += ( ypos*iRestStride + xpos);
+#endif
+
+  if ( m_fpFilter && ( iWidth & 3 ) == 0 )
   {
-    assert(ypos ==0 && xpos ==0);
-    assert(iHeight == pcPicRest->getHeight() >> 1);
-    assert(iWidth  == pcPicRest->getWidth()  >> 1);
+    ALFFilterKernel cKernel;
+    xInitChromaKernel( &cKernel, qh, iTap, iDecStride );
+    if ( cKernel.bValid )
+    {
+      m_fpFilter( pDec, iDecStride, pRest, iRestStride, iWidth, iHeight, &cKernel, NULL, 0, 0 );
+      return;
+    }
   }
-#endif
 
   Pel* pTmpDec1, *pTmpDec2;
   Pel* pTmpPixSum;
@@ -2131,6 +2132,162 @@ Void TComAdaptiveLoopFilter::xFrameChroma( TComPicYuv* pcPicDec, TComPicYuv* pcP
   }
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// Vectorised kernels and LCU row threads
+// --------------------------------------------------------------------------------------------------------------------
+
+/** Luma filter of shape filtNo with the coefficients m_filterCoeffPrevSelected of each class, as filtered by subfilterFrame().
+ * \param pcKernel  filter for m_fpFilter, not valid if a coefficient exceeds 16 bits
+ * \param filtNo    filter shape
+ * \param iStride   stride of the picture to filter
+ */
+Void TComAdaptiveLoopFilter::xInitLumaKernel( ALFFilterKernel* pcKernel, Int filtNo, Int iStride )
+{
+  Int* piPatternMap = m_patternMapTab[filtNo];
+  Int  aiCoef[ALF_MAX_NUM_COEF];
+  Int  iCentre      = MAX_SQR_FILT_LENGTH - 2;
+  
+  pcKernel->iNumPairs = 0;
+  for ( Int k = 0; k < iCentre; k++ )
+  {
+    if ( piPatternMap[k] > 0 )
+    {
+      pcKernel->aiOffset[pcKernel->iNumPairs++] = ( k / FILTER_LENGTH - FILTER_LENGTH/2 ) * iStride + k % FILTER_LENGTH - FILTER_LENGTH/2;
+    }
+  }
+  pcKernel->iShift = NUM_BITS - 1;
+  pcKernel->bValid = g_uiIBDI_MAX < ( 1 << 14 );
+  
+  for ( Int iClass = 0; iClass < NO_VAR_BINS; iClass++ )
+  {
+    Int* piCoef = m_filterCoeffPrevSelected[iClass];
+    Int  n      = 0;
+    for ( Int k = 0; k < iCentre; k++ )
+    {
+      if ( piPatternMap[k] > 0 )
+      {
+        aiCoef[n++] = piCoef[k];
+      }
+    }
+    aiCoef[n] = piCoef[iCentre];
+    xSetKernelCoef( pcKernel, iClass, aiCoef, piCoef[iCentre + 1] + ( 1 << ( NUM_BITS - 2 ) ) );
+  }
+}
+
+/** Chroma filter of xFrameChroma(), the coefficients qh are in raster order up to the centre one, followed by the DC offset.
+ * \param pcKernel  filter for m_fpFilter, not valid if a coefficient exceeds 16 bits
+ * \param qh        filter coefficients
+ * \param iTap      filter tap
+ * \param iStride   stride of the picture to filter
+ */
+Void TComAdaptiveLoopFilter::xInitChromaKernel( ALFFilterKernel* pcKernel, Int* qh, Int iTap, Int iStride )
+{
+  Int iHalf = iTap >> 1;
+  Int N     = ( iTap*iTap + 1 ) >> 1;
+  
+  pcKernel->iNumPairs = N - 1;
+  for ( Int i = 0; i < N - 1; i++ )
+  {
+    pcKernel->aiOffset[i] = ( i / iTap - iHalf ) * iStride + i % iTap - iHalf;
+  }
+  pcKernel->iShift = ALF_NUM_BIT_SHIFT;
+  pcKernel->bValid = g_uiIBDI_MAX < ( 1 << 14 );
+  
+  xSetKernelCoef( pcKernel, 0, qh, ( qh[N] << ( g_uiBitDepth + g_uiBitIncrement - 8 ) ) + ALF_ROUND_OFFSET );
+}
+
+/** Pack the coefficients of one class two by two.
+ * \param piCoef    coefficients of the sample pairs followed by the centre one
+ * \param iDC       DC offset including the rounding offset
+ */
+Void TComAdaptiveLoopFilter::xSetKernelCoef( ALFFilterKernel* pcKernel, Int iClass, const Int* piCoef, Int iDC )
+{
+  Int iNumTerms = pcKernel->iNumPairs + 1;
+  
+  for ( Int k = 0; k < iNumTerms; k += 2 )
+  {
+    Int iCoef0 = piCoef[k];
+    Int iCoef1 = k + 1 < iNumTerms ? piCoef[k + 1] : 0;
+    if ( iCoef0 != (Short)iCoef0 || iCoef1 != (Short)iCoef1 )
+    {
+      pcKernel->bValid = false;
+    }
+    pcKernel->aaiCoefPair[iClass][k >> 1] = (Int)( (UInt)(UShort)iCoef0 | ( (UInt)(UShort)iCoef1 << 16 ) );
+  }
+  pcKernel->aiDC[iClass] = iDC;
+}
+
+/** Run eJob on all LCU rows of the picture, on the threads of m_pcThreadPool if any.
+ * The rows of a job are independent, each one is filtered by a single thread.
+ */
+Void TComAdaptiveLoopFilter::xRunRows( RowJob eJob )
+{
+  m_eRowJob = eJob;
+  m_cRows.init( ( m_img_height + m_uiLCUHeight - 1 ) / m_uiLCUHeight );
+  
+  if ( m_pcThreadPool && m_pcThreadPool->getNumThreads() > 1 )
+  {
+    m_pcThreadPool->run( this );
+  }
+  else
+  {
+    runTask( 0 );
+  }
+}
+
+/** Run the current job on one LCU row.
+ * \param iRow LCU row of the picture
+ */
+Void TComAdaptiveLoopFilter::xFilterRow( Int iRow )
+{
+  Int iPelY      = iRow * m_uiLCUHeight;
+  Int iRowHeight = min<Int>( m_uiLCUHeight, m_img_height - iPelY );
+  
+  switch ( m_eRowJob )
+  {
+#if MQT_BA_RA
+    case ROW_JOB_VAR_GRADIENT:
+    {
+      // the gradients extend 2*VAR_SIZE rows below the picture
+      Int iEndRow = iPelY + iRowHeight + ( iPelY + iRowHeight == m_img_height ? (VAR_SIZE<<1) : 0 );
+      xCalcVarGradients( iPelY, iEndRow, 0, m_pRowDec, FILTER_LENGTH/2, VAR_SIZE, m_img_width, m_iRowStride );
+    }
+      break;
+    case ROW_JOB_VAR_CLASS:
+      xCalcVarClasses( iPelY, iPelY + iRowHeight, 0, m_imgY_var, m_img_width );
+      break;
+#endif
+    case ROW_JOB_LUMA:
+      subfilterFrame( m_pRowRest, m_pRowDec, m_pcRowAlfParam->realfiltNo, iPelY, iPelY + iRowHeight, 0, m_img_width, m_iRowStride );
+      break;
+    case ROW_JOB_LUMA_CU:
+    {
+      UInt uiWidthInCU = m_pcRowPic->getFrameWidthInCU();
+      for ( UInt uiCUAddr = iRow * uiWidthInCU; uiCUAddr < ( iRow + 1 ) * uiWidthInCU; uiCUAddr++ )
+      {
+        xSubCUAdaptive_qc( m_pcRowPic->getCU( uiCUAddr ), m_pcRowAlfParam, m_pRowRest, m_pRowDec, 0, 0, m_iRowStride );
+      }
+    }
+      break;
+#if MTK_NONCROSS_INLOOP_FILTER
+    case ROW_JOB_LUMA_SLICE:
+      xFilterOneSlice( m_pcRowSlice, m_pRowDec, m_pRowRest, m_iRowStride, m_pcRowAlfParam, iRow );
+      break;
+    case ROW_JOB_CHROMA:
+      xFrameChroma( iPelY >> 1, 0, iRowHeight >> 1, m_img_width >> 1, m_pcRowPicDec, m_pcRowPicRest,
+                    m_pcRowAlfParam->coeff_chroma, m_pcRowAlfParam->tap_chroma, m_iRowColor );
+      break;
+    case ROW_JOB_CHROMA_SLICE:
+      xFrameChromaforOneSlice( m_pcRowSlice, m_iRowColor ? ALF_Cr : ALF_Cb, m_pcRowPicDec, m_pcRowPicRest,
+                               m_pcRowAlfParam->coeff_chroma, m_pcRowAlfParam->tap_chroma, iRow );
+      break;
+#endif
+    default:
+      assert(0);
+      break;
+  }
+}
+
 #if TSB_ALF_HEADER
 Void TComAdaptiveLoopFilter::setNumCUsInFrame(TComPic *pcPic)
 {
@@ -2261,7 +2418,10 @@ Void TComAdaptiveLoopFilter::calcVarforOneSlice(CAlfSlice* pSlice, imgpel **imgY
 }
 
 
-Void TComAdaptiveLoopFilter::xFrameChromaforOneSlice(CAlfSlice* pSlice, Int ComponentID, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, Int *qh, Int iTap)
+/** 
+ \param iLCURow     LCU row of the picture whose LCUs in the slice are filtered, -1 for all LCUs of the slice
+ */
+Void TComAdaptiveLoopFilter::xFrameChromaforOneSlice(CAlfSlice* pSlice, Int ComponentID, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, Int *qh, Int iTap, Int iLCURow)
 {
   Int iColor = (ComponentID == ALF_Cb)?(0):(1);
 
@@ -2271,6 +2431,10 @@ Void TComAdaptiveLoopFilter::xFrameChromaforOneSlice(CAlfSlice* pSlice, Int Comp
   for(Int i=0; i< pSlice->getNumLCUs(); i++)
   { 
     CAlfCU* pAlfCU = &((*pSlice)[i]);
+    if(iLCURow >= 0 && pAlfCU->getCU()->getCUPelY() / m_uiLCUHeight != (UInt)iLCURow)
+    {
+      continue;
+    }
 
     ypos    = (pAlfCU->getCU()->getCUPelY() >> 1);
     xpos    = (pAlfCU->getCU()->getCUPelX() >> 1);
@@ -2697,7 +2861,10 @@ Void CAlfSlice::copySliceChroma(Pel* pPicDst, Pel* pPicSrc, Int iStride )
 
 
 
-Void TComAdaptiveLoopFilter::xFilterOneSlice(CAlfSlice* pSlice, imgpel* pDec, imgpel* pRest, Int iStride, ALFParam* pcAlfParam)
+/** 
+ \param iLCURow     LCU row of the picture, only the LCUs of the slice in this row are filtered
+ */
+Void TComAdaptiveLoopFilter::xFilterOneSlice(CAlfSlice* pSlice, imgpel* pDec, imgpel* pRest, Int iStride, ALFParam* pcAlfParam, Int iLCURow)
 {
 
 
@@ -2709,6 +2876,10 @@ Void TComAdaptiveLoopFilter::xFilterOneSlice(CAlfSlice* pSlice, imgpel* pDec, im
     {
       CAlfCU*     pAlfCU = &((*pSlice)[i]);
       TComDataCU* pcCU   = pAlfCU->getCU();
+      if(pcCU->getCUPelY() / m_uiLCUHeight != (UInt)iLCURow)
+      {
+        continue;
+      }
       xSubCUAdaptive_qc(pcCU, pcAlfParam, pRest, pDec, 0, 0, iStride);
     }
 
@@ -2725,6 +2896,10 @@ Void TComAdaptiveLoopFilter::xFilterOneSlice(CAlfSlice* pSlice, imgpel* pDec, im
     {
       CAlfCU*     pAlfCU = &((*pSlice)[i]);
       TComDataCU* pcCU   = pAlfCU->getCU();
+      if(pcCU->getCUPelY() / m_uiLCUHeight != (UInt)iLCURow)
+      {
+        continue;
+      }
 
       iTPelY = (Int)pcCU->getCUPelY();
       iLPelX = (Int)pcCU->getCUPelX();
@@ -2748,14 +2923,19 @@ Void TComAdaptiveLoopFilter::xFilterOneSlice(CAlfSlice* pSlice, imgpel* pDec, im
 #if MTK_SAO
 TComSampleAdaptiveOffset::TComSampleAdaptiveOffset() :
  m_psQAOPart( NULL ),
- m_pClipTable( NULL ),
  m_ppLumaTableBo0( NULL ),
  m_ppLumaTableBo1( NULL ),
  m_iUpBuff1( NULL ),
  m_iUpBuff2( NULL ),
  m_iUpBufft( NULL ),
- ipSwap( NULL )
-{}
+ ipSwap( NULL ),
+ m_pcOffsetTable( NULL ),
+ m_piLcuPart( NULL ),
+ m_piDbkY( NULL ),
+ m_pcThreadPool( NULL )
+{
+  setSIMDLevel( SIMD_AUTO );
+}
 
 
 const Int TComSampleAdaptiveOffset::m_aiNumPartsInRow[5] =
@@ -2886,32 +3066,10 @@ Void TComSampleAdaptiveOffset::create( UInt uiSourceWidth, UInt uiSourceHeight,
   m_iUpBuff2 = new Int[m_iPicWidth+2];
   m_iUpBufft = new Int[m_iPicWidth+2];
 
-  Pel i;
-
-
-  UInt uiMaxY  = 255   << g_uiBitIncrement;
-  UInt uiMinY  = 0   << g_uiBitIncrement;
-
-
-  Int iCcTableRange = CRANGE >> (4-g_uiBitIncrement);
-
-  for(i=0;i<iCcTableRange;i++)
-  {
-    m_pClipTableBase[i+CRANGE_EXT] = i;
-  }
-
-  for(i=0;i<uiMinY+CRANGE_EXT;i++)
-  {
-    m_pClipTableBase[i] = uiMinY;
-  }
-  for(i=uiMaxY+CRANGE_EXT;i<CRANGE_ALL;i++)
-  {
-    m_pClipTableBase[i] = uiMaxY;
-  }
-
-  m_pClipTable = &(m_pClipTableBase[CRANGE_EXT]);
-
-
+  m_pcOffsetTable = new SAOOffsetTable[m_iNumTotalParts];
+  m_piLcuPart     = new Int[m_iNumCuInWidth*m_iNumCuInHeight];
+  m_piDbkY        = new Pel[m_iPicWidth*m_iPicHeight];
+  m_cRows.create( m_iNumCuInHeight );
 }
 
 
@@ -2920,7 +3078,6 @@ Void TComSampleAdaptiveOffset::create( UInt uiSourceWidth, UInt uiSourceHeight,
  */
 Void TComSampleAdaptiveOffset::destroy()
 {
-  m_pClipTable = NULL;
   ipSwap = NULL;
 
   if (m_ppLumaTableBo0)
@@ -2945,7 +3102,19 @@ Void TComSampleAdaptiveOffset::destroy()
   {
     delete [] m_iUpBufft; m_iUpBufft = NULL;
   }
-
+  if (m_pcOffsetTable)
+  {
+    delete [] m_pcOffsetTable; m_pcOffsetTable = NULL;
+  }
+  if (m_piLcuPart)
+  {
+    delete [] m_piLcuPart; m_piLcuPart = NULL;
+  }
+  if (m_piDbkY)
+  {
+    delete [] m_piDbkY; m_piDbkY = NULL;
+  }
+  m_cRows.destroy();
 }
 
 
@@ -3240,205 +3409,122 @@ inline int xSign(int x)
   return ((x >> 31) | ((int)( (((unsigned int) -x)) >> 31)));
 }
 
-/** Adaptive offset process for Cu
- * \param  iAddr, iPartIdx
+/** Apply SAO to one LCU, the C kernel used if no vectorised one is selected.
+ * \param piSrc deblocked samples, the only ones the classification reads
+ * \param iSrcStride stride of piSrc
+ * \param piDst reconstructed samples receiving the result
+ * \param iDstStride stride of piDst
+ * \param iWidth, iHeight size of the LCU inside the picture
+ * \param pcTable offsets of the partition of the LCU
+ *
+ * Edge offsets leave the samples on the LCU border across the edge direction untouched, so no LCU depends on the
+ * samples of another one.
  */
-Void TComSampleAdaptiveOffset::AoProcessCu(Int iAddr, Int iPartIdx)
-{
-  Int x,y;
-  TComDataCU *pTmpCu = m_pcPic->getCU(iAddr);
-  Pel* pRec       = m_pcPic->getPicYuvRec()->getLumaAddr(iAddr);
-  Int  iStride    = m_pcPic->getStride();
-  Int  iLcuWidth  = m_uiMaxCUWidth;
-  Int  iLcuHeight = m_uiMaxCUHeight;
-  UInt uiLPelX    = pTmpCu->getCUPelX();
-  UInt uiRPelX    = uiLPelX + iLcuWidth;
-  UInt uiTPelY    = pTmpCu->getCUPelY();
-  UInt uiBPelY    = uiTPelY + iLcuHeight;
-  Int  iAoType    = m_psQAOPart[iPartIdx].iBestType;
-  Int  iSignLeft;
-  Int  iSignRight;
-  Int  iSignDown;
-  Int  iSignDown1;
-  Int  iSignDown2;
-  UInt uiEdgeType;
-
-  uiRPelX    = uiRPelX > m_iPicWidth ? m_iPicWidth : uiRPelX;
-  uiBPelY    = uiBPelY > m_iPicHeight? m_iPicHeight: uiBPelY;
-  iLcuWidth  = uiRPelX - uiLPelX;
-  iLcuHeight = uiBPelY - uiTPelY;
-
-  switch (iAoType)
+Void TComSampleAdaptiveOffset::xFilterLcu( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight, const SAOOffsetTable* pcTable )
+{
+  const Int* piOffsetEo = pcTable->aiOffsetEo;
+  Int  iMaxVal = pcTable->iMaxVal;
+  Int  iStartX = 1;
+  Int  iEndX   = iWidth-1;
+  Int  iStartY = 1;
+  Int  iEndY   = iHeight-1;
+  Int  iOffset;
+  Int  iEdgeType;
+  Int  x, y;
+
+  switch (pcTable->iType)
   {
   case SAO_EO_0:
-    {
-      for (y=0; y<iLcuHeight; y++)
-      {
-        iSignLeft  = xSign(pRec[1] - pRec[0]);
-        for (x=1; x<iLcuWidth-1; x++)
-        {
-          iSignRight =  xSign(pRec[x] - pRec[x+1]); 
-          uiEdgeType =  iSignRight + iSignLeft + 2;
-          iSignLeft  = -iSignRight;
-
-          pRec[x] = m_pClipTable[pRec[x] + m_iOffsetEo[uiEdgeType]];
-        }
-        pRec += iStride;
-      }
-      break;
-    }
+    iStartY = 0;
+    iEndY   = iHeight;
+    iOffset = 1;
+    break;
   case SAO_EO_1:
+    iStartX = 0;
+    iEndX   = iWidth;
+    iOffset = iSrcStride;
+    break;
+  case SAO_EO_2:
+    iOffset = iSrcStride+1;
+    break;
+  case SAO_EO_3:
+    iOffset = iSrcStride-1;
+    break;
+  default:
     {
-      pRec += iStride;
-      for (x=0; x< iLcuWidth; x++)
+      const Int* piOffsetBo = pcTable->aiOffsetBo;
+      Int        iShift     = pcTable->iBandShift;
+      for (y=0; y<iHeight; y++)
       {
-        m_iUpBuff1[x] = xSign(pRec[x] - pRec[x-iStride]);
-      }
-      for (y=1; y<iLcuHeight-1; y++)
-      {
-        for (x=0; x<iLcuWidth; x++)
+        for (x=0; x<iWidth; x++)
         {
-          iSignDown  =  xSign(pRec[x] - pRec[x+iStride]); 
-          uiEdgeType =  iSignDown + m_iUpBuff1[x] + 2;
-          m_iUpBuff1[x]= -iSignDown;
-
-          pRec[x] = m_pClipTable[pRec[x] + m_iOffsetEo[uiEdgeType]];
+          piDst[x] = Clip3(0, iMaxVal, piSrc[x] + piOffsetBo[piSrc[x] >> iShift]);
         }
-        pRec += iStride;
+        piSrc += iSrcStride;
+        piDst += iDstStride;
       }
-      break;
+      return;
     }
-  case SAO_EO_2:
-    {
-      pRec += iStride;
-      for (x=1; x<iLcuWidth; x++)
-      {
-        m_iUpBuff1[x] = xSign(pRec[x] - pRec[x-iStride-1]);
-      }
-      for (y=1; y<iLcuHeight-1; y++)
-      {
-        iSignDown2 = xSign(pRec[iStride] - pRec[0]);
-
-        for (x=1; x<iLcuWidth-1; x++)
-        {
-          iSignDown1      =  xSign(pRec[x] - pRec[x+iStride+1]) ;
-          uiEdgeType      =  iSignDown1 + m_iUpBuff1[x] + 2;
-          m_iUpBufft[x+1] = -iSignDown1; 
-          pRec[x] = m_pClipTable[pRec[x] + m_iOffsetEo[uiEdgeType]];
-        }
-        m_iUpBufft[1] = iSignDown2;
-
-        ipSwap     = m_iUpBuff1;
-        m_iUpBuff1 = m_iUpBufft;
-        m_iUpBufft = ipSwap;
+  }
 
-        pRec += iStride;
-      }
-      break;
-    } 
-  case SAO_EO_3:
+  const Pel* piSrcRow = piSrc + iStartY*iSrcStride;
+  Pel*       piDstRow = piDst + iStartY*iDstStride;
+  for (y=iStartY; y<iEndY; y++)
+  {
+    for (x=iStartX; x<iEndX; x++)
     {
-      pRec += iStride;
-      for (x=0; x<iLcuWidth-1; x++)
-      {
-        m_iUpBuff1[x] = xSign(pRec[x] - pRec[x-iStride+1]);
-      }
-      for (y=1; y<iLcuHeight-1; y++)
-      {
-        for (x=1; x<iLcuWidth-1; x++)
-        {
-          iSignDown1      =  xSign(pRec[x] - pRec[x+iStride-1]) ;
-          uiEdgeType      =  iSignDown1 + m_iUpBuff1[x] + 2;
-          m_iUpBuff1[x-1]   = -iSignDown1; 
-          pRec[x] = m_pClipTable[pRec[x] + m_iOffsetEo[uiEdgeType]];
-        }
-        m_iUpBuff1[iLcuWidth-2] = xSign(pRec[iLcuWidth-2 + iStride] - pRec[iLcuWidth-1]);
+      iEdgeType     = xSign(piSrcRow[x] - piSrcRow[x-iOffset]) + xSign(piSrcRow[x] - piSrcRow[x+iOffset]) + 2;
+      piDstRow[x]   = Clip3(0, iMaxVal, piSrcRow[x] + piOffsetEo[iEdgeType]);
+    }
+    piSrcRow += iSrcStride;
+    piDstRow += iDstStride;
+  }
 
-        pRec += iStride;
-      } 
-      break;
-    }   
-  case SAO_BO_0:
-  case SAO_BO_1:
+  // below the second row the line buffer of the 135 degree class compares the first column with the one above
+  // instead of the second column with the first one above, the result depends on it
+  if (pcTable->iType == SAO_EO_2 && iWidth > 2)
+  {
+    for (y=2; y<iHeight-1; y++)
     {
-      for (y=0; y<iLcuHeight; y++)
-      {
-        for (x=0; x<iLcuWidth; x++)
-        {
-          pRec[x] = m_iOffsetBo[pRec[x]];
-        }
-        pRec += iStride;
-      }
-      break;
+      const Pel* piSrcY = piSrc + y*iSrcStride;
+      iEdgeType = xSign(piSrcY[0] - piSrcY[-iSrcStride]) + xSign(piSrcY[1] - piSrcY[iSrcStride+2]) + 2;
+      piDst[y*iDstStride+1] = Clip3(0, iMaxVal, piSrcY[1] + piOffsetEo[iEdgeType]);
     }
-  default: break;
-
   }
 }
 
-
-/** run adaptive offset One Part
- * \param  uiPartIdx, pcPicYuvDst, pcPicYuvSrc
+/** Set the offsets of one partition in the form taken by the SAO kernels
+ * \param  uiPartIdx
  */
-Void TComSampleAdaptiveOffset::xAoOnePart(UInt uiPartIdx, TComPicYuv* pcPicYuvDst, TComPicYuv* pcPicYuvSrc)
+Void TComSampleAdaptiveOffset::xSetOffsetTable(UInt uiPartIdx)
 {
-  int  i;
-  UInt uiEdgeType, uiTypeIdx;
-  Pel* ppLumaTable = NULL;
-
-  static Int iOffset[LUMA_GROUP_NUM];
-  Int LcuIdxX;
-  Int LcuIdxY;
-  Int iAddr;
-  Int iFrameWidthInCU = m_pcPic->getFrameWidthInCU();
+  SAOQTPart*      pQAOPart = &(m_psQAOPart[uiPartIdx]);
+  SAOOffsetTable* pcTable  = &(m_pcOffsetTable[uiPartIdx]);
+  Int  iOffset[LUMA_GROUP_NUM];
+  Int  i;
 
-  if(m_psQAOPart[uiPartIdx].bEnableFlag)
+  ::memset(iOffset, 0, sizeof(iOffset));
+  for (i=0;i<pQAOPart->iLength;i++)
   {
-    uiTypeIdx = m_psQAOPart[uiPartIdx].iBestType;
-    if (uiTypeIdx == SAO_BO_0 || uiTypeIdx == SAO_BO_1)
-    {
-      for (i=0;i<m_psQAOPart[uiPartIdx].iLength;i++)
-        iOffset[i+1] = m_psQAOPart[uiPartIdx].iOffset[i] << (g_uiBitIncrement-m_uiAoBitDepth);
-
-      if (uiTypeIdx == SAO_BO_0 )
-      {
-        ppLumaTable = m_ppLumaTableBo0;
-      }
-      if (uiTypeIdx == SAO_BO_1 )
-      {
-        ppLumaTable = m_ppLumaTableBo1;
-      }
+    iOffset[i+1] = pQAOPart->iOffset[i] << (g_uiBitIncrement-m_uiAoBitDepth);
+  }
 
-      for (i=0;i<(1<<(g_uiBitIncrement+8));i++)
-      {
-        m_iOffsetBo[i] = m_pClipTable[i + iOffset[ppLumaTable[i]]];
-      }
+  pcTable->iType      = pQAOPart->iBestType;
+  pcTable->iBandShift = g_uiBitDepth + g_uiBitIncrement - MTK_QAO_BO_BITS;
+  pcTable->iMaxVal    = 255 << g_uiBitIncrement;
 
-    }
-    if (uiTypeIdx == SAO_EO_0 || uiTypeIdx == SAO_EO_1 || uiTypeIdx == SAO_EO_2 || uiTypeIdx == SAO_EO_3)
-    {
-      for (i=0;i<m_psQAOPart[uiPartIdx].iLength;i++)
-      {
-        iOffset[i+1] = m_psQAOPart[uiPartIdx].iOffset[i] << (g_uiBitIncrement-m_uiAoBitDepth);
-      }
-      for (uiEdgeType=0;uiEdgeType<6;uiEdgeType++)
-      {
-        m_iOffsetEo[uiEdgeType]= iOffset[m_auiEoTable[uiEdgeType]];
-      }
-    }
-    for (LcuIdxY = m_psQAOPart[uiPartIdx].StartCUY; LcuIdxY<= m_psQAOPart[uiPartIdx].EndCUY; LcuIdxY++)
-    {
-      for (LcuIdxX = m_psQAOPart[uiPartIdx].StartCUX; LcuIdxX<= m_psQAOPart[uiPartIdx].EndCUX; LcuIdxX++)
-      {
-        iAddr = LcuIdxY * iFrameWidthInCU + LcuIdxX;
-        AoProcessCu(iAddr, uiPartIdx);
-      }
-    }
+  for (i=0;i<=SAO_EO_LEN;i++)
+  {
+    pcTable->aiOffsetEo[i] = iOffset[m_auiEoTable[i]];
+  }
+  Pel* ppLumaTable = (pcTable->iType == SAO_BO_1) ? m_ppLumaTableBo1 : m_ppLumaTableBo0;
+  for (i=0;i<LUMA_GROUP_NUM;i++)
+  {
+    pcTable->aiOffsetBo[i] = iOffset[ppLumaTable[i << pcTable->iBandShift]];
   }
 }
 
-
-/** Process QuadTree adaptive offset
+/** Process QuadTree adaptive offset: set the offsets of the enabled partitions and the partition of their LCUs
  * \param  uiPartIdx, pcPicYuvRec, pcPicYuvExt
  */
 Void TComSampleAdaptiveOffset::xProcessQuadTreeAo(UInt uiPartIdx, TComPicYuv* pcPicYuvRec, TComPicYuv* pcPicYuvExt)
@@ -3449,10 +3535,14 @@ Void TComSampleAdaptiveOffset::xProcessQuadTreeAo(UInt uiPartIdx, TComPicYuv* pc
   {
     if (pQAOPart->bEnableFlag)
     {
-      xAoOnePart(uiPartIdx, pcPicYuvRec, pcPicYuvExt);
-    }
-    else
-    {
+      xSetOffsetTable(uiPartIdx);
+      for (Int LcuIdxY = pQAOPart->StartCUY; LcuIdxY<= pQAOPart->EndCUY; LcuIdxY++)
+      {
+        for (Int LcuIdxX = pQAOPart->StartCUX; LcuIdxX<= pQAOPart->EndCUX; LcuIdxX++)
+        {
+          m_piLcuPart[LcuIdxY * m_iNumCuInWidth + LcuIdxX] = uiPartIdx;
+        }
+      }
     }
     return;
   }
@@ -3466,6 +3556,88 @@ Void TComSampleAdaptiveOffset::xProcessQuadTreeAo(UInt uiPartIdx, TComPicYuv* pc
   }
 }
 
+/** Apply SAO to the LCUs of one row
+ * \param  iRow LCU row
+ *
+ * Each LCU is first copied to the shared deblocked picture, the kernel then classifies from the copy and writes to
+ * the reconstruction.
+ */
+Void TComSampleAdaptiveOffset::xFilterRow(Int iRow)
+{
+  Pel* piRec    = m_pcPic->getPicYuvRec()->getLumaAddr();
+  Int  iStride  = m_pcPic->getStride();
+  Int  iTPelY   = iRow * (Int)m_uiMaxCUHeight;
+  Int  iHeight  = min<Int>(m_uiMaxCUHeight, m_iPicHeight - iTPelY);
+  FpSAOFilter fpFilter = m_fpFilter ? m_fpFilter : xFilterLcu;
+
+  for (Int iCol=0; iCol<m_iNumCuInWidth; iCol++)
+  {
+    Int iPartIdx = m_piLcuPart[iRow*m_iNumCuInWidth + iCol];
+    if (iPartIdx < 0)
+    {
+      continue;
+    }
+    Int  iLPelX = iCol * (Int)m_uiMaxCUWidth;
+    Int  iWidth = min<Int>(m_uiMaxCUWidth, m_iPicWidth - iLPelX);
+    Pel* piDst  = piRec + iTPelY*iStride + iLPelX;
+    Pel* piSrc  = m_piDbkY + iTPelY*m_iPicWidth + iLPelX;
+    for (Int y=0; y<iHeight; y++)
+    {
+      ::memcpy(piSrc + y*m_iPicWidth, piDst + y*iStride, sizeof(Pel)*iWidth);
+    }
+    fpFilter(piSrc, m_iPicWidth, piDst, iStride, iWidth, iHeight, &m_pcOffsetTable[iPartIdx]);
+  }
+}
+
+/** Set the partition of each LCU and the offsets of the partitions from the quad-tree
+ */
+Void TComSampleAdaptiveOffset::xSetLcuParts()
+{
+  for (Int i=0; i<m_iNumCuInWidth*m_iNumCuInHeight; i++)
+  {
+    m_piLcuPart[i] = -1;
+  }
+  xProcessQuadTreeAo(0, m_pcPic->getPicYuvRec(), NULL);
+}
+
+/** Apply the offsets of the partition quad-tree to the LCU rows of m_pcPic, on the threads of m_pcThreadPool if any
+ */
+Void TComSampleAdaptiveOffset::xRunRows()
+{
+  xSetLcuParts();
+
+  m_cRows.init(m_iNumCuInHeight);
+  if (m_pcThreadPool && m_pcThreadPool->getNumThreads() > 1)
+  {
+    m_pcThreadPool->run(this);
+  }
+  else
+  {
+    runTask(0);
+  }
+}
+
+/** Apply SAO to the LCU rows claimed by one thread
+ * \param  iThreadIdx
+ */
+Void TComSampleAdaptiveOffset::runTask(Int iThreadIdx)
+{
+  Int iRow;
+  while ((iRow = m_cRows.claimRow()) >= 0)
+  {
+    xFilterRow(iRow);
+  }
+}
+
+/** Select the SAO kernel
+ * \param iLevel requested SIMDLevel, see TComAdaptiveLoopFilterSIMD::initSaoFunc()
+ * \returns level in use
+ */
+Int TComSampleAdaptiveOffset::setSIMDLevel(Int iLevel)
+{
+  m_fpFilter = NULL;
+  return TComAdaptiveLoopFilterSIMD::initSaoFunc(&m_fpFilter, iLevel);
+}
 
 /** reset QT Part
  * \param  
@@ -3505,8 +3677,9 @@ Void TComSampleAdaptiveOffset::copyQaoData(SAOParam* pcQaoParam )
 }
 /** Sample adaptive offset Process
  * \param pcPic, pcQaoParam  
+ * \param pcThreadPool threads sharing the LCU rows, NULL to run on the calling thread
  */
-Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pcPic, SAOParam* pcQaoParam)
+Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pcPic, SAOParam* pcQaoParam, TComThreadPool* pcThreadPool)
 {
 
   if (pcQaoParam->bSaoFlag)
@@ -3519,16 +3692,42 @@ Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pcPic, SAOParam* pcQaoParam)
     {
       m_uiAoBitDepth = 0;
     }
-    m_pcPic = pcPic;
-    TComPicYuv* pcPicYuvRec = m_pcPic->getPicYuvRec();
-    TComPicYuv* pcPicYuvExt = NULL;
+    m_pcPic        = pcPic;
+    m_pcThreadPool = pcThreadPool;
+
+    xRunRows();
+
+    m_pcPic        = NULL;
+    m_pcThreadPool = NULL;
+  }
+}
 
+/** Prepare SAOProcessRow() to apply the offsets to the LCU rows of a picture one at a time, on the calling thread.
+ * Each row only reads its own samples, so it can be processed as soon as its deblocking is final.
+ * \param pcPic, pcQaoParam
+ */
+Void TComSampleAdaptiveOffset::SAOStartRows(TComPic* pcPic, SAOParam* pcQaoParam)
+{
+  m_pcPic = NULL;
+  if (pcQaoParam->bSaoFlag)
+  {
+    m_uiAoBitDepth = g_uiBitIncrement>1 ? 1 : 0;
+    m_pcPic        = pcPic;
+    xSetLcuParts();
+  }
+}
 
+/** \param iRow LCU row, the rows being processed in order
+ */
+Void TComSampleAdaptiveOffset::SAOProcessRow(Int iRow)
+{
+  if (m_pcPic)
+  {
+    xFilterRow(iRow);
+    if (iRow == m_iNumCuInHeight-1)
     {
-      xProcessQuadTreeAo( 0, pcPicYuvRec,  pcPicYuvExt);
+      m_pcPic = NULL;
     }
-
-    m_pcPic = NULL;
   }
 }
 
@@ -3546,17 +3745,27 @@ Void TComAdaptiveLoopFilter::PCMLFDisableProcess (TComPic* pcPic)
   xPCMRestoration(pcPic);
 }
 
+/** Same as PCMLFDisableProcess() for the LCUs of one row.
+ * \param pcPic picture (TComPic) pointer
+ * \param iRow  LCU row
+ */
+Void TComAdaptiveLoopFilter::PCMLFDisableProcessRow (TComPic* pcPic, Int iRow)
+{
+  xPCMRestoration(pcPic, iRow * pcPic->getFrameWidthInCU(), ( iRow + 1 ) * pcPic->getFrameWidthInCU());
+}
+
 /** Picture-level PCM restoration. 
  * \param pcPic picture (TComPic) pointer
+ * \param uiStartCUAddr, uiEndCUAddr LCUs restored, all of them by default
  * \returns Void
  */
-Void TComAdaptiveLoopFilter::xPCMRestoration(TComPic* pcPic)
+Void TComAdaptiveLoopFilter::xPCMRestoration(TComPic* pcPic, UInt uiStartCUAddr, UInt uiEndCUAddr)
 {
   Bool  bPCMFilter = (pcPic->getSlice(0)->getSPS()->getPCMFilterDisableFlag() && ((1<<pcPic->getSlice(0)->getSPS()->getPCMLog2MinSize()) <= g_uiMaxCUWidth))? true : false;
 
   if(bPCMFilter)
   {
-    for( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame() ; uiCUAddr++ )
+    for( UInt uiCUAddr = uiStartCUAddr; uiCUAddr < min( uiEndCUAddr, pcPic->getNumCUsInFrame() ) ; uiCUAddr++ )
     {
       TComDataCU* pcCU = pcPic->getCU(uiCUAddr);
 
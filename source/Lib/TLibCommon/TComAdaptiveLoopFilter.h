@@ -39,6 +39,7 @@
 #define __TCOMADAPTIVELOOPFILTER__
 
 #include "TComPic.h"
+#include "TComThreadPool.h"
 
 // ====================================================================================================================
 // Constants
@@ -123,6 +124,22 @@ enum ALFClassficationMethod
   NUM_ALF_CLASS_METHOD
 };
 #endif
+
+/// point-symmetric ALF filter in the form taken by the filtering kernels
+struct ALFFilterKernel
+{
+  Int   iNumPairs;                                        ///< number of sample pairs, the centre sample excluded
+  Int   aiOffset[ALF_MAX_NUM_COEF];                       ///< offset of one sample of each pair, the other one is mirrored
+  Int   aaiCoefPair[NO_VAR_BINS][ALF_MAX_NUM_COEF/2];     ///< coefficients of each class, pair terms then centre, two per Int
+  Int   aiDC[NO_VAR_BINS];                                ///< DC offset of each class including the rounding offset
+  Int   iShift;                                           ///< right shift of the weighted sum
+  Bool  bValid;                                           ///< coefficients fit in 16 bits and are up to date
+};
+
+/// filter a block with an ALFFilterKernel, the class of each 4x4 block is read from ppiClass (class 0 if NULL)
+typedef Void (*FpALFFilter)( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                             const ALFFilterKernel* pcKernel, imgpel** ppiClass, Int iClassX, Int iClassY );
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -139,7 +156,21 @@ enum ALFClassficationMethod
 #define MAX_NUM_QAO_CLASS              32
 #define SAO_RDCO 0
 
-class TComSampleAdaptiveOffset
+/// offsets of one SAO partition in the form taken by the SAO kernels
+struct SAOOffsetTable
+{
+  Int   iType;                                            ///< SAO_EO_0 ... SAO_BO_1
+  Int   aiOffsetEo[SAO_EO_LEN+1];                         ///< offset of each edge class, the sum of the two signs plus 2
+  Int   aiOffsetBo[LUMA_GROUP_NUM];                       ///< offset of each band
+  Int   iBandShift;                                       ///< right shift giving the band of a sample
+  Int   iMaxVal;                                          ///< largest output sample
+};
+
+/// apply an SAOOffsetTable to one LCU, the classification reads the deblocked samples of piSrc only
+typedef Void (*FpSAOFilter)( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                             const SAOOffsetTable* pcTable );
+
+class TComSampleAdaptiveOffset : public TComThreadTask
 {
 protected:
   TComPic*          m_pcPic;
@@ -152,8 +183,6 @@ protected:
   static const UInt m_auiEoTable[9];
   static const UInt m_auiEoTable2D[9];
   static const UInt m_iWeightAO[MAX_NUM_SAO_TYPE];
-  Int m_iOffsetBo[4096];
-  Int m_iOffsetEo[LUMA_GROUP_NUM];
 
   Int  m_iPicWidth;
   Int  m_iPicHeight;
@@ -181,8 +210,6 @@ protected:
   Int   m_iMaxCb;
   Int   m_iMinCr;
   Int   m_iMaxCr;
-  Pel   *m_pClipTable;
-  Pel   m_pClipTableBase[CRANGE_ALL];
   Pel   *m_ppLumaTableBo0;
   Pel   *m_ppLumaTableBo1;
 
@@ -191,8 +218,23 @@ protected:
   Int   *m_iUpBufft;
   Int  *ipSwap;
 
+  SAOOffsetTable*   m_pcOffsetTable;                     ///< offsets of each partition, set by xProcessQuadTreeAo()
+  Int*              m_piLcuPart;                         ///< partition applied to each LCU, -1 if none
+  Pel*              m_piDbkY;                            ///< deblocked luma read by the classification of all LCU rows
+  FpSAOFilter       m_fpFilter;                          ///< vectorised kernel, xFilterLcu() if NULL
+  TComWavefront     m_cRows;                             ///< hands the LCU rows out to the threads
+  TComThreadPool*   m_pcThreadPool;                      ///< threads of the current SAOProcess(), NULL if none
+  
+  static Void xFilterLcu( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                          const SAOOffsetTable* pcTable );
+  Void xSetOffsetTable  ( UInt uiPartIdx );
+  Void xFilterRow       ( Int iRow );
+  Void xSetLcuParts     ();
+  Void xRunRows         ();
+
 public:
   TComSampleAdaptiveOffset();
+  virtual ~TComSampleAdaptiveOffset() {}
   Void create( UInt uiSourceWidth, UInt uiSourceHeight, UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxCUDepth );
   Void destroy ();
   Void xCreateQAOParts();
@@ -205,14 +247,16 @@ public:
   Int  getMaxSplitLevel() {return (Int)m_uiMaxSplitLevel;}
   SAOQTPart * getQTPart() {return m_psQAOPart;}
 
-  Void SAOProcess(TComPic* pcPic, SAOParam* pcQaoParam);
+  Int  setSIMDLevel( Int iLevel );
+  Void SAOProcess(TComPic* pcPic, SAOParam* pcQaoParam, TComThreadPool* pcThreadPool = NULL);
+  Void SAOStartRows(TComPic* pcPic, SAOParam* pcQaoParam);   ///< SAOProcess() split into SAOProcessRow() calls
+  Void SAOProcessRow(Int iRow);
+  Void runTask( Int iThreadIdx );
   Void resetQTPart();
-  Void xAoOnePart(UInt uiPartIdx, TComPicYuv* pcPicYuvRec, TComPicYuv* pcPicYuvExt);
   Void xProcessQuadTreeAo(UInt uiPartIdx, TComPicYuv* pcPicYuvRec, TComPicYuv* pcPicYuvExt);
   Void copyQaoData(SAOParam* pcQaoParam);
 
   Void InitSao(SAOParam* pSaoParam);
-  Void AoProcessCu(Int iAddr, Int iPartIdx);
 };
 #endif
 
@@ -291,8 +335,8 @@ private:
 #endif 
 
 
-/// adaptive loop filter class
-class TComAdaptiveLoopFilter
+/// adaptive loop filter class, the LCU rows of a picture may be filtered on several threads
+class TComAdaptiveLoopFilter : public TComThreadTask
 {
 protected:
   // quantized filter coefficients
@@ -365,9 +409,9 @@ protected:
   CAlfSlice*  m_pSlice;
   Bool        m_bIsFirstDecodedSlice;
 
-  Void xFilterOneSlice            (CAlfSlice* pSlice, imgpel* pDec, imgpel* pRest, Int iStride, ALFParam* pcAlfParam);
+  Void xFilterOneSlice            (CAlfSlice* pSlice, imgpel* pDec, imgpel* pRest, Int iStride, ALFParam* pcAlfParam, Int iLCURow);
   Void calcVarforOneSlice         (CAlfSlice* pSlice, imgpel **imgY_var, imgpel *imgY_pad, Int pad_size, Int fl, Int img_stride);
-  Void xFrameChromaforOneSlice    (CAlfSlice* pSlice, Int ComponentID, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, Int *qh, Int iTap);
+  Void xFrameChromaforOneSlice    (CAlfSlice* pSlice, Int ComponentID, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, Int *qh, Int iTap, Int iLCURow = -1);
   //for decoder CU on/off control
   Void setAlfCtrlFlagsforSlices   (ALFParam *pcAlfParam, UInt &idx);
   Void setAlfCtrlFlagsforOneSlice (CAlfSlice* pSlice, ALFParam *pcAlfParam, UInt &idx);
@@ -401,18 +445,21 @@ protected:
   Void calcVar(int ypos, int xpos, imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride);
 #else
   Void calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride);
+#endif
+#if MQT_BA_RA
+  Void xCalcVarGradients(Int iStartRow, Int iEndRow, Int xpos, imgpel *imgY_pad, Int pad_size, Int fl, Int img_width, Int img_stride);
+  Void xCalcVarClasses  (Int iStartRow, Int iEndRow, Int xpos, imgpel **imgY_var, Int img_width);
 #endif
   Void DecFilter_qc(imgpel* imgY_rec,ALFParam* pcAlfParam, int Stride);
   Void xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, UInt uiAbsPartIdx, UInt uiDepth, Int Stride);
   Void xCUAdaptive_qc(TComPic* pcPic, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, Int Stride);
   Void subfilterFrame(imgpel *imgY_rec_post, imgpel *imgY_rec, int filtNo, int start_height, int end_height, int start_width, int end_width, int Stride);
-  Void filterFrame(imgpel *imgY_rec_post, imgpel *imgY_rec, int filtNo, int Stride);
 #if TSB_ALF_HEADER
   UInt  m_uiNumCUsInFrame;
   Void  setAlfCtrlFlags (ALFParam *pAlfParam, TComDataCU *pcCU, UInt uiAbsPartIdx, UInt uiDepth, UInt &idx);
 #endif
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-  Void xPCMRestoration        (TComPic* pcPic);
+  Void xPCMRestoration        (TComPic* pcPic, UInt uiStartCUAddr = 0, UInt uiEndCUAddr = MAX_UINT);
   Void xPCMCURestoration      (TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth);
   Void xPCMSampleRestoration  (TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, TextType ttText);
 #endif
@@ -430,6 +477,51 @@ protected:
 #else
   Void xFrameChroma ( TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, Int *qh, Int iTap, Int iColor );
 #endif
+  
+  // ------------------------------------------------------------------------------------------------------------------
+  // Vectorised kernels and LCU row threads
+  // ------------------------------------------------------------------------------------------------------------------
+  
+  /// stage of ALFProcess() run on the LCU rows by runTask()
+  enum RowJob
+  {
+    ROW_JOB_VAR_GRADIENT,                                ///< gradients of calcVar()
+    ROW_JOB_VAR_CLASS,                                   ///< classification of calcVar(), after all gradients
+    ROW_JOB_LUMA,                                        ///< luma filtering of the whole picture
+    ROW_JOB_LUMA_CU,                                     ///< luma filtering controlled by the CU flags
+    ROW_JOB_LUMA_SLICE,                                  ///< luma filtering of the LCUs of one slice
+    ROW_JOB_CHROMA,                                      ///< chroma filtering of the whole picture
+    ROW_JOB_CHROMA_SLICE,                                ///< chroma filtering of the LCUs of one slice
+    ROW_JOB_CORRELATION                                  ///< encoder statistics, see TEncAdaptiveLoopFilter::runTask()
+  };
+  
+  FpALFFilter       m_fpFilter;                          ///< vectorised kernel, NULL to use the C filters
+  ALFFilterKernel   m_cLumaKernel;                       ///< luma filter of the picture for m_fpFilter, built by xALFLuma_qc()
+  
+  UInt              m_uiLCUHeight;
+  TComWavefront     m_cRows;                             ///< hands the LCU rows out to the threads
+  TComThreadPool*   m_pcThreadPool;                      ///< threads of the current ALFProcess(), NULL if none
+  RowJob            m_eRowJob;
+  TComPic*          m_pcRowPic;
+  ALFParam*         m_pcRowAlfParam;
+  imgpel*           m_pRowDec;
+  imgpel*           m_pRowRest;
+  Int               m_iRowStride;
+#if MTK_NONCROSS_INLOOP_FILTER
+  CAlfSlice*        m_pcRowSlice;
+#endif
+  TComPicYuv*       m_pcRowPicDec;
+  TComPicYuv*       m_pcRowPicRest;
+  Int               m_iRowColor;
+  UInt              m_uiRowCtrlIdx;                      ///< next CU flag of ALFProcessRow()
+  
+  Void xInitLumaKernel    ( ALFFilterKernel* pcKernel, Int filtNo, Int iStride );
+  Void xInitChromaKernel  ( ALFFilterKernel* pcKernel, Int* qh, Int iTap, Int iStride );
+  Void xSetKernelCoef     ( ALFFilterKernel* pcKernel, Int iClass, const Int* piCoef, Int iDC );
+  
+  Void xRunRows           ( RowJob eJob );
+  Void xFilterRow         ( Int iRow );
+  Void xInitLuma          ( ALFParam* pcAlfParam, imgpel* pDec, imgpel* pRest, Int LumaStride );
 
 public:
   TComAdaptiveLoopFilter();
@@ -451,10 +543,18 @@ public:
   Void predictALFCoeff        ( ALFParam* pAlfParam );                  ///< prediction of luma ALF coefficients
   Void predictALFCoeffChroma  ( ALFParam* pAlfParam );                  ///< prediction of chroma ALF coefficients
   
+  Int  setSIMDLevel           ( Int iLevel );
+  
   // interface function
-  Void ALFProcess             ( TComPic* pcPic, ALFParam* pcAlfParam ); ///< interface function for ALF process
+  Void ALFProcess             ( TComPic* pcPic, ALFParam* pcAlfParam, TComThreadPool* pcThreadPool = NULL ); ///< interface function for ALF process
+  Void runTask                ( Int iThreadIdx );
+#if MTK_NONCROSS_INLOOP_FILTER && MQT_BA_RA
+  Void ALFStartRows           ( TComPic* pcPic, ALFParam* pcAlfParam ); ///< ALFProcess() split into ALFProcessRow() calls
+  Int  ALFProcessRow          ( Int iRow );
+#endif
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
   Void PCMLFDisableProcess    ( TComPic* pcPic);                        ///< interface function for ALF process 
+  Void PCMLFDisableProcessRow ( TComPic* pcPic, Int iRow );
 #endif
 
 #if TI_ALF_MAX_VSIZE_7
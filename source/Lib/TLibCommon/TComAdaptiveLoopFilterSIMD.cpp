@@ -0,0 +1,573 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComAdaptiveLoopFilterSIMD.cpp
+    \brief    SSE4.1 / AVX2 adaptive loop filter kernels selected at run time
+*/
+
+#include "TComAdaptiveLoopFilterSIMD.h"
+#include "TComRom.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ALF_SIMD          1
+#include <immintrin.h>
+#else
+#define ALF_SIMD          0
+#endif
+
+// the kernels are compiled for their own instruction set, the rest of the library keeps the default target
+#if defined(__GNUC__)
+#define TARGET_SSE41  __attribute__((target("sse4.1")))
+#define TARGET_AVX2   __attribute__((target("avx2")))
+#define SIMD_INLINE   inline __attribute__((always_inline))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#define SIMD_INLINE   __forceinline
+#endif
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+// the terms of the filter are the sums of the mirrored sample pairs followed by the centre sample; two terms share
+// one madd with the coefficient pair of their class, a zero term pads an odd number of terms
+
+#if ALF_SIMD
+
+// --------------------------------------------------------------------------------------------------------------------
+// SSE4.1
+// --------------------------------------------------------------------------------------------------------------------
+
+/// eight adjacent samples, or four in the low half
+template <Bool bHalf>
+TARGET_SSE41 static SIMD_INLINE __m128i xLoad( const Pel* piSrc )
+{
+  return bHalf ? _mm_loadl_epi64( (const __m128i*)piSrc ) : _mm_loadu_si128( (const __m128i*)piSrc );
+}
+
+/// sums of the samples iOffset before and after eight adjacent positions
+template <Bool bHalf>
+TARGET_SSE41 static SIMD_INLINE __m128i xPairSum( const Pel* piSrc, Int iOffset )
+{
+  return _mm_add_epi16( xLoad<bHalf>( piSrc + iOffset ), xLoad<bHalf>( piSrc - iOffset ) );
+}
+
+/// filtered outputs of eight adjacent positions, the first four use the coefficients of class iClass0, the others
+/// the ones of iClass1; only the first four are computed if bHalf
+template <Bool bHalf>
+TARGET_SSE41 static SIMD_INLINE __m128i xFilter8( const Pel* piSrc, const ALFFilterKernel* pcKernel, Int iClass0, Int iClass1, __m128i vShift, __m128i vMax )
+{
+  const Int*  piOffset  = pcKernel->aiOffset;
+  const Int*  piCoef0   = pcKernel->aaiCoefPair[iClass0];
+  const Int*  piCoef1   = pcKernel->aaiCoefPair[iClass1];
+  Int         iNumPairs = pcKernel->iNumPairs;
+  
+  __m128i vLo = _mm_set1_epi32( pcKernel->aiDC[iClass0] );
+  __m128i vHi = _mm_set1_epi32( pcKernel->aiDC[iClass1] );
+  Int k = 0;
+  for ( ; k + 1 < iNumPairs; k += 2 )
+  {
+    __m128i vT0 = xPairSum<bHalf>( piSrc, piOffset[k    ] );
+    __m128i vT1 = xPairSum<bHalf>( piSrc, piOffset[k + 1] );
+    vLo = _mm_add_epi32( vLo, _mm_madd_epi16( _mm_unpacklo_epi16( vT0, vT1 ), _mm_set1_epi32( piCoef0[k >> 1] ) ) );
+    if ( !bHalf )
+    {
+      vHi = _mm_add_epi32( vHi, _mm_madd_epi16( _mm_unpackhi_epi16( vT0, vT1 ), _mm_set1_epi32( piCoef1[k >> 1] ) ) );
+    }
+  }
+  __m128i vCentre = xLoad<bHalf>( piSrc );
+  __m128i vT0     = k < iNumPairs ? xPairSum<bHalf>( piSrc, piOffset[k] ) : vCentre;
+  __m128i vT1     = k < iNumPairs ? vCentre : _mm_setzero_si128();
+  vLo = _mm_add_epi32( vLo, _mm_madd_epi16( _mm_unpacklo_epi16( vT0, vT1 ), _mm_set1_epi32( piCoef0[k >> 1] ) ) );
+  vLo = _mm_sra_epi32( vLo, vShift );
+  if ( bHalf )
+  {
+    vHi = vLo;
+  }
+  else
+  {
+    vHi = _mm_add_epi32( vHi, _mm_madd_epi16( _mm_unpackhi_epi16( vT0, vT1 ), _mm_set1_epi32( piCoef1[k >> 1] ) ) );
+    vHi = _mm_sra_epi32( vHi, vShift );
+  }
+  // saturation of the pack cannot change the result of the clip
+  return _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), _mm_setzero_si128() ), vMax );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// AVX2
+// --------------------------------------------------------------------------------------------------------------------
+
+/// iValue0 in the low 128-bit lane, iValue1 in the high one
+TARGET_AVX2 static SIMD_INLINE __m256i xSet2( Int iValue0, Int iValue1 )
+{
+  return _mm256_blend_epi32( _mm256_set1_epi32( iValue0 ), _mm256_set1_epi32( iValue1 ), 0xf0 );
+}
+
+/// sums of the samples iOffset before and after sixteen adjacent positions
+TARGET_AVX2 static SIMD_INLINE __m256i xPairSum16( const Pel* piSrc, Int iOffset )
+{
+  return _mm256_add_epi16( _mm256_loadu_si256( (const __m256i*)( piSrc + iOffset ) ), _mm256_loadu_si256( (const __m256i*)( piSrc - iOffset ) ) );
+}
+
+/// filtered outputs of sixteen adjacent positions, each group of four uses the coefficients of its class in aiClass
+TARGET_AVX2 static SIMD_INLINE __m256i xFilter16( const Pel* piSrc, const ALFFilterKernel* pcKernel, const Int* aiClass, __m128i vShift, __m256i vMax )
+{
+  const Int*  piOffset  = pcKernel->aiOffset;
+  const Int*  piCoef0   = pcKernel->aaiCoefPair[aiClass[0]];
+  const Int*  piCoef1   = pcKernel->aaiCoefPair[aiClass[1]];
+  const Int*  piCoef2   = pcKernel->aaiCoefPair[aiClass[2]];
+  const Int*  piCoef3   = pcKernel->aaiCoefPair[aiClass[3]];
+  Int         iNumPairs = pcKernel->iNumPairs;
+  
+  // after the in-lane unpack the low half holds outputs 0-3 and 8-11, the high half outputs 4-7 and 12-15
+  __m256i vLo = xSet2( pcKernel->aiDC[aiClass[0]], pcKernel->aiDC[aiClass[2]] );
+  __m256i vHi = xSet2( pcKernel->aiDC[aiClass[1]], pcKernel->aiDC[aiClass[3]] );
+  Int k = 0;
+  for ( ; k + 1 < iNumPairs; k += 2 )
+  {
+    __m256i vT0 = xPairSum16( piSrc, piOffset[k    ] );
+    __m256i vT1 = xPairSum16( piSrc, piOffset[k + 1] );
+    vLo = _mm256_add_epi32( vLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( vT0, vT1 ), xSet2( piCoef0[k >> 1], piCoef2[k >> 1] ) ) );
+    vHi = _mm256_add_epi32( vHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( vT0, vT1 ), xSet2( piCoef1[k >> 1], piCoef3[k >> 1] ) ) );
+  }
+  __m256i vCentre = _mm256_loadu_si256( (const __m256i*)piSrc );
+  __m256i vT0     = k < iNumPairs ? xPairSum16( piSrc, piOffset[k] ) : vCentre;
+  __m256i vT1     = k < iNumPairs ? vCentre : _mm256_setzero_si256();
+  vLo = _mm256_add_epi32( vLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( vT0, vT1 ), xSet2( piCoef0[k >> 1], piCoef2[k >> 1] ) ) );
+  vHi = _mm256_add_epi32( vHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( vT0, vT1 ), xSet2( piCoef1[k >> 1], piCoef3[k >> 1] ) ) );
+  vLo = _mm256_sra_epi32( vLo, vShift );
+  vHi = _mm256_sra_epi32( vHi, vShift );
+  return _mm256_min_epi16( _mm256_max_epi16( _mm256_packs_epi32( vLo, vHi ), _mm256_setzero_si256() ), vMax );
+}
+
+#if MTK_SAO
+// --------------------------------------------------------------------------------------------------------------------
+// SAO
+// --------------------------------------------------------------------------------------------------------------------
+
+// the offsets are looked up with byte shuffles, lane i of a table holds offset i as a 16-bit entry
+
+/// window of the samples an edge class changes and the distance of their neighbours, false for the band classes
+static Bool xSaoWindow( Int iType, Int iWidth, Int iHeight, Int iStride, Int& riStartX, Int& riEndX, Int& riStartY, Int& riEndY, Int& riOffset )
+{
+  riStartX = 1;
+  riEndX   = iWidth - 1;
+  riStartY = 1;
+  riEndY   = iHeight - 1;
+  switch ( iType )
+  {
+    case SAO_EO_0: riStartY = 0; riEndY = iHeight; riOffset = 1;           return true;
+    case SAO_EO_1: riStartX = 0; riEndX = iWidth;  riOffset = iStride;     return true;
+    case SAO_EO_2:                                 riOffset = iStride + 1; return true;
+    case SAO_EO_3:                                 riOffset = iStride - 1; return true;
+    default:                                                               return false;
+  }
+}
+
+static inline Int xSaoSign( Int iDiff )
+{
+  return ( iDiff > 0 ) - ( iDiff < 0 );
+}
+
+/// edge offset of one position, for windows narrower than a vector
+static inline Pel xSaoEdge1( const Pel* piSrc, Int iOffset, const SAOOffsetTable* pcTable )
+{
+  Int iEdgeType = xSaoSign( piSrc[0] - piSrc[-iOffset] ) + xSaoSign( piSrc[0] - piSrc[iOffset] ) + 2;
+  return (Pel)Clip3( 0, pcTable->iMaxVal, piSrc[0] + pcTable->aiOffsetEo[iEdgeType] );
+}
+
+/// band offset of one position, for blocks narrower than a vector
+static inline Pel xSaoBand1( const Pel* piSrc, const SAOOffsetTable* pcTable )
+{
+  return (Pel)Clip3( 0, pcTable->iMaxVal, piSrc[0] + pcTable->aiOffsetBo[piSrc[0] >> pcTable->iBandShift] );
+}
+
+/// second column of the 135 degree class below the second row, see TComSampleAdaptiveOffset::xFilterLcu()
+static Void xSaoFixEo2( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight, const SAOOffsetTable* pcTable )
+{
+  if ( iWidth <= 2 )
+  {
+    return;
+  }
+  for ( Int y = 2; y < iHeight - 1; y++ )
+  {
+    const Pel* piSrcY    = piSrc + y * iSrcStride;
+    Int        iEdgeType = xSaoSign( piSrcY[0] - piSrcY[-iSrcStride] ) + xSaoSign( piSrcY[1] - piSrcY[iSrcStride + 2] ) + 2;
+    piDst[y * iDstStride + 1] = (Pel)Clip3( 0, pcTable->iMaxVal, piSrcY[1] + pcTable->aiOffsetEo[iEdgeType] );
+  }
+}
+
+/// shuffle control selecting entry vIdx + iBias of a table of 16-bit entries in each 16-bit lane
+TARGET_SSE41 static SIMD_INLINE __m128i xSaoShuffleIdx( __m128i vIdx, Int iBias )
+{
+  return _mm_add_epi16( _mm_mullo_epi16( vIdx, _mm_set1_epi16( 0x0202 ) ), _mm_set1_epi16( (Short)( 0x0100 + iBias * 0x0202 ) ) );
+}
+
+/// edge offsets of eight adjacent positions, their neighbours are iOffset before and after them
+TARGET_SSE41 static SIMD_INLINE __m128i xSaoEdge8( const Pel* piSrc, Int iOffset, __m128i vTable, __m128i vMax )
+{
+  __m128i vC    = _mm_loadu_si128( (const __m128i*)piSrc );
+  __m128i vA    = _mm_loadu_si128( (const __m128i*)( piSrc - iOffset ) );
+  __m128i vB    = _mm_loadu_si128( (const __m128i*)( piSrc + iOffset ) );
+  // sign(c-a) + sign(c-b) from the all-ones masks of the compares
+  __m128i vSign = _mm_sub_epi16( _mm_add_epi16( _mm_cmpgt_epi16( vA, vC ), _mm_cmpgt_epi16( vB, vC ) ),
+                                 _mm_add_epi16( _mm_cmpgt_epi16( vC, vA ), _mm_cmpgt_epi16( vC, vB ) ) );
+  __m128i vOut  = _mm_add_epi16( vC, _mm_shuffle_epi8( vTable, xSaoShuffleIdx( vSign, 2 ) ) );
+  return _mm_min_epi16( _mm_max_epi16( vOut, _mm_setzero_si128() ), vMax );
+}
+
+/// band offsets of eight adjacent positions, avTable holds the offsets of eight bands each
+TARGET_SSE41 static SIMD_INLINE __m128i xSaoBand8( const Pel* piSrc, const __m128i* avTable, __m128i vShift, __m128i vMax )
+{
+  __m128i vC     = _mm_loadu_si128( (const __m128i*)piSrc );
+  __m128i vBand  = _mm_srl_epi16( vC, vShift );
+  __m128i vIdx   = xSaoShuffleIdx( _mm_and_si128( vBand, _mm_set1_epi16( 7 ) ), 0 );
+  __m128i vGroup = _mm_srli_epi16( vBand, 3 );
+  __m128i vOff   = _mm_setzero_si128();
+  for ( Int k = 0; k < LUMA_GROUP_NUM / 8; k++ )
+  {
+    vOff = _mm_or_si128( vOff, _mm_and_si128( _mm_cmpeq_epi16( vGroup, _mm_set1_epi16( (Short)k ) ), _mm_shuffle_epi8( avTable[k], vIdx ) ) );
+  }
+  vC = _mm_add_epi16( vC, vOff );
+  return _mm_min_epi16( _mm_max_epi16( vC, _mm_setzero_si128() ), vMax );
+}
+
+/// edge offset table of xSaoEdge8()
+TARGET_SSE41 static SIMD_INLINE __m128i xSaoEdgeTable( const SAOOffsetTable* pcTable )
+{
+  const Int* piOffset = pcTable->aiOffsetEo;
+  return _mm_setr_epi16( (Short)piOffset[0], (Short)piOffset[1], (Short)piOffset[2], (Short)piOffset[3], (Short)piOffset[4], 0, 0, 0 );
+}
+
+/// band offset tables of xSaoBand8()
+TARGET_SSE41 static SIMD_INLINE Void xSaoBandTable( const SAOOffsetTable* pcTable, __m128i* avTable )
+{
+  for ( Int k = 0; k < LUMA_GROUP_NUM / 8; k++ )
+  {
+    const Int* piOffset = pcTable->aiOffsetBo + 8 * k;
+    avTable[k] = _mm_setr_epi16( (Short)piOffset[0], (Short)piOffset[1], (Short)piOffset[2], (Short)piOffset[3],
+                                 (Short)piOffset[4], (Short)piOffset[5], (Short)piOffset[6], (Short)piOffset[7] );
+  }
+}
+
+/// edge offsets of sixteen adjacent positions, vTable holds the table of xSaoEdge8() in both lanes
+TARGET_AVX2 static SIMD_INLINE __m256i xSaoEdge16( const Pel* piSrc, Int iOffset, __m256i vTable, __m256i vMax )
+{
+  __m256i vC    = _mm256_loadu_si256( (const __m256i*)piSrc );
+  __m256i vA    = _mm256_loadu_si256( (const __m256i*)( piSrc - iOffset ) );
+  __m256i vB    = _mm256_loadu_si256( (const __m256i*)( piSrc + iOffset ) );
+  __m256i vSign = _mm256_sub_epi16( _mm256_add_epi16( _mm256_cmpgt_epi16( vA, vC ), _mm256_cmpgt_epi16( vB, vC ) ),
+                                    _mm256_add_epi16( _mm256_cmpgt_epi16( vC, vA ), _mm256_cmpgt_epi16( vC, vB ) ) );
+  __m256i vIdx  = _mm256_add_epi16( _mm256_mullo_epi16( vSign, _mm256_set1_epi16( 0x0202 ) ), _mm256_set1_epi16( 0x0504 ) );
+  __m256i vOut  = _mm256_add_epi16( vC, _mm256_shuffle_epi8( vTable, vIdx ) );
+  return _mm256_min_epi16( _mm256_max_epi16( vOut, _mm256_setzero_si256() ), vMax );
+}
+
+/// band offsets of sixteen adjacent positions, avTable holds the tables of xSaoBand8() in both lanes
+TARGET_AVX2 static SIMD_INLINE __m256i xSaoBand16( const Pel* piSrc, const __m256i* avTable, __m128i vShift, __m256i vMax )
+{
+  __m256i vC     = _mm256_loadu_si256( (const __m256i*)piSrc );
+  __m256i vBand  = _mm256_srl_epi16( vC, vShift );
+  __m256i vIdx   = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_and_si256( vBand, _mm256_set1_epi16( 7 ) ), _mm256_set1_epi16( 0x0202 ) ),
+                                     _mm256_set1_epi16( 0x0100 ) );
+  __m256i vGroup = _mm256_srli_epi16( vBand, 3 );
+  __m256i vOff   = _mm256_setzero_si256();
+  for ( Int k = 0; k < LUMA_GROUP_NUM / 8; k++ )
+  {
+    vOff = _mm256_or_si256( vOff, _mm256_and_si256( _mm256_cmpeq_epi16( vGroup, _mm256_set1_epi16( (Short)k ) ), _mm256_shuffle_epi8( avTable[k], vIdx ) ) );
+  }
+  vC = _mm256_add_epi16( vC, vOff );
+  return _mm256_min_epi16( _mm256_max_epi16( vC, _mm256_setzero_si256() ), vMax );
+}
+#endif // MTK_SAO
+
+#endif // ALF_SIMD
+
+// ====================================================================================================================
+// Kernels
+// ====================================================================================================================
+
+// iWidth is a multiple of 4 and, if ppiClass is given, iClassX as well, so each group of four outputs has one class
+
+#if ALF_SIMD
+
+TARGET_SSE41 Void TComAdaptiveLoopFilterSIMD::xFilter_SSE41( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                                             const ALFFilterKernel* pcKernel, imgpel** ppiClass, Int iClassX, Int iClassY )
+{
+  __m128i vShift = _mm_cvtsi32_si128( pcKernel->iShift );
+  __m128i vMax   = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    const imgpel* piClass = ppiClass ? ppiClass[( iClassY + y ) >> 2] + ( iClassX >> 2 ) : NULL;
+    Int x = 0;
+    for ( ; x + 8 <= iWidth; x += 8 )
+    {
+      Int iClass0 = piClass ? piClass[( x >> 2 )    ] : 0;
+      Int iClass1 = piClass ? piClass[( x >> 2 ) + 1] : 0;
+      _mm_storeu_si128( (__m128i*)&piDst[x], xFilter8<false>( piSrc + x, pcKernel, iClass0, iClass1, vShift, vMax ) );
+    }
+    if ( x < iWidth )
+    {
+      Int iClass0 = piClass ? piClass[x >> 2] : 0;
+      _mm_storel_epi64( (__m128i*)&piDst[x], xFilter8<true>( piSrc + x, pcKernel, iClass0, iClass0, vShift, vMax ) );
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+TARGET_AVX2 Void TComAdaptiveLoopFilterSIMD::xFilter_AVX2( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                                           const ALFFilterKernel* pcKernel, imgpel** ppiClass, Int iClassX, Int iClassY )
+{
+  __m128i vShift    = _mm_cvtsi32_si128( pcKernel->iShift );
+  __m128i vMax      = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  __m256i vMax256   = _mm256_set1_epi16( (Short)g_uiIBDI_MAX );
+  Int     aiClass[4] = { 0, 0, 0, 0 };
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    const imgpel* piClass = ppiClass ? ppiClass[( iClassY + y ) >> 2] + ( iClassX >> 2 ) : NULL;
+    Int x = 0;
+    for ( ; x + 16 <= iWidth; x += 16 )
+    {
+      if ( piClass )
+      {
+        for ( Int i = 0; i < 4; i++ )
+        {
+          aiClass[i] = piClass[( x >> 2 ) + i];
+        }
+      }
+      _mm256_storeu_si256( (__m256i*)&piDst[x], xFilter16( piSrc + x, pcKernel, aiClass, vShift, vMax256 ) );
+    }
+    if ( x + 8 <= iWidth )
+    {
+      Int iClass0 = piClass ? piClass[( x >> 2 )    ] : 0;
+      Int iClass1 = piClass ? piClass[( x >> 2 ) + 1] : 0;
+      _mm_storeu_si128( (__m128i*)&piDst[x], xFilter8<false>( piSrc + x, pcKernel, iClass0, iClass1, vShift, vMax ) );
+      x += 8;
+    }
+    if ( x < iWidth )
+    {
+      Int iClass0 = piClass ? piClass[x >> 2] : 0;
+      _mm_storel_epi64( (__m128i*)&piDst[x], xFilter8<true>( piSrc + x, pcKernel, iClass0, iClass0, vShift, vMax ) );
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+#if MTK_SAO
+// piSrc and piDst do not overlap, so the last vector of a row may overlap the one before it instead of a scalar tail
+
+TARGET_SSE41 Void TComAdaptiveLoopFilterSIMD::xSao_SSE41( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                                          const SAOOffsetTable* pcTable )
+{
+  __m128i vMax = _mm_set1_epi16( (Short)pcTable->iMaxVal );
+  Int iStartX, iEndX, iStartY, iEndY, iOffset;
+  Int x, y;
+  
+  if ( !xSaoWindow( pcTable->iType, iWidth, iHeight, iSrcStride, iStartX, iEndX, iStartY, iEndY, iOffset ) )
+  {
+    __m128i avTable[LUMA_GROUP_NUM / 8];
+    __m128i vShift = _mm_cvtsi32_si128( pcTable->iBandShift );
+    xSaoBandTable( pcTable, avTable );
+    for ( y = 0; y < iHeight; y++ )
+    {
+      if ( iWidth < 8 )
+      {
+        for ( x = 0; x < iWidth; x++ )
+        {
+          piDst[x] = xSaoBand1( piSrc + x, pcTable );
+        }
+      }
+      else
+      {
+        for ( x = 0; x < iWidth; x += 8 )
+        {
+          Int iPos = min( x, iWidth - 8 );
+          _mm_storeu_si128( (__m128i*)&piDst[iPos], xSaoBand8( piSrc + iPos, avTable, vShift, vMax ) );
+        }
+      }
+      piSrc += iSrcStride;
+      piDst += iDstStride;
+    }
+    return;
+  }
+  
+  __m128i    vTable   = xSaoEdgeTable( pcTable );
+  const Pel* piSrcRow = piSrc + iStartY * iSrcStride;
+  Pel*       piDstRow = piDst + iStartY * iDstStride;
+  for ( y = iStartY; y < iEndY; y++ )
+  {
+    if ( iEndX - iStartX < 8 )
+    {
+      for ( x = iStartX; x < iEndX; x++ )
+      {
+        piDstRow[x] = xSaoEdge1( piSrcRow + x, iOffset, pcTable );
+      }
+    }
+    else
+    {
+      for ( x = iStartX; x < iEndX; x += 8 )
+      {
+        Int iPos = min( x, iEndX - 8 );
+        _mm_storeu_si128( (__m128i*)&piDstRow[iPos], xSaoEdge8( piSrcRow + iPos, iOffset, vTable, vMax ) );
+      }
+    }
+    piSrcRow += iSrcStride;
+    piDstRow += iDstStride;
+  }
+  if ( pcTable->iType == SAO_EO_2 )
+  {
+    xSaoFixEo2( piSrc, iSrcStride, piDst, iDstStride, iWidth, iHeight, pcTable );
+  }
+}
+
+TARGET_AVX2 Void TComAdaptiveLoopFilterSIMD::xSao_AVX2( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                                        const SAOOffsetTable* pcTable )
+{
+  Int iStartX, iEndX, iStartY, iEndY, iOffset;
+  Int x, y;
+  
+  // blocks narrower than sixteen samples are left to the SSE4.1 kernel
+  if ( iWidth < 18 )
+  {
+    xSao_SSE41( piSrc, iSrcStride, piDst, iDstStride, iWidth, iHeight, pcTable );
+    return;
+  }
+  
+  __m256i vMax = _mm256_set1_epi16( (Short)pcTable->iMaxVal );
+  if ( !xSaoWindow( pcTable->iType, iWidth, iHeight, iSrcStride, iStartX, iEndX, iStartY, iEndY, iOffset ) )
+  {
+    __m128i avTable128[LUMA_GROUP_NUM / 8];
+    __m256i avTable[LUMA_GROUP_NUM / 8];
+    __m128i vShift = _mm_cvtsi32_si128( pcTable->iBandShift );
+    xSaoBandTable( pcTable, avTable128 );
+    for ( Int k = 0; k < LUMA_GROUP_NUM / 8; k++ )
+    {
+      avTable[k] = _mm256_broadcastsi128_si256( avTable128[k] );
+    }
+    for ( y = 0; y < iHeight; y++ )
+    {
+      for ( x = 0; x < iWidth; x += 16 )
+      {
+        Int iPos = min( x, iWidth - 16 );
+        _mm256_storeu_si256( (__m256i*)&piDst[iPos], xSaoBand16( piSrc + iPos, avTable, vShift, vMax ) );
+      }
+      piSrc += iSrcStride;
+      piDst += iDstStride;
+    }
+    return;
+  }
+  
+  __m256i    vTable   = _mm256_broadcastsi128_si256( xSaoEdgeTable( pcTable ) );
+  const Pel* piSrcRow = piSrc + iStartY * iSrcStride;
+  Pel*       piDstRow = piDst + iStartY * iDstStride;
+  for ( y = iStartY; y < iEndY; y++ )
+  {
+    for ( x = iStartX; x < iEndX; x += 16 )
+    {
+      Int iPos = min( x, iEndX - 16 );
+      _mm256_storeu_si256( (__m256i*)&piDstRow[iPos], xSaoEdge16( piSrcRow + iPos, iOffset, vTable, vMax ) );
+    }
+    piSrcRow += iSrcStride;
+    piDstRow += iDstStride;
+  }
+  if ( pcTable->iType == SAO_EO_2 )
+  {
+    xSaoFixEo2( piSrc, iSrcStride, piDst, iDstStride, iWidth, iHeight, pcTable );
+  }
+}
+#endif // MTK_SAO
+
+#endif // ALF_SIMD
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** set the vectorised kernel of the requested level, left unchanged below SIMD_SSE41
+ * \param iLevel  SIMDLevel to use, clamped to what the CPU supports; SIMD_AUTO selects the best one
+ * \returns the level actually in use
+ */
+Int TComAdaptiveLoopFilterSIMD::initFilterFunc( FpALFFilter* pfpFilter, Int iLevel )
+{
+  Int iCPULevel = TComRdCostSIMD::getCPULevel();
+  if ( iLevel < 0 || iLevel > iCPULevel )
+  {
+    iLevel = iCPULevel;
+  }
+  
+#if ALF_SIMD
+  if ( iLevel >= SIMD_SSE41 )
+  {
+    *pfpFilter = xFilter_SSE41;
+  }
+  if ( iLevel >= SIMD_AVX2 )
+  {
+    *pfpFilter = xFilter_AVX2;
+  }
+#endif
+  
+  return iLevel;
+}
+
+#if MTK_SAO
+/** set the vectorised SAO kernel of the requested level, left unchanged below SIMD_SSE41
+ * \param iLevel  SIMDLevel to use, clamped to what the CPU supports; SIMD_AUTO selects the best one
+ * \returns the level actually in use
+ */
+Int TComAdaptiveLoopFilterSIMD::initSaoFunc( FpSAOFilter* pfpFilter, Int iLevel )
+{
+  Int iCPULevel = TComRdCostSIMD::getCPULevel();
+  if ( iLevel < 0 || iLevel > iCPULevel )
+  {
+    iLevel = iCPULevel;
+  }
+  
+#if ALF_SIMD
+  if ( iLevel >= SIMD_SSE41 )
+  {
+    *pfpFilter = xSao_SSE41;
+  }
+  if ( iLevel >= SIMD_AVX2 )
+  {
+    *pfpFilter = xSao_AVX2;
+  }
+#endif
+  
+  return iLevel;
+}
+#endif
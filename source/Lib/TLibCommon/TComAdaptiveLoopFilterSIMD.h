@@ -0,0 +1,74 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComAdaptiveLoopFilterSIMD.h
+    \brief    SSE4.1 / AVX2 adaptive loop filter kernels selected at run time (header)
+*/
+
+#ifndef __TCOMADAPTIVELOOPFILTERSIMD__
+#define __TCOMADAPTIVELOOPFILTERSIMD__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TComAdaptiveLoopFilter.h"
+#include "TComRdCostSIMD.h"
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// vectorised point-symmetric filters, bit-exact with the C filters of TComAdaptiveLoopFilter
+class TComAdaptiveLoopFilterSIMD
+{
+public:
+  static Int  initFilterFunc  ( FpALFFilter* pfpFilter, Int iLevel );
+#if MTK_SAO
+  static Int  initSaoFunc     ( FpSAOFilter* pfpFilter, Int iLevel );
+#endif
+  
+private:
+  static Void xFilter_SSE41   ( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                const ALFFilterKernel* pcKernel, imgpel** ppiClass, Int iClassX, Int iClassY );
+  static Void xFilter_AVX2    ( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                const ALFFilterKernel* pcKernel, imgpel** ppiClass, Int iClassX, Int iClassY );
+#if MTK_SAO
+  static Void xSao_SSE41      ( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                const SAOOffsetTable* pcTable );
+  static Void xSao_AVX2       ( const Pel* piSrc, Int iSrcStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight,
+                                const SAOOffsetTable* pcTable );
+#endif
+};// END CLASS DEFINITION TComAdaptiveLoopFilterSIMD
+
+#endif // __TCOMADAPTIVELOOPFILTERSIMD__
@@ -59,11 +59,21 @@ TComOutputBitstream::~TComOutputBitstream()
 }
 
 TComInputBitstream::TComInputBitstream(vector<uint8_t>* buf)
+{
+  m_fifo = buf->empty() ? NULL : &buf->front();
+  m_fifo_size = unsigned(buf->size());
+  m_fifo_idx = 0;
+  m_cache = 0;
+  m_num_cached_bits = 0;
+}
+
+TComInputBitstream::TComInputBitstream(const uint8_t* buf, unsigned int size)
 {
   m_fifo = buf;
+  m_fifo_size = size;
   m_fifo_idx = 0;
-  m_held_bits = 0;
-  m_num_held_bits = 0;
+  m_cache = 0;
+  m_num_cached_bits = 0;
 }
 
 // ====================================================================================================================
@@ -146,90 +156,44 @@ Void TComOutputBitstream::writeAlignZero()
   m_num_held_bits = 0;
 }
 
-#if LCEC_INTRA_MODE || QC_LCEC_INTER_MODE
-/**
- * read #uiNumberOfBits# from bitstream without updating the bitstream
- * state, storing the result in #ruiBits#.
- *
- * If reading #uiNumberOfBits# would overrun the bitstream buffer,
- * the bitsream is effectively padded with sufficient zero-bits to
- * avoid the overrun.
- */
-Void TComInputBitstream::pseudoRead ( UInt uiNumberOfBits, UInt& ruiBits )
+Void TComInputBitstream::xRefill()
 {
-  unsigned int saved_num_held_bits = m_num_held_bits;
-  unsigned char saved_held_bits = m_held_bits;
-  unsigned int saved_fifo_idx = m_fifo_idx;
-
-  unsigned num_bits_to_read = min(uiNumberOfBits, getNumBitsLeft());
-  read(num_bits_to_read, ruiBits);
-  ruiBits <<= (uiNumberOfBits - num_bits_to_read);
-
-  m_fifo_idx = saved_fifo_idx;
-  m_held_bits = saved_held_bits;
-  m_num_held_bits = saved_num_held_bits;
-}
-#endif
-
+  unsigned num_bytes_left = m_fifo_size - m_fifo_idx;
 
-Void TComInputBitstream::read (UInt uiNumberOfBits, UInt& ruiBits)
-{
-  assert( uiNumberOfBits <= 32 );
-  
-  /* NB, bits are extracted from the MSB of each byte. */
-  unsigned retval = 0;
-  if (uiNumberOfBits <= m_num_held_bits)
+  if (num_bytes_left >= 8)
   {
-    /* n=1, len(H)=7:   -VHH HHHH, shift_down=6, mask=0xfe
-     * n=3, len(H)=7:   -VVV HHHH, shift_down=4, mask=0xf8
-     */
-    retval = m_held_bits >> (m_num_held_bits - uiNumberOfBits);
-    retval &= ~(0xff << uiNumberOfBits);
-    m_num_held_bits -= uiNumberOfBits;
-    ruiBits = retval;
+    /* one unaligned big-endian load of 8 bytes, of which the whole bytes
+     * fitting behind the cached bits are kept */
+    const uint8_t* src = m_fifo + m_fifo_idx;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t word;
+    memcpy(&word, src, 8);
+    word = __builtin_bswap64(word);
+#else
+    uint64_t word = 0;
+    for (int i = 0; i < 8; i++)
+    {
+      word = (word << 8) | src[i];
+    }
+#endif
+    unsigned num_bytes = (64 - m_num_cached_bits) >> 3;
+    m_cache |= word >> m_num_cached_bits;
+    m_fifo_idx += num_bytes;
+    m_num_cached_bits += num_bytes << 3;
+    if (m_num_cached_bits < 64)
+    {
+      m_cache &= ~uint64_t(0) << (64 - m_num_cached_bits);
+    }
     return;
   }
 
-  /* all num_held_bits will go into retval
-   *   => need to mask leftover bits from previous extractions
-   *   => align retval with top of extracted word */
-  /* n=5, len(H)=3: ---- -VVV, mask=0x07, shift_up=5-3=2,
-   * n=9, len(H)=3: ---- -VVV, mask=0x07, shift_up=9-3=6 */
-  uiNumberOfBits -= m_num_held_bits;
-  retval = m_held_bits & ~(0xff << m_num_held_bits);
-  retval <<= uiNumberOfBits;
-
-  /* number of whole bytes that need to be loaded to form retval */
-  /* n=32, len(H)=0, load 4bytes, shift_down=0
-   * n=32, len(H)=1, load 4bytes, shift_down=1
-   * n=31, len(H)=1, load 4bytes, shift_down=1+1
-   * n=8,  len(H)=0, load 1byte,  shift_down=0
-   * n=8,  len(H)=3, load 1byte,  shift_down=3
-   * n=5,  len(H)=1, load 1byte,  shift_down=1+3
-   */
-  unsigned aligned_word = 0;
-  unsigned num_bytes_to_load = (uiNumberOfBits - 1) >> 3;
-  assert(m_fifo_idx + num_bytes_to_load < m_fifo->size());
-
-  switch (num_bytes_to_load)
+  /* tail of the bytestream */
+  while (num_bytes_left && m_num_cached_bits <= 56)
   {
-  case 3: aligned_word  = (*m_fifo)[m_fifo_idx++] << 24;
-  case 2: aligned_word |= (*m_fifo)[m_fifo_idx++] << 16;
-  case 1: aligned_word |= (*m_fifo)[m_fifo_idx++] <<  8;
-  case 0: aligned_word |= (*m_fifo)[m_fifo_idx++];
+    m_cache |= uint64_t(m_fifo[m_fifo_idx++]) << (56 - m_num_cached_bits);
+    m_num_cached_bits += 8;
+    num_bytes_left--;
   }
-
-  /* resolve remainder bits */
-  unsigned next_num_held_bits = (32 - uiNumberOfBits) % 8;
-
-  /* copy required part of aligned_word into retval */
-  retval |= aligned_word >> next_num_held_bits;
-
-  /* store held bits */
-  m_num_held_bits = next_num_held_bits;
-  m_held_bits = aligned_word;
-
-  ruiBits = retval;
 }
 
 /**
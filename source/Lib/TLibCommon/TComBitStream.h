@@ -151,16 +151,24 @@ public:
 /**
  * Model of an input bitstream that extracts bits from a predefined
  * bytestream.
+ *
+ * Bits are read through a 64-bit cache that is refilled with whole
+ * bytes, eight at a time with a single big-endian word load where the
+ * bytestream allows it.
  */
 class TComInputBitstream
 {
-  std::vector<uint8_t> *m_fifo; /// FIFO for storage of complete bytes
+  const uint8_t* m_fifo; /// storage of complete bytes
+  unsigned int m_fifo_size;
 
 protected:
-  unsigned int m_fifo_idx; /// Read index into m_fifo
+  unsigned int m_fifo_idx; /// Read index into m_fifo, next byte to load into the cache
+
+  uint64_t m_cache; /// bits loaded and not read yet, msb-aligned, zero below them
+  unsigned int m_num_cached_bits;
 
-  unsigned int m_num_held_bits;
-  unsigned char m_held_bits;
+  /** load whole bytes into the cache until it holds more than 56 bits or the bytestream is exhausted */
+  Void        xRefill         ();
 
 public:
   /**
@@ -170,19 +178,53 @@ public:
    */
   TComInputBitstream(std::vector<uint8_t>* buf);
 
+  /**
+   * Create a new bitstream reader object that reads the #size# bytes at
+   * #buf#, which remain owned by the callee.
+   */
+  TComInputBitstream(const uint8_t* buf, unsigned int size);
+
   // interface for decoding
 #if LCEC_INTRA_MODE || QC_LCEC_INTER_MODE
-  Void        pseudoRead      ( UInt uiNumberOfBits, UInt& ruiBits );
+  Void        pseudoRead      ( UInt uiNumberOfBits, UInt& ruiBits ) { ruiBits = peekBits( uiNumberOfBits ); }
 #endif
-  Void        read            ( UInt uiNumberOfBits, UInt& ruiBits );
+  Void        read            ( UInt uiNumberOfBits, UInt& ruiBits )
+  {
+    assert( uiNumberOfBits <= 32 );
+    if( uiNumberOfBits > m_num_cached_bits )
+    {
+      xRefill();
+      assert( uiNumberOfBits <= m_num_cached_bits );
+    }
+    ruiBits = uiNumberOfBits ? UInt( m_cache >> ( 64 - uiNumberOfBits ) ) : 0;
+    m_cache <<= uiNumberOfBits;
+    m_num_cached_bits -= uiNumberOfBits;
+  }
 
-  // Peek at bits in word-storage. Used in determining if we have completed reading of current bitstream and therefore slice in LCEC.
-  UInt        peekBits (UInt uiBits) { unsigned tmp; pseudoRead(uiBits, tmp); return tmp; }
+  /**
+   * Peek at the next #uiBits# bits without reading them. Beyond the end of
+   * the bytestream, the bitstream is effectively padded with zero-bits.
+   * Used in determining if we have completed reading of current bitstream and therefore slice in LCEC.
+   */
+  UInt        peekBits        ( UInt uiBits )
+  {
+    assert( uiBits <= 32 );
+    if( uiBits > m_num_cached_bits )
+    {
+      xRefill();
+    }
+    return uiBits ? UInt( m_cache >> ( 64 - uiBits ) ) : 0;
+  }
+
+  /** skip #uiBits# bits, at most 32 */
+  Void        skipBits        ( UInt uiBits ) { UInt uiDummy; read( uiBits, uiDummy ); }
 
   // utility functions
   unsigned read(unsigned numberOfBits) { UInt tmp; read(numberOfBits, tmp); return tmp; }
-  unsigned getNumBitsUntilByteAligned() { return m_num_held_bits & (0x7); }
-  unsigned getNumBitsLeft() { return 8*((unsigned)m_fifo->size() - m_fifo_idx) + m_num_held_bits; }
+  /** read the next byte of a byte-aligned bitstream */
+  UInt        readByte() { assert( ( m_num_cached_bits & 0x7 ) == 0 ); return read( 8 ); }
+  unsigned getNumBitsUntilByteAligned() { return m_num_cached_bits & (0x7); }
+  unsigned getNumBitsLeft() { return 8*(m_fifo_size - m_fifo_idx) + m_num_cached_bits; }
 };
 
 #endif
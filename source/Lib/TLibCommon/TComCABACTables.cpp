@@ -105,3 +105,16 @@ const UChar TComCABACTables::sm_aucLPSTable[64][4] =
   {   2,   2,   2,   2}
 };
 
+/// renormalisation shift of an LPS range, indexed by the LPS range >> 3
+const UChar TComCABACTables::sm_aucRenormTable[32] =
+{
+  6,  5,  4,  4,
+  3,  3,  3,  3,
+  2,  2,  2,  2,
+  2,  2,  2,  2,
+  1,  1,  1,  1,
+  1,  1,  1,  1,
+  1,  1,  1,  1,
+  1,  1,  1,  1
+};
+
@@ -48,6 +48,7 @@ class TComCABACTables
 {
 public:
   const static UChar  sm_aucLPSTable[64][4];
+  const static UChar  sm_aucRenormTable[32];
 };
 
 
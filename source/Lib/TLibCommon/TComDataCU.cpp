@@ -69,6 +69,11 @@ TComDataCU::TComDataCU()
   m_puhCbf[0]          = NULL;
   m_puhCbf[1]          = NULL;
   m_puhCbf[2]          = NULL;
+  for( UInt ui = 0; ui < 3; ui++ )
+  {
+    m_puhNzRows[ui]    = NULL;
+    m_puhNzCols[ui]    = NULL;
+  }
   m_pcTrCoeffY         = NULL;
   m_pcTrCoeffCb        = NULL;
   m_pcTrCoeffCr        = NULL;
@@ -143,6 +148,11 @@ Void TComDataCU::create(UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool b
     m_puhCbf[0]          = (UChar* )xMalloc(UChar,  uiNumPartition);
     m_puhCbf[1]          = (UChar* )xMalloc(UChar,  uiNumPartition);
     m_puhCbf[2]          = (UChar* )xMalloc(UChar,  uiNumPartition);
+    for( UInt ui = 0; ui < 3; ui++ )
+    {
+      m_puhNzRows[ui]    = (UChar* )xMalloc(UChar,  uiNumPartition);
+      m_puhNzCols[ui]    = (UChar* )xMalloc(UChar,  uiNumPartition);
+    }
     
     m_apiMVPIdx[0]       = (Int*   )xMalloc(Int,  uiNumPartition);
     m_apiMVPIdx[1]       = (Int*   )xMalloc(Int,  uiNumPartition);
@@ -207,6 +217,11 @@ Void TComDataCU::destroy()
     if ( m_puhCbf[0]          ) { xFree(m_puhCbf[0]);           m_puhCbf[0]         = NULL; }
     if ( m_puhCbf[1]          ) { xFree(m_puhCbf[1]);           m_puhCbf[1]         = NULL; }
     if ( m_puhCbf[2]          ) { xFree(m_puhCbf[2]);           m_puhCbf[2]         = NULL; }
+    for( UInt ui = 0; ui < 3; ui++ )
+    {
+      if ( m_puhNzRows[ui]    ) { xFree(m_puhNzRows[ui]);       m_puhNzRows[ui]     = NULL; }
+      if ( m_puhNzCols[ui]    ) { xFree(m_puhNzCols[ui]);       m_puhNzCols[ui]     = NULL; }
+    }
     if ( m_puiAlfCtrlFlag     ) { xFree(m_puiAlfCtrlFlag);      m_puiAlfCtrlFlag    = NULL; }
     if ( m_puhInterDir        ) { xFree(m_puhInterDir);         m_puhInterDir       = NULL; }
     if ( m_pbMergeFlag        ) { xFree(m_pbMergeFlag);         m_pbMergeFlag       = NULL; }
@@ -298,6 +313,11 @@ Void TComDataCU::initCU( TComPic* pcPic, UInt iCUAddr )
   memset( m_puhCbf[0],          0, iSizeInUchar );
   memset( m_puhCbf[1],          0, iSizeInUchar );
   memset( m_puhCbf[2],          0, iSizeInUchar );
+  for( UInt ui = 0; ui < 3; ui++ )
+  {
+    memset( m_puhNzRows[ui],    0, iSizeInUchar );
+    memset( m_puhNzCols[ui],    0, iSizeInUchar );
+  }
   memset( m_puhDepth,           0, iSizeInUchar );
   
   UChar uhWidth  = g_uiMaxCUWidth;
@@ -365,22 +385,29 @@ Void TComDataCU::initCU( TComPic* pcPic, UInt iCUAddr )
     m_pcCUAboveRight = pcPic->getCU( m_uiCUAddr - uiWidthInCU + 1 );
   }
   
+  // the motion of a co-located picture decoded on another thread is read once the LCU row below this one is final
+  const Int iColRows = m_uiCUAddr / uiWidthInCU + 2;
   if ( pcSlice->getNumRefIdx( REF_PIC_LIST_0 ) > 0 )
   {
+    TComPic* pcColPic = pcSlice->getRefPic( REF_PIC_LIST_0, 0 );
+    pcColPic->waitRecRows( pcColPic->getPictureSizeIdx() == pcSlice->getPPS()->getPictureSizeIdx() ? iColRows : MAX_INT );
 #if JCT_ARC
-    if (pcSlice->getPPS()->getPictureSizeIdx() == pcSlice->getRefPic( REF_PIC_LIST_0, 0)->getPictureSizeIdx() ){
-      m_apcCUColocated[0] = pcSlice->getRefPic( REF_PIC_LIST_0, 0)->getCU( m_uiCUAddr );
-    }
-  }
+    // the motion of a reference coded at another rung is resampled to the current one
+    m_apcCUColocated[0] = pcSlice->getRefPic( REF_PIC_LIST_0, 0)->getMotionCU( m_uiCUAddr, pcSlice->getPPS()->getPictureSizeIdx() );
+#else
+    m_apcCUColocated[0] = pcSlice->getRefPic( REF_PIC_LIST_0, 0)->getCU( m_uiCUAddr );
 #endif
+  }
   if ( pcSlice->getNumRefIdx( REF_PIC_LIST_1 ) > 0 )
   {
+    TComPic* pcColPic = pcSlice->getRefPic( REF_PIC_LIST_1, 0 );
+    pcColPic->waitRecRows( pcColPic->getPictureSizeIdx() == pcSlice->getPPS()->getPictureSizeIdx() ? iColRows : MAX_INT );
 #if JCT_ARC
-    if (pcSlice->getPPS()->getPictureSizeIdx() == pcSlice->getRefPic( REF_PIC_LIST_1, 0)->getPictureSizeIdx() ){
-      m_apcCUColocated[1] = pcSlice->getRefPic( REF_PIC_LIST_1, 0)->getCU( m_uiCUAddr );
-    }
-  }
+    m_apcCUColocated[1] = pcSlice->getRefPic( REF_PIC_LIST_1, 0)->getMotionCU( m_uiCUAddr, pcSlice->getPPS()->getPictureSizeIdx() );
+#else
+    m_apcCUColocated[1] = pcSlice->getRefPic( REF_PIC_LIST_1, 0)->getCU( m_uiCUAddr );
 #endif
+  }
 }
 
 // initialize prediction data
@@ -651,6 +678,12 @@ Void TComDataCU::copySubCU( TComDataCU* pcCU, UInt uiAbsPartIdx, UInt uiDepth )
   m_puhCbf[0]= pcCU->getCbf(TEXT_LUMA)            + uiPart;
   m_puhCbf[1]= pcCU->getCbf(TEXT_CHROMA_U)        + uiPart;
   m_puhCbf[2]= pcCU->getCbf(TEXT_CHROMA_V)        + uiPart;
+  m_puhNzRows[0]= pcCU->getNzRows(TEXT_LUMA)      + uiPart;
+  m_puhNzRows[1]= pcCU->getNzRows(TEXT_CHROMA_U)  + uiPart;
+  m_puhNzRows[2]= pcCU->getNzRows(TEXT_CHROMA_V)  + uiPart;
+  m_puhNzCols[0]= pcCU->getNzCols(TEXT_LUMA)      + uiPart;
+  m_puhNzCols[1]= pcCU->getNzCols(TEXT_CHROMA_U)  + uiPart;
+  m_puhNzCols[2]= pcCU->getNzCols(TEXT_CHROMA_V)  + uiPart;
   
   m_puhDepth=pcCU->getDepth()                     + uiPart;
   m_puhWidth=pcCU->getWidth()                     + uiPart;
@@ -3616,6 +3649,18 @@ Void TComDataCU::clearCbf( UInt uiIdx, TextType eType, UInt uiNumParts )
   ::memset( &m_puhCbf[g_aucConvertTxtTypeToIdx[eType]][uiIdx], 0, sizeof(UChar)*uiNumParts);
 }
 
+/** Record the area holding the non-zero coefficients of a transform unit.
+ * \param uiIdx     partition index of the first partition of the transform unit
+ * \param eType     texture type
+ * \param uiNzRows  number of leading rows holding non-zero coefficients
+ * \param uiNzCols  number of leading columns holding non-zero coefficients
+ */
+Void TComDataCU::setNzArea( UInt uiIdx, TextType eType, UInt uiNzRows, UInt uiNzCols )
+{
+  m_puhNzRows[g_aucConvertTxtTypeToIdx[eType]][uiIdx] = uiNzRows;
+  m_puhNzCols[g_aucConvertTxtTypeToIdx[eType]][uiIdx] = uiNzCols;
+}
+
 #if E057_INTRA_PCM
 /** Set a I_PCM flag for all sub-partitions of a partition.
  * \param bIpcmFlag I_PCM flag
@@ -3886,14 +3931,14 @@ Bool TComDataCU::xGetColMVP( RefPicList eRefPicList, Int uiCUAddr, Int uiPartUni
 
   iCurrPOC = m_pcSlice->getPOC();
   iCurrRefPOC = m_pcSlice->getRefPic(eRefPicList, riRefIdx)->getPOC();
-#if JCT_ARC
-  // No co-located vector if the reference picture is a different size
   RefPicList refList = RefPicList(getSlice()->isInterB() ? getSlice()->getColDir() : 0 );
-  if (m_pcSlice->getRefPic(refList, 0)->getPictureSizeIdx() != m_pcSlice->getPPS()->getPictureSizeIdx() )
-    return false;
-#endif
   TComPic *pColPic = getSlice()->getRefPic( refList, 0);
+#if JCT_ARC
+  // a co-located picture coded at another rung provides its motion resampled to the current one
+  TComDataCU *pColCU = pColPic->getMotionCU( uiCUAddr, m_pcSlice->getPPS()->getPictureSizeIdx() );
+#else
   TComDataCU *pColCU = pColPic->getCU( uiCUAddr );
+#endif
   iColPOC = pColCU->getSlice()->getPOC();  
 
   if (pColCU->isIntra(uiAbsPartAddr))
@@ -4151,6 +4196,88 @@ Void TComDataCU::compressMV()
 }
 #endif 
 
+#if JCT_ARC
+/** Scale one motion vector component by iDst/iSrc, rounding half away from zero.
+ */
+static inline Int xScaleMvComp( Int iMv, Int iDst, Int iSrc )
+{
+  Int iScaled = ( abs( iMv ) * iDst + ( iSrc >> 1 ) ) / iSrc;
+  return iMv < 0 ? -iScaled : iScaled;
+}
+
+/** Initialise this LCU of rung iLevel of pcPic with the motion coded at the current rung of pcPic.
+ * Each partition takes the prediction mode, reference indices and vectors of the coded partition under its centre,
+ * vectors being scaled by the size ratio of the two rungs. The field is compressed like the coded one.
+ * \param pcPic    picture holding the coded motion
+ * \param uiCUAddr LCU address at rung iLevel
+ * \param iLevel   rung the motion is mapped to
+ */
+Void TComDataCU::initScaledMotion( TComPic* pcPic, UInt uiCUAddr, Int iLevel )
+{
+  const Int iSrcLevel  = pcPic->getPictureSizeIdx();
+  const Int iSrcWidth  = pcPic->getWidth ( iSrcLevel );
+  const Int iSrcHeight = pcPic->getHeight( iSrcLevel );
+  const Int iDstWidth  = pcPic->getWidth ( iLevel );
+  const Int iDstHeight = pcPic->getHeight( iLevel );
+  const UInt uiNumPartInWidth = pcPic->getNumPartInWidth( iLevel );
+  const UInt uiMinCUWidth     = g_uiMaxCUWidth  / uiNumPartInWidth;
+  const UInt uiMinCUHeight    = g_uiMaxCUHeight / pcPic->getNumPartInHeight( iLevel );
+  const UInt uiSrcWidthInCU   = pcPic->getFrameWidthInCU( iSrcLevel );
+
+  m_pcPic          = pcPic;
+  m_uiCUAddr       = uiCUAddr;
+  m_uiCUPelX       = ( uiCUAddr % pcPic->getFrameWidthInCU( iLevel ) ) * g_uiMaxCUWidth;
+  m_uiCUPelY       = ( uiCUAddr / pcPic->getFrameWidthInCU( iLevel ) ) * g_uiMaxCUHeight;
+  m_uiAbsIdxInLCU  = 0;
+  m_uiNumPartition = pcPic->getNumPartInCU( iLevel );
+  m_pcSlice        = NULL;
+
+  for ( UInt uiAbsPartIdx = 0; uiAbsPartIdx < m_uiNumPartition; uiAbsPartIdx++ )
+  {
+    UInt uiRaster = g_auiZscanToRaster[uiAbsPartIdx];
+    Int  iDstX    = m_uiCUPelX + ( uiRaster % uiNumPartInWidth ) * uiMinCUWidth  + ( uiMinCUWidth  >> 1 );
+    Int  iDstY    = m_uiCUPelY + ( uiRaster / uiNumPartInWidth ) * uiMinCUHeight + ( uiMinCUHeight >> 1 );
+    if ( iDstX >= iDstWidth || iDstY >= iDstHeight )
+    {
+      m_pePredMode[uiAbsPartIdx] = MODE_INTRA;
+      m_acCUMvField[0].setRefIdx( NOT_VALID, uiAbsPartIdx );
+      m_acCUMvField[1].setRefIdx( NOT_VALID, uiAbsPartIdx );
+      continue;
+    }
+
+    Int iSrcX = min( iSrcWidth  - 1, (Int)( ( 2 * (Int64)iDstX + 1 ) * iSrcWidth  / ( 2 * iDstWidth  ) ) );
+    Int iSrcY = min( iSrcHeight - 1, (Int)( ( 2 * (Int64)iDstY + 1 ) * iSrcHeight / ( 2 * iDstHeight ) ) );
+
+    TComDataCU* pcSrcCU = pcPic->getCU( ( iSrcY / g_uiMaxCUHeight ) * uiSrcWidthInCU + iSrcX / g_uiMaxCUWidth );
+    UInt uiSrcPartIdx   = g_auiRasterToZscan[ ( ( iSrcY % g_uiMaxCUHeight ) / uiMinCUHeight ) * uiNumPartInWidth + ( iSrcX % g_uiMaxCUWidth ) / uiMinCUWidth ];
+
+    // POC and reference POCs do not depend on the rung, the slice of the coded LCU is used as is
+    if ( m_pcSlice == NULL )
+    {
+      m_pcSlice = pcSrcCU->getSlice();
+    }
+
+    m_pePredMode[uiAbsPartIdx] = pcSrcCU->getPredictionMode( uiSrcPartIdx );
+    for ( Int iList = 0; iList < 2; iList++ )
+    {
+      TComCUMvField* pcSrcField = pcSrcCU->getCUMvField( RefPicList( iList ) );
+      TComMv         cMv        = pcSrcField->getMv( uiSrcPartIdx );
+      m_acCUMvField[iList].setRefIdx( pcSrcField->getRefIdx( uiSrcPartIdx ), uiAbsPartIdx );
+      m_acCUMvField[iList].setMv( TComMv( xScaleMvComp( cMv.getHor(), iDstWidth, iSrcWidth ), xScaleMvComp( cMv.getVer(), iDstHeight, iSrcHeight ) ), uiAbsPartIdx );
+    }
+  }
+
+  if ( m_pcSlice == NULL )
+  {
+    // LCU entirely outside of the picture, never read
+    m_pcSlice = pcPic->getSlice( 0 );
+  }
+#if AMVP_BUFFERCOMPRESS
+  compressMV();
+#endif
+}
+#endif
+
 #if QC_MDCS
 UInt TComDataCU::getCoefScanIdx(UInt uiAbsPartIdx, UInt uiWidth, Bool bIsLuma, Bool bIsIntra)
 {
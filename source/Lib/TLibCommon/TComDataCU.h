@@ -90,6 +90,8 @@ private:
   UChar*        m_phQP;               ///< array of QP values
   UChar*        m_puhTrIdx;           ///< array of transform indices
   UChar*        m_puhCbf[3];          ///< array of coded block flags (CBF)
+  UChar*        m_puhNzRows[3];       ///< array of rows holding non-zero coefficients, per transform unit (decoder)
+  UChar*        m_puhNzCols[3];       ///< array of columns holding non-zero coefficients, per transform unit (decoder)
   TComCUMvField m_acCUMvField[2];     ///< array of motion vectors
   TCoeff*       m_pcTrCoeffY;         ///< transformed coefficient buffer (Y)
   TCoeff*       m_pcTrCoeffCb;        ///< transformed coefficient buffer (Cb)
@@ -291,6 +293,11 @@ public:
   UChar         getCbf    ( UInt uiIdx, TextType eType, UInt uiTrDepth )  { return ( ( getCbf( uiIdx, eType ) >> uiTrDepth ) & 0x1 ); }
   Void          setCbf    ( UInt uiIdx, TextType eType, UChar uh )        { m_puhCbf[g_aucConvertTxtTypeToIdx[eType]][uiIdx] = uh;    }
   Void          clearCbf  ( UInt uiIdx, TextType eType, UInt uiNumParts );
+  UChar         getNzRows ( UInt uiIdx, TextType eType )                  { return m_puhNzRows[g_aucConvertTxtTypeToIdx[eType]][uiIdx]; }
+  UChar*        getNzRows ( TextType eType )                              { return m_puhNzRows[g_aucConvertTxtTypeToIdx[eType]];        }
+  UChar         getNzCols ( UInt uiIdx, TextType eType )                  { return m_puhNzCols[g_aucConvertTxtTypeToIdx[eType]][uiIdx]; }
+  UChar*        getNzCols ( TextType eType )                              { return m_puhNzCols[g_aucConvertTxtTypeToIdx[eType]];        }
+  Void          setNzArea ( UInt uiIdx, TextType eType, UInt uiNzRows, UInt uiNzCols );
   UChar         getQtRootCbf          ( UInt uiIdx )                      { return getCbf( uiIdx, TEXT_LUMA, 0 ) || getCbf( uiIdx, TEXT_CHROMA_U, 0 ) || getCbf( uiIdx, TEXT_CHROMA_V, 0 ); }
   
   Void          setCbfSubParts        ( UInt uiCbfY, UInt uiCbfU, UInt uiCbfV, UInt uiAbsPartIdx, UInt uiDepth          );
@@ -393,6 +400,9 @@ public:
 #if AMVP_BUFFERCOMPRESS
   Void          compressMV            ();
 #endif 
+#if JCT_ARC
+  Void          initScaledMotion      ( TComPic* pcPic, UInt uiCUAddr, Int iLevel );
+#endif
   
   // -------------------------------------------------------------------------------------------------------------------
   // utility functions for neighbouring information
@@ -75,9 +75,16 @@ const UChar betatable_8x8[52] =
 // ====================================================================================================================
 
 TComLoopFilter::TComLoopFilter()
-: m_uiNumPartitions( 0 )
+: m_uiMaxCUDepth( 0 )
+, m_uiNumPartitions( 0 )
 {
   m_uiDisableDeblockingFilterIdc = 0;
+#if PARALLEL_MERGED_DEBLK
+  m_pcRowPic       = NULL;
+  m_iMaxRows       = 0;
+  m_iNumRowFilters = 0;
+  m_pcRowFilters   = NULL;
+#endif
   for( UInt uiDir = 0; uiDir < 2; uiDir++ )
   {
     for( UInt uiPlane = 0; uiPlane < 3; uiPlane++ )
@@ -100,11 +107,18 @@ TComLoopFilter::~TComLoopFilter()
 Void TComLoopFilter::setCfg( UInt uiDisableDblkIdc, Int iAlphaOffset, Int iBetaOffset)
 {
   m_uiDisableDeblockingFilterIdc  = uiDisableDblkIdc;
+#if PARALLEL_MERGED_DEBLK
+  for ( Int i = 0; i < m_iNumRowFilters; i++ )
+  {
+    m_pcRowFilters[i].setCfg( uiDisableDblkIdc, iAlphaOffset, iBetaOffset );
+  }
+#endif
 }
 
 Void TComLoopFilter::create( UInt uiMaxCUDepth )
 {
   destroy();
+  m_uiMaxCUDepth    = uiMaxCUDepth;
   m_uiNumPartitions = 1 << ( uiMaxCUDepth<<1 );
   for( UInt uiDir = 0; uiDir < 2; uiDir++ )
   {
@@ -132,52 +146,58 @@ Void TComLoopFilter::destroy()
       }
     }
   }
+#if PARALLEL_MERGED_DEBLK
+  for ( Int i = 0; i < m_iNumRowFilters; i++ )
+  {
+    m_pcRowFilters[i].destroy();
+  }
+  delete [] m_pcRowFilters;
+  m_pcRowFilters   = NULL;
+  m_iNumRowFilters = 0;
+  m_cRows.destroy();
+  m_iMaxRows = 0;
+  m_pcRowPic = NULL;
+#endif
 }
 
 /**
  - call deblocking function for every CU
  .
- \param  pcPic   picture class (TComPic) pointer
+ With PARALLEL_MERGED_DEBLK the picture is processed in LCU row jobs: the vertical edges of a row, then its
+ horizontal edges once the vertical edges of the row above are done. This gives the same result as filtering
+ all vertical edges of the picture first, since the decisions read the samples copied before deblocking.
+ \param  pcPic         picture class (TComPic) pointer
+ \param  pcThreadPool  threads sharing the row jobs, NULL to filter on the calling thread only
  */
-Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
+Void TComLoopFilter::loopFilterPic( TComPic* pcPic, TComThreadPool* pcThreadPool )
 {
   if (m_uiDisableDeblockingFilterIdc == 1)
+  {
+#if PARALLEL_MERGED_DEBLK
+    m_pcRowPic = NULL;
+#endif
     return;
+  }
   
 #if PARALLEL_MERGED_DEBLK
-  pcPic->getPicYuvRec()->copyToPicLuma(pcPic->getPicYuvDeblkBuf());
-
-  // Horizontal filtering
-  for ( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame(); uiCUAddr++ )
+  // the rows not filtered while the picture was decoded, i.e. all of them in the encoder
+  if ( m_pcRowPic != pcPic )
   {
-    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
-
-    for( Int iPlane = 0; iPlane < 3; iPlane++ )
-    {
-      ::memset( m_aapucBS       [EDGE_VER][iPlane], 0, sizeof( UChar ) * m_uiNumPartitions );
-      assert( 0 == false );
-      ::memset( m_aapbEdgeFilter[EDGE_VER][iPlane], 0, sizeof( bool  ) * m_uiNumPartitions );
-    }
-
-    // CU-based deblocking
-    xDeblockCU( pcCU, 0, 0, EDGE_VER );
+    xStartRows( pcPic );
   }
-
-  // Vertical filtering
-  for ( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame(); uiCUAddr++ )
+  m_cRows.stopWaiting( false );
+  m_cRows.setNumAvailable( pcPic->getFrameHeightInCU() );
+  
+  if ( pcThreadPool && pcThreadPool->getNumThreads() > 1 )
   {
-    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
-
-    for( Int iPlane = 0; iPlane < 3; iPlane++ )
-    {
-      ::memset( m_aapucBS       [EDGE_HOR][iPlane], 0, sizeof( UChar ) * m_uiNumPartitions );
-      assert( 0 == false );
-      ::memset( m_aapbEdgeFilter[EDGE_HOR][iPlane], 0, sizeof( bool  ) * m_uiNumPartitions );
-    }
-
-    // CU-based deblocking
-    xDeblockCU( pcCU, 0, 0, EDGE_HOR );
+    xCreateRowFilters( pcThreadPool->getNumThreads() );
+    pcThreadPool->run( this );
   }
+  else
+  {
+    runTask( 0 );
+  }
+  m_pcRowPic = NULL;
 #else
   // for every CU
   for ( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame(); uiCUAddr++ )
@@ -199,11 +219,150 @@ Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
 #endif
 }
 
+#if PARALLEL_MERGED_DEBLK
+/** Start filtering the LCU rows of a picture while it is being decoded.
+ * No row is handed out before setRowsDecoded() is called, loopFilterPic() filters the rows left at the end.
+ * \param pcPic        picture being decoded
+ * \param iNumThreads  number of threads that may call runTask()
+ */
+Void TComLoopFilter::startPicRows( TComPic* pcPic, Int iNumThreads )
+{
+  xStartRows( pcPic );
+  xCreateRowFilters( iNumThreads );
+  m_cRows.setNumAvailable( 0 );
+}
+
+/** Hand out the rows that the decoding of the picture no longer reads.
+ * The intra prediction of a row reads the unfiltered bottom line of the row above, so the last decoded row is
+ * kept back.
+ * \param pcPic     picture being decoded
+ * \param iNumRows  number of LCU rows completely reconstructed
+ */
+Void TComLoopFilter::setRowsDecoded( TComPic* pcPic, Int iNumRows )
+{
+  if ( pcPic == m_pcRowPic )
+  {
+    m_cRows.setNumAvailable( iNumRows-1 );
+  }
+}
+
+Void TComLoopFilter::stopRows( Bool bStop )
+{
+  m_cRows.stopWaiting( bStop );
+}
+
+/** Same as the rows of loopFilterPic() run on a single thread: the vertical edges of the row, then its horizontal
+ * edges. The horizontal edges change the bottom lines of the row above, and the intra prediction of the row below
+ * reads the unfiltered bottom line of this one.
+ * \param pcPic  picture being decoded
+ * \param iRow   LCU row, the rows above being filtered already
+ */
+Void TComLoopFilter::loopFilterRow( TComPic* pcPic, Int iRow )
+{
+  xCopyRowForDecisions( pcPic, iRow );
+  xDeblockRow( pcPic, iRow, EDGE_VER );
+  xDeblockRow( pcPic, iRow, EDGE_HOR );
+}
+
+Void TComLoopFilter::runTask( Int iThreadIdx )
+{
+  TComLoopFilter* pcFilter    = iThreadIdx == 0 ? this : &m_pcRowFilters[iThreadIdx-1];
+  TComPic*        pcPic       = m_pcRowPic;
+  Int             iRow;
+  
+  while ( ( iRow = m_cRows.waitRow() ) >= 0 )
+  {
+    xCopyRowForDecisions( pcPic, iRow );
+    
+    pcFilter->xDeblockRow( pcPic, iRow, EDGE_VER );
+    m_cRows.setProgress( iRow, 1 );
+    
+    // the top edges of the row filter the vertically filtered bottom lines of the row above
+    if ( iRow > 0 )
+    {
+      m_cRows.waitProgress( iRow-1, 1 );
+    }
+    pcFilter->xDeblockRow( pcPic, iRow, EDGE_HOR );
+  }
+}
+#endif
+
 
 // ====================================================================================================================
 // Protected member functions
 // ====================================================================================================================
 
+#if PARALLEL_MERGED_DEBLK
+Void TComLoopFilter::xStartRows( TComPic* pcPic )
+{
+  Int iNumRows = pcPic->getFrameHeightInCU();
+  if ( iNumRows > m_iMaxRows )
+  {
+    m_cRows.create( iNumRows );
+    m_iMaxRows = iNumRows;
+  }
+  m_cRows.init( iNumRows );
+  
+  // allocated on first use, which must not happen in the row threads
+  pcPic->getPicYuvDeblkBuf();
+  m_pcRowPic = pcPic;
+}
+
+/** Make sure there are BS and edge arrays for iNumThreads threads, this object being the ones of thread 0.
+ */
+Void TComLoopFilter::xCreateRowFilters( Int iNumThreads )
+{
+  if ( m_iNumRowFilters >= iNumThreads-1 )
+  {
+    return;
+  }
+  for ( Int i = 0; i < m_iNumRowFilters; i++ )
+  {
+    m_pcRowFilters[i].destroy();
+  }
+  delete [] m_pcRowFilters;
+  
+  m_iNumRowFilters = iNumThreads-1;
+  m_pcRowFilters   = new TComLoopFilter[ m_iNumRowFilters ];
+  for ( Int i = 0; i < m_iNumRowFilters; i++ )
+  {
+    m_pcRowFilters[i].create( m_uiMaxCUDepth );
+    m_pcRowFilters[i].setCfg( m_uiDisableDeblockingFilterIdc, 0, 0 );
+  }
+}
+
+/** The decisions of both directions read the samples before deblocking, kept in the deblocking buffer.
+ */
+Void TComLoopFilter::xCopyRowForDecisions( TComPic* pcPic, Int iRow )
+{
+  TComPicYuv* pcPicYuvRec = pcPic->getPicYuvRec();
+  Int         iPelY       = iRow*g_uiMaxCUHeight;
+  pcPicYuvRec->copyToPicLumaRows( pcPic->getPicYuvDeblkBuf(), iPelY, min( (Int)g_uiMaxCUHeight, pcPicYuvRec->getHeight()-iPelY ) );
+}
+
+/** Filter the edges of one direction in one LCU row.
+ * \param pcPic  picture class
+ * \param iRow   LCU row
+ * \param iDir   EDGE_VER or EDGE_HOR
+ */
+Void TComLoopFilter::xDeblockRow( TComPic* pcPic, Int iRow, Int iDir )
+{
+  const UInt uiWidthInCU = pcPic->getFrameWidthInCU();
+  for ( UInt uiCUAddr = iRow*uiWidthInCU; uiCUAddr < (iRow+1)*uiWidthInCU; uiCUAddr++ )
+  {
+    for( Int iPlane = 0; iPlane < 3; iPlane++ )
+    {
+      ::memset( m_aapucBS       [iDir][iPlane], 0, sizeof( UChar ) * m_uiNumPartitions );
+      ::memset( m_aapbEdgeFilter[iDir][iPlane], 0, sizeof( bool  ) * m_uiNumPartitions );
+    }
+    
+    // CU-based deblocking
+    xDeblockCU( pcPic->getCU( uiCUAddr ), 0, 0, iDir );
+  }
+}
+#endif
+
+
 #if PARALLEL_MERGED_DEBLK
 /**
  - Deblocking filter process in CU-based (the same function as conventional's)
@@ -379,9 +538,12 @@ Void TComLoopFilter::xSetLoopfilterParam( TComDataCU* pcCU, UInt uiAbsZorderIdx
   UInt        uiTempPartIdx;
 #endif
 
-  m_stLFCUParam.bInternalEdge = m_uiDisableDeblockingFilterIdc ? false : true ;
+  // the edges of a CU are filtered according to the slice it belongs to
+  const Bool bDisabled = pcCU->getSlice()->getLoopFilterDisable();
+  
+  m_stLFCUParam.bInternalEdge = bDisabled ? false : true ;
   
-  if ( (uiX == 0) || (m_uiDisableDeblockingFilterIdc == 1) )
+  if ( (uiX == 0) || bDisabled )
     m_stLFCUParam.bLeftEdge = false;
   else
     m_stLFCUParam.bLeftEdge = true;
@@ -396,7 +558,7 @@ Void TComLoopFilter::xSetLoopfilterParam( TComDataCU* pcCU, UInt uiAbsZorderIdx
   }
 #endif
   
-  if ( (uiY == 0 ) || (m_uiDisableDeblockingFilterIdc == 1) )
+  if ( (uiY == 0 ) || bDisabled )
     m_stLFCUParam.bTopEdge = false;
   else
     m_stLFCUParam.bTopEdge = true;
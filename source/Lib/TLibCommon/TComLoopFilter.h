@@ -40,6 +40,7 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#include "TComThreadPool.h"
 
 #define DEBLOCK_SMALLEST_BLOCK  8
 
@@ -49,14 +50,27 @@
 
 /// deblocking filter class
 class TComLoopFilter
+#if PARALLEL_MERGED_DEBLK
+: public TComThreadTask
+#endif
 {
 private:
-  UInt      m_uiDisableDeblockingFilterIdc; ///< deblocking filter idc
+  UInt      m_uiDisableDeblockingFilterIdc; ///< 1: deblocking disabled in every slice of the picture
+  UInt      m_uiMaxCUDepth;
   UInt      m_uiNumPartitions;
   UChar*    m_aapucBS[2][3];              ///< Bs for [Ver/Hor][Y/U/V][Blk_Idx]
   Bool*     m_aapbEdgeFilter[2][3];
   LFCUParam m_stLFCUParam;                  ///< status structure
   
+#if PARALLEL_MERGED_DEBLK
+  // LCU row jobs, the horizontal edges of a row are filtered once the vertical edges of the row above are done
+  TComPic*        m_pcRowPic;               ///< picture whose rows are handed out by m_cRows, NULL if none
+  TComWavefront   m_cRows;                  ///< progress 1 once the vertical edges of a row are filtered
+  Int             m_iMaxRows;
+  Int             m_iNumRowFilters;
+  TComLoopFilter* m_pcRowFilters;           ///< BS and edge arrays of the threads other than the calling one
+#endif
+  
 #if (PARALLEL_DEBLK_DECISION && !PARALLEL_MERGED_DEBLK)
   UInt m_decisions_D     [MAX_CU_SIZE/DEBLOCK_SMALLEST_BLOCK][MAX_CU_SIZE/DEBLOCK_SMALLEST_BLOCK];
   UInt m_decisions_Sample[MAX_CU_SIZE/DEBLOCK_SMALLEST_BLOCK][MAX_CU_SIZE];
@@ -124,6 +138,13 @@ protected:
 #endif
   __inline Int xCalcD( Pel* piSrc, Int iOffset);
   
+#if PARALLEL_MERGED_DEBLK
+  Void xStartRows                 ( TComPic* pcPic );
+  Void xCreateRowFilters          ( Int iNumThreads );
+  Void xDeblockRow                ( TComPic* pcPic, Int iRow, Int iDir );
+  Void xCopyRowForDecisions       ( TComPic* pcPic, Int iRow );
+#endif
+  
 public:
   TComLoopFilter();
   virtual ~TComLoopFilter();
@@ -134,8 +155,21 @@ public:
   /// set configuration
   Void setCfg( UInt uiDisableDblkIdc, Int iAlphaOffset, Int iBetaOffset );
   
-  /// picture-level deblocking filter
-  Void loopFilterPic( TComPic* pcPic );
+  /// picture-level deblocking filter, split into LCU row jobs over the threads of pcThreadPool if given
+  Void loopFilterPic( TComPic* pcPic, TComThreadPool* pcThreadPool = NULL );
+  
+#if PARALLEL_MERGED_DEBLK
+  /// filtering of the LCU rows of a picture while it is decoded, loopFilterPic() completes it
+  Void startPicRows   ( TComPic* pcPic, Int iNumThreads );
+  Void setRowsDecoded ( TComPic* pcPic, Int iNumRows );   ///< iNumRows LCU rows are completely reconstructed
+  Void stopRows       ( Bool bStop );                     ///< make the row threads return instead of waiting
+  
+  /// filter one LCU row on the calling thread, the rows being filtered in order without loopFilterPic()
+  Void loopFilterRow  ( TComPic* pcPic, Int iRow );
+  
+  /// filter the rows handed out for the current picture with the BS and edge arrays of thread iThreadIdx
+  Void runTask        ( Int iThreadIdx );
+#endif
 };
 
 #endif
@@ -48,9 +48,14 @@ m_uiMaxWidth(0),
 m_uiMaxHeight(0),
 m_uiMaxDepth(0)
 {
+  m_iNumPicResolutions = 0;
   m_uiTLayer          = 0;
+  m_uiCurrSliceIdx    = 0;
   for (int i=0; i<NUM_PIC_RESOLUTIONS; ++i){
     m_apcPicSym[i]      = NULL;
+    m_abMotionScaled[i] = false;
+    m_abOrgScaled[i]    = false;
+    m_auiScaledGeneration[i] = 0;
     m_apcPicYuv[i][0]   = NULL;
     m_apcPicYuv[i][1]   = NULL;
     m_pcPicYuvPred[i]   = NULL;
@@ -61,8 +66,10 @@ m_uiMaxDepth(0)
 #endif
   }
 
-  m_bReconstructed    = false;
+  m_bReconstructed.set( false );
+  m_uiRecGeneration   = 1;
   m_iPicSizeIndex = 0;
+  m_iNumRecRows.set( MAX_INT );
 }
 
 TComPic::~TComPic()
@@ -70,27 +77,29 @@ TComPic::~TComPic()
   destroy();
 }
 
-Void TComPic::create( Int iWidth, Int iHeight, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth, Int iPicSizeIndex, Bool bIsVirtual )
+Void TComPic::create( TComSPS* pcSPS, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth, Int iPicSizeIndex, Bool bIsVirtual )
 {
 #if JCT_ARC
   m_iPicSizeIndex = iPicSizeIndex;
+  m_iNumPicResolutions = pcSPS->getNumPicResolutions();
 
-  for (int i=0; i<NUM_PIC_RESOLUTIONS; ++i){
-    m_iWidth[i] = iWidth >> i;
-    m_iHeight[i] = iHeight >> i;
+  // picture sizes of all rungs of the resolution ladder are carried in the SPS
+  for (int i=0; i<m_iNumPicResolutions; ++i){
+    m_iWidth[i] = pcSPS->getPictureWidth(i);
+    m_iHeight[i] = pcSPS->getPictureHeight(i);
   }
   m_uiMaxWidth = uiMaxWidth;
   m_uiMaxHeight = uiMaxHeight;
   m_uiMaxDepth = uiMaxDepth;
 
-  for (int i=0; i<NUM_PIC_RESOLUTIONS; ++i){
+  for (int i=0; i<m_iNumPicResolutions; ++i){
     m_apcPicSym[i]     = new TComPicSym;  m_apcPicSym[i]   ->create( m_iWidth[i], m_iHeight[i], uiMaxWidth, uiMaxHeight, uiMaxDepth );
   }
 #endif
   // Only create the original picture data at level 0 initially : other levels created as needed on the fly
   if (!bIsVirtual)
   {
-    m_apcPicYuv[0][0]  = new TComPicYuv;  m_apcPicYuv[0][0]->create( iWidth, iHeight, uiMaxWidth, uiMaxHeight, uiMaxDepth );
+    m_apcPicYuv[0][0]  = new TComPicYuv;  m_apcPicYuv[0][0]->create( m_iWidth[0], m_iHeight[0], uiMaxWidth, uiMaxHeight, uiMaxDepth );
   }
 
   // Only create the reconstructed picture data at level iPicSizeIndex initially : other  levels created as needed on the fly
@@ -108,32 +117,23 @@ Void TComPic::create( Int iWidth, Int iHeight, UInt uiMaxWidth, UInt uiMaxHeight
 #if JCT_ARC
 Void TComPic::setPictureSizeIdx( Int iPicSizeIndex ){
 
-  if ( iPicSizeIndex!=m_iPicSizeIndex ){
+  // Planes of every rung are kept allocated once used, so that a buffer recycled at another resolution does not pay
+  // for allocation again. The coded rung is about to be (re)written: whatever was resampled from it is stale.
+  if (m_apcPicYuv[iPicSizeIndex][1]==NULL){
     m_apcPicYuv[iPicSizeIndex][1]  = new TComPicYuv;  m_apcPicYuv[iPicSizeIndex][1]->create( m_iWidth[iPicSizeIndex], m_iHeight[iPicSizeIndex], m_uiMaxWidth, m_uiMaxHeight, m_uiMaxDepth );
-    if (m_apcPicYuv[m_iPicSizeIndex][1]!=NULL){
-      m_apcPicYuv[m_iPicSizeIndex][1]->destroy();
-      delete m_apcPicYuv[m_iPicSizeIndex][1];
-      m_apcPicYuv[m_iPicSizeIndex][1]  = NULL;
-    }
-
+  }
+  m_apcPicYuv[iPicSizeIndex][1]->setBorderExtension( false );
 #if PARALLEL_MERGED_DEBLK
+  if (m_pcPicYuvDeblkBuf[iPicSizeIndex]==NULL){
     m_pcPicYuvDeblkBuf[iPicSizeIndex]  = new TComPicYuv;  m_pcPicYuvDeblkBuf[iPicSizeIndex]->create( m_iWidth[iPicSizeIndex], m_iHeight[iPicSizeIndex], m_uiMaxWidth, m_uiMaxHeight, m_uiMaxDepth );
-    if (m_pcPicYuvDeblkBuf[m_iPicSizeIndex]!=NULL){
-      m_pcPicYuvDeblkBuf[m_iPicSizeIndex]->destroy();
-      delete m_pcPicYuvDeblkBuf[m_iPicSizeIndex];
-      m_pcPicYuvDeblkBuf[m_iPicSizeIndex] = NULL;
-    }
-#endif
   }
+#endif
+  m_uiRecGeneration++;
 
-  // Delete all originals except the top-level, which will be over-written anyway.
+  // Originals other than the top-level are resampled from the new input on next use.
   for (int i=0; i<NUM_PIC_RESOLUTIONS; ++i){
-    if (i>0 && m_apcPicYuv[i][0] != NULL){
-      m_apcPicYuv[i][0]->destroy();
-      delete m_apcPicYuv[i][0];
-      m_apcPicYuv[i][0]  = NULL;
-    }
-
+    m_abOrgScaled[i]    = false;
+    m_abMotionScaled[i] = false;
   }
 
   m_iPicSizeIndex = iPicSizeIndex;
@@ -144,40 +144,134 @@ TComPicYuv*   TComPic::getPicYuvOrg(Int i){
 
   if (i==0){
     return m_apcPicYuv[0][0];
-  } else {
-    if ( m_apcPicYuv[i][0]!=NULL ){
-      return m_apcPicYuv[i][0];
-    } else {
-      m_apcPicYuv[i][0]  = new TComPicYuv;  m_apcPicYuv[i][0]->create( m_iWidth[i], m_iHeight[i], m_uiMaxWidth, m_uiMaxHeight, m_uiMaxDepth );
-      downScale( 0, i, m_apcPicYuv[0][0], m_apcPicYuv[i][0] );
-      return m_apcPicYuv[i][0];
-    }
   }
+  if ( m_apcPicYuv[i][0]==NULL ){
+    m_apcPicYuv[i][0]  = new TComPicYuv;  m_apcPicYuv[i][0]->create( m_iWidth[i], m_iHeight[i], m_uiMaxWidth, m_uiMaxHeight, m_uiMaxDepth );
+    m_abOrgScaled[i] = false;
+  }
+  if ( !m_abOrgScaled[i] ){
+    downScale( 0, i, m_apcPicYuv[0][0], m_apcPicYuv[i][0] );
+    m_abOrgScaled[i] = true;
+  }
+  return m_apcPicYuv[i][0];
 
 }
 
+/** Reconstruction of this picture at rung i.
+ * Rungs other than the coded one are resampled from the coded reconstruction into a plane owned by the picture. Once
+ * the picture is reconstructed the result is kept, border-extended, until the reconstruction changes again. Pictures
+ * decoded on several threads may request the same rung at the same time, so the plane is allocated and resampled
+ * under m_cScaleMutex and is handed out once it holds the final reconstruction. Before that the rung is resampled
+ * on every access, which only the thread reconstructing the picture does: the other ones wait for all its LCU rows.
+ */
 TComPicYuv*   TComPic::getPicYuvRec(Int i){
 
-  Bool bScale = !m_bReconstructed;
+  // Scale will only be enforced if requested resolution is not current resolution
+  if (i==m_iPicSizeIndex){
+    return m_apcPicYuv[i][1];
+  }
+
+  m_cScaleMutex.lock();
   if (m_apcPicYuv[i][1]==NULL){
     m_apcPicYuv[i][1]  = new TComPicYuv;  m_apcPicYuv[i][1]->create( m_iWidth[i], m_iHeight[i], m_uiMaxWidth, m_uiMaxHeight, m_uiMaxDepth );
-    bScale = true;
+    m_auiScaledGeneration[i] = 0;
   }
+  if ( !m_bReconstructed.get() || m_auiScaledGeneration[i]!=m_uiRecGeneration ){
+    // always resample from the reconstruction at the coded resolution
+    if (i<m_iPicSizeIndex) {
+      upScale( m_iPicSizeIndex, i, m_apcPicYuv[m_iPicSizeIndex][1], m_apcPicYuv[i][1] );
+    } else {
+      downScale( m_iPicSizeIndex, i, m_apcPicYuv[m_iPicSizeIndex][1], m_apcPicYuv[i][1] );
+    }
+    if (m_bReconstructed.get()){
+      m_apcPicYuv[i][1]->extendPicBorder();
+      m_auiScaledGeneration[i] = m_uiRecGeneration;
+    }
+  }
+  m_cScaleMutex.unlock();
+  return m_apcPicYuv[i][1];
+
+}
+
+/** Mark the reconstruction as complete, or as about to be overwritten.
+ * The quarter-pel planes interpolated from a previous reconstruction are dropped when a new one starts.
+ */
+Void TComPic::setReconMark( Bool b )
+{
+  if ( b )
+  {
+    m_uiRecGeneration++;
+    m_bReconstructed.set( true );
+    return;
+  }
+  m_bReconstructed.set( false );
+  for ( Int i = 0; i < m_iNumPicResolutions; i++ )
+  {
+    if ( m_apcPicYuv[i][1] )
+    {
+      m_apcPicYuv[i][1]->setSubPelValid( false );
+    }
+  }
+}
+
+/** LCU holding the motion of this picture at rung i.
+ * The motion coded at another rung is resampled into the symbol of rung i on first use, and kept until the picture
+ * is coded again.
+ */
+TComDataCU*   TComPic::getMotionCU( UInt uiCUAddr, Int i ){
 
-  // Scale will only be enforced if requested resolution is not current resolution
   if (i!=m_iPicSizeIndex){
-    if (bScale==true){
-      if (i==0) { //scale up
-        assert(m_iPicSizeIndex == 1);
-        upScale( m_iPicSizeIndex, 0, m_apcPicYuv[m_iPicSizeIndex][1], m_apcPicYuv[0][1] );
-      } else {// FIXME assume we're scaling down from 0. Need to support other cases
-        assert(m_iPicSizeIndex==0);
-        downScale( 0, i, m_apcPicYuv[m_iPicSizeIndex][1], m_apcPicYuv[i][1] );
+    m_cScaleMutex.lock();
+    if (!m_abMotionScaled[i]){
+      for (UInt uiAddr=0; uiAddr<m_apcPicSym[i]->getNumberOfCUsInFrame(); ++uiAddr){
+        m_apcPicSym[i]->getCU( uiAddr )->initScaledMotion( this, uiAddr, i );
       }
+      m_abMotionScaled[i] = true;
     }
+    m_cScaleMutex.unlock();
   }
-  return m_apcPicYuv[i][1];
+  return m_apcPicSym[i]->getCU( uiCUAddr );
+
+}
+
+/** Start tracking the LCU rows of the reconstruction as they become final.
+ * A picture decoded while the pictures predicting from it are decoded on other threads is used by them only up to the
+ * rows reported by setRecRows(); waitRecRows() blocks for the others. Pictures that are not tracked are complete.
+ */
+Void TComPic::startRecRows()
+{
+  m_cRecMutex.lock();
+  m_iNumRecRows.set( 0 );
+  m_cRecMutex.unlock();
+}
+
+Void TComPic::setRecRows( Int iNumRows )
+{
+  m_cRecMutex.lock();
+  m_iNumRecRows.set( iNumRows );
+  m_cRecRowsDone.broadcast();
+  m_cRecMutex.unlock();
+}
 
+/** \param iNumRows number of LCU rows from the top that are read, more than the picture has for all of them
+ *
+ * The count only grows while the picture is decoded and is MAX_INT for pictures that are not tracked. It is published
+ * after the rows it covers, so the rows already final are read without taking the lock; only rows still pending wait
+ * on the condition.
+ */
+Void TComPic::waitRecRows( Int iNumRows )
+{
+  iNumRows = min( iNumRows, (Int)getFrameHeightInCU() );
+  if ( m_iNumRecRows.get() >= iNumRows )
+  {
+    return;
+  }
+  m_cRecMutex.lock();
+  while ( m_iNumRecRows.get() < iNumRows )
+  {
+    m_cRecRowsDone.wait( m_cRecMutex );
+  }
+  m_cRecMutex.unlock();
 }
 
 #if PARALLEL_MERGED_DEBLK
@@ -194,24 +288,17 @@ TComPicYuv*  TComPic::getPicYuvDeblkBuf(Int i) {
 }
 #endif
 
-void TComPic::resetRecData(){
+/** Drop the reconstruction ahead of reusing the buffer for another picture.
+ * The planes stay allocated; only their content is invalidated.
+ */
+Void TComPic::resetRecData(){
 
+  m_uiRecGeneration++;
   for (int i=0; i<NUM_PIC_RESOLUTIONS; ++i){
     if (m_apcPicYuv[i][1])
     {
-      m_apcPicYuv[i][1]->destroy();
-      delete m_apcPicYuv[i][1];
-      m_apcPicYuv[i][1]  = NULL;
-    }
-  
-#if PARALLEL_MERGED_DEBLK
-    if (m_pcPicYuvDeblkBuf[i])
-    {
-      m_pcPicYuvDeblkBuf[i]->destroy();
-      delete m_pcPicYuvDeblkBuf[i];
-      m_pcPicYuvDeblkBuf[i]  = NULL;
+      m_apcPicYuv[i][1]->setBorderExtension( false );
     }
-#endif
   }
 }
 
@@ -231,9 +318,23 @@ Void TComPic::destroy()
       delete m_apcPicYuv[i][0];
       m_apcPicYuv[i][0]  = NULL;
     }
-  }
 
-  resetRecData();
+    if (m_apcPicYuv[i][1])
+    {
+      m_apcPicYuv[i][1]->destroy();
+      delete m_apcPicYuv[i][1];
+      m_apcPicYuv[i][1]  = NULL;
+    }
+
+#if PARALLEL_MERGED_DEBLK
+    if (m_pcPicYuvDeblkBuf[i])
+    {
+      m_pcPicYuvDeblkBuf[i]->destroy();
+      delete m_pcPicYuvDeblkBuf[i];
+      m_pcPicYuvDeblkBuf[i]  = NULL;
+    }
+#endif
+  }
 
   if (m_SEIs!=NULL){
     delete m_SEIs;
@@ -252,5 +353,14 @@ Void TComPic::compressMotion()
     pcCU->compressMV();
   }
 }
+
+Void TComPic::compressMotion( Int iRow )
+{
+  TComPicSym* pPicSym = getPicSym();
+  for ( UInt uiCUAddr = iRow*pPicSym->getFrameWidthInCU(); uiCUAddr < (iRow+1)*pPicSym->getFrameWidthInCU(); uiCUAddr++ )
+  {
+    pPicSym->getCU(uiCUAddr)->compressMV();
+  }
+}
 #endif
 
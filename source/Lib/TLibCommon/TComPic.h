@@ -43,6 +43,7 @@
 #include "TComPicSym.h"
 #include "TComPicYuv.h"
 #include "TComBitStream.h"
+#include "TComThreadPool.h"
 
 class SEImessages;
 
@@ -54,6 +55,7 @@ class SEImessages;
 class TComPic
 {
 private:
+  Int                   m_iNumPicResolutions;     //  Number of rungs of the resolution ladder
   Int                   m_iWidth[NUM_PIC_RESOLUTIONS];
   Int                   m_iHeight[NUM_PIC_RESOLUTIONS];
   UInt                  m_uiMaxWidth;
@@ -62,15 +64,23 @@ private:
   UInt                  m_uiTLayer;               //  Temporal layer
 
   TComPicSym*           m_apcPicSym[NUM_PIC_RESOLUTIONS];              //  Symbol
+  Bool                  m_abMotionScaled[NUM_PIC_RESOLUTIONS];         //  Symbol of the rung holds the resampled motion
   TComPicYuv*           m_apcPicYuv[NUM_PIC_RESOLUTIONS][2];           //  Texture,  0:org / 1:rec
+  Bool                  m_abOrgScaled[NUM_PIC_RESOLUTIONS];            //  Original of the rung holds the current input
+  UInt                  m_uiRecGeneration;                             //  Bumped whenever the reconstruction changes
+  UInt                  m_auiScaledGeneration[NUM_PIC_RESOLUTIONS];    //  Generation the rung was resampled from
   TComPicYuv*           m_pcPicYuvPred[NUM_PIC_RESOLUTIONS];           //  Prediction
   TComPicYuv*           m_pcPicYuvResi[NUM_PIC_RESOLUTIONS];           //  Residual
 #if PARALLEL_MERGED_DEBLK
   TComPicYuv*           m_pcPicYuvDeblkBuf[NUM_PIC_RESOLUTIONS];
 #endif
-  Bool                  m_bReconstructed;
+  TComAtomic<Bool>      m_bReconstructed;         //  read without a lock by the threads looking for references
   UInt                  m_uiCurrSliceIdx;         // Index of current slice
   Int                   m_iPicSizeIndex;
+  TComAtomic<Int>       m_iNumRecRows;            //  LCU rows of the reconstruction that are final while it is being decoded
+  TComMutex             m_cRecMutex;
+  TComCondition         m_cRecRowsDone;           //  signalled when m_iNumRecRows grows
+  TComMutex             m_cScaleMutex;            //  guards the resampling of the other rungs
   
   SEImessages* m_SEIs; ///< Any SEI messages that have been received.  If !NULL we own the object.
 
@@ -78,7 +88,7 @@ public:
   TComPic();
   virtual ~TComPic();
   
-  Void          create( Int iWidth, Int iHeight, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth, Int iPicSizeIndex = 0, Bool bIsVirtual = false );
+  Void          create( TComSPS* pcSPS, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth, Int iPicSizeIndex = 0, Bool bIsVirtual = false );
   Void          destroy();
   
   UInt          getTLayer()                { return m_uiTLayer;   }
@@ -86,6 +96,7 @@ public:
 #if JCT_ARC
   Int           getPictureSizeIdx()     { return m_iPicSizeIndex; }
   Void          setPictureSizeIdx(Int i);
+  Int           getNumPicResolutions()  { return m_iNumPicResolutions; }
 #endif
 
   Int           getWidth()            { return m_iWidth[m_iPicSizeIndex]; }
@@ -97,11 +108,14 @@ public:
   TComPicSym*   getPicSym(Int i)      { return  m_apcPicSym[i];    }
   TComSlice*    getSlice(Int s)       { return  m_apcPicSym[m_iPicSizeIndex]->getSlice(s);  }
   TComSlice*    getSlice(Int s, Int i){ return  m_apcPicSym[i]->getSlice(s);  }
-  Int           getPOC()              { return  m_apcPicSym[m_iPicSizeIndex]->getSlice(m_uiCurrSliceIdx)->getPOC();  }
+  Int           getPOC()              { return  m_apcPicSym[m_iPicSizeIndex]->getSlice(0)->getPOC();  }   // shared by all the slices
   Bool          getDRBFlag()          { return  m_apcPicSym[m_iPicSizeIndex]->getSlice(m_uiCurrSliceIdx)->getDRBFlag();  }
   Int           getERBIndex()         { return  m_apcPicSym[m_iPicSizeIndex]->getSlice(m_uiCurrSliceIdx)->getERBIndex();  }
   TComDataCU*&  getCU( UInt uiCUAddr )  { return  m_apcPicSym[m_iPicSizeIndex]->getCU( uiCUAddr ); }
   TComDataCU*&  getCU( UInt uiCUAddr, Int i )  { return  m_apcPicSym[i]->getCU( uiCUAddr ); }
+#if JCT_ARC
+  TComDataCU*   getMotionCU( UInt uiCUAddr, Int i );
+#endif
   
   TComPicYuv*   getPicYuvOrg(Int i);
   TComPicYuv*   getPicYuvOrg()        { return  this->getPicYuvOrg(m_iPicSizeIndex); }
@@ -140,15 +154,21 @@ public:
   Int           getCStride()          { return m_apcPicYuv[m_iPicSizeIndex][1]->getCStride(); }
   Int           getCStride(Int i)     { return m_apcPicYuv[i][1]->getCStride(); }
   
-  Void          setReconMark (Bool b) { m_bReconstructed = b;     }
-  Bool          getReconMark ()       { return m_bReconstructed;  }
+  Void          setReconMark (Bool b);
+  Bool          getReconMark ()       { return m_bReconstructed.get();  }
 
   Void          resetRecData();
 
-  Void          setPOC(Int p)         { for (int i=0; i<NUM_PIC_RESOLUTIONS; ++i) { m_apcPicSym[i]->getSlice(0)->setPOC(p); } }
+  Void          startRecRows ();                  ///< reconstruction is decoded from now on, on another thread than its users
+  Void          setRecRows   ( Int iNumRows );    ///< the first iNumRows LCU rows of the reconstruction are final
+  Void          waitRecRows  ( Int iNumRows );    ///< block until the first iNumRows LCU rows of the reconstruction are final
+  Bool          getRecInProgress ()   { return m_iNumRecRows.get() < (Int)getFrameHeightInCU(); }
+
+  Void          setPOC(Int p)         { for (int i=0; i<m_iNumPicResolutions; ++i) { m_apcPicSym[i]->getSlice(0)->setPOC(p); } }
 
 #if AMVP_BUFFERCOMPRESS
   Void          compressMotion(); 
+  Void          compressMotion( Int iRow );       ///< the LCUs of one row only
 #endif 
   UInt          getCurrSliceIdx()            { return m_uiCurrSliceIdx;                }
   Void          setCurrSliceIdx(UInt i)      { m_uiCurrSliceIdx = i;                   }
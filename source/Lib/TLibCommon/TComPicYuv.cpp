@@ -58,6 +58,12 @@ TComPicYuv::TComPicYuv()
   m_piPicOrgV       = NULL;
   
   m_bIsBorderExtended = false;
+  
+  for ( Int i = 0; i < 16; i++ )
+  {
+    m_apiSubPelBufY[i] = NULL;
+  }
+  m_bSubPelValid      = false;
 }
 
 TComPicYuv::~TComPicYuv()
@@ -107,6 +113,8 @@ Void TComPicYuv::destroy()
   if( m_apiPicBufY ){ xFree( m_apiPicBufY );    m_apiPicBufY = NULL; }
   if( m_apiPicBufU ){ xFree( m_apiPicBufU );    m_apiPicBufU = NULL; }
   if( m_apiPicBufV ){ xFree( m_apiPicBufV );    m_apiPicBufV = NULL; }
+  
+  destroySubPelPlanes();
 }
 
 Void TComPicYuv::createLuma( Int iPicWidth, Int iPicHeight, UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxCUDepth )
@@ -140,6 +148,29 @@ Void TComPicYuv::destroyLuma()
   if( m_apiPicBufY ){ xFree( m_apiPicBufY );    m_apiPicBufY = NULL; }
 }
 
+/** Allocate the quarter-pel luma planes, if not done yet. Their content is undefined until they are marked valid.
+ */
+Void TComPicYuv::createSubPelPlanes()
+{
+  for ( Int i = 1; i < 16; i++ )
+  {
+    if ( m_apiSubPelBufY[i] == NULL )
+    {
+      m_apiSubPelBufY[i] = (Pel*)xMalloc( Pel, getStride() * ( m_iPicHeight + (m_iLumaMarginY<<1) ) );
+    }
+  }
+  m_bSubPelValid = false;
+}
+
+Void TComPicYuv::destroySubPelPlanes()
+{
+  for ( Int i = 1; i < 16; i++ )
+  {
+    if( m_apiSubPelBufY[i] ){ xFree( m_apiSubPelBufY[i] );    m_apiSubPelBufY[i] = NULL; }
+  }
+  m_bSubPelValid = false;
+}
+
 Pel*  TComPicYuv::getLumaAddr( int iCuAddr )
 {
   Int iCuX = iCuAddr % m_iNumCuInWidth;
@@ -229,6 +260,28 @@ Void  TComPicYuv::copyToPicLuma (TComPicYuv*  pcPicYuvDst) const
   return;
 }
 
+Void  TComPicYuv::copyToPicLumaRows (TComPicYuv*  pcPicYuvDst, Int iPelY, Int iHeight) const
+{
+  assert( m_iPicWidth  == pcPicYuvDst->getWidth()  );
+  assert( m_iPicHeight == pcPicYuvDst->getHeight() );
+  
+  Int iStride = getStride();
+  ::memcpy ( pcPicYuvDst->getLumaAddr() + iPelY*iStride, m_piPicOrgY + iPelY*iStride, sizeof (Pel) * iStride * iHeight );
+  return;
+}
+
+/** Copy the luma lines iPelY to iPelY+iHeight-1 and the chroma lines they cover.
+ */
+Void  TComPicYuv::copyToPicRows (TComPicYuv*  pcPicYuvDst, Int iPelY, Int iHeight) const
+{
+  copyToPicLumaRows( pcPicYuvDst, iPelY, iHeight );
+  
+  Int iCStride = getCStride();
+  ::memcpy ( pcPicYuvDst->getCbAddr() + (iPelY>>1)*iCStride, m_piPicOrgU + (iPelY>>1)*iCStride, sizeof (Pel) * iCStride * (iHeight>>1) );
+  ::memcpy ( pcPicYuvDst->getCrAddr() + (iPelY>>1)*iCStride, m_piPicOrgV + (iPelY>>1)*iCStride, sizeof (Pel) * iCStride * (iHeight>>1) );
+  return;
+}
+
 Void  TComPicYuv::copyToPicCb (TComPicYuv*  pcPicYuvDst) const
 {
   assert( m_iPicWidth  == pcPicYuvDst->getWidth()  );
@@ -269,23 +322,41 @@ Void TComPicYuv::getLumaMinMax( Int *pMin, Int *pMax )
   *pMax = iMax;
 }
 
+/** Extend the picture into its margins, once: the margins of a reference are read by the pictures predicting from it
+ * while other threads may ask for the extension again.
+ */
 Void TComPicYuv::extendPicBorder ()
 {
+  if ( m_bIsBorderExtended )
+  {
+    return;
+  }
+  extendPicBorderRows( 0, getHeight() );
+}
+
+/** Extend the lines iPelY to iPelY+iHeight-1 into the left and right margins, and into the top and bottom margins
+ * when they include the first or the last line. The chroma lines they cover are extended the same way, so extending
+ * all the lines in order, e.g. each LCU row once it is final, gives the result of extendPicBorder().
+ */
+Void TComPicYuv::extendPicBorderRows ( Int iPelY, Int iHeight )
+{
+  xExtendPicCompBorder( getLumaAddr(), getStride(),  getWidth(),      getHeight(),      m_iLumaMarginX,   m_iLumaMarginY,   iPelY,      iHeight      );
+  xExtendPicCompBorder( getCbAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY, iPelY >> 1, iHeight >> 1 );
+  xExtendPicCompBorder( getCrAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY, iPelY >> 1, iHeight >> 1 );
   
-  xExtendPicCompBorder( getLumaAddr(), getStride(),  getWidth(),      getHeight(),      m_iLumaMarginX,   m_iLumaMarginY   );
-  xExtendPicCompBorder( getCbAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY );
-  xExtendPicCompBorder( getCrAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY );
-  
-  m_bIsBorderExtended = true;
+  if ( iPelY + iHeight == getHeight() )
+  {
+    m_bIsBorderExtended = true;
+  }
 }
 
-Void TComPicYuv::xExtendPicCompBorder  (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY)
+Void TComPicYuv::xExtendPicCompBorder  (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY, Int iPelY, Int iNumLines)
 {
   Int   x, y;
   Pel*  pi;
   
-  pi = piTxt;
-  for ( y = 0; y < iHeight; y++)
+  pi = piTxt + iPelY * iStride;
+  for ( y = 0; y < iNumLines; y++)
   {
     for ( x = 0; x < iMarginX; x++ )
     {
@@ -295,16 +366,22 @@ Void TComPicYuv::xExtendPicCompBorder  (Pel* piTxt, Int iStride, Int iWidth, Int
     pi += iStride;
   }
   
-  pi -= (iStride + iMarginX);
-  for ( y = 0; y < iMarginY; y++ )
+  if ( iPelY + iNumLines == iHeight )
   {
-    ::memcpy( pi + (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    pi = piTxt + (iHeight-1) * iStride - iMarginX;
+    for ( y = 0; y < iMarginY; y++ )
+    {
+      ::memcpy( pi + (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    }
   }
   
-  pi -= ((iHeight-1) * iStride);
-  for ( y = 0; y < iMarginY; y++ )
+  if ( iPelY == 0 )
   {
-    ::memcpy( pi - (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    pi = piTxt - iMarginX;
+    for ( y = 0; y < iMarginY; y++ )
+    {
+      ::memcpy( pi - (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    }
   }
 }
 
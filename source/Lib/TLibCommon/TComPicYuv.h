@@ -82,8 +82,11 @@ private:
   
   Bool  m_bIsBorderExtended;
   
+  Pel*  m_apiSubPelBufY[16];    ///< Quarter-pel luma planes laid out as m_apiPicBufY, [ fracY * 4 + fracX ], [0] unused
+  Bool  m_bSubPelValid;         ///< Planes hold the interpolation of the current luma
+  
 protected:
-  Void  xExtendPicCompBorder (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY);
+  Void  xExtendPicCompBorder (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY, Int iPelY, Int iNumLines);
   
 public:
   TComPicYuv         ();
@@ -99,6 +102,9 @@ public:
   Void  createLuma  ( Int iPicWidth, Int iPicHeight, UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uhMaxCUDepth );
   Void  destroyLuma ();
   
+  Void  createSubPelPlanes  ();
+  Void  destroySubPelPlanes ();
+  
   // ------------------------------------------------------------------------------------------------
   //  Get information of picture
   // ------------------------------------------------------------------------------------------------
@@ -110,6 +116,7 @@ public:
   Int   getCStride  () const { return (m_iPicWidth >> 1) + (m_iChromaMarginX<<1); }
   
   Int   getLumaMargin   () const { return m_iLumaMarginX;  }
+  Int   getLumaMarginY  () const { return m_iLumaMarginY;  }
   Int   getChromaMargin () const { return m_iChromaMarginX;}
   
   Void  getLumaMinMax( Int* pMin, Int* pMax );
@@ -149,11 +156,14 @@ public:
   //  Copy function to picture
   Void  copyToPic      ( TComPicYuv*  pcPicYuvDst ) const;
   Void  copyToPicLuma   ( TComPicYuv*  pcPicYuvDst ) const;
+  Void  copyToPicLumaRows ( TComPicYuv*  pcPicYuvDst, Int iPelY, Int iHeight ) const;  ///< lines iPelY to iPelY+iHeight-1 only
+  Void  copyToPicRows   ( TComPicYuv*  pcPicYuvDst, Int iPelY, Int iHeight ) const;  ///< same for the three planes
   Void  copyToPicCb     ( TComPicYuv*  pcPicYuvDst ) const;
   Void  copyToPicCr     ( TComPicYuv*  pcPicYuvDst ) const;
   
   //  Extend function of picture buffer
   Void  extendPicBorder      ();
+  Void  extendPicBorderRows  ( Int iPelY, Int iHeight );  ///< margins of the luma lines iPelY to iPelY+iHeight-1 only
   
   //  Dump picture
   Void  dump (char* pFileName, Bool bAdd = false);
@@ -161,6 +171,12 @@ public:
   // Set border extension flag
   Void  setBorderExtension(Bool b) { m_bIsBorderExtended = b; }
   Bool  getIsBorderExtended(){ return m_bIsBorderExtended; }
+  
+  // Quarter-pel planes, see TComPredFilter::interpolateSubPelPlanes()
+  Pel*  getSubPelBufY     ( Int iFrac )                   { return m_apiSubPelBufY[iFrac]; }
+  Pel*  getSubPelLumaAddr ( Int iFrac, Pel* piLumaAddr )  { return iFrac == 0 ? piLumaAddr : m_apiSubPelBufY[iFrac] + ( piLumaAddr - m_apiPicBufY ); }
+  Void  setSubPelValid    ( Bool b )                      { m_bSubPelValid = b;    }
+  Bool  getSubPelValid    ()                              { return m_bSubPelValid; }
 #if FIXED_ROUNDING_FRAME_MEMORY
   Void  xFixedRoundingPic();
 #endif  
@@ -36,6 +36,33 @@
 */
 
 #include "TComPredFilter.h"
+#include "TComPredFilterSIMD.h"
+
+// ====================================================================================================================
+// Tables
+// ====================================================================================================================
+
+/// luma DCT-IF taps of the quarter-pel positions
+static const Short s_aasLumaFilter[4][8] =
+{
+  {  0, 0,   0, 64,  0,   0, 0,  0 },
+  { -1, 4, -10, 57, 19,  -7, 3, -1 },
+  { -1, 4, -11, 40, 40, -11, 4, -1 },
+  { -1, 3,  -7, 19, 57, -10, 4, -1 }
+};
+
+/// chroma DCT-IF taps of the eighth-pel positions
+static const Short s_aasChromaFilter[8][4] =
+{
+  {  0, 64,  0,  0 },
+  { -3, 60,  8, -1 },
+  { -4, 54, 16, -2 },
+  { -5, 46, 27, -4 },
+  { -4, 36, 36, -4 },
+  { -4, 27, 46, -5 },
+  { -2, 16, 54, -4 },
+  { -1,  8, 60, -3 }
+};
 
 // ====================================================================================================================
 // Constructor
@@ -44,5 +71,161 @@
 TComPredFilter::TComPredFilter()
 {
   // initial number of taps for Luma
+  setSIMDLevel( SIMD_AUTO );
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Select the kernels of the generic interpolation filters.
+ * \param iLevel requested SIMDLevel, see TComPredFilterSIMD::initFilterFunc()
+ * \returns level actually used
+ */
+Int TComPredFilter::setSIMDLevel( Int iLevel )
+{
+  m_afpFilterPel   [FILTER_LUMA]   = xFilterPel<8>;
+  m_afpFilterPel   [FILTER_CHROMA] = xFilterPel<4>;
+  m_afpFilterPelInt[FILTER_LUMA]   = xFilterPelInt<8>;
+  m_afpFilterPelInt[FILTER_CHROMA] = xFilterPelInt<4>;
+  m_afpFilterIntPel[FILTER_LUMA]   = xFilterIntPel<8>;
+  m_afpFilterIntPel[FILTER_CHROMA] = xFilterIntPel<4>;
+  
+  return TComPredFilterSIMD::initFilterFunc( m_afpFilterPel, m_afpFilterPelInt, m_afpFilterIntPel, iLevel );
+}
+
+/** Interpolate the 15 quarter-pel luma planes of a reconstructed, border-extended picture.
+ * The samples are the ones the fractional motion search derives around each block, so the search can read them
+ * directly. Only the outermost 4 samples of the margin, which no motion vector reaches, are left undefined.
+ * \param pcPicYuv picture, its planes are allocated on first use and marked valid
+ */
+Void TComPredFilter::interpolateSubPelPlanes( TComPicYuv* pcPicYuv )
+{
+  const Int iStrip  = 16;
+  
+  pcPicYuv->createSubPelPlanes();
+  
+  Int   iStride     = pcPicYuv->getStride();
+  Int   iMarginX    = pcPicYuv->getLumaMargin () - 4;
+  Int   iMarginY    = pcPicYuv->getLumaMarginY() - 4;
+  Int   iWidth      = pcPicYuv->getWidth () + 2 * iMarginX;
+  Int   iHeight     = pcPicYuv->getHeight() + 2 * iMarginY;
+  Pel*  piSrc       = pcPicYuv->getLumaAddr() - iMarginY * iStride - iMarginX;
+  Int   iOffset     = (Int)( piSrc - pcPicYuv->getBufY() );
+  
+  Int   iExtStride  = iWidth + 7;
+  Int*  piExt       = new Int[ iExtStride * iStrip ];
+  Int   iRndOffset, iShift, iMaxVal;
+  
+  // positions on integer rows and columns
+  xGetRounding( false, false, iRndOffset, iShift, iMaxVal );
+  for ( Int iFrac = 1; iFrac < 4; iFrac++ )
+  {
+    m_afpFilterPel[FILTER_LUMA]( piSrc, iStride, 1,       iWidth, iHeight, s_aasLumaFilter[iFrac], iRndOffset, iShift, iMaxVal, pcPicYuv->getSubPelBufY( iFrac      ) + iOffset, iStride );
+    m_afpFilterPel[FILTER_LUMA]( piSrc, iStride, iStride, iWidth, iHeight, s_aasLumaFilter[iFrac], iRndOffset, iShift, iMaxVal, pcPicYuv->getSubPelBufY( iFrac << 2 ) + iOffset, iStride );
+  }
+  
+  // 2-D positions, vertical pass over a strip of rows then the three horizontal ones
+  xGetRounding( false, true, iRndOffset, iShift, iMaxVal );
+  for ( Int y = 0; y < iHeight; y += iStrip )
+  {
+    Int iRows = min( iStrip, iHeight - y );
+    for ( Int iFracY = 1; iFracY < 4; iFracY++ )
+    {
+      m_afpFilterPelInt[FILTER_LUMA]( piSrc + y * iStride - 3, iStride, iStride, iWidth + 7, iRows, s_aasLumaFilter[iFracY], piExt, iExtStride );
+      for ( Int iFracX = 1; iFracX < 4; iFracX++ )
+      {
+        Pel* piDst = pcPicYuv->getSubPelBufY( ( iFracY << 2 ) + iFracX ) + iOffset + y * iStride;
+        m_afpFilterIntPel[FILTER_LUMA]( piExt + 3, iExtStride, iWidth, iRows, s_aasLumaFilter[iFracX], iRndOffset, iShift, iMaxVal, piDst, iStride );
+      }
+    }
+  }
+  
+  delete [] piExt;
+  
+  pcPicYuv->setSubPelValid( true );
 }
 
+// ====================================================================================================================
+// Protected member functions
+// ====================================================================================================================
+
+/** Interpolate a luma block at a fractional position.
+ * \param piRef         integer sample at the top-left of the block
+ * \param iFracX        horizontal quarter-pel phase
+ * \param iFracY        vertical quarter-pel phase, iFracX and iFracY are not both 0
+ * \param bHighAccuracy keep the 14-bit precision of high accuracy bi-prediction instead of clipping to the sample range
+ * \param piExt         buffer of the first pass of 2-D positions, ( iWidth + 7 ) x iHeight
+ */
+Void TComPredFilter::xInterpolateLuma( Pel* piRef, Int iRefStride, Int iWidth, Int iHeight, Int iFracX, Int iFracY, Bool bHighAccuracy, Int* piExt, Int iExtStride, Pel* piDst, Int iDstStride )
+{
+  Int iOffset, iShift, iMaxVal;
+  
+  if ( iFracY == 0 )
+  {
+    xGetRounding( bHighAccuracy, false, iOffset, iShift, iMaxVal );
+    m_afpFilterPel[FILTER_LUMA]( piRef, iRefStride, 1, iWidth, iHeight, s_aasLumaFilter[iFracX], iOffset, iShift, iMaxVal, piDst, iDstStride );
+  }
+  else if ( iFracX == 0 )
+  {
+    xGetRounding( bHighAccuracy, false, iOffset, iShift, iMaxVal );
+    m_afpFilterPel[FILTER_LUMA]( piRef, iRefStride, iRefStride, iWidth, iHeight, s_aasLumaFilter[iFracY], iOffset, iShift, iMaxVal, piDst, iDstStride );
+  }
+  else
+  {
+    xGetRounding( bHighAccuracy, true, iOffset, iShift, iMaxVal );
+    m_afpFilterPelInt[FILTER_LUMA]( piRef - 3, iRefStride, iRefStride, iWidth + 7, iHeight, s_aasLumaFilter[iFracY], piExt, iExtStride );
+    m_afpFilterIntPel[FILTER_LUMA]( piExt + 3, iExtStride, iWidth, iHeight, s_aasLumaFilter[iFracX], iOffset, iShift, iMaxVal, piDst, iDstStride );
+  }
+}
+
+/** Interpolate a chroma block at a fractional position, as xInterpolateLuma() with eighth-pel phases.
+ * \param piExt         buffer of the first pass of 2-D positions, ( iWidth + 3 ) x iHeight
+ */
+Void TComPredFilter::xInterpolateChroma( Pel* piRef, Int iRefStride, Int iWidth, Int iHeight, Int iFracX, Int iFracY, Bool bHighAccuracy, Int* piExt, Int iExtStride, Pel* piDst, Int iDstStride )
+{
+  Int iOffset, iShift, iMaxVal;
+  
+  if ( iFracY == 0 )
+  {
+    xGetRounding( bHighAccuracy, false, iOffset, iShift, iMaxVal );
+    m_afpFilterPel[FILTER_CHROMA]( piRef, iRefStride, 1, iWidth, iHeight, s_aasChromaFilter[iFracX], iOffset, iShift, iMaxVal, piDst, iDstStride );
+  }
+  else if ( iFracX == 0 )
+  {
+    xGetRounding( bHighAccuracy, false, iOffset, iShift, iMaxVal );
+    m_afpFilterPel[FILTER_CHROMA]( piRef, iRefStride, iRefStride, iWidth, iHeight, s_aasChromaFilter[iFracY], iOffset, iShift, iMaxVal, piDst, iDstStride );
+  }
+  else
+  {
+    xGetRounding( bHighAccuracy, true, iOffset, iShift, iMaxVal );
+    m_afpFilterPelInt[FILTER_CHROMA]( piRef - 1, iRefStride, iRefStride, iWidth + 3, iHeight, s_aasChromaFilter[iFracY], piExt, iExtStride );
+    m_afpFilterIntPel[FILTER_CHROMA]( piExt + 1, iExtStride, iWidth, iHeight, s_aasChromaFilter[iFracX], iOffset, iShift, iMaxVal, piDst, iDstStride );
+  }
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Rounding of a filtered sample, the taps add up to 64 in each direction.
+ * \param bHighAccuracy output at 14-bit precision for high accuracy bi-prediction
+ * \param b2D           second pass of a 2-D position
+ */
+Void TComPredFilter::xGetRounding( Bool bHighAccuracy, Bool b2D, Int& riOffset, Int& riShift, Int& riMaxVal )
+{
+  riShift  = b2D ? 12 : 6;
+  riMaxVal = g_uiIBDI_MAX;
+#if HIGH_ACCURACY_BI
+  if ( bHighAccuracy )
+  {
+    riShift  = ( b2D ? 6 : 0 ) + g_uiBitIncrement + g_uiBitDepth - 8;
+#if REMOVE_INTERMEDIATE_CLIPPING
+    riMaxVal = -1;
+#else
+    riMaxVal = 16383;
+#endif
+  }
+#endif
+  riOffset = riShift > 0 ? 1 << ( riShift - 1 ) : 0;
+}
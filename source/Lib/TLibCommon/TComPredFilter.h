@@ -51,6 +51,23 @@
 #define QU0_IDX   0
 #define QU1_IDX   2
 
+// tap sets of the generic interpolation kernels
+#define FILTER_LUMA     0                       ///< 8-tap luma filter, quarter-pel positions
+#define FILTER_CHROMA   1                       ///< 4-tap chroma filter, eighth-pel positions
+
+// ====================================================================================================================
+// Type definition
+// ====================================================================================================================
+
+/// FIR filter of Pel samples with rounding, output clipped to [0, iMaxVal] (only truncated to Pel if iMaxVal < 0)
+typedef Void (*FpFilterPel)     ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+
+/// FIR filter of Pel samples keeping the full-precision sums (first pass of a 2-D position)
+typedef Void (*FpFilterPelInt)  ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int* piDst, Int iDstStride );
+
+/// horizontal FIR filter of full-precision sums with rounding (second pass of a 2-D position), output as FpFilterPel
+typedef Void (*FpFilterIntPel)  ( const Int* piSrc, Int iSrcStride, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -58,9 +75,30 @@
 /// interpolation filter class
 class TComPredFilter
 {
+  friend class TComPredFilterSIMD;
+  
+protected:
+  // generic kernels, [FILTER_LUMA / FILTER_CHROMA], taps are read from piSrc - ( taps / 2 - 1 ) * iTapStep on
+  FpFilterPel     m_afpFilterPel   [2];
+  FpFilterPelInt  m_afpFilterPelInt[2];
+  FpFilterIntPel  m_afpFilterIntPel[2];
+  
+  Void  xInterpolateLuma    ( Pel* piRef, Int iRefStride, Int iWidth, Int iHeight, Int iFracX, Int iFracY, Bool bHighAccuracy, Int* piExt, Int iExtStride, Pel* piDst, Int iDstStride );
+  Void  xInterpolateChroma  ( Pel* piRef, Int iRefStride, Int iWidth, Int iHeight, Int iFracX, Int iFracY, Bool bHighAccuracy, Int* piExt, Int iExtStride, Pel* piDst, Int iDstStride );
+  
+private:
+  Void  xGetRounding        ( Bool bHighAccuracy, Bool b2D, Int& riOffset, Int& riShift, Int& riMaxVal );
+  
+  template <Int iTaps> static Void xFilterPel     ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+  template <Int iTaps> static Void xFilterPelInt  ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int* piDst, Int iDstStride );
+  template <Int iTaps> static Void xFilterIntPel  ( const Int* piSrc, Int iSrcStride, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+  
 public:
   TComPredFilter();
   
+  Int   setSIMDLevel            ( Int iLevel );
+  Void  interpolateSubPelPlanes ( TComPicYuv* pcPicYuv );
+  
   // DIF filter interface (for half & quarter)
   __inline Void xCTI_FilterHalfHor(Pel* piSrc, Int iSrcStride, Int iSrcStep, Int iWidth, Int iHeight, Int iDstStride, Int iDstStep, Pel*& rpiDst);
   __inline Void xCTI_FilterHalfHor(Int* piSrc, Int iSrcStride, Int iSrcStep, Int iWidth, Int iHeight, Int iDstStride, Int iDstStep, Pel*& rpiDst);
@@ -556,6 +594,75 @@ __inline Void TComPredFilter::xCTI_FilterHalfVer_ha  (Pel* piSrc, Int iSrcStride
 
 #endif
 
+// ------------------------------------------------------------------------------------------------
+// Generic filters (C kernels)
+// ------------------------------------------------------------------------------------------------
+
+template <Int iTaps>
+inline Void TComPredFilter::xFilterPel( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride )
+{
+  piSrc -= ( iTaps / 2 - 1 ) * iTapStep;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      Int iSum = 0;
+      for ( Int k = 0; k < iTaps; k++ )
+      {
+        iSum += psCoef[k] * piSrc[x + k * iTapStep];
+      }
+      iSum = ( iSum + iOffset ) >> iShift;
+      piDst[x] = iMaxVal < 0 ? (Pel)iSum : Clip3( 0, iMaxVal, iSum );
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+template <Int iTaps>
+inline Void TComPredFilter::xFilterPelInt( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int* piDst, Int iDstStride )
+{
+  piSrc -= ( iTaps / 2 - 1 ) * iTapStep;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      Int iSum = 0;
+      for ( Int k = 0; k < iTaps; k++ )
+      {
+        iSum += psCoef[k] * piSrc[x + k * iTapStep];
+      }
+      piDst[x] = iSum;
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+template <Int iTaps>
+inline Void TComPredFilter::xFilterIntPel( const Int* piSrc, Int iSrcStride, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride )
+{
+  piSrc -= iTaps / 2 - 1;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      Int iSum = 0;
+      for ( Int k = 0; k < iTaps; k++ )
+      {
+        iSum += psCoef[k] * piSrc[x + k];
+      }
+      iSum = ( iSum + iOffset ) >> iShift;
+      piDst[x] = iMaxVal < 0 ? (Pel)iSum : Clip3( 0, iMaxVal, iSum );
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
 // ------------------------------------------------------------------------------------------------
 // DCTIF filters
 // ------------------------------------------------------------------------------------------------
@@ -0,0 +1,475 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComPredFilterSIMD.cpp
+    \brief    SSE4.1 / AVX2 interpolation filter kernels selected at run time
+*/
+
+#include "TComPredFilterSIMD.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PREDFILTER_SIMD   1
+#include <immintrin.h>
+#else
+#define PREDFILTER_SIMD   0
+#endif
+
+// the kernels are compiled for their own instruction set, the rest of the library keeps the default target
+#if defined(__GNUC__)
+#define TARGET_SSE41  __attribute__((target("sse4.1")))
+#define TARGET_AVX2   __attribute__((target("avx2")))
+#define SIMD_INLINE   inline __attribute__((always_inline))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#define SIMD_INLINE   __forceinline
+#endif
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+#if PREDFILTER_SIMD
+
+/// coefficient pair ( c0, c1 ) packed into one 32-bit lane for madd
+static inline Int xCoefPair( Short sCoef0, Short sCoef1 )
+{
+  return (Int)( (UInt)(UShort)sCoef0 | ( (UInt)(UShort)sCoef1 << 16 ) );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// SSE4.1
+// --------------------------------------------------------------------------------------------------------------------
+
+/// full-precision sums of eight horizontally adjacent outputs, taps iTapStep apart
+template <Int iTaps>
+TARGET_SSE41 static SIMD_INLINE Void xSumsPel8( const Pel* piSrc, Int iTapStep, const __m128i* avCoef, __m128i& rvLo, __m128i& rvHi )
+{
+  rvLo = _mm_setzero_si128();
+  rvHi = _mm_setzero_si128();
+  for ( Int k = 0; k < iTaps; k += 2 )
+  {
+    __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)&piSrc[ k      * iTapStep] );
+    __m128i vSrc1 = _mm_loadu_si128( (const __m128i*)&piSrc[(k + 1) * iTapStep] );
+    rvLo = _mm_add_epi32( rvLo, _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), avCoef[k >> 1] ) );
+    rvHi = _mm_add_epi32( rvHi, _mm_madd_epi16( _mm_unpackhi_epi16( vSrc0, vSrc1 ), avCoef[k >> 1] ) );
+  }
+}
+
+/// full-precision sums of four horizontally adjacent outputs
+template <Int iTaps>
+TARGET_SSE41 static SIMD_INLINE __m128i xSumsPel4( const Pel* piSrc, Int iTapStep, const __m128i* avCoef )
+{
+  __m128i vSum = _mm_setzero_si128();
+  for ( Int k = 0; k < iTaps; k += 2 )
+  {
+    __m128i vSrc0 = _mm_loadl_epi64( (const __m128i*)&piSrc[ k      * iTapStep] );
+    __m128i vSrc1 = _mm_loadl_epi64( (const __m128i*)&piSrc[(k + 1) * iTapStep] );
+    vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), avCoef[k >> 1] ) );
+  }
+  return vSum;
+}
+
+/// full-precision sums of four adjacent outputs from full-precision input
+template <Int iTaps>
+TARGET_SSE41 static SIMD_INLINE __m128i xSumsInt4( const Int* piSrc, const __m128i* avCoef )
+{
+  __m128i vSum = _mm_setzero_si128();
+  for ( Int k = 0; k < iTaps; k++ )
+  {
+    vSum = _mm_add_epi32( vSum, _mm_mullo_epi32( _mm_loadu_si128( (const __m128i*)&piSrc[k] ), avCoef[k] ) );
+  }
+  return vSum;
+}
+
+/// rounds eight sums and packs them to Pel, clipped to [0, max] or truncated as the C kernel does
+TARGET_SSE41 static SIMD_INLINE __m128i xRoundPack( __m128i vLo, __m128i vHi, __m128i vOffset, __m128i vShift, __m128i vMax, Bool bClip )
+{
+  vLo = _mm_sra_epi32( _mm_add_epi32( vLo, vOffset ), vShift );
+  vHi = _mm_sra_epi32( _mm_add_epi32( vHi, vOffset ), vShift );
+  if ( bClip )
+  {
+    // saturation of the pack cannot change the result of the clip
+    return _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), _mm_setzero_si128() ), vMax );
+  }
+  vLo = _mm_srai_epi32( _mm_slli_epi32( vLo, 16 ), 16 );
+  vHi = _mm_srai_epi32( _mm_slli_epi32( vHi, 16 ), 16 );
+  return _mm_packs_epi32( vLo, vHi );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// AVX2
+// --------------------------------------------------------------------------------------------------------------------
+
+/// full-precision sums of sixteen horizontally adjacent outputs, in 128-bit lane order
+template <Int iTaps>
+TARGET_AVX2 static SIMD_INLINE Void xSumsPel16( const Pel* piSrc, Int iTapStep, const __m256i* avCoef, __m256i& rvLo, __m256i& rvHi )
+{
+  rvLo = _mm256_setzero_si256();
+  rvHi = _mm256_setzero_si256();
+  for ( Int k = 0; k < iTaps; k += 2 )
+  {
+    __m256i vSrc0 = _mm256_loadu_si256( (const __m256i*)&piSrc[ k      * iTapStep] );
+    __m256i vSrc1 = _mm256_loadu_si256( (const __m256i*)&piSrc[(k + 1) * iTapStep] );
+    rvLo = _mm256_add_epi32( rvLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( vSrc0, vSrc1 ), avCoef[k >> 1] ) );
+    rvHi = _mm256_add_epi32( rvHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( vSrc0, vSrc1 ), avCoef[k >> 1] ) );
+  }
+}
+
+/// full-precision sums of eight adjacent outputs from full-precision input
+template <Int iTaps>
+TARGET_AVX2 static SIMD_INLINE __m256i xSumsInt8( const Int* piSrc, const __m256i* avCoef )
+{
+  __m256i vSum = _mm256_setzero_si256();
+  for ( Int k = 0; k < iTaps; k++ )
+  {
+    vSum = _mm256_add_epi32( vSum, _mm256_mullo_epi32( _mm256_loadu_si256( (const __m256i*)&piSrc[k] ), avCoef[k] ) );
+  }
+  return vSum;
+}
+
+/// rounds sixteen sums and packs them to Pel within each 128-bit lane
+TARGET_AVX2 static SIMD_INLINE __m256i xRoundPack256( __m256i vLo, __m256i vHi, __m256i vOffset, __m128i vShift, __m256i vMax, Bool bClip )
+{
+  vLo = _mm256_sra_epi32( _mm256_add_epi32( vLo, vOffset ), vShift );
+  vHi = _mm256_sra_epi32( _mm256_add_epi32( vHi, vOffset ), vShift );
+  if ( bClip )
+  {
+    return _mm256_min_epi16( _mm256_max_epi16( _mm256_packs_epi32( vLo, vHi ), _mm256_setzero_si256() ), vMax );
+  }
+  vLo = _mm256_srai_epi32( _mm256_slli_epi32( vLo, 16 ), 16 );
+  vHi = _mm256_srai_epi32( _mm256_slli_epi32( vHi, 16 ), 16 );
+  return _mm256_packs_epi32( vLo, vHi );
+}
+
+#endif // PREDFILTER_SIMD
+
+// ====================================================================================================================
+// SSE4.1 kernels
+// ====================================================================================================================
+
+// blocks narrower than a vector are left to the C kernels; the last vector of a row is shifted back to end at iWidth,
+// recomputing a few outputs instead of falling back to scalar code
+
+#if PREDFILTER_SIMD
+
+template <Int iTaps>
+TARGET_SSE41 Void TComPredFilterSIMD::xFilterPel_SSE41( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride )
+{
+  if ( iWidth < 4 )
+  {
+    TComPredFilter::xFilterPel<iTaps>( piSrc, iSrcStride, iTapStep, iWidth, iHeight, psCoef, iOffset, iShift, iMaxVal, piDst, iDstStride );
+    return;
+  }
+  
+  __m128i avCoef[iTaps / 2];
+  for ( Int k = 0; k < iTaps; k += 2 )
+  {
+    avCoef[k >> 1] = _mm_set1_epi32( xCoefPair( psCoef[k], psCoef[k + 1] ) );
+  }
+  __m128i vOffset = _mm_set1_epi32( iOffset );
+  __m128i vShift  = _mm_cvtsi32_si128( iShift );
+  __m128i vMax    = _mm_set1_epi16( (Short)iMaxVal );
+  Bool    bClip   = iMaxVal >= 0;
+  __m128i vLo, vHi;
+  
+  piSrc -= ( iTaps / 2 - 1 ) * iTapStep;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    if ( iWidth >= 8 )
+    {
+      for ( Int x = 0; x < iWidth; x += 8 )
+      {
+        x = x + 8 > iWidth ? iWidth - 8 : x;
+        xSumsPel8<iTaps>( piSrc + x, iTapStep, avCoef, vLo, vHi );
+        _mm_storeu_si128( (__m128i*)&piDst[x], xRoundPack( vLo, vHi, vOffset, vShift, vMax, bClip ) );
+      }
+    }
+    else
+    {
+      for ( Int x = 0; x < iWidth; x += 4 )
+      {
+        x = x + 4 > iWidth ? iWidth - 4 : x;
+        vLo = xSumsPel4<iTaps>( piSrc + x, iTapStep, avCoef );
+        _mm_storel_epi64( (__m128i*)&piDst[x], xRoundPack( vLo, vLo, vOffset, vShift, vMax, bClip ) );
+      }
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+template <Int iTaps>
+TARGET_SSE41 Void TComPredFilterSIMD::xFilterPelInt_SSE41( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int* piDst, Int iDstStride )
+{
+  if ( iWidth < 4 )
+  {
+    TComPredFilter::xFilterPelInt<iTaps>( piSrc, iSrcStride, iTapStep, iWidth, iHeight, psCoef, piDst, iDstStride );
+    return;
+  }
+  
+  __m128i avCoef[iTaps / 2];
+  for ( Int k = 0; k < iTaps; k += 2 )
+  {
+    avCoef[k >> 1] = _mm_set1_epi32( xCoefPair( psCoef[k], psCoef[k + 1] ) );
+  }
+  __m128i vLo, vHi;
+  
+  piSrc -= ( iTaps / 2 - 1 ) * iTapStep;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    if ( iWidth >= 8 )
+    {
+      for ( Int x = 0; x < iWidth; x += 8 )
+      {
+        x = x + 8 > iWidth ? iWidth - 8 : x;
+        xSumsPel8<iTaps>( piSrc + x, iTapStep, avCoef, vLo, vHi );
+        _mm_storeu_si128( (__m128i*)&piDst[x    ], vLo );
+        _mm_storeu_si128( (__m128i*)&piDst[x + 4], vHi );
+      }
+    }
+    else
+    {
+      for ( Int x = 0; x < iWidth; x += 4 )
+      {
+        x = x + 4 > iWidth ? iWidth - 4 : x;
+        _mm_storeu_si128( (__m128i*)&piDst[x], xSumsPel4<iTaps>( piSrc + x, iTapStep, avCoef ) );
+      }
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+template <Int iTaps>
+TARGET_SSE41 Void TComPredFilterSIMD::xFilterIntPel_SSE41( const Int* piSrc, Int iSrcStride, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride )
+{
+  if ( iWidth < 4 )
+  {
+    TComPredFilter::xFilterIntPel<iTaps>( piSrc, iSrcStride, iWidth, iHeight, psCoef, iOffset, iShift, iMaxVal, piDst, iDstStride );
+    return;
+  }
+  
+  __m128i avCoef[iTaps];
+  for ( Int k = 0; k < iTaps; k++ )
+  {
+    avCoef[k] = _mm_set1_epi32( psCoef[k] );
+  }
+  __m128i vOffset = _mm_set1_epi32( iOffset );
+  __m128i vShift  = _mm_cvtsi32_si128( iShift );
+  __m128i vMax    = _mm_set1_epi16( (Short)iMaxVal );
+  Bool    bClip   = iMaxVal >= 0;
+  
+  piSrc -= iTaps / 2 - 1;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    if ( iWidth >= 8 )
+    {
+      for ( Int x = 0; x < iWidth; x += 8 )
+      {
+        x = x + 8 > iWidth ? iWidth - 8 : x;
+        __m128i vLo = xSumsInt4<iTaps>( piSrc + x,     avCoef );
+        __m128i vHi = xSumsInt4<iTaps>( piSrc + x + 4, avCoef );
+        _mm_storeu_si128( (__m128i*)&piDst[x], xRoundPack( vLo, vHi, vOffset, vShift, vMax, bClip ) );
+      }
+    }
+    else
+    {
+      for ( Int x = 0; x < iWidth; x += 4 )
+      {
+        x = x + 4 > iWidth ? iWidth - 4 : x;
+        __m128i vSum = xSumsInt4<iTaps>( piSrc + x, avCoef );
+        _mm_storel_epi64( (__m128i*)&piDst[x], xRoundPack( vSum, vSum, vOffset, vShift, vMax, bClip ) );
+      }
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+// ====================================================================================================================
+// AVX2 kernels
+// ====================================================================================================================
+
+// blocks narrower than 16 samples keep the SSE4.1 kernels
+
+template <Int iTaps>
+TARGET_AVX2 Void TComPredFilterSIMD::xFilterPel_AVX2( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride )
+{
+  if ( iWidth < 16 )
+  {
+    xFilterPel_SSE41<iTaps>( piSrc, iSrcStride, iTapStep, iWidth, iHeight, psCoef, iOffset, iShift, iMaxVal, piDst, iDstStride );
+    return;
+  }
+  
+  __m256i avCoef[iTaps / 2];
+  for ( Int k = 0; k < iTaps; k += 2 )
+  {
+    avCoef[k >> 1] = _mm256_set1_epi32( xCoefPair( psCoef[k], psCoef[k + 1] ) );
+  }
+  __m256i vOffset = _mm256_set1_epi32( iOffset );
+  __m128i vShift  = _mm_cvtsi32_si128( iShift );
+  __m256i vMax    = _mm256_set1_epi16( (Short)iMaxVal );
+  Bool    bClip   = iMaxVal >= 0;
+  __m256i vLo, vHi;
+  
+  piSrc -= ( iTaps / 2 - 1 ) * iTapStep;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x += 16 )
+    {
+      x = x + 16 > iWidth ? iWidth - 16 : x;
+      // unpack and pack both work within 128-bit lanes, so the outputs come back in order
+      xSumsPel16<iTaps>( piSrc + x, iTapStep, avCoef, vLo, vHi );
+      _mm256_storeu_si256( (__m256i*)&piDst[x], xRoundPack256( vLo, vHi, vOffset, vShift, vMax, bClip ) );
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+template <Int iTaps>
+TARGET_AVX2 Void TComPredFilterSIMD::xFilterPelInt_AVX2( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int* piDst, Int iDstStride )
+{
+  if ( iWidth < 16 )
+  {
+    xFilterPelInt_SSE41<iTaps>( piSrc, iSrcStride, iTapStep, iWidth, iHeight, psCoef, piDst, iDstStride );
+    return;
+  }
+  
+  __m256i avCoef[iTaps / 2];
+  for ( Int k = 0; k < iTaps; k += 2 )
+  {
+    avCoef[k >> 1] = _mm256_set1_epi32( xCoefPair( psCoef[k], psCoef[k + 1] ) );
+  }
+  __m256i vLo, vHi;
+  
+  piSrc -= ( iTaps / 2 - 1 ) * iTapStep;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x += 16 )
+    {
+      x = x + 16 > iWidth ? iWidth - 16 : x;
+      // vLo holds outputs 0-3 | 8-11 and vHi 4-7 | 12-15
+      xSumsPel16<iTaps>( piSrc + x, iTapStep, avCoef, vLo, vHi );
+      _mm256_storeu_si256( (__m256i*)&piDst[x    ], _mm256_permute2x128_si256( vLo, vHi, 0x20 ) );
+      _mm256_storeu_si256( (__m256i*)&piDst[x + 8], _mm256_permute2x128_si256( vLo, vHi, 0x31 ) );
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+template <Int iTaps>
+TARGET_AVX2 Void TComPredFilterSIMD::xFilterIntPel_AVX2( const Int* piSrc, Int iSrcStride, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride )
+{
+  if ( iWidth < 16 )
+  {
+    xFilterIntPel_SSE41<iTaps>( piSrc, iSrcStride, iWidth, iHeight, psCoef, iOffset, iShift, iMaxVal, piDst, iDstStride );
+    return;
+  }
+  
+  __m256i avCoef[iTaps];
+  for ( Int k = 0; k < iTaps; k++ )
+  {
+    avCoef[k] = _mm256_set1_epi32( psCoef[k] );
+  }
+  __m256i vOffset = _mm256_set1_epi32( iOffset );
+  __m128i vShift  = _mm_cvtsi32_si128( iShift );
+  __m256i vMax    = _mm256_set1_epi16( (Short)iMaxVal );
+  Bool    bClip   = iMaxVal >= 0;
+  
+  piSrc -= iTaps / 2 - 1;
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x += 16 )
+    {
+      x = x + 16 > iWidth ? iWidth - 16 : x;
+      __m256i vLo = xSumsInt8<iTaps>( piSrc + x,     avCoef );
+      __m256i vHi = xSumsInt8<iTaps>( piSrc + x + 8, avCoef );
+      // the pack interleaves the lanes as 0-3 | 8-11 | 4-7 | 12-15
+      __m256i vPel = xRoundPack256( vLo, vHi, vOffset, vShift, vMax, bClip );
+      _mm256_storeu_si256( (__m256i*)&piDst[x], _mm256_permute4x64_epi64( vPel, 0xd8 ) );
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+
+#endif // PREDFILTER_SIMD
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** overwrite the C kernels with the vectorised ones of the requested level
+ * \param iLevel  SIMDLevel to use, clamped to what the CPU supports; SIMD_AUTO selects the best one
+ * \returns the level actually in use
+ */
+Int TComPredFilterSIMD::initFilterFunc( FpFilterPel* afpFilterPel, FpFilterPelInt* afpFilterPelInt, FpFilterIntPel* afpFilterIntPel, Int iLevel )
+{
+  Int iCPULevel = TComRdCostSIMD::getCPULevel();
+  if ( iLevel < 0 || iLevel > iCPULevel )
+  {
+    iLevel = iCPULevel;
+  }
+  
+#if PREDFILTER_SIMD
+  if ( iLevel >= SIMD_SSE41 )
+  {
+    afpFilterPel   [FILTER_LUMA  ] = xFilterPel_SSE41<8>;
+    afpFilterPel   [FILTER_CHROMA] = xFilterPel_SSE41<4>;
+    afpFilterPelInt[FILTER_LUMA  ] = xFilterPelInt_SSE41<8>;
+    afpFilterPelInt[FILTER_CHROMA] = xFilterPelInt_SSE41<4>;
+    afpFilterIntPel[FILTER_LUMA  ] = xFilterIntPel_SSE41<8>;
+    afpFilterIntPel[FILTER_CHROMA] = xFilterIntPel_SSE41<4>;
+  }
+  if ( iLevel >= SIMD_AVX2 )
+  {
+    afpFilterPel   [FILTER_LUMA  ] = xFilterPel_AVX2<8>;
+    afpFilterPel   [FILTER_CHROMA] = xFilterPel_AVX2<4>;
+    afpFilterPelInt[FILTER_LUMA  ] = xFilterPelInt_AVX2<8>;
+    afpFilterPelInt[FILTER_CHROMA] = xFilterPelInt_AVX2<4>;
+    afpFilterIntPel[FILTER_LUMA  ] = xFilterIntPel_AVX2<8>;
+    afpFilterIntPel[FILTER_CHROMA] = xFilterIntPel_AVX2<4>;
+  }
+#endif
+  
+  return iLevel;
+}
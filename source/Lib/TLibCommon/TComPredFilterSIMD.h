@@ -0,0 +1,68 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComPredFilterSIMD.h
+    \brief    SSE4.1 / AVX2 interpolation filter kernels selected at run time (header)
+*/
+
+#ifndef __TCOMPREDFILTERSIMD__
+#define __TCOMPREDFILTERSIMD__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TComPredFilter.h"
+#include "TComRdCostSIMD.h"
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// vectorised FIR kernels, bit-exact with the generic C kernels of TComPredFilter
+class TComPredFilterSIMD
+{
+public:
+  static Int  initFilterFunc  ( FpFilterPel* afpFilterPel, FpFilterPelInt* afpFilterPelInt, FpFilterIntPel* afpFilterIntPel, Int iLevel );
+  
+private:
+  template <Int iTaps> static Void xFilterPel_SSE41     ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+  template <Int iTaps> static Void xFilterPelInt_SSE41  ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int* piDst, Int iDstStride );
+  template <Int iTaps> static Void xFilterIntPel_SSE41  ( const Int* piSrc, Int iSrcStride, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+  
+  template <Int iTaps> static Void xFilterPel_AVX2      ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+  template <Int iTaps> static Void xFilterPelInt_AVX2   ( const Pel* piSrc, Int iSrcStride, Int iTapStep, Int iWidth, Int iHeight, const Short* psCoef, Int* piDst, Int iDstStride );
+  template <Int iTaps> static Void xFilterIntPel_AVX2   ( const Int* piSrc, Int iSrcStride, Int iWidth, Int iHeight, const Short* psCoef, Int iOffset, Int iShift, Int iMaxVal, Pel* piDst, Int iDstStride );
+};// END CLASS DEFINITION TComPredFilterSIMD
+
+#endif // __TCOMPREDFILTERSIMD__
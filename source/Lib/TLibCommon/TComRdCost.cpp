@@ -38,6 +38,7 @@
 #include <math.h>
 #include <assert.h>
 #include "TComRdCost.h"
+#include "TComRdCostSIMD.h"
 
 TComRdCost::TComRdCost()
 {
@@ -154,44 +155,7 @@ Void TComRdCost::setLambda( Double dLambda )
 // Initalize Function Pointer by [eDFunc]
 Void TComRdCost::init()
 {
-  m_afpDistortFunc[0]  = NULL;                  // for DF_DEFAULT
-  
-  m_afpDistortFunc[1]  = TComRdCost::xGetSSE;
-  m_afpDistortFunc[2]  = TComRdCost::xGetSSE4;
-  m_afpDistortFunc[3]  = TComRdCost::xGetSSE8;
-  m_afpDistortFunc[4]  = TComRdCost::xGetSSE16;
-  m_afpDistortFunc[5]  = TComRdCost::xGetSSE32;
-  m_afpDistortFunc[6]  = TComRdCost::xGetSSE64;
-  m_afpDistortFunc[7]  = TComRdCost::xGetSSE16N;
-  
-  m_afpDistortFunc[8]  = TComRdCost::xGetSAD;
-  m_afpDistortFunc[9]  = TComRdCost::xGetSAD4;
-  m_afpDistortFunc[10] = TComRdCost::xGetSAD8;
-  m_afpDistortFunc[11] = TComRdCost::xGetSAD16;
-  m_afpDistortFunc[12] = TComRdCost::xGetSAD32;
-  m_afpDistortFunc[13] = TComRdCost::xGetSAD64;
-  m_afpDistortFunc[14] = TComRdCost::xGetSAD16N;
-  
-  m_afpDistortFunc[15] = TComRdCost::xGetSADs;
-  m_afpDistortFunc[16] = TComRdCost::xGetSADs4;
-  m_afpDistortFunc[17] = TComRdCost::xGetSADs8;
-  m_afpDistortFunc[18] = TComRdCost::xGetSADs16;
-  m_afpDistortFunc[19] = TComRdCost::xGetSADs32;
-  m_afpDistortFunc[20] = TComRdCost::xGetSADs64;
-  m_afpDistortFunc[21] = TComRdCost::xGetSADs16N;
-  
-  m_afpDistortFunc[22] = TComRdCost::xGetHADs;
-#ifdef DCM_RDCOST_TEMP_FIX //Temporary fix since xGetHADs4 and xGetHADs8 assume that the row size cannot be 1, 2, 3 or 6 when the column size is 4 or 8.
-  m_afpDistortFunc[23] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[24] = TComRdCost::xGetHADs;
-#else
-  m_afpDistortFunc[23] = TComRdCost::xGetHADs4;
-  m_afpDistortFunc[24] = TComRdCost::xGetHADs8;
-#endif
-  m_afpDistortFunc[25] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[26] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[27] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[28] = TComRdCost::xGetHADs;
+  xInitDistortionFunc( SIMD_AUTO );
   
 #ifdef ROUNDING_CONTROL_BIPRED
   m_afpDistortFuncRnd[0]  = NULL;
@@ -237,6 +201,64 @@ Void TComRdCost::init()
   m_iSearchLimit            = 0xdeaddead;
 }
 
+/** Select the instruction set of the distortion kernels.
+ * \param iLevel SIMDLevel, SIMD_AUTO selects the best one the CPU supports
+ * \returns level actually used
+ */
+Int TComRdCost::setSIMDLevel( Int iLevel )
+{
+  return xInitDistortionFunc( iLevel );
+}
+
+Int TComRdCost::xInitDistortionFunc( Int iSIMDLevel )
+{
+  m_afpDistortFunc[0]  = NULL;                  // for DF_DEFAULT
+  
+  m_afpDistortFunc[1]  = TComRdCost::xGetSSE;
+  m_afpDistortFunc[2]  = TComRdCost::xGetSSE4;
+  m_afpDistortFunc[3]  = TComRdCost::xGetSSE8;
+  m_afpDistortFunc[4]  = TComRdCost::xGetSSE16;
+  m_afpDistortFunc[5]  = TComRdCost::xGetSSE32;
+  m_afpDistortFunc[6]  = TComRdCost::xGetSSE64;
+  m_afpDistortFunc[7]  = TComRdCost::xGetSSE16N;
+  
+  m_afpDistortFunc[8]  = TComRdCost::xGetSAD;
+  m_afpDistortFunc[9]  = TComRdCost::xGetSAD4;
+  m_afpDistortFunc[10] = TComRdCost::xGetSAD8;
+  m_afpDistortFunc[11] = TComRdCost::xGetSAD16;
+  m_afpDistortFunc[12] = TComRdCost::xGetSAD32;
+  m_afpDistortFunc[13] = TComRdCost::xGetSAD64;
+  m_afpDistortFunc[14] = TComRdCost::xGetSAD16N;
+  
+  for ( Int i = 0; i < 33; i++ )
+  {
+    m_afpDistortFuncMulti[i] = ( i >= DF_SAD && i <= DF_SAD16N ? TComRdCost::xGetSADMulti : NULL );
+  }
+  
+  m_afpDistortFunc[15] = TComRdCost::xGetSADs;
+  m_afpDistortFunc[16] = TComRdCost::xGetSADs4;
+  m_afpDistortFunc[17] = TComRdCost::xGetSADs8;
+  m_afpDistortFunc[18] = TComRdCost::xGetSADs16;
+  m_afpDistortFunc[19] = TComRdCost::xGetSADs32;
+  m_afpDistortFunc[20] = TComRdCost::xGetSADs64;
+  m_afpDistortFunc[21] = TComRdCost::xGetSADs16N;
+  
+  m_afpDistortFunc[22] = TComRdCost::xGetHADs;
+#ifdef DCM_RDCOST_TEMP_FIX //Temporary fix since xGetHADs4 and xGetHADs8 assume that the row size cannot be 1, 2, 3 or 6 when the column size is 4 or 8.
+  m_afpDistortFunc[23] = TComRdCost::xGetHADs;
+  m_afpDistortFunc[24] = TComRdCost::xGetHADs;
+#else
+  m_afpDistortFunc[23] = TComRdCost::xGetHADs4;
+  m_afpDistortFunc[24] = TComRdCost::xGetHADs8;
+#endif
+  m_afpDistortFunc[25] = TComRdCost::xGetHADs;
+  m_afpDistortFunc[26] = TComRdCost::xGetHADs;
+  m_afpDistortFunc[27] = TComRdCost::xGetHADs;
+  m_afpDistortFunc[28] = TComRdCost::xGetHADs;
+  
+  return TComRdCostSIMD::initDistortionFunc( m_afpDistortFunc, m_afpDistortFuncMulti, iSIMDLevel );
+}
+
 Void TComRdCost::initRateDistortionModel( Int iSubPelSearchLimit )
 {
   // make it larger
@@ -363,6 +385,7 @@ Void TComRdCost::setDistParam( TComPattern* pcPatternKey, Pel* piRefY, Int iRefS
   rcDistParam.iCols    = pcPatternKey->getROIYWidth();
   rcDistParam.iRows    = pcPatternKey->getROIYHeight();
   rcDistParam.DistFunc = m_afpDistortFunc[DF_SAD + g_aucConvertToBit[ rcDistParam.iCols ] + 1 ];
+  rcDistParam.DistFuncMulti = m_afpDistortFuncMulti[DF_SAD + g_aucConvertToBit[ rcDistParam.iCols ] + 1 ];
   
   // initialize
   rcDistParam.iSubShift  = 0;
@@ -480,6 +503,24 @@ UInt TComRdCost::getDistPart( Pel* piCur, Int iCurStride,  Pel* piOrg, Int iOrgS
 // SAD
 // --------------------------------------------------------------------------------------------------------------------
 
+/** SADs of several candidate positions, one DistFunc call each.
+ * \param pcDtParam distortion parameters, pCur is the position all offsets refer to
+ * \param piOffsets offsets of the candidates from pCur
+ * \param iNumCand number of candidates
+ * \param puiSad receives the distortion of each candidate
+ */
+Void TComRdCost::xGetSADMulti( DistParam* pcDtParam, const Int* piOffsets, Int iNumCand, UInt* puiSad )
+{
+  Pel* piCur = pcDtParam->pCur;
+  
+  for ( Int i = 0; i < iNumCand; i++ )
+  {
+    pcDtParam->pCur = piCur + piOffsets[i];
+    puiSad[i] = pcDtParam->DistFunc( pcDtParam );
+  }
+  pcDtParam->pCur = piCur;
+}
+
 #ifdef ROUNDING_CONTROL_BIPRED
 UInt TComRdCost::xGetSAD( DistParam* pcDtParam, Pel* pRefY, Bool bRound )
 {
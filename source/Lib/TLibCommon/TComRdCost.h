@@ -53,6 +53,9 @@ class TComPattern;
 // for function pointer
 typedef UInt (*FpDistFunc) (DistParam*);
 
+// SADs of one original block against several reference positions (offsets from DistParam::pCur)
+typedef Void (*FpDistFuncMulti) (DistParam*, const Int*, Int, UInt*);
+
 #ifdef ROUNDING_CONTROL_BIPRED
 typedef UInt (*FpDistFuncRnd) (DistParam*, Pel*, Bool);
 #endif
@@ -73,6 +76,7 @@ public:
   Int   iCols;
   Int   iStep;
   FpDistFunc DistFunc;
+  FpDistFuncMulti DistFuncMulti;  ///< same distortion as DistFunc for a list of candidates, set for integer ME only
 #ifdef ROUNDING_CONTROL_BIPRED
   FpDistFuncRnd DistFuncRnd;
 #endif
@@ -91,6 +95,7 @@ public:
     iCols = 0;
     iStep = 1;
     DistFunc = NULL;
+    DistFuncMulti = NULL;
 #ifdef ROUNDING_CONTROL_BIPRED
     DistFuncRnd = NULL;
 #endif
@@ -107,6 +112,7 @@ private:
   Int                     m_iBlkHeight;
   
   FpDistFunc              m_afpDistortFunc[33]; // [eDFunc]
+  FpDistFuncMulti         m_afpDistortFuncMulti[33];
 #ifdef ROUNDING_CONTROL_BIPRED
   FpDistFuncRnd           m_afpDistortFuncRnd[33];
 #endif
@@ -126,6 +132,8 @@ private:
   Int                     m_iCostScale;
   Int                     m_iSearchLimit;
   
+  friend class TComRdCostSIMD;
+  
 public:
   TComRdCost();
   virtual ~TComRdCost();
@@ -135,11 +143,14 @@ public:
   
   Void    setLambda      ( Double dLambda );
   Void    setFrameLambda ( Double dLambda ) { m_dFrameLambda = dLambda; }
+  Double  getLambda      ()                 { return m_dLambda;      }
+  Double  getFrameLambda ()                 { return m_dFrameLambda; }
   
   Double  getSqrtLambda ()   { return m_sqrtLambda; }
   
   // Distortion Functions
   Void    init();
+  Int     setSIMDLevel( Int iLevel );
   
   Void    setDistParam( UInt uiBlkWidth, UInt uiBlkHeight, DFunc eDFunc, DistParam& rcDistParam );
   Void    setDistParam( TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride,            DistParam& rcDistParam );
@@ -173,6 +184,8 @@ public:
   
 private:
   
+  Int     xInitDistortionFunc( Int iSIMDLevel );
+  
   static UInt xGetSSE           ( DistParam* pcDtParam );
   static UInt xGetSSE4          ( DistParam* pcDtParam );
   static UInt xGetSSE8          ( DistParam* pcDtParam );
@@ -188,6 +201,7 @@ private:
   static UInt xGetSAD32         ( DistParam* pcDtParam );
   static UInt xGetSAD64         ( DistParam* pcDtParam );
   static UInt xGetSAD16N        ( DistParam* pcDtParam );
+  static Void xGetSADMulti      ( DistParam* pcDtParam, const Int* piOffsets, Int iNumCand, UInt* puiSad );
   
   static UInt xGetSADs          ( DistParam* pcDtParam );
   static UInt xGetSADs4         ( DistParam* pcDtParam );
@@ -0,0 +1,935 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComRdCostSIMD.cpp
+    \brief    SSE4.1 / AVX2 distortion kernels selected at run time
+*/
+
+#include <stdlib.h>
+#include "TComRdCostSIMD.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define RDCOST_SIMD   1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define RDCOST_SIMD   0
+#endif
+
+// the kernels are compiled for their own instruction set, the rest of the library keeps the default target
+#if defined(__GNUC__)
+#define TARGET_SSE41  __attribute__((target("sse4.1")))
+#define TARGET_AVX2   __attribute__((target("avx2")))
+#define SIMD_INLINE   inline __attribute__((always_inline))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#define SIMD_INLINE   __forceinline
+#endif
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+#if RDCOST_SIMD
+
+/// number of columns the C kernel of a table entry processes
+template <Int iWidth> static inline Int xBlockWidth( Int iCols )
+{
+  return iWidth > 0 ? iWidth : ( iWidth < 0 ? ( ( iCols + 15 ) & ~15 ) : iCols );
+}
+
+/// SAD on a sub-sampled interpolation buffer, kept in C
+static UInt xSADStep( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, Int iCols, Int iStep )
+{
+  UInt uiSum = 0;
+  
+  for( ; iRows != 0; iRows-- )
+  {
+    for ( Int n = 0; n < iCols; n++ )
+    {
+      uiSum += abs( piOrg[n] - piCur[n*iStep] );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  return uiSum;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// SSE4.1
+// --------------------------------------------------------------------------------------------------------------------
+
+/// horizontal sum of four 32-bit lanes
+TARGET_SSE41 static SIMD_INLINE UInt xHorSum( __m128i vSum )
+{
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0x4e ) );
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0xb1 ) );
+  return (UInt)_mm_cvtsi128_si32( vSum );
+}
+
+/// adds |org - cur| of eight samples; max - min cannot overflow as an unsigned 16-bit value
+TARGET_SSE41 static SIMD_INLINE __m128i xAddAbsDiff( __m128i vSum, __m128i vOrg, __m128i vCur )
+{
+  __m128i vZero = _mm_setzero_si128();
+  __m128i vDiff = _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) );
+  vSum = _mm_add_epi32( vSum, _mm_unpacklo_epi16( vDiff, vZero ) );
+  return _mm_add_epi32( vSum, _mm_unpackhi_epi16( vDiff, vZero ) );
+}
+
+/// adds ( org - cur )^2 >> shift of the four low samples
+TARGET_SSE41 static SIMD_INLINE __m128i xAddSqrDiff( __m128i vSum, __m128i vOrg, __m128i vCur, __m128i vShift )
+{
+  __m128i vDiff = _mm_sub_epi32( _mm_cvtepi16_epi32( vOrg ), _mm_cvtepi16_epi32( vCur ) );
+  return _mm_add_epi32( vSum, _mm_srl_epi32( _mm_mullo_epi32( vDiff, vDiff ), vShift ) );
+}
+
+/// SAD of the columns [x, iCols) of one row
+TARGET_SSE41 static SIMD_INLINE UInt xSADRowSSE41( __m128i& rvSum, const Pel* piOrg, const Pel* piCur, Int x, Int iCols )
+{
+  UInt uiSum = 0;
+  
+  for ( ; x + 8 <= iCols; x += 8 )
+  {
+    rvSum = xAddAbsDiff( rvSum, _mm_loadu_si128( (const __m128i*)&piOrg[x] ), _mm_loadu_si128( (const __m128i*)&piCur[x] ) );
+  }
+  if ( x + 4 <= iCols )
+  {
+    rvSum = xAddAbsDiff( rvSum, _mm_loadl_epi64( (const __m128i*)&piOrg[x] ), _mm_loadl_epi64( (const __m128i*)&piCur[x] ) );
+    x += 4;
+  }
+  for ( ; x < iCols; x++ )
+  {
+    uiSum += abs( piOrg[x] - piCur[x] );
+  }
+  return uiSum;
+}
+
+/// SSE of the columns [x, iCols) of one row
+TARGET_SSE41 static SIMD_INLINE UInt xSSERowSSE41( __m128i& rvSum, const Pel* piOrg, const Pel* piCur, Int x, Int iCols, UInt uiShift )
+{
+  __m128i vShift = _mm_cvtsi32_si128( uiShift );
+  UInt    uiSum  = 0;
+  Int     iTemp;
+  
+  for ( ; x + 8 <= iCols; x += 8 )
+  {
+    __m128i vOrg = _mm_loadu_si128( (const __m128i*)&piOrg[x] );
+    __m128i vCur = _mm_loadu_si128( (const __m128i*)&piCur[x] );
+    rvSum = xAddSqrDiff( rvSum, vOrg, vCur, vShift );
+    rvSum = xAddSqrDiff( rvSum, _mm_srli_si128( vOrg, 8 ), _mm_srli_si128( vCur, 8 ), vShift );
+  }
+  if ( x + 4 <= iCols )
+  {
+    rvSum = xAddSqrDiff( rvSum, _mm_loadl_epi64( (const __m128i*)&piOrg[x] ), _mm_loadl_epi64( (const __m128i*)&piCur[x] ), vShift );
+    x += 4;
+  }
+  for ( ; x < iCols; x++ )
+  {
+    iTemp = piOrg[x] - piCur[x];
+    uiSum += ( iTemp * iTemp ) >> uiShift;
+  }
+  return uiSum;
+}
+
+/// SADs of four candidates; each original row is loaded once for all of them
+TARGET_SSE41 static SIMD_INLINE Void xSADMulti4SSE41( const Pel* piOrg, Int iStrideOrg, const Pel* const* ppiCur, Int iStrideCur,
+                                                       Int iRows, Int iCols, Int iSubStep, UInt* puiSum )
+{
+  __m128i avSum[4];
+  UInt    auiSum[4];
+  Int     iOffset = 0;
+  Int     c;
+  
+  for ( c = 0; c < 4; c++ )
+  {
+    avSum[c]  = _mm_setzero_si128();
+    auiSum[c] = 0;
+  }
+  for( ; iRows > 0; iRows-=iSubStep )
+  {
+    Int x = 0;
+    for ( ; x + 8 <= iCols; x += 8 )
+    {
+      __m128i vOrg = _mm_loadu_si128( (const __m128i*)&piOrg[x] );
+      for ( c = 0; c < 4; c++ )
+      {
+        avSum[c] = xAddAbsDiff( avSum[c], vOrg, _mm_loadu_si128( (const __m128i*)&ppiCur[c][iOffset + x] ) );
+      }
+    }
+    if ( x + 4 <= iCols )
+    {
+      __m128i vOrg = _mm_loadl_epi64( (const __m128i*)&piOrg[x] );
+      for ( c = 0; c < 4; c++ )
+      {
+        avSum[c] = xAddAbsDiff( avSum[c], vOrg, _mm_loadl_epi64( (const __m128i*)&ppiCur[c][iOffset + x] ) );
+      }
+      x += 4;
+    }
+    for ( ; x < iCols; x++ )
+    {
+      for ( c = 0; c < 4; c++ )
+      {
+        auiSum[c] += abs( piOrg[x] - ppiCur[c][iOffset + x] );
+      }
+    }
+    piOrg   += iStrideOrg;
+    iOffset += iStrideCur;
+  }
+  for ( c = 0; c < 4; c++ )
+  {
+    puiSum[c] = auiSum[c] + xHorSum( avSum[c] );
+  }
+}
+
+TARGET_SSE41 static SIMD_INLINE Void xButterfly( __m128i& ra, __m128i& rb )
+{
+  __m128i vTmp = ra;
+  ra = _mm_add_epi32( vTmp, rb );
+  rb = _mm_sub_epi32( vTmp, rb );
+}
+
+/// 4-point Hadamard transform across four vectors
+TARGET_SSE41 static SIMD_INLINE Void xHadamard4( __m128i* pv )
+{
+  xButterfly( pv[0], pv[2] ); xButterfly( pv[1], pv[3] );
+  xButterfly( pv[0], pv[1] ); xButterfly( pv[2], pv[3] );
+}
+
+/// 8-point Hadamard transform across eight vectors
+TARGET_SSE41 static SIMD_INLINE Void xHadamard8( __m128i* pv )
+{
+  xButterfly( pv[0], pv[4] ); xButterfly( pv[1], pv[5] ); xButterfly( pv[2], pv[6] ); xButterfly( pv[3], pv[7] );
+  xHadamard4( pv );
+  xHadamard4( pv + 4 );
+}
+
+TARGET_SSE41 static SIMD_INLINE Void xTranspose4x4( __m128i& r0, __m128i& r1, __m128i& r2, __m128i& r3 )
+{
+  __m128i v0 = _mm_unpacklo_epi32( r0, r1 );
+  __m128i v1 = _mm_unpackhi_epi32( r0, r1 );
+  __m128i v2 = _mm_unpacklo_epi32( r2, r3 );
+  __m128i v3 = _mm_unpackhi_epi32( r2, r3 );
+  r0 = _mm_unpacklo_epi64( v0, v2 );
+  r1 = _mm_unpackhi_epi64( v0, v2 );
+  r2 = _mm_unpacklo_epi64( v1, v3 );
+  r3 = _mm_unpackhi_epi64( v1, v3 );
+}
+
+/// org - cur of four samples as 32-bit lanes
+TARGET_SSE41 static SIMD_INLINE __m128i xLoadDiff4( const Pel* piOrg, const Pel* piCur, Int iStep )
+{
+  __m128i vOrg = _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)piOrg ) );
+  __m128i vCur = ( iStep == 1 ? _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)piCur ) )
+                              : _mm_setr_epi32( piCur[0], piCur[iStep], piCur[2*iStep], piCur[3*iStep] ) );
+  return _mm_sub_epi32( vOrg, vCur );
+}
+
+/// same result as TComRdCost::xCalcHADs4x4: the butterfly order differs but the coefficient magnitudes do not
+TARGET_SSE41 static UInt xCalcHADs4x4SSE41( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur, Int iStep )
+{
+  __m128i av[4];
+  
+  for ( Int k = 0; k < 4; k++ )
+  {
+    av[k] = xLoadDiff4( piOrg + k*iStrideOrg, piCur + k*iStrideCur, iStep );
+  }
+  xHadamard4( av );
+  xTranspose4x4( av[0], av[1], av[2], av[3] );
+  xHadamard4( av );
+  
+  __m128i vSum = _mm_add_epi32( _mm_add_epi32( _mm_abs_epi32( av[0] ), _mm_abs_epi32( av[1] ) ),
+                                _mm_add_epi32( _mm_abs_epi32( av[2] ), _mm_abs_epi32( av[3] ) ) );
+  return ( xHorSum( vSum ) + 1 ) >> 1;
+}
+
+/// same result as TComRdCost::xCalcHADs8x8, columns 0-3 and 4-7 kept in separate vectors
+TARGET_SSE41 static UInt xCalcHADs8x8SSE41( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur, Int iStep )
+{
+  __m128i avL[8], avH[8], avColL[8], avColH[8];
+  Int     k;
+  
+  for ( k = 0; k < 8; k++ )
+  {
+    avL[k] = xLoadDiff4( piOrg + k*iStrideOrg,     piCur + k*iStrideCur,           iStep );
+    avH[k] = xLoadDiff4( piOrg + k*iStrideOrg + 4, piCur + k*iStrideCur + 4*iStep, iStep );
+  }
+  xHadamard8( avL );
+  xHadamard8( avH );
+  
+  xTranspose4x4( avL[0], avL[1], avL[2], avL[3] );
+  xTranspose4x4( avL[4], avL[5], avL[6], avL[7] );
+  xTranspose4x4( avH[0], avH[1], avH[2], avH[3] );
+  xTranspose4x4( avH[4], avH[5], avH[6], avH[7] );
+  for ( k = 0; k < 4; k++ )
+  {
+    avColL[k  ] = avL[k];
+    avColH[k  ] = avL[k+4];
+    avColL[k+4] = avH[k];
+    avColH[k+4] = avH[k+4];
+  }
+  xHadamard8( avColL );
+  xHadamard8( avColH );
+  
+  __m128i vSum = _mm_setzero_si128();
+  for ( k = 0; k < 8; k++ )
+  {
+    vSum = _mm_add_epi32( vSum, _mm_add_epi32( _mm_abs_epi32( avColL[k] ), _mm_abs_epi32( avColH[k] ) ) );
+  }
+  return ( xHorSum( vSum ) + 2 ) >> 2;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// AVX2
+// --------------------------------------------------------------------------------------------------------------------
+
+TARGET_AVX2 static SIMD_INLINE __m128i xFoldSum( __m256i vSum )
+{
+  return _mm_add_epi32( _mm256_castsi256_si128( vSum ), _mm256_extracti128_si256( vSum, 1 ) );
+}
+
+TARGET_AVX2 static SIMD_INLINE UInt xSADRowAVX2( __m128i& rvSum, const Pel* piOrg, const Pel* piCur, Int iCols )
+{
+  __m256i vZero = _mm256_setzero_si256();
+  __m256i vSum  = _mm256_setzero_si256();
+  Int     x     = 0;
+  
+  for ( ; x + 16 <= iCols; x += 16 )
+  {
+    __m256i vOrg  = _mm256_loadu_si256( (const __m256i*)&piOrg[x] );
+    __m256i vCur  = _mm256_loadu_si256( (const __m256i*)&piCur[x] );
+    __m256i vDiff = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+    vSum = _mm256_add_epi32( vSum, _mm256_unpacklo_epi16( vDiff, vZero ) );
+    vSum = _mm256_add_epi32( vSum, _mm256_unpackhi_epi16( vDiff, vZero ) );
+  }
+  rvSum = _mm_add_epi32( rvSum, xFoldSum( vSum ) );
+  return xSADRowSSE41( rvSum, piOrg, piCur, x, iCols );
+}
+
+/// SADs of four candidates, the 16-sample wide part of each row in 256-bit registers
+TARGET_AVX2 static SIMD_INLINE Void xSADMulti4AVX2( const Pel* piOrg, Int iStrideOrg, const Pel* const* ppiCur, Int iStrideCur,
+                                                     Int iRows, Int iCols, Int iSubStep, UInt* puiSum )
+{
+  const Pel* apiCurTail[4];
+  Int        iWide = iCols & ~15;
+  Int        c;
+  
+  for ( c = 0; c < 4; c++ )
+  {
+    apiCurTail[c] = ppiCur[c] + iWide;
+  }
+  xSADMulti4SSE41( piOrg + iWide, iStrideOrg, apiCurTail, iStrideCur, iRows, iCols - iWide, iSubStep, puiSum );
+  if ( iWide == 0 )
+  {
+    return;
+  }
+  
+  __m256i vZero = _mm256_setzero_si256();
+  __m256i avSum[4];
+  Int     iOffset = 0;
+  
+  for ( c = 0; c < 4; c++ )
+  {
+    avSum[c] = _mm256_setzero_si256();
+  }
+  for( ; iRows > 0; iRows-=iSubStep )
+  {
+    for ( Int x = 0; x < iWide; x += 16 )
+    {
+      __m256i vOrg = _mm256_loadu_si256( (const __m256i*)&piOrg[x] );
+      for ( c = 0; c < 4; c++ )
+      {
+        __m256i vCur  = _mm256_loadu_si256( (const __m256i*)&ppiCur[c][iOffset + x] );
+        __m256i vDiff = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+        avSum[c] = _mm256_add_epi32( avSum[c], _mm256_unpacklo_epi16( vDiff, vZero ) );
+        avSum[c] = _mm256_add_epi32( avSum[c], _mm256_unpackhi_epi16( vDiff, vZero ) );
+      }
+    }
+    piOrg   += iStrideOrg;
+    iOffset += iStrideCur;
+  }
+  for ( c = 0; c < 4; c++ )
+  {
+    puiSum[c] += xHorSum( xFoldSum( avSum[c] ) );
+  }
+}
+
+TARGET_AVX2 static SIMD_INLINE UInt xSSERowAVX2( __m128i& rvSum, const Pel* piOrg, const Pel* piCur, Int iCols, UInt uiShift )
+{
+  __m128i vShift = _mm_cvtsi32_si128( uiShift );
+  __m256i vSum   = _mm256_setzero_si256();
+  Int     x      = 0;
+  
+  for ( ; x + 8 <= iCols; x += 8 )
+  {
+    __m256i vDiff = _mm256_sub_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)&piOrg[x] ) ),
+                                      _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)&piCur[x] ) ) );
+    vSum = _mm256_add_epi32( vSum, _mm256_srl_epi32( _mm256_mullo_epi32( vDiff, vDiff ), vShift ) );
+  }
+  rvSum = _mm_add_epi32( rvSum, xFoldSum( vSum ) );
+  return xSSERowSSE41( rvSum, piOrg, piCur, x, iCols, uiShift );
+}
+
+TARGET_AVX2 static SIMD_INLINE Void xButterfly( __m256i& ra, __m256i& rb )
+{
+  __m256i vTmp = ra;
+  ra = _mm256_add_epi32( vTmp, rb );
+  rb = _mm256_sub_epi32( vTmp, rb );
+}
+
+TARGET_AVX2 static SIMD_INLINE Void xHadamard8( __m256i* pv )
+{
+  xButterfly( pv[0], pv[4] ); xButterfly( pv[1], pv[5] ); xButterfly( pv[2], pv[6] ); xButterfly( pv[3], pv[7] );
+  xButterfly( pv[0], pv[2] ); xButterfly( pv[1], pv[3] ); xButterfly( pv[4], pv[6] ); xButterfly( pv[5], pv[7] );
+  xButterfly( pv[0], pv[1] ); xButterfly( pv[2], pv[3] ); xButterfly( pv[4], pv[5] ); xButterfly( pv[6], pv[7] );
+}
+
+TARGET_AVX2 static SIMD_INLINE Void xTranspose8x8( __m256i* pv )
+{
+  __m256i av[8], aw[8];
+  Int     k;
+  
+  for ( k = 0; k < 8; k += 2 )
+  {
+    av[k  ] = _mm256_unpacklo_epi32( pv[k], pv[k+1] );
+    av[k+1] = _mm256_unpackhi_epi32( pv[k], pv[k+1] );
+  }
+  for ( k = 0; k < 8; k += 4 )
+  {
+    aw[k  ] = _mm256_unpacklo_epi64( av[k  ], av[k+2] );
+    aw[k+1] = _mm256_unpackhi_epi64( av[k  ], av[k+2] );
+    aw[k+2] = _mm256_unpacklo_epi64( av[k+1], av[k+3] );
+    aw[k+3] = _mm256_unpackhi_epi64( av[k+1], av[k+3] );
+  }
+  for ( k = 0; k < 4; k++ )
+  {
+    pv[k  ] = _mm256_permute2x128_si256( aw[k], aw[k+4], 0x20 );
+    pv[k+4] = _mm256_permute2x128_si256( aw[k], aw[k+4], 0x31 );
+  }
+}
+
+/// same result as TComRdCost::xCalcHADs8x8, one row per vector
+TARGET_AVX2 static UInt xCalcHADs8x8AVX2( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur, Int iStep )
+{
+  __m256i av[8];
+  Int     k;
+  
+  for ( k = 0; k < 8; k++ )
+  {
+    const Pel* pCur = piCur + k*iStrideCur;
+    __m256i    vCur = ( iStep == 1 ? _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)pCur ) )
+                                   : _mm256_setr_epi32( pCur[0      ], pCur[  iStep], pCur[2*iStep], pCur[3*iStep],
+                                                        pCur[4*iStep], pCur[5*iStep], pCur[6*iStep], pCur[7*iStep] ) );
+    av[k] = _mm256_sub_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)( piOrg + k*iStrideOrg ) ) ), vCur );
+  }
+  xHadamard8( av );
+  xTranspose8x8( av );
+  xHadamard8( av );
+  
+  __m256i vSum = _mm256_setzero_si256();
+  for ( k = 0; k < 8; k++ )
+  {
+    vSum = _mm256_add_epi32( vSum, _mm256_abs_epi32( av[k] ) );
+  }
+  return ( xHorSum( xFoldSum( vSum ) ) + 2 ) >> 2;
+}
+
+#endif
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+// defined ahead of initDistortionFunc() so that each instantiation is compiled for its instruction set
+#if RDCOST_SIMD
+
+// --------------------------------------------------------------------------------------------------------------------
+// SAD
+// --------------------------------------------------------------------------------------------------------------------
+
+/// the fixed width kernels honour row sub-sampling, the kernel for any width does not (as in TComRdCost)
+template <Int iWidth>
+TARGET_SSE41 UInt TComRdCostSIMD::xGetSAD_SSE41( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iSubShift  = ( iWidth != 0 ? pcDtParam->iSubShift : 0 );
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  __m128i vSum  = _mm_setzero_si128();
+  UInt    uiSum = 0;
+  
+  for( ; iRows > 0; iRows-=iSubStep )
+  {
+    uiSum += xSADRowSSE41( vSum, piOrg, piCur, 0, iCols );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  uiSum += xHorSum( vSum );
+  uiSum <<= iSubShift;
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+template <Int iWidth>
+TARGET_AVX2 UInt TComRdCostSIMD::xGetSAD_AVX2( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iSubShift  = ( iWidth != 0 ? pcDtParam->iSubShift : 0 );
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  __m128i vSum  = _mm_setzero_si128();
+  UInt    uiSum = 0;
+  
+  for( ; iRows > 0; iRows-=iSubStep )
+  {
+    uiSum += xSADRowAVX2( vSum, piOrg, piCur, iCols );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  uiSum += xHorSum( vSum );
+  uiSum <<= iSubShift;
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+/// candidates are taken four at a time, a short last group repeats its last candidate
+template <Int iWidth>
+TARGET_SSE41 Void TComRdCostSIMD::xGetSADMulti_SSE41( DistParam* pcDtParam, const Int* piOffsets, Int iNumCand, UInt* puiSad )
+{
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iSubShift  = ( iWidth != 0 ? pcDtParam->iSubShift : 0 );
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  for ( Int i = 0; i < iNumCand; i += 4 )
+  {
+    const Pel* apiCur[4];
+    UInt       auiSum[4];
+    Int        c;
+    for ( c = 0; c < 4; c++ )
+    {
+      apiCur[c] = pcDtParam->pCur + piOffsets[ i + c < iNumCand ? i + c : iNumCand - 1 ];
+    }
+    xSADMulti4SSE41( pcDtParam->pOrg, iStrideOrg, apiCur, iStrideCur, pcDtParam->iRows, iCols, iSubStep, auiSum );
+    for ( c = 0; c < 4 && i + c < iNumCand; c++ )
+    {
+      puiSad[i + c] = ( auiSum[c] << iSubShift ) >> g_uiBitIncrement;
+    }
+  }
+}
+
+template <Int iWidth>
+TARGET_AVX2 Void TComRdCostSIMD::xGetSADMulti_AVX2( DistParam* pcDtParam, const Int* piOffsets, Int iNumCand, UInt* puiSad )
+{
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iSubShift  = ( iWidth != 0 ? pcDtParam->iSubShift : 0 );
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  for ( Int i = 0; i < iNumCand; i += 4 )
+  {
+    const Pel* apiCur[4];
+    UInt       auiSum[4];
+    Int        c;
+    for ( c = 0; c < 4; c++ )
+    {
+      apiCur[c] = pcDtParam->pCur + piOffsets[ i + c < iNumCand ? i + c : iNumCand - 1 ];
+    }
+    xSADMulti4AVX2( pcDtParam->pOrg, iStrideOrg, apiCur, iStrideCur, pcDtParam->iRows, iCols, iSubStep, auiSum );
+    for ( c = 0; c < 4 && i + c < iNumCand; c++ )
+    {
+      puiSad[i + c] = ( auiSum[c] << iSubShift ) >> g_uiBitIncrement;
+    }
+  }
+}
+
+/// rows are never sub-sampled; a step other than one (interpolated buffer) stays in C
+template <Int iWidth>
+TARGET_SSE41 UInt TComRdCostSIMD::xGetSADs_SSE41( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  
+  if ( pcDtParam->iStep != 1 )
+  {
+    return ( xSADStep( piOrg, iStrideOrg, piCur, iStrideCur, iRows, iCols, pcDtParam->iStep ) >> g_uiBitIncrement );
+  }
+  
+  __m128i vSum  = _mm_setzero_si128();
+  UInt    uiSum = 0;
+  
+  for( ; iRows != 0; iRows-- )
+  {
+    uiSum += xSADRowSSE41( vSum, piOrg, piCur, 0, iCols );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  uiSum += xHorSum( vSum );
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+template <Int iWidth>
+TARGET_AVX2 UInt TComRdCostSIMD::xGetSADs_AVX2( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  
+  if ( pcDtParam->iStep != 1 )
+  {
+    return ( xSADStep( piOrg, iStrideOrg, piCur, iStrideCur, iRows, iCols, pcDtParam->iStep ) >> g_uiBitIncrement );
+  }
+  
+  __m128i vSum  = _mm_setzero_si128();
+  UInt    uiSum = 0;
+  
+  for( ; iRows != 0; iRows-- )
+  {
+    uiSum += xSADRowAVX2( vSum, piOrg, piCur, iCols );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  uiSum += xHorSum( vSum );
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// SSE
+// --------------------------------------------------------------------------------------------------------------------
+
+template <Int iWidth>
+TARGET_SSE41 UInt TComRdCostSIMD::xGetSSE_SSE41( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  
+  __m128i vSum    = _mm_setzero_si128();
+  UInt    uiSum   = 0;
+  UInt    uiShift = g_uiBitIncrement<<1;
+  
+  for( ; iRows != 0; iRows-- )
+  {
+    uiSum += xSSERowSSE41( vSum, piOrg, piCur, 0, iCols, uiShift );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  return ( uiSum + xHorSum( vSum ) );
+}
+
+template <Int iWidth>
+TARGET_AVX2 UInt TComRdCostSIMD::xGetSSE_AVX2( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = xBlockWidth<iWidth>( pcDtParam->iCols );
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  
+  __m128i vSum    = _mm_setzero_si128();
+  UInt    uiSum   = 0;
+  UInt    uiShift = g_uiBitIncrement<<1;
+  
+  for( ; iRows != 0; iRows-- )
+  {
+    uiSum += xSSERowAVX2( vSum, piOrg, piCur, iCols, uiShift );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  return ( uiSum + xHorSum( vSum ) );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Hadamard
+// --------------------------------------------------------------------------------------------------------------------
+
+/// block sizes that are not a multiple of 4 go to the C kernel
+TARGET_SSE41 UInt TComRdCostSIMD::xGetHADs_SSE41( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = pcDtParam->iCols;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  Int  iStep      = pcDtParam->iStep;
+  
+  Int  x, y;
+  
+  UInt uiSum = 0;
+  
+  if( ( iRows % 8 == 0) && (iCols % 8 == 0) )
+  {
+    for ( y=0; y<iRows; y+= 8 )
+    {
+      for ( x=0; x<iCols; x+= 8 )
+      {
+        uiSum += xCalcHADs8x8SSE41( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep );
+      }
+      piOrg += iStrideOrg<<3;
+      piCur += iStrideCur<<3;
+    }
+  }
+  else if( ( iRows % 4 == 0) && (iCols % 4 == 0) )
+  {
+    for ( y=0; y<iRows; y+= 4 )
+    {
+      for ( x=0; x<iCols; x+= 4 )
+      {
+        uiSum += xCalcHADs4x4SSE41( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep );
+      }
+      piOrg += iStrideOrg<<2;
+      piCur += iStrideCur<<2;
+    }
+  }
+  else
+  {
+    return TComRdCost::xGetHADs( pcDtParam );
+  }
+  
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+TARGET_AVX2 UInt TComRdCostSIMD::xGetHADs_AVX2( DistParam* pcDtParam )
+{
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = pcDtParam->iCols;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  Int  iStep      = pcDtParam->iStep;
+  
+  Int  x, y;
+  
+  UInt uiSum = 0;
+  
+  if( ( iRows % 8 == 0) && (iCols % 8 == 0) )
+  {
+    for ( y=0; y<iRows; y+= 8 )
+    {
+      for ( x=0; x<iCols; x+= 8 )
+      {
+        uiSum += xCalcHADs8x8AVX2( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep );
+      }
+      piOrg += iStrideOrg<<3;
+      piCur += iStrideCur<<3;
+    }
+  }
+  else
+  {
+    return xGetHADs_SSE41( pcDtParam );
+  }
+  
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+#endif
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Highest kernel level the running CPU (and OS) supports.
+ * \returns SIMD_NONE, SIMD_SSE41 or SIMD_AVX2
+ */
+Int TComRdCostSIMD::getCPULevel()
+{
+#if RDCOST_SIMD && defined(__GNUC__)
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports( "avx2" ) )
+  {
+    return SIMD_AVX2;
+  }
+  if ( __builtin_cpu_supports( "sse4.1" ) )
+  {
+    return SIMD_SSE41;
+  }
+#elif RDCOST_SIMD && defined(_MSC_VER)
+  Int aiRegs[4];
+  __cpuid( aiRegs, 0 );
+  Int  iMaxLeaf = aiRegs[0];
+  __cpuid( aiRegs, 1 );
+  Bool bSSE41   = ( ( aiRegs[2] >> 19 ) & 1 ) != 0;
+  Bool bAVX     = ( ( aiRegs[2] >> 27 ) & 1 ) && ( ( aiRegs[2] >> 28 ) & 1 ) && ( _xgetbv( 0 ) & 6 ) == 6;
+  if ( bAVX && iMaxLeaf >= 7 )
+  {
+    __cpuidex( aiRegs, 7, 0 );
+    if ( ( aiRegs[1] >> 5 ) & 1 )
+    {
+      return SIMD_AVX2;
+    }
+  }
+  if ( bSSE41 )
+  {
+    return SIMD_SSE41;
+  }
+#endif
+  return SIMD_NONE;
+}
+
+/** Replace the C kernels of a TComRdCost table by vectorised ones.
+ * \param afpDistortFunc table filled with the C kernels
+ * \param afpDistortFuncMulti table of the multi-candidate SAD kernels, filled with the C kernels
+ * \param iLevel requested SIMDLevel, SIMD_AUTO or a level above the CPU level selects the CPU level
+ * \returns level actually used
+ */
+Int TComRdCostSIMD::initDistortionFunc( FpDistFunc* afpDistortFunc, FpDistFuncMulti* afpDistortFuncMulti, Int iLevel )
+{
+  Int iCPULevel = getCPULevel();
+  if ( iLevel < 0 || iLevel > iCPULevel )
+  {
+    iLevel = iCPULevel;
+  }
+  
+#if RDCOST_SIMD
+  if ( iLevel >= SIMD_SSE41 )
+  {
+#if !IBDI_DISTORTION
+    afpDistortFunc[1]  = xGetSSE_SSE41<0>;
+    afpDistortFunc[2]  = xGetSSE_SSE41<4>;
+    afpDistortFunc[3]  = xGetSSE_SSE41<8>;
+    afpDistortFunc[4]  = xGetSSE_SSE41<16>;
+    afpDistortFunc[5]  = xGetSSE_SSE41<32>;
+    afpDistortFunc[6]  = xGetSSE_SSE41<64>;
+    afpDistortFunc[7]  = xGetSSE_SSE41<-16>;
+#endif
+    
+    afpDistortFunc[8]  = xGetSAD_SSE41<0>;
+    afpDistortFunc[9]  = xGetSAD_SSE41<4>;
+    afpDistortFunc[10] = xGetSAD_SSE41<8>;
+    afpDistortFunc[11] = xGetSAD_SSE41<16>;
+    afpDistortFunc[12] = xGetSAD_SSE41<32>;
+    afpDistortFunc[13] = xGetSAD_SSE41<64>;
+    afpDistortFunc[14] = xGetSAD_SSE41<-16>;
+    
+    afpDistortFuncMulti[8]  = xGetSADMulti_SSE41<0>;
+    afpDistortFuncMulti[9]  = xGetSADMulti_SSE41<4>;
+    afpDistortFuncMulti[10] = xGetSADMulti_SSE41<8>;
+    afpDistortFuncMulti[11] = xGetSADMulti_SSE41<16>;
+    afpDistortFuncMulti[12] = xGetSADMulti_SSE41<32>;
+    afpDistortFuncMulti[13] = xGetSADMulti_SSE41<64>;
+    afpDistortFuncMulti[14] = xGetSADMulti_SSE41<-16>;
+    
+    afpDistortFunc[15] = xGetSADs_SSE41<0>;
+    afpDistortFunc[16] = xGetSADs_SSE41<4>;
+    afpDistortFunc[17] = xGetSADs_SSE41<8>;
+    afpDistortFunc[18] = xGetSADs_SSE41<16>;
+    afpDistortFunc[19] = xGetSADs_SSE41<32>;
+    afpDistortFunc[20] = xGetSADs_SSE41<64>;
+    afpDistortFunc[21] = xGetSADs_SSE41<-16>;
+    
+    afpDistortFunc[22] = xGetHADs_SSE41;
+#ifdef DCM_RDCOST_TEMP_FIX
+    afpDistortFunc[23] = xGetHADs_SSE41;
+    afpDistortFunc[24] = xGetHADs_SSE41;
+#endif
+    afpDistortFunc[25] = xGetHADs_SSE41;
+    afpDistortFunc[26] = xGetHADs_SSE41;
+    afpDistortFunc[27] = xGetHADs_SSE41;
+    afpDistortFunc[28] = xGetHADs_SSE41;
+  }
+  
+  // 4-sample wide blocks gain nothing from 256-bit registers and keep the SSE4.1 kernels
+  if ( iLevel >= SIMD_AVX2 )
+  {
+#if !IBDI_DISTORTION
+    afpDistortFunc[1]  = xGetSSE_AVX2<0>;
+    afpDistortFunc[3]  = xGetSSE_AVX2<8>;
+    afpDistortFunc[4]  = xGetSSE_AVX2<16>;
+    afpDistortFunc[5]  = xGetSSE_AVX2<32>;
+    afpDistortFunc[6]  = xGetSSE_AVX2<64>;
+    afpDistortFunc[7]  = xGetSSE_AVX2<-16>;
+#endif
+    
+    afpDistortFunc[8]  = xGetSAD_AVX2<0>;
+    afpDistortFunc[11] = xGetSAD_AVX2<16>;
+    afpDistortFunc[12] = xGetSAD_AVX2<32>;
+    afpDistortFunc[13] = xGetSAD_AVX2<64>;
+    afpDistortFunc[14] = xGetSAD_AVX2<-16>;
+    
+    afpDistortFuncMulti[8]  = xGetSADMulti_AVX2<0>;
+    afpDistortFuncMulti[11] = xGetSADMulti_AVX2<16>;
+    afpDistortFuncMulti[12] = xGetSADMulti_AVX2<32>;
+    afpDistortFuncMulti[13] = xGetSADMulti_AVX2<64>;
+    afpDistortFuncMulti[14] = xGetSADMulti_AVX2<-16>;
+    
+    afpDistortFunc[15] = xGetSADs_AVX2<0>;
+    afpDistortFunc[18] = xGetSADs_AVX2<16>;
+    afpDistortFunc[19] = xGetSADs_AVX2<32>;
+    afpDistortFunc[20] = xGetSADs_AVX2<64>;
+    afpDistortFunc[21] = xGetSADs_AVX2<-16>;
+    
+    afpDistortFunc[22] = xGetHADs_AVX2;
+#ifdef DCM_RDCOST_TEMP_FIX
+    afpDistortFunc[23] = xGetHADs_AVX2;
+    afpDistortFunc[24] = xGetHADs_AVX2;
+#endif
+    afpDistortFunc[25] = xGetHADs_AVX2;
+    afpDistortFunc[26] = xGetHADs_AVX2;
+    afpDistortFunc[27] = xGetHADs_AVX2;
+    afpDistortFunc[28] = xGetHADs_AVX2;
+  }
+#endif
+  
+  return iLevel;
+}
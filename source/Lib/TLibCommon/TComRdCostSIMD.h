@@ -0,0 +1,86 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComRdCostSIMD.h
+    \brief    SSE4.1 / AVX2 distortion kernels selected at run time (header)
+*/
+
+#ifndef __TCOMRDCOSTSIMD__
+#define __TCOMRDCOSTSIMD__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TComRdCost.h"
+
+// ====================================================================================================================
+// Type definition
+// ====================================================================================================================
+
+/// instruction sets the distortion kernels can be dispatched to
+enum SIMDLevel
+{
+  SIMD_AUTO  = -1,                              ///< best level supported by the running CPU
+  SIMD_NONE  =  0,                              ///< portable C kernels of TComRdCost
+  SIMD_SSE41 =  1,                              ///< SSE4.1
+  SIMD_AVX2  =  2                               ///< AVX2
+};
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// vectorised SAD, SSE and Hadamard kernels, bit-exact with the C kernels of TComRdCost
+class TComRdCostSIMD
+{
+public:
+  static Int  getCPULevel         ();
+  static Int  initDistortionFunc  ( FpDistFunc* afpDistortFunc, FpDistFuncMulti* afpDistortFuncMulti, Int iLevel );
+  
+private:
+  // iWidth: fixed block width, 0 = any width, -16 = any multiple of 16 (same as the C kernel of the table entry)
+  template <Int iWidth> static UInt xGetSAD_SSE41   ( DistParam* pcDtParam );
+  template <Int iWidth> static Void xGetSADMulti_SSE41( DistParam* pcDtParam, const Int* piOffsets, Int iNumCand, UInt* puiSad );
+  template <Int iWidth> static UInt xGetSADs_SSE41  ( DistParam* pcDtParam );
+  template <Int iWidth> static UInt xGetSSE_SSE41   ( DistParam* pcDtParam );
+  static UInt xGetHADs_SSE41  ( DistParam* pcDtParam );
+  
+  template <Int iWidth> static UInt xGetSAD_AVX2    ( DistParam* pcDtParam );
+  template <Int iWidth> static Void xGetSADMulti_AVX2 ( DistParam* pcDtParam, const Int* piOffsets, Int iNumCand, UInt* puiSad );
+  template <Int iWidth> static UInt xGetSADs_AVX2   ( DistParam* pcDtParam );
+  template <Int iWidth> static UInt xGetSSE_AVX2    ( DistParam* pcDtParam );
+  static UInt xGetHADs_AVX2   ( DistParam* pcDtParam );
+};// END CLASS DEFINITION TComRdCostSIMD
+
+#endif // __TCOMRDCOSTSIMD__
@@ -0,0 +1,362 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComScale.cpp
+    \brief    picture resampling for adaptive resolution change
+*/
+
+#include <math.h>
+#include <memory.h>
+#include <assert.h>
+#include "TComScale.h"
+
+// ====================================================================================================================
+// Tables
+// ====================================================================================================================
+
+/// 8-tap luma up-sampling filter, tap 3 is the integer sample position
+static const Int g_aaiScaleUpLuma[SCALE_NUM_PHASE][8] =
+{
+  {  0, 0,   0, 64,  0,   0, 0,  0 },
+  {  0, 1,  -3, 63,  4,  -2, 1,  0 },
+  { -1, 2,  -5, 62,  8,  -3, 1,  0 },
+  { -1, 3,  -8, 60, 13,  -4, 1,  0 },
+  { -1, 4, -10, 58, 17,  -5, 1,  0 },
+  { -1, 4, -11, 52, 26,  -8, 3, -1 },
+  { -1, 3,  -9, 47, 31, -10, 4, -1 },
+  { -1, 4, -11, 45, 34, -10, 4, -1 },
+  { -1, 4, -11, 40, 40, -11, 4, -1 },
+  { -1, 4, -10, 34, 45, -11, 4, -1 },
+  { -1, 4, -10, 31, 47,  -9, 3, -1 },
+  { -1, 3,  -8, 26, 52, -11, 4, -1 },
+  {  0, 1,  -5, 17, 58, -10, 4, -1 },
+  {  0, 1,  -4, 13, 60,  -8, 3, -1 },
+  {  0, 1,  -3,  8, 62,  -5, 2, -1 },
+  {  0, 1,  -2,  4, 63,  -3, 1,  0 }
+};
+
+/// 4-tap chroma up-sampling filter, tap 1 is the integer sample position
+static const Int g_aaiScaleUpChroma[SCALE_NUM_PHASE][4] =
+{
+  {  0, 64,  0,  0 },
+  { -2, 62,  4,  0 },
+  { -2, 58, 10, -2 },
+  { -4, 56, 14, -2 },
+  { -4, 54, 16, -2 },
+  { -6, 52, 20, -2 },
+  { -6, 46, 28, -4 },
+  { -4, 42, 30, -4 },
+  { -4, 36, 36, -4 },
+  { -4, 30, 42, -4 },
+  { -4, 28, 46, -6 },
+  { -2, 20, 52, -6 },
+  { -2, 16, 54, -4 },
+  { -2, 14, 56, -4 },
+  {  0, 10, 58, -2 },
+  {  0,  4, 62, -2 }
+};
+
+static inline Double xSinc( Double x )
+{
+  const Double dPi = 3.14159265358979323846;
+  return ( fabs( x ) < 1e-9 ) ? 1.0 : sin( dPi * x ) / ( dPi * x );
+}
+
+// ====================================================================================================================
+// Constructor / destructor
+// ====================================================================================================================
+
+TComScale::TComScale()
+: m_piPos    ( NULL )
+, m_piPhase  ( NULL )
+, m_iPosSize ( 0 )
+, m_piTmp    ( NULL )
+, m_iTmpSize ( 0 )
+{
+  m_aiTaps[0] = m_aiTaps[1] = 0;
+}
+
+TComScale::~TComScale()
+{
+  destroy();
+}
+
+Void TComScale::destroy()
+{
+  if ( m_piPos   ) { delete [] m_piPos;   m_piPos   = NULL; }
+  if ( m_piPhase ) { delete [] m_piPhase; m_piPhase = NULL; }
+  if ( m_piTmp   ) { xFree( m_piTmp );    m_piTmp   = NULL; }
+  m_iPosSize = 0;
+  m_iTmpSize = 0;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+Void TComScale::resample( TComPicYuv* pcSrc, TComPicYuv* pcDst )
+{
+  // the filters read up to SCALE_MAX_TAPS/2 samples beyond the picture edge from the padded planes
+  pcSrc->extendPicBorder();
+
+  Int iSrcW = pcSrc->getWidth();
+  Int iSrcH = pcSrc->getHeight();
+  Int iDstW = pcDst->getWidth();
+  Int iDstH = pcDst->getHeight();
+
+  xResamplePlane( pcSrc->getLumaAddr(), pcSrc->getStride(),  iSrcW,      iSrcH,      pcDst->getLumaAddr(), pcDst->getStride(),  iDstW,      iDstH,      false );
+  xResamplePlane( pcSrc->getCbAddr(),   pcSrc->getCStride(), iSrcW >> 1, iSrcH >> 1, pcDst->getCbAddr(),   pcDst->getCStride(), iDstW >> 1, iDstH >> 1, true  );
+  xResamplePlane( pcSrc->getCrAddr(),   pcSrc->getCStride(), iSrcW >> 1, iSrcH >> 1, pcDst->getCrAddr(),   pcDst->getCStride(), iDstW >> 1, iDstH >> 1, true  );
+
+  pcDst->setBorderExtension( false );
+}
+
+// ====================================================================================================================
+// Protected member functions
+// ====================================================================================================================
+
+/** Set up the polyphase filter bank of one direction.
+ * \param iSrcLen  number of input samples
+ * \param iDstLen  number of output samples
+ * \param bChroma  chroma plane
+ * \param iDir     0: horizontal, 1: vertical
+ * Up-sampling uses fixed 8-tap (luma) and 4-tap (chroma) interpolation filters. Down-sampling uses a 12-tap
+ * Lanczos-windowed sinc whose cut-off follows the scaling ratio, quantised to SCALE_COEF_BITS.
+ */
+Void TComScale::xInitFilter( Int iSrcLen, Int iDstLen, Bool bChroma, Int iDir )
+{
+  Int (*paaiCoef)[SCALE_MAX_TAPS] = m_aaaiCoef[iDir];
+
+  if ( iDstLen >= iSrcLen )
+  {
+    m_aiTaps[iDir] = bChroma ? 4 : 8;
+    for ( Int iPhase = 0; iPhase < SCALE_NUM_PHASE; iPhase++ )
+    {
+      for ( Int k = 0; k < m_aiTaps[iDir]; k++ )
+      {
+        paaiCoef[iPhase][k] = bChroma ? g_aaiScaleUpChroma[iPhase][k] : g_aaiScaleUpLuma[iPhase][k];
+      }
+    }
+    return;
+  }
+
+  const Int    iTaps   = SCALE_MAX_TAPS;
+  const Int    iCenter = ( iTaps >> 1 ) - 1;
+  const Double dRatio  = (Double)iDstLen / (Double)iSrcLen;
+  const Double dLobes  = (Double)( iTaps >> 1 );
+
+  m_aiTaps[iDir] = iTaps;
+  for ( Int iPhase = 0; iPhase < SCALE_NUM_PHASE; iPhase++ )
+  {
+    Double adCoef[SCALE_MAX_TAPS];
+    Double dSum = 0.0;
+    for ( Int k = 0; k < iTaps; k++ )
+    {
+      Double dDist = (Double)( k - iCenter ) - (Double)iPhase / SCALE_NUM_PHASE;
+      adCoef[k]    = ( fabs( dDist ) < dLobes ) ? dRatio * xSinc( dRatio * dDist ) * xSinc( dDist / dLobes ) : 0.0;
+      dSum        += adCoef[k];
+    }
+
+    Int iSum  = 0;
+    Int iPeak = 0;
+    for ( Int k = 0; k < iTaps; k++ )
+    {
+      paaiCoef[iPhase][k] = (Int)floor( adCoef[k] / dSum * ( 1 << SCALE_COEF_BITS ) + 0.5 );
+      iSum += paaiCoef[iPhase][k];
+      if ( adCoef[k] > adCoef[iPeak] )
+      {
+        iPeak = k;
+      }
+    }
+    // keep the DC gain exact
+    paaiCoef[iPhase][iPeak] += ( 1 << SCALE_COEF_BITS ) - iSum;
+  }
+}
+
+/** Derive, for each output sample, the first input sample of the filter support and the filter phase.
+ * Sample centres of both grids are aligned, positions are computed in 1/SCALE_NUM_PHASE sample units.
+ */
+Void TComScale::xInitPosition( Int iSrcLen, Int iDstLen, Int iTaps, Int* piPos, Int* piPhase )
+{
+  const Int   iCenter = ( iTaps >> 1 ) - 1;
+  const Int64 iDen    = 2 * (Int64)iDstLen;
+
+  for ( Int i = 0; i < iDstLen; i++ )
+  {
+    Int64 iNum = ( 2 * (Int64)i + 1 ) * iSrcLen * SCALE_NUM_PHASE - (Int64)SCALE_NUM_PHASE * iDstLen;
+    Int64 iPos = ( iNum >= 0 ) ? iNum / iDen : -( ( -iNum + iDen - 1 ) / iDen );
+
+    piPos  [i] = (Int)( iPos >> SCALE_PHASE_BITS ) - iCenter;
+    piPhase[i] = (Int)( iPos & ( SCALE_NUM_PHASE - 1 ) );
+  }
+}
+
+/** Horizontal pass: filter iRows rows of the padded source plane into the intermediate buffer.
+ * The intermediate values keep the full SCALE_COEF_BITS precision.
+ */
+template <Int N>
+Void TComScale::xFilterHor( const Pel* piSrc, Int iSrcStride, Int iRows, Int* piDst, Int iDstWidth, const Int* piPos, const Int* piPhase )
+{
+  const Int (*paaiCoef)[SCALE_MAX_TAPS] = m_aaaiCoef[0];
+
+  for ( Int y = 0; y < iRows; y++ )
+  {
+    for ( Int x = 0; x < iDstWidth; x++ )
+    {
+      const Pel* piS = piSrc + piPos[x];
+      const Int* piC = paaiCoef[ piPhase[x] ];
+      Int iSum = 0;
+      for ( Int k = 0; k < N; k++ )
+      {
+        iSum += piC[k] * piS[k];
+      }
+      piDst[x] = iSum;
+    }
+    piSrc += iSrcStride;
+    piDst += iDstWidth;
+  }
+}
+
+/** Vertical pass: filter the intermediate rows into the destination plane, round and clip.
+ * The inner loop runs along a row so that it maps directly onto SIMD multiply-accumulate.
+ */
+template <Int N>
+Void TComScale::xFilterVer( const Int* piSrc, Int iSrcWidth, Pel* piDst, Int iDstStride, Int iDstHeight, const Int* piPos, const Int* piPhase )
+{
+  const Int (*paaiCoef)[SCALE_MAX_TAPS] = m_aaaiCoef[1];
+  const Int iShift  = SCALE_COEF_BITS << 1;
+  const Int iOffset = 1 << ( iShift - 1 );
+  const Int iMaxVal = (Int)g_uiIBDI_MAX;
+
+  for ( Int y = 0; y < iDstHeight; y++ )
+  {
+    const Int* piS = piSrc + piPos[y] * iSrcWidth;
+    const Int* piC = paaiCoef[ piPhase[y] ];
+    for ( Int x = 0; x < iSrcWidth; x++ )
+    {
+      Int iSum = 0;
+      for ( Int k = 0; k < N; k++ )
+      {
+        iSum += piC[k] * piS[ k * iSrcWidth + x ];
+      }
+      iSum = ( iSum + iOffset ) >> iShift;
+      piDst[x] = (Pel)Clip3( 0, iMaxVal, iSum );
+    }
+    piDst += iDstStride;
+  }
+}
+
+Void TComScale::xResamplePlane( const Pel* piSrc, Int iSrcStride, Int iSrcWidth, Int iSrcHeight,
+                                Pel* piDst, Int iDstStride, Int iDstWidth, Int iDstHeight, Bool bChroma )
+{
+  if ( iSrcWidth == iDstWidth && iSrcHeight == iDstHeight )
+  {
+    for ( Int y = 0; y < iDstHeight; y++ )
+    {
+      ::memcpy( piDst + y * iDstStride, piSrc + y * iSrcStride, sizeof(Pel) * iDstWidth );
+    }
+    return;
+  }
+
+  xInitFilter( iSrcWidth,  iDstWidth,  bChroma, 0 );
+  xInitFilter( iSrcHeight, iDstHeight, bChroma, 1 );
+
+  if ( m_iPosSize < iDstWidth + iDstHeight )
+  {
+    if ( m_piPos   ) { delete [] m_piPos;   }
+    if ( m_piPhase ) { delete [] m_piPhase; }
+    m_iPosSize = iDstWidth + iDstHeight;
+    m_piPos    = new Int[ m_iPosSize ];
+    m_piPhase  = new Int[ m_iPosSize ];
+  }
+  Int* piPosHor   = m_piPos;
+  Int* piPhaseHor = m_piPhase;
+  Int* piPosVer   = m_piPos   + iDstWidth;
+  Int* piPhaseVer = m_piPhase + iDstWidth;
+
+  xInitPosition( iSrcWidth,  iDstWidth,  m_aiTaps[0], piPosHor, piPhaseHor );
+  xInitPosition( iSrcHeight, iDstHeight, m_aiTaps[1], piPosVer, piPhaseVer );
+
+  // only the source rows covered by the vertical filter support are filtered horizontally
+  Int iRowFirst = piPosVer[0];
+  Int iRows     = piPosVer[iDstHeight-1] + m_aiTaps[1] - iRowFirst;
+  for ( Int y = 0; y < iDstHeight; y++ )
+  {
+    piPosVer[y] -= iRowFirst;
+  }
+
+  if ( m_iTmpSize < iRows * iDstWidth )
+  {
+    if ( m_piTmp ) { xFree( m_piTmp ); }
+    m_iTmpSize = iRows * iDstWidth;
+    m_piTmp    = (Int*)xMalloc( Int, m_iTmpSize );
+  }
+
+  const Pel* piSrcRows = piSrc + iRowFirst * iSrcStride;
+  switch ( m_aiTaps[0] )
+  {
+    case 4:  xFilterHor<4> ( piSrcRows, iSrcStride, iRows, m_piTmp, iDstWidth, piPosHor, piPhaseHor ); break;
+    case 8:  xFilterHor<8> ( piSrcRows, iSrcStride, iRows, m_piTmp, iDstWidth, piPosHor, piPhaseHor ); break;
+    case 12: xFilterHor<12>( piSrcRows, iSrcStride, iRows, m_piTmp, iDstWidth, piPosHor, piPhaseHor ); break;
+    default: assert( 0 ); break;
+  }
+  switch ( m_aiTaps[1] )
+  {
+    case 4:  xFilterVer<4> ( m_piTmp, iDstWidth, piDst, iDstStride, iDstHeight, piPosVer, piPhaseVer ); break;
+    case 8:  xFilterVer<8> ( m_piTmp, iDstWidth, piDst, iDstStride, iDstHeight, piPosVer, piPhaseVer ); break;
+    case 12: xFilterVer<12>( m_piTmp, iDstWidth, piDst, iDstStride, iDstHeight, piPosVer, piPhaseVer ); break;
+    default: assert( 0 ); break;
+  }
+}
+
+// ====================================================================================================================
+// Resolution level conversion
+// ====================================================================================================================
+
+Void downScale( Int iFromLevel, Int iToLevel, TComPicYuv* pcSrc, TComPicYuv* pcDst )
+{
+  assert( iToLevel > iFromLevel );
+  assert( pcDst->getWidth() <= pcSrc->getWidth() && pcDst->getHeight() <= pcSrc->getHeight() );
+
+  TComScale cScale;
+  cScale.resample( pcSrc, pcDst );
+}
+
+Void upScale( Int iFromLevel, Int iToLevel, TComPicYuv* pcSrc, TComPicYuv* pcDst )
+{
+  assert( iToLevel < iFromLevel );
+  assert( pcDst->getWidth() >= pcSrc->getWidth() && pcDst->getHeight() >= pcSrc->getHeight() );
+
+  TComScale cScale;
+  cScale.resample( pcSrc, pcDst );
+}
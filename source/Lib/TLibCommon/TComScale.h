@@ -0,0 +1,93 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComScale.h
+    \brief    picture resampling for adaptive resolution change (header)
+*/
+
+#ifndef __TCOMSCALE__
+#define __TCOMSCALE__
+
+#include "CommonDef.h"
+#include "TComPicYuv.h"
+
+#define SCALE_NUM_PHASE         16          ///< number of sub-sample phases of the resampling filters
+#define SCALE_PHASE_BITS        4           ///< log2 of SCALE_NUM_PHASE
+#define SCALE_MAX_TAPS          12          ///< length of the longest resampling filter (down-sampling)
+#define SCALE_COEF_BITS         6           ///< filter coefficients of each phase sum up to (1<<SCALE_COEF_BITS)
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// separable polyphase resampler between two picture buffers of arbitrary size
+class TComScale
+{
+private:
+  Int     m_aiTaps[2];                                        ///< filter length [hor/ver]
+  Int     m_aaaiCoef[2][SCALE_NUM_PHASE][SCALE_MAX_TAPS];     ///< filter coefficients [hor/ver][phase][tap]
+
+  Int*    m_piPos;                                            ///< first source sample used by each output sample
+  Int*    m_piPhase;                                          ///< filter phase used by each output sample
+  Int     m_iPosSize;
+
+  Int*    m_piTmp;                                            ///< horizontally filtered rows
+  Int     m_iTmpSize;
+
+  Void  xInitFilter     ( Int iSrcLen, Int iDstLen, Bool bChroma, Int iDir );
+  Void  xInitPosition   ( Int iSrcLen, Int iDstLen, Int iTaps, Int* piPos, Int* piPhase );
+
+  template <Int N>
+  Void  xFilterHor      ( const Pel* piSrc, Int iSrcStride, Int iRows, Int* piDst, Int iDstWidth, const Int* piPos, const Int* piPhase );
+  template <Int N>
+  Void  xFilterVer      ( const Int* piSrc, Int iSrcWidth, Pel* piDst, Int iDstStride, Int iDstHeight, const Int* piPos, const Int* piPhase );
+
+  Void  xResamplePlane  ( const Pel* piSrc, Int iSrcStride, Int iSrcWidth, Int iSrcHeight,
+                          Pel* piDst, Int iDstStride, Int iDstWidth, Int iDstHeight, Bool bChroma );
+
+public:
+  TComScale();
+  virtual ~TComScale();
+
+  Void  destroy         ();
+
+  /// resample all three planes of pcSrc into pcDst, sizes are taken from the buffers
+  Void  resample        ( TComPicYuv* pcSrc, TComPicYuv* pcDst );
+};// END CLASS DEFINITION TComScale
+
+/// down-sample the picture of resolution level iFromLevel into the (smaller) picture of level iToLevel
+Void downScale( Int iFromLevel, Int iToLevel, TComPicYuv* pcSrc, TComPicYuv* pcDst );
+/// up-sample the picture of resolution level iFromLevel into the (larger) picture of level iToLevel
+Void upScale  ( Int iFromLevel, Int iToLevel, TComPicYuv* pcSrc, TComPicYuv* pcDst );
+
+#endif // __TCOMSCALE__
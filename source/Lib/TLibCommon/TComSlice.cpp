@@ -138,13 +138,12 @@ Void  TComSlice::sortPicList        (TComList<TComPic*>& rcListPic)
     iterPicExtract = rcListPic.begin();
     for (Int j = 0; j < i; j++) iterPicExtract++;
     pcPicExtract = *(iterPicExtract);
-    pcPicExtract->setCurrSliceIdx(0);
     
+    // the slice index of a picture decoded on another thread is left as is
     iterPicInsert = rcListPic.begin();
     while (iterPicInsert != iterPicExtract)
     {
       pcPicInsert = *(iterPicInsert);
-      pcPicInsert->setCurrSliceIdx(0);
       if (pcPicInsert->getPOC() >= pcPicExtract->getPOC())
       {
         break;
@@ -193,7 +192,7 @@ TComPic* TComSlice::xGetRefPic (TComList<TComPic*>& rcListPic,
       
       iterPic--;
       pcPic = *(iterPic);
-      if( ( !pcPic->getReconMark()                        ) ||
+      if( ( !pcPic->getReconMark() && !pcPic->getRecInProgress() ) ||
           ( bDRBFlag  != pcPic->getSlice(0)->getDRBFlag()  ) ||
           ( eERBIndex != pcPic->getSlice(0)->getERBIndex() ) )
         continue;
@@ -231,7 +230,7 @@ TComPic* TComSlice::xGetRefPic (TComList<TComPic*>& rcListPic,
           break;
         
         pcPic = *(iterPic);
-        if( ( !pcPic->getReconMark()                        ) ||
+        if( ( !pcPic->getReconMark() && !pcPic->getRecInProgress() ) ||
           ( bDRBFlag  != pcPic->getSlice(0)->getDRBFlag()  ) ||
           ( eERBIndex != pcPic->getSlice(0)->getERBIndex() ) )
           continue;
@@ -260,7 +259,7 @@ TComPic* TComSlice::xGetRefPic (TComList<TComPic*>& rcListPic,
         break;
       
       pcPic = *(iterPic);
-      if( ( !pcPic->getReconMark()                        ) ||
+      if( ( !pcPic->getReconMark() && !pcPic->getRecInProgress() ) ||
           ( bDRBFlag  != pcPic->getSlice(0)->getDRBFlag()  ) ||
           ( eERBIndex != pcPic->getSlice(0)->getERBIndex() ) )
         continue;
@@ -295,7 +294,7 @@ TComPic* TComSlice::xGetRefPic (TComList<TComPic*>& rcListPic,
       
       iterPic--;
       pcPic = *(iterPic);
-      if( ( !pcPic->getReconMark()                        ) ||
+      if( ( !pcPic->getReconMark() && !pcPic->getRecInProgress() ) ||
           ( bDRBFlag  != pcPic->getSlice(0)->getDRBFlag()  ) ||
           ( eERBIndex != pcPic->getSlice(0)->getERBIndex() ) )
         continue;
@@ -435,7 +434,11 @@ Void TComSlice::setRefPicList       ( TComList<TComPic*>& rcListPic )
     {
       m_apcRefPicList[eRefPicList][iRefIdx] = pcRefPic;
      
-      pcRefPic->getPicYuvRec(m_pcPPS->getPictureSizeIdx())->extendPicBorder();
+      // a reference still being decoded extends its border itself once it is reconstructed
+      if ( !pcRefPic->getRecInProgress() )
+      {
+        pcRefPic->getPicYuvRec(m_pcPPS->getPictureSizeIdx())->extendPicBorder();
+      }
       
       iRefIdx++;
       uiOrderDRB++;
@@ -475,7 +478,10 @@ Void TComSlice::setRefPicList       ( TComList<TComPic*>& rcListPic )
         m_apcRefPicList[eRefPicList][iRefIdx] = pcRefPic;
       }
      
-      pcRefPic->getPicYuvRec(m_pcPPS->getPictureSizeIdx())->extendPicBorder();
+      if ( !pcRefPic->getRecInProgress() )
+      {
+        pcRefPic->getPicYuvRec(m_pcPPS->getPictureSizeIdx())->extendPicBorder();
+      }
       
       iRefIdx++;
       uiOrderERB++;
@@ -504,7 +510,10 @@ Void TComSlice::setRefPicList       ( TComList<TComPic*>& rcListPic )
       {
         m_apcRefPicList[eRefPicList][iRefIdx] = pcRefPic;
         
-        pcRefPic->getPicYuvRec()->extendPicBorder();
+        if ( !pcRefPic->getRecInProgress() )
+        {
+          pcRefPic->getPicYuvRec(m_pcPPS->getPictureSizeIdx())->extendPicBorder();
+        }
         
         iRefIdx++;
         uiActualListSize++;
@@ -559,7 +568,6 @@ Void TComSlice::decodingRefreshMarking(UInt& uiPOCCDR, Bool& bRefreshPending, TC
     while (iterPic != rcListPic.end())
     {
       rpcPic = *(iterPic);
-      rpcPic->setCurrSliceIdx(0);
       if (rpcPic->getPOC() != uiPOCCurr) rpcPic->getSlice(0)->setReferenced(false);
       iterPic++;
     }
@@ -799,6 +807,12 @@ TComSPS::TComSPS()
   // Structure
   m_uiNominalWidth = 352;
   m_uiNominalHeight= 288;
+  m_uiNumPicResolutions = 1;
+  for ( Int i = 0; i < NUM_PIC_RESOLUTIONS; i++ )
+  {
+    m_auiPicWidth [i] = m_uiNominalWidth;
+    m_auiPicHeight[i] = m_uiNominalHeight;
+  }
   m_uiMaxCUWidth  = 32;
   m_uiMaxCUHeight = 32;
   m_uiMaxCUDepth  = 3;
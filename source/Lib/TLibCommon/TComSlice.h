@@ -62,6 +62,9 @@ private:
   UInt        m_uiNominalWidth;
   UInt        m_uiNominalHeight;
 //  UInt        m_uiPictureSizeIdx;
+  UInt        m_uiNumPicResolutions;                        ///< number of rungs of the resolution ladder
+  UInt        m_auiPicWidth [NUM_PIC_RESOLUTIONS];          ///< picture width of each rung
+  UInt        m_auiPicHeight[NUM_PIC_RESOLUTIONS];          ///< picture height of each rung
   Int         m_aiPad[2];
   UInt        m_uiMaxCUWidth;
   UInt        m_uiMaxCUHeight;
@@ -137,6 +140,12 @@ public:
 //  Void setPictureSizeIdx(UInt u)  { m_uiPictureSizeIdx = u; m_uiWidth = m_uiNominalWidth >> u; m_uiHeight = m_uiNominalHeight >> u;}
 //  UInt getPictureWidth ()         { return  m_uiWidth;       }
 //  UInt getPictureHeight()         { return  m_uiHeight;      }
+  Void setNumPicResolutions( UInt u ) { assert( u > 0 && u <= NUM_PIC_RESOLUTIONS ); m_uiNumPicResolutions = u; }
+  UInt getNumPicResolutions()         { return  m_uiNumPicResolutions; }
+  Void setPictureWidth ( UInt uiIdx, UInt u ) { assert( uiIdx < NUM_PIC_RESOLUTIONS ); m_auiPicWidth [uiIdx] = u; }
+  UInt getPictureWidth ( UInt uiIdx )         { assert( uiIdx < m_uiNumPicResolutions ); return uiIdx==0 ? m_uiNominalWidth  : m_auiPicWidth [uiIdx]; }
+  Void setPictureHeight( UInt uiIdx, UInt u ) { assert( uiIdx < NUM_PIC_RESOLUTIONS ); m_auiPicHeight[uiIdx] = u; }
+  UInt getPictureHeight( UInt uiIdx )         { assert( uiIdx < m_uiNumPicResolutions ); return uiIdx==0 ? m_uiNominalHeight : m_auiPicHeight[uiIdx]; }
   Void setMaxCUWidth  ( UInt u ) { m_uiMaxCUWidth = u;      }
   UInt getMaxCUWidth  ()         { return  m_uiMaxCUWidth;  }
   Void setMaxCUHeight ( UInt u ) { m_uiMaxCUHeight = u;     }
@@ -282,7 +291,7 @@ public:
   UInt      getPictureHeight()         { return  m_uiHeight;      }
 
   UInt      getPictureSizeIdx()        { return m_uiPictureSizeIdx; }
-  Void      setPictureSizeIdx(UInt u)  { m_uiPictureSizeIdx = u; m_uiWidth = m_pcSPS->getNominalWidth() >> u; m_uiHeight = m_pcSPS->getNominalHeight() >> u;}
+  Void      setPictureSizeIdx(UInt u)  { m_uiPictureSizeIdx = u; m_uiWidth = m_pcSPS->getPictureWidth(u); m_uiHeight = m_pcSPS->getPictureHeight(u);}
 
   UInt      getNumTLayerSwitchingFlags()                                  { return m_uiNumTlayerSwitchingFlags; }
   Void      setNumTLayerSwitchingFlags( UInt uiNumTlayerSwitchingFlags )  { assert( uiNumTlayerSwitchingFlags < MAX_TLAYER ); m_uiNumTlayerSwitchingFlags = uiNumTlayerSwitchingFlags; }
@@ -0,0 +1,340 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.cpp
+    \brief    thread pool and wavefront synchronisation
+*/
+
+#include <assert.h>
+#include "TComThreadPool.h"
+
+// ====================================================================================================================
+// TComMutex / TComCondition
+// ====================================================================================================================
+
+#ifdef _WIN32
+TComMutex::TComMutex()                  { InitializeCriticalSection( &m_cSection ); }
+TComMutex::~TComMutex()                 { DeleteCriticalSection( &m_cSection ); }
+Void TComMutex::lock()                  { EnterCriticalSection( &m_cSection ); }
+Void TComMutex::unlock()                { LeaveCriticalSection( &m_cSection ); }
+
+TComCondition::TComCondition()          { InitializeConditionVariable( &m_cCondition ); }
+TComCondition::~TComCondition()         {}
+Void TComCondition::wait( TComMutex& rcMutex )  { SleepConditionVariableCS( &m_cCondition, &rcMutex.m_cSection, INFINITE ); }
+Void TComCondition::broadcast()         { WakeAllConditionVariable( &m_cCondition ); }
+#else
+TComMutex::TComMutex()                  { pthread_mutex_init( &m_cMutex, NULL ); }
+TComMutex::~TComMutex()                 { pthread_mutex_destroy( &m_cMutex ); }
+Void TComMutex::lock()                  { pthread_mutex_lock( &m_cMutex ); }
+Void TComMutex::unlock()                { pthread_mutex_unlock( &m_cMutex ); }
+
+TComCondition::TComCondition()          { pthread_cond_init( &m_cCondition, NULL ); }
+TComCondition::~TComCondition()         { pthread_cond_destroy( &m_cCondition ); }
+Void TComCondition::wait( TComMutex& rcMutex )  { pthread_cond_wait( &m_cCondition, &rcMutex.m_cMutex ); }
+Void TComCondition::broadcast()         { pthread_cond_broadcast( &m_cCondition ); }
+#endif
+
+// ====================================================================================================================
+// TComThreadPool
+// ====================================================================================================================
+
+TComThreadPool::TComThreadPool()
+{
+  m_iNumThreads = 1;
+#ifdef _WIN32
+  m_phThread    = NULL;
+#else
+  m_pcThread    = NULL;
+#endif
+  m_pcThreadArg = NULL;
+  m_pcTask      = NULL;
+  m_uiTaskId    = 0;
+  m_iNumBusy    = 0;
+  m_bExit       = false;
+}
+
+TComThreadPool::~TComThreadPool()
+{
+  destroy();
+}
+
+Void TComThreadPool::create( Int iNumThreads )
+{
+  assert( iNumThreads >= 1 );
+  destroy();
+
+  m_iNumThreads = iNumThreads;
+  m_bExit       = false;
+  if ( m_iNumThreads == 1 )
+  {
+    return;
+  }
+
+  m_pcThreadArg = new TComThreadArg[ m_iNumThreads ];
+#ifdef _WIN32
+  m_phThread    = new HANDLE[ m_iNumThreads ];
+#else
+  m_pcThread    = new pthread_t[ m_iNumThreads ];
+#endif
+  for ( Int i = 1; i < m_iNumThreads; i++ )
+  {
+    TComThreadArg* pcArg = &m_pcThreadArg[i];
+    pcArg->pcPool     = this;
+    pcArg->iThreadIdx = i;
+#ifdef _WIN32
+    m_phThread[i] = CreateThread( NULL, 0, xThreadEntry, pcArg, 0, NULL );
+#else
+    pthread_create( &m_pcThread[i], NULL, xThreadEntry, pcArg );
+#endif
+  }
+}
+
+Void TComThreadPool::destroy()
+{
+  if ( m_pcThreadArg == NULL )
+  {
+    m_iNumThreads = 1;
+    return;
+  }
+
+  m_cMutex.lock();
+  m_bExit = true;
+  m_cStart.broadcast();
+  m_cMutex.unlock();
+
+  for ( Int i = 1; i < m_iNumThreads; i++ )
+  {
+#ifdef _WIN32
+    WaitForSingleObject( m_phThread[i], INFINITE );
+    CloseHandle( m_phThread[i] );
+#else
+    pthread_join( m_pcThread[i], NULL );
+#endif
+  }
+
+#ifdef _WIN32
+  delete [] m_phThread;
+  m_phThread    = NULL;
+#else
+  delete [] m_pcThread;
+  m_pcThread    = NULL;
+#endif
+  delete [] m_pcThreadArg;
+  m_pcThreadArg = NULL;
+  m_iNumThreads = 1;
+}
+
+Void TComThreadPool::run( TComThreadTask* pcTask )
+{
+  start( pcTask );
+  pcTask->runTask( 0 );
+  wait();
+}
+
+Void TComThreadPool::start( TComThreadTask* pcTask )
+{
+  if ( m_iNumThreads == 1 )
+  {
+    return;
+  }
+
+  m_cMutex.lock();
+  m_pcTask   = pcTask;
+  m_iNumBusy = m_iNumThreads - 1;
+  m_uiTaskId++;
+  m_cStart.broadcast();
+  m_cMutex.unlock();
+}
+
+Void TComThreadPool::wait()
+{
+  m_cMutex.lock();
+  while ( m_iNumBusy > 0 )
+  {
+    m_cDone.wait( m_cMutex );
+  }
+  m_pcTask = NULL;
+  m_cMutex.unlock();
+}
+
+#ifdef _WIN32
+DWORD WINAPI TComThreadPool::xThreadEntry( LPVOID pArg )
+{
+  TComThreadArg* pcArg = (TComThreadArg*)pArg;
+  pcArg->pcPool->xHelperLoop( pcArg->iThreadIdx );
+  return 0;
+}
+#else
+Void* TComThreadPool::xThreadEntry( Void* pArg )
+{
+  TComThreadArg* pcArg = (TComThreadArg*)pArg;
+  pcArg->pcPool->xHelperLoop( pcArg->iThreadIdx );
+  return NULL;
+}
+#endif
+
+Void TComThreadPool::xHelperLoop( Int iThreadIdx )
+{
+  UInt uiTaskId = 0;
+
+  m_cMutex.lock();
+  for (;;)
+  {
+    while ( !m_bExit && uiTaskId == m_uiTaskId )
+    {
+      m_cStart.wait( m_cMutex );
+    }
+    if ( m_bExit )
+    {
+      break;
+    }
+    uiTaskId = m_uiTaskId;
+    TComThreadTask* pcTask = m_pcTask;
+    m_cMutex.unlock();
+
+    pcTask->runTask( iThreadIdx );
+
+    m_cMutex.lock();
+    if ( --m_iNumBusy == 0 )
+    {
+      m_cDone.broadcast();
+    }
+  }
+  m_cMutex.unlock();
+}
+
+// ====================================================================================================================
+// TComWavefront
+// ====================================================================================================================
+
+TComWavefront::TComWavefront()
+{
+  m_iNumRows   = 0;
+  m_iMaxRows   = 0;
+  m_iNextRow   = 0;
+  m_iNumAvailable = 0;
+  m_bStopWaiting  = false;
+  m_piProgress = NULL;
+}
+
+TComWavefront::~TComWavefront()
+{
+  destroy();
+}
+
+Void TComWavefront::create( Int iMaxRows )
+{
+  destroy();
+  m_iMaxRows   = iMaxRows;
+  m_piProgress = new Int[ iMaxRows ];
+}
+
+Void TComWavefront::destroy()
+{
+  if ( m_piProgress )
+  {
+    delete [] m_piProgress;
+    m_piProgress = NULL;
+  }
+  m_iMaxRows = 0;
+}
+
+Void TComWavefront::init( Int iNumRows )
+{
+  assert( iNumRows <= m_iMaxRows );
+  m_iNumRows = iNumRows;
+  m_iNextRow = 0;
+  m_iNumAvailable = iNumRows;
+  m_bStopWaiting  = false;
+  for ( Int i = 0; i < iNumRows; i++ )
+  {
+    m_piProgress[i] = 0;
+  }
+}
+
+Int TComWavefront::claimRow()
+{
+  m_cMutex.lock();
+  Int iRow = m_iNextRow < m_iNumRows ? m_iNextRow++ : -1;
+  m_cMutex.unlock();
+  return iRow;
+}
+
+Void TComWavefront::setNumAvailable( Int iNumRows )
+{
+  m_cMutex.lock();
+  m_iNumAvailable = iNumRows < m_iNumRows ? iNumRows : m_iNumRows;
+  m_cProgress.broadcast();
+  m_cMutex.unlock();
+}
+
+Void TComWavefront::stopWaiting( Bool bStop )
+{
+  m_cMutex.lock();
+  m_bStopWaiting = bStop;
+  m_cProgress.broadcast();
+  m_cMutex.unlock();
+}
+
+/** Hand out the rows in top-down order as they are made available by setNumAvailable().
+ * \returns next row, -1 once all rows are handed out or while stopWaiting(true) is in effect
+ */
+Int TComWavefront::waitRow()
+{
+  m_cMutex.lock();
+  while ( m_iNextRow >= m_iNumAvailable && m_iNextRow < m_iNumRows && !m_bStopWaiting )
+  {
+    m_cProgress.wait( m_cMutex );
+  }
+  Int iRow = ( m_iNextRow < m_iNumAvailable && !m_bStopWaiting ) ? m_iNextRow++ : -1;
+  m_cMutex.unlock();
+  return iRow;
+}
+
+Void TComWavefront::setProgress( Int iRow, Int iNumDone )
+{
+  m_cMutex.lock();
+  m_piProgress[iRow] = iNumDone;
+  m_cProgress.broadcast();
+  m_cMutex.unlock();
+}
+
+Void TComWavefront::waitProgress( Int iRow, Int iNumDone )
+{
+  m_cMutex.lock();
+  while ( m_piProgress[iRow] < iNumDone )
+  {
+    m_cProgress.wait( m_cMutex );
+  }
+  m_cMutex.unlock();
+}
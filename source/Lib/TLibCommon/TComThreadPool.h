@@ -0,0 +1,215 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.h
+    \brief    thread pool and wavefront synchronisation (header)
+*/
+
+#ifndef __TCOMTHREADPOOL__
+#define __TCOMTHREADPOOL__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "CommonDef.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// mutual exclusion lock
+class TComMutex
+{
+private:
+#ifdef _WIN32
+  CRITICAL_SECTION        m_cSection;
+#else
+  pthread_mutex_t         m_cMutex;
+#endif
+
+  friend class TComCondition;
+
+public:
+  TComMutex();
+  virtual ~TComMutex();
+
+  Void  lock    ();
+  Void  unlock  ();
+};
+
+/// condition variable, always used together with a TComMutex
+class TComCondition
+{
+private:
+#ifdef _WIN32
+  CONDITION_VARIABLE      m_cCondition;
+#else
+  pthread_cond_t          m_cCondition;
+#endif
+
+public:
+  TComCondition();
+  virtual ~TComCondition();
+
+  Void  wait      ( TComMutex& rcMutex );                     ///< rcMutex must be locked by the caller
+  Void  broadcast ();
+};
+
+/// value read by other threads without a lock: the writes made before set() are seen by a thread once get() returns
+/// the new value
+template <typename T>
+class TComAtomic
+{
+private:
+#ifdef _WIN32
+  volatile T              m_tValue;                           ///< volatile accesses acquire and release with MSVC
+#else
+  T                       m_tValue;
+#endif
+
+public:
+  TComAtomic( T tValue = T() ) : m_tValue( tValue ) {}
+
+#ifdef _WIN32
+  T     get   () const      { return m_tValue; }
+  Void  set   ( T tValue )  { m_tValue = tValue; }
+#else
+  T     get   () const      { return __atomic_load_n( &m_tValue, __ATOMIC_ACQUIRE ); }
+  Void  set   ( T tValue )  { __atomic_store_n( &m_tValue, tValue, __ATOMIC_RELEASE ); }
+#endif
+};
+
+/// work run by every thread of a TComThreadPool
+class TComThreadTask
+{
+public:
+  virtual ~TComThreadTask() {}
+
+  virtual Void  runTask ( Int iThreadIdx ) = 0;
+};
+
+class TComThreadPool;
+
+/// argument passed to a helper thread
+struct TComThreadArg
+{
+  TComThreadPool*         pcPool;
+  Int                     iThreadIdx;
+};
+
+/// fixed set of threads running one task at a time, the calling thread takes part as thread 0
+class TComThreadPool
+{
+private:
+  Int                     m_iNumThreads;                      ///< number of threads including the calling one
+#ifdef _WIN32
+  HANDLE*                 m_phThread;
+#else
+  pthread_t*              m_pcThread;
+#endif
+  TComThreadArg*          m_pcThreadArg;
+
+  TComMutex               m_cMutex;
+  TComCondition           m_cStart;                           ///< signalled when a task is posted or on exit
+  TComCondition           m_cDone;                            ///< signalled when the last helper finished its task
+  TComThreadTask*         m_pcTask;
+  UInt                    m_uiTaskId;                         ///< incremented for each posted task
+  Int                     m_iNumBusy;                         ///< helpers still running the current task
+  Bool                    m_bExit;
+
+#ifdef _WIN32
+  static DWORD WINAPI     xThreadEntry  ( LPVOID pArg );
+#else
+  static Void*            xThreadEntry  ( Void* pArg );
+#endif
+  Void                    xHelperLoop   ( Int iThreadIdx );
+
+public:
+  TComThreadPool();
+  virtual ~TComThreadPool();
+
+  Void  create          ( Int iNumThreads );
+  Void  destroy         ();
+
+  Int   getNumThreads   ()  { return m_iNumThreads; }
+
+  /// run pcTask->runTask(i) on every thread i and return once all of them are done
+  Void  run             ( TComThreadTask* pcTask );
+
+  /// run pcTask->runTask(i) on every thread i but the calling one, without waiting for them
+  Void  start           ( TComThreadTask* pcTask );
+  Void  wait            ();                                   ///< block until the task posted by start() is done
+};
+
+/// progress of the rows of a picture processed in wavefront order
+class TComWavefront
+{
+private:
+  Int                     m_iNumRows;
+  Int                     m_iMaxRows;
+  Int                     m_iNextRow;                         ///< next row handed out by claimRow()
+  Int                     m_iNumAvailable;                    ///< rows that waitRow() may hand out
+  Bool                    m_bStopWaiting;
+  Int*                    m_piProgress;                       ///< number of units completed in each row
+
+  TComMutex               m_cMutex;
+  TComCondition           m_cProgress;
+
+public:
+  TComWavefront();
+  virtual ~TComWavefront();
+
+  Void  create          ( Int iMaxRows );
+  Void  destroy         ();
+
+  Void  init            ( Int iNumRows );                     ///< start a new picture with no row processed
+  Int   claimRow        ();                                   ///< next unprocessed row in top-down order, -1 if none left
+  
+  Void  setNumAvailable ( Int iNumRows );                     ///< rows below iNumRows may be handed out by waitRow()
+  Void  stopWaiting     ( Bool bStop );                       ///< make waitRow() return -1 instead of blocking
+  Int   waitRow         ();                                   ///< next row once it is available, -1 if none left or stopped
+  Void  setProgress     ( Int iRow, Int iNumDone );
+  Void  waitProgress    ( Int iRow, Int iNumDone );           ///< block until row iRow has iNumDone units completed
+};
+
+#endif // __TCOMTHREADPOOL__
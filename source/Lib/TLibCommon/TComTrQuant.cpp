@@ -39,6 +39,7 @@
 #include <math.h>
 #include <memory.h>
 #include "TComTrQuant.h"
+#include "TComTrQuantSIMD.h"
 #include "TComPic.h"
 #include "ContextTables.h"
 
@@ -263,19 +264,23 @@ TComTrQuant::TComTrQuant()
   m_cQP.clear();
   
   // allocate temporary buffers
-  m_plTempCoeff  = new Long[ MAX_CU_SIZE*MAX_CU_SIZE ];
+  m_piTempCoeff  = new TCoeff[ MAX_CU_SIZE*MAX_CU_SIZE ];
   
   // allocate bit estimation class  (for RDOQ)
   m_pcEstBitsSbac = new estBitsSbacStruct;
+  
+#if E243_CORE_TRANSFORMS
+  setSIMDLevel( SIMD_AUTO );
+#endif
 }
 
 TComTrQuant::~TComTrQuant()
 {
   // delete temporary buffers
-  if ( m_plTempCoeff )
+  if ( m_piTempCoeff )
   {
-    delete [] m_plTempCoeff;
-    m_plTempCoeff = NULL;
+    delete [] m_piTempCoeff;
+    m_piTempCoeff = NULL;
   }
   
   // delete bit estimation class
@@ -306,9 +311,9 @@ Void TComTrQuant::setQPforQuant( Int iQP, Bool bLowpass, SliceType eSliceType, T
  *  \param uiMode is Intra Prediction mode used in Mode-Dependent DCT/DST only
  */
 #if INTRA_DST_TYPE_7
-void xTr(Pel *block, Long *coeff, UInt uiStride, UInt uiTrSize, UInt uiMode)
+void xTr(Pel *block, TCoeff *coeff, UInt uiStride, UInt uiTrSize, UInt uiMode)
 #else
-void xTr(Pel *block, Long *coeff, UInt uiStride, UInt uiTrSize)
+void xTr(Pel *block, TCoeff *coeff, UInt uiStride, UInt uiTrSize)
 #endif
 {
   Int i,j,k,iSum;
@@ -406,9 +411,9 @@ void xTr(Pel *block, Long *coeff, UInt uiStride, UInt uiTrSize)
  *  \param uiMode is Intra Prediction mode used in Mode-Dependent DCT/DST only
  */
 #if INTRA_DST_TYPE_7
-void xITr(Long *coeff, Pel *block, UInt uiStride, UInt uiTrSize, UInt uiMode)
+void xITr(TCoeff *coeff, Pel *block, UInt uiStride, UInt uiTrSize, UInt uiMode)
 #else
-void xITr(Long *coeff, Pel *block, UInt uiStride, UInt uiTrSize)
+void xITr(TCoeff *coeff, Pel *block, UInt uiStride, UInt uiTrSize)
 #endif
 {
   int i,j,k,iSum;
@@ -1086,9 +1091,117 @@ void xITr32(short coeff[32][32],short block[32][32])
   partialButterflyInverse32(tmp,block,shift_2nd);
 }
 #endif //MATRIX_MULT
+
+#if !MATRIX_MULT
+// core transforms of each block size, resolved on the array type by the generic kernels below
+static inline Void xTrN ( short block[ 4][ 4], short coeff[ 4][ 4], UInt uiMode )
+{
+#if INTRA_DST_TYPE_7
+  xTr4( block, coeff, uiMode );
+#else
+  xTr4( block, coeff );
+#endif
+}
+static inline Void xTrN ( short block[ 8][ 8], short coeff[ 8][ 8], UInt ) { xTr8 ( block, coeff ); }
+static inline Void xTrN ( short block[16][16], short coeff[16][16], UInt ) { xTr16( block, coeff ); }
+static inline Void xTrN ( short block[32][32], short coeff[32][32], UInt ) { xTr32( block, coeff ); }
+
+static inline Void xITrN( short coeff[ 4][ 4], short block[ 4][ 4], UInt uiMode )
+{
+#if INTRA_DST_TYPE_7
+  xITr4( coeff, block, uiMode );
+#else
+  xITr4( coeff, block );
+#endif
+}
+static inline Void xITrN( short coeff[ 8][ 8], short block[ 8][ 8], UInt ) { xITr8 ( coeff, block ); }
+static inline Void xITrN( short coeff[16][16], short block[16][16], UInt ) { xITr16( coeff, block ); }
+static inline Void xITrN( short coeff[32][32], short block[32][32], UInt ) { xITr32( coeff, block ); }
+#endif
+
+/** Generic NxN forward core transform, the reference for the kernels of TComTrQuantSIMD
+ *  \param uiMode is Intra Prediction mode used in Mode-Dependent DCT/DST only
+ *  \param piResi input data (residual)
+ *  \param uiStride stride of input residual data
+ *  \param piCoeff output data (transform coefficients)
+ */
+template <Int iLog2Size>
+Void TComTrQuant::xFwdTrans( UInt uiMode, const Pel* piResi, UInt uiStride, TCoeff* piCoeff )
+{
+  const Int iSize = 1 << iLog2Size;
+#if MATRIX_MULT
+#if INTRA_DST_TYPE_7
+  xTr( (Pel*)piResi, piCoeff, uiStride, (UInt)iSize, uiMode );
+#else
+  xTr( (Pel*)piResi, piCoeff, uiStride, (UInt)iSize );
+#endif
+#else
+  short block[iSize][iSize];
+  short coeff[iSize][iSize];
+  Int j,k;
+  
+  for (j=0; j<iSize; j++)
+  {
+    memcpy(block[j],piResi+j*uiStride,iSize*sizeof(short));
+  }
+  xTrN(block,coeff,uiMode);
+  for (j=0; j<iSize; j++)
+  {
+    for (k=0; k<iSize; k++)
+    {
+      piCoeff[j*iSize+k] = coeff[j][k];
+    }
+  }
+#endif
+}
+
+/** Generic NxN inverse core transform, the reference for the kernels of TComTrQuantSIMD
+ *  \param uiMode is Intra Prediction mode used in Mode-Dependent DCT/DST only
+ *  \param piCoeff input data (transform coefficients)
+ *  \param piResi output data (residual)
+ *  \param uiStride stride of output residual data
+ *  \param iNzRows, iNzCols size of the top-left area holding the non-zero coefficients, the others are not read
+ */
+template <Int iLog2Size>
+Void TComTrQuant::xInvTrans( UInt uiMode, const TCoeff* piCoeff, Pel* piResi, UInt uiStride, Int iNzRows, Int iNzCols )
+{
+  const Int iSize = 1 << iLog2Size;
+  Int j,k;
+#if MATRIX_MULT
+  TCoeff aiCoeff[iSize*iSize];
+  
+  memset( aiCoeff, 0, sizeof(aiCoeff) );
+  for (j=0; j<iNzRows; j++)
+  {
+    memcpy( aiCoeff+j*iSize, piCoeff+j*iSize, iNzCols*sizeof(TCoeff) );
+  }
+#if INTRA_DST_TYPE_7
+  xITr( aiCoeff, piResi, uiStride, (UInt)iSize, uiMode );
+#else
+  xITr( aiCoeff, piResi, uiStride, (UInt)iSize );
+#endif
+#else
+  short block[iSize][iSize];
+  short coeff[iSize][iSize];
+  
+  memset( coeff, 0, sizeof(coeff) );
+  for (j=0; j<iNzRows; j++)
+  {
+    for (k=0; k<iNzCols; k++)
+    {
+      coeff[j][k] = (short)piCoeff[j*iSize+k];
+    }
+  }
+  xITrN(coeff,block,uiMode);
+  for (j=0; j<iSize; j++)
+  {
+    memcpy(piResi+j*uiStride,block[j],iSize*sizeof(short));
+  }
+#endif
+}
 #else //E243_CORE_TRANSFORMS
 
-Void TComTrQuant::xT32( Pel* pSrc, UInt uiStride, Long* pDes )
+Void TComTrQuant::xT32( Pel* pSrc, UInt uiStride, TCoeff* pDes )
 {
   Int x, y;
   Long aaiTemp[32][32];
@@ -1592,7 +1705,7 @@ Void TComTrQuant::xT32( Pel* pSrc, UInt uiStride, Long* pDes )
   }
 }
 
-Void TComTrQuant::xT16( Pel* pSrc, UInt uiStride, Long* pDes )
+Void TComTrQuant::xT16( Pel* pSrc, UInt uiStride, TCoeff* pDes )
 {
   Int x, y;
   
@@ -2680,7 +2793,7 @@ Int TComTrQuant::bitCount_LCEC(Int k,Int pos,Int n,Int lpflag,Int levelMode,Int
 #endif
 #if QC_MOD_LCEC_RDOQ
 static levelDataStruct slevelData  [ MAX_CU_SIZE*MAX_CU_SIZE ];
-Void TComTrQuant::xRateDistOptQuant_LCEC(TComDataCU* pcCU, Long* pSrcCoeff, TCoeff*& pDstCoeff, UInt uiWidth, UInt uiHeight, UInt& uiAbsSum, TextType eTType, 
+Void TComTrQuant::xRateDistOptQuant_LCEC(TComDataCU* pcCU, TCoeff* pSrcCoeff, TCoeff*& pDstCoeff, UInt uiWidth, UInt uiHeight, UInt& uiAbsSum, TextType eTType, 
                                          UInt uiAbsPartIdx )
 {
   Int     i, j;
@@ -2947,7 +3060,7 @@ Void TComTrQuant::xRateDistOptQuant_LCEC(TComDataCU* pcCU, Long* pSrcCoeff, TCoe
 
           levelDataStruct *psLevelData = &levelData[iScanning];
 #if E243_CORE_TRANSFORMS
-          psLevelData->levelDouble = abs(pSrcCoeff[iPos]) * uiQ;          
+          psLevelData->levelDouble = (Long)abs(pSrcCoeff[iPos]) * uiQ;          
           iQuantCoeff = (Int)((psLevelData->levelDouble + iAddRDOQ) >> q_bits);
 
           psLevelData->levelQ   = (Long)( psLevelData->levelDouble >> q_bits );
@@ -3221,7 +3334,7 @@ Void TComTrQuant::xRateDistOptQuant_LCEC(TComDataCU* pcCU, Long* pSrcCoeff, TCoe
 }
 #else
 Void TComTrQuant::xRateDistOptQuant_LCEC             ( TComDataCU*                     pcCU,
-                                                      Long*                           plSrcCoeff,
+                                                      TCoeff*                         plSrcCoeff,
                                                       TCoeff*&                        piDstCoeff,
                                                       UInt                            uiWidth,
                                                       UInt                            uiHeight,
@@ -3452,9 +3565,9 @@ Void TComTrQuant::xRateDistOptQuant_LCEC             ( TComDataCU*
 } 
 #endif
 
-Void TComTrQuant::xQuantLTR  (TComDataCU* pcCU, Long* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx )
+Void TComTrQuant::xQuantLTR  (TComDataCU* pcCU, TCoeff* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx )
 {
-  Long*   piCoef    = pSrc;
+  TCoeff* piCoef    = pSrc;
   TCoeff* piQCoef   = pDes;
   Int   iAdd = 0;
   
@@ -3644,11 +3757,11 @@ Void TComTrQuant::xQuantLTR  (TComDataCU* pcCU, Long* pSrc, TCoeff*& pDes, Int i
 #endif
 }
 
-Void TComTrQuant::xDeQuantLTR( TCoeff* pSrc, Long*& pDes, Int iWidth, Int iHeight )
+Void TComTrQuant::xDeQuantLTR( TCoeff* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, Int& riNzRows, Int& riNzCols )
 {
   
   TCoeff* piQCoef   = pSrc;
-  Long*   piCoef    = pDes;
+  TCoeff* piCoef    = pDes;
   
   if ( iWidth > (Int)m_uiMaxTrSize )
   {
@@ -3671,12 +3784,42 @@ Void TComTrQuant::xDeQuantLTR( TCoeff* pSrc, Long*& pDes, Int iWidth, Int iHeigh
   iAdd = 1 << (iShift-1);
   uiQ = g_auiIQ[m_cQP.m_iRem];
 
-  for( Int n = 0; n < iWidth*iHeight; n++ )
+  // zero levels give zero coefficients; unless the entropy decoder has recorded the area holding the others, track it for the inverse transform
+  const Bool bFindArea = ( riNzRows < 0 );
+  Int iRows = iHeight;
+  Int iCols = iWidth;
+  if ( bFindArea )
   {
-    iCoeffQ = ((piQCoef[n]*(Int)uiQ << m_cQP.m_iPer)+iAdd)>>iShift;
-    piCoef[n] = Clip3(-32768,32767,iCoeffQ);
-  } 
+    riNzRows = 0;
+    riNzCols = 0;
+  }
+  else
+  {
+    // the SIMD kernels read whole groups of up to 8 rows and columns
+    iRows = min( iHeight, ( riNzRows + 7 ) & ~7 );
+    iCols = min( iWidth,  ( riNzCols + 7 ) & ~7 );
+  }
+  for( Int y = 0; y < iRows; y++ )
+  {
+    for( Int x = 0, n = y * iWidth; x < iCols; x++, n++ )
+    {
+      if ( piQCoef[n] == 0 )
+      {
+        piCoef[n] = 0;
+        continue;
+      }
+      iCoeffQ = ((piQCoef[n]*(Int)uiQ << m_cQP.m_iPer)+iAdd)>>iShift;
+      piCoef[n] = Clip3(-32768,32767,iCoeffQ);
+      if ( bFindArea )
+      {
+        riNzRows = y + 1;
+        riNzCols = max( riNzCols, x + 1 );
+      }
+    }
+  }
 #else
+  riNzRows = iHeight;
+  riNzCols = iWidth;
   UInt* piDeQuantCoef = NULL;
   switch(iWidth)
   {
@@ -3733,7 +3876,7 @@ Void TComTrQuant::xDeQuantLTR( TCoeff* pSrc, Long*& pDes, Int iWidth, Int iHeigh
 #endif
 }
 #if !E243_CORE_TRANSFORMS
-Void TComTrQuant::xIT16( Long* pSrc, Pel* pDes, UInt uiStride )
+Void TComTrQuant::xIT16( TCoeff* pSrc, Pel* pDes, UInt uiStride )
 {
   Int x, y;
   Long aaiTemp[16][16];
@@ -3994,7 +4137,7 @@ Void TComTrQuant::xIT16( Long* pSrc, Pel* pDes, UInt uiStride )
   }
 }
 
-Void TComTrQuant::xIT32( Long* pSrc, Pel* pDes, UInt uiStride )
+Void TComTrQuant::xIT32( TCoeff* pSrc, Pel* pDes, UInt uiStride )
 {
   Int x, y;
   Long aaiTemp[32][32];
@@ -4590,14 +4733,14 @@ Void TComTrQuant::init( UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxTrSize, Int
   }
 }
 
-Void TComTrQuant::xQuant( TComDataCU* pcCU, Long* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx )
+Void TComTrQuant::xQuant( TComDataCU* pcCU, TCoeff* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx )
 {
   xQuantLTR(pcCU, pSrc, pDes, iWidth, iHeight, uiAcSum, eTType, uiAbsPartIdx );
 }
 
-Void TComTrQuant::xDeQuant( TCoeff* pSrc, Long*& pDes, Int iWidth, Int iHeight )
+Void TComTrQuant::xDeQuant( TCoeff* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, Int& riNzRows, Int& riNzCols )
 {
-  xDeQuantLTR( pSrc, pDes, iWidth, iHeight );
+  xDeQuantLTR( pSrc, pDes, iWidth, iHeight, riNzRows, riNzCols );
 }
 
 #if INTRA_DST_TYPE_7
@@ -4612,8 +4755,8 @@ Void TComTrQuant::transformNxN( TComDataCU* pcCU, Pel* pcResidual, UInt uiStride
   uiAbsSum = 0;
   assert( (pcCU->getSlice()->getSPS()->getMaxTrSize() >= uiWidth) );
 
-  xT( uiMode, pcResidual, uiStride, m_plTempCoeff, uiWidth );
-  xQuant( pcCU, m_plTempCoeff, rpcCoeff, uiWidth, uiHeight, uiAbsSum, eTType, uiAbsPartIdx );
+  xT( uiMode, pcResidual, uiStride, m_piTempCoeff, uiWidth );
+  xQuant( pcCU, m_piTempCoeff, rpcCoeff, uiWidth, uiHeight, uiAbsSum, eTType, uiAbsPartIdx );
 }
 #else
 Void TComTrQuant::transformNxN( TComDataCU* pcCU, Pel* pcResidual, UInt uiStride, TCoeff*& rpcCoeff, UInt uiWidth, UInt uiHeight, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx )
@@ -4622,28 +4765,32 @@ Void TComTrQuant::transformNxN( TComDataCU* pcCU, Pel* pcResidual, UInt uiStride
   
   assert( (pcCU->getSlice()->getSPS()->getMaxTrSize() >= uiWidth) );
   
-  xT( pcResidual, uiStride, m_plTempCoeff, uiWidth );
-  xQuant( pcCU, m_plTempCoeff, rpcCoeff, uiWidth, uiHeight, uiAbsSum, eTType, uiAbsPartIdx );
+  xT( pcResidual, uiStride, m_piTempCoeff, uiWidth );
+  xQuant( pcCU, m_piTempCoeff, rpcCoeff, uiWidth, uiHeight, uiAbsSum, eTType, uiAbsPartIdx );
 }
 #endif
 
 
 #if INTRA_DST_TYPE_7
-Void TComTrQuant::invtransformNxN( TextType eText,UInt uiMode, Pel*& rpcResidual, UInt uiStride, TCoeff* pcCoeff, UInt uiWidth, UInt uiHeight )
+/** Inverse quantisation and transform of a transform unit.
+ * \param iNzRows number of leading rows holding non-zero levels as recorded by the entropy decoder, -1 to find it while dequantising
+ * \param iNzCols number of leading columns holding non-zero levels, -1 to find it while dequantising
+ */
+Void TComTrQuant::invtransformNxN( TextType eText,UInt uiMode, Pel*& rpcResidual, UInt uiStride, TCoeff* pcCoeff, UInt uiWidth, UInt uiHeight, Int iNzRows, Int iNzCols )
 {
-  xDeQuant( pcCoeff, m_plTempCoeff, uiWidth, uiHeight);
-  xIT( uiMode, m_plTempCoeff, rpcResidual, uiStride, uiWidth);
+  xDeQuant( pcCoeff, m_piTempCoeff, uiWidth, uiHeight, iNzRows, iNzCols );
+  xIT( uiMode, m_piTempCoeff, rpcResidual, uiStride, uiWidth, iNzRows, iNzCols );
 }
 #else
-Void TComTrQuant::invtransformNxN( Pel*& rpcResidual, UInt uiStride, TCoeff* pcCoeff, UInt uiWidth, UInt uiHeight )
+Void TComTrQuant::invtransformNxN( Pel*& rpcResidual, UInt uiStride, TCoeff* pcCoeff, UInt uiWidth, UInt uiHeight, Int iNzRows, Int iNzCols )
 {
-  xDeQuant( pcCoeff, m_plTempCoeff, uiWidth, uiHeight);
-  xIT( m_plTempCoeff, rpcResidual, uiStride, uiWidth );
+  xDeQuant( pcCoeff, m_piTempCoeff, uiWidth, uiHeight, iNzRows, iNzCols );
+  xIT( m_piTempCoeff, rpcResidual, uiStride, uiWidth, iNzRows, iNzCols );
 }
 #endif
 
 #if !E243_CORE_TRANSFORMS
-Void TComTrQuant::xT2( Pel* piBlkResi, UInt uiStride, Long* psCoeff )
+Void TComTrQuant::xT2( Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff )
 {
   Int itmp1, itmp2;
   
@@ -4660,7 +4807,7 @@ Void TComTrQuant::xT2( Pel* piBlkResi, UInt uiStride, Long* psCoeff )
   psCoeff[3] = itmp1 - itmp2;
 }
 
-Void TComTrQuant::xT4( Pel* piBlkResi, UInt uiStride, Long* psCoeff )
+Void TComTrQuant::xT4( Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff )
 {
   Int aai[4][4];
   Int tmp1, tmp2;
@@ -4697,7 +4844,7 @@ Void TComTrQuant::xT4( Pel* piBlkResi, UInt uiStride, Long* psCoeff )
   }
 }
 
-Void TComTrQuant::xT8( Pel* piBlkResi, UInt uiStride, Long* psCoeff )
+Void TComTrQuant::xT8( Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff )
 {
   Int aai[8][8];
 #ifdef TRANS_PRECISION_EXT
@@ -4796,7 +4943,7 @@ Void TComTrQuant::xT8( Pel* piBlkResi, UInt uiStride, Long* psCoeff )
   }
 }
 
-Void TComTrQuant::xQuant2x2( Long* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum )
+Void TComTrQuant::xQuant2x2( TCoeff* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum )
 {
   Int iLevel;
   Int iSign;
@@ -4872,7 +5019,7 @@ Void TComTrQuant::xQuant2x2( Long* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum
   }
 }
 
-Void TComTrQuant::xQuant4x4( TComDataCU* pcCU, Long* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx )
+Void TComTrQuant::xQuant4x4( TComDataCU* pcCU, TCoeff* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx )
 {
   if ( m_bUseRDOQ && (eTType == TEXT_LUMA || RDOQ_CHROMA) )
   {
@@ -4908,7 +5055,7 @@ Void TComTrQuant::xQuant4x4( TComDataCU* pcCU, Long* plSrcCoef, TCoeff*& pDstCoe
   }
 }
 
-Void TComTrQuant::xQuant8x8( TComDataCU* pcCU, Long* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx )
+Void TComTrQuant::xQuant8x8( TComDataCU* pcCU, TCoeff* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx )
 {
   Int iBit = m_cQP.m_iBits + 1;
   
@@ -4947,7 +5094,7 @@ Void TComTrQuant::xQuant8x8( TComDataCU* pcCU, Long* plSrcCoef, TCoeff*& pDstCoe
   }
 }
 
-Void TComTrQuant::xIT2( Long* plCoef, Pel* pResidual, UInt uiStride )
+Void TComTrQuant::xIT2( TCoeff* plCoef, Pel* pResidual, UInt uiStride )
 {
   Int itemp, itmp1, itmp2;
   Int iSign;
@@ -4985,7 +5132,7 @@ Void TComTrQuant::xIT2( Long* plCoef, Pel* pResidual, UInt uiStride )
   pResidual[uiStride+1] -= iSign;
 }
 
-Void TComTrQuant::xIT4( Long* plCoef, Pel* pResidual, UInt uiStride )
+Void TComTrQuant::xIT4( TCoeff* plCoef, Pel* pResidual, UInt uiStride )
 {
   Int aai[4][4];
   Int tmp1, tmp2;
@@ -5024,7 +5171,7 @@ Void TComTrQuant::xIT4( Long* plCoef, Pel* pResidual, UInt uiStride )
   }
 }
 
-Void TComTrQuant::xIT8( Long* plCoef, Pel* pResidual, UInt uiStride )
+Void TComTrQuant::xIT8( TCoeff* plCoef, Pel* pResidual, UInt uiStride )
 {
   Long aai[8][8];
   Int n;
@@ -5045,7 +5192,7 @@ Void TComTrQuant::xIT8( Long* plCoef, Pel* pResidual, UInt uiStride )
   
   for( n = 0; n < 8; n++ )
   {
-    Long* pi = plCoef + (n<<3);
+    TCoeff* pi = plCoef + (n<<3);
     Long     ai1[8];
     Long     ai2[8];
 #ifdef TRANS_PRECISION_EXT
@@ -5150,7 +5297,7 @@ Void TComTrQuant::xIT8( Long* plCoef, Pel* pResidual, UInt uiStride )
   }
 }
 
-Void TComTrQuant::xDeQuant2x2( TCoeff* pSrcCoef, Long*& rplDstCoef )
+Void TComTrQuant::xDeQuant2x2( TCoeff* pSrcCoef, TCoeff*& rplDstCoef )
 {
   Int iDeScale = g_aiDequantCoef4[m_cQP.m_iRem];
   
@@ -5191,7 +5338,7 @@ Void TComTrQuant::xDeQuant2x2( TCoeff* pSrcCoef, Long*& rplDstCoef )
   }
 }
 
-Void TComTrQuant::xDeQuant4x4( TCoeff* pSrcCoef, Long*& rplDstCoef )
+Void TComTrQuant::xDeQuant4x4( TCoeff* pSrcCoef, TCoeff*& rplDstCoef )
 {
   Int iLevel;
   Int iDeScale;
@@ -5213,7 +5360,7 @@ Void TComTrQuant::xDeQuant4x4( TCoeff* pSrcCoef, Long*& rplDstCoef )
   }
 }
 
-Void TComTrQuant::xDeQuant8x8( TCoeff* pSrcCoef, Long*& rplDstCoef )
+Void TComTrQuant::xDeQuant8x8( TCoeff* pSrcCoef, TCoeff*& rplDstCoef )
 {
   Int iLevel;
   Int iDeScale;
@@ -5263,10 +5410,13 @@ Void TComTrQuant::invRecurTransformNxN( TComDataCU* pcCU, UInt uiAbsPartIdx, Tex
       uiHeight <<= 1;
     }
     Pel* pResi = rpcResidual + uiAddr;
+    // area of the non-zero levels as recorded by the entropy decoder
+    Int  iNzRows = pcCU->getNzRows( uiAbsPartIdx, eTxt );
+    Int  iNzCols = pcCU->getNzCols( uiAbsPartIdx, eTxt );
 #if INTRA_DST_TYPE_7
-    invtransformNxN( eTxt, REG_DCT, pResi, uiStride, rpcCoeff, uiWidth, uiHeight );
+    invtransformNxN( eTxt, REG_DCT, pResi, uiStride, rpcCoeff, uiWidth, uiHeight, iNzRows, iNzCols );
 #else
-    invtransformNxN( pResi, uiStride, rpcCoeff, uiWidth, uiHeight );
+    invtransformNxN( pResi, uiStride, rpcCoeff, uiWidth, uiHeight, iNzRows, iNzCols );
 #endif
   }
   else
@@ -5289,6 +5439,24 @@ Void TComTrQuant::invRecurTransformNxN( TComDataCU* pcCU, UInt uiAbsPartIdx, Tex
 // ------------------------------------------------------------------------------------------------
 
 #if E243_CORE_TRANSFORMS
+/** Select the kernels of the core transforms.
+ * \param iLevel requested SIMDLevel, see TComTrQuantSIMD::initTrQuantFunc()
+ * \returns level actually used
+ */
+Int TComTrQuant::setSIMDLevel( Int iLevel )
+{
+  m_afpFwdTrans[0] = xFwdTrans<2>;
+  m_afpFwdTrans[1] = xFwdTrans<3>;
+  m_afpFwdTrans[2] = xFwdTrans<4>;
+  m_afpFwdTrans[3] = xFwdTrans<5>;
+  m_afpInvTrans[0] = xInvTrans<2>;
+  m_afpInvTrans[1] = xInvTrans<3>;
+  m_afpInvTrans[2] = xInvTrans<4>;
+  m_afpInvTrans[3] = xInvTrans<5>;
+  
+  return TComTrQuantSIMD::initTrQuantFunc( m_afpFwdTrans, m_afpInvTrans, iLevel );
+}
+
 /** Wrapper function between HM interface and core NxN forward transform (2D) 
  *  \param piBlkResi input data (residual)
  *  \param psCoeff output data (transform coefficients)
@@ -5297,201 +5465,81 @@ Void TComTrQuant::invRecurTransformNxN( TComDataCU* pcCU, UInt uiAbsPartIdx, Tex
  *  \param uiMode is Intra Prediction mode used in Mode-Dependent DCT/DST only
  */
 #if INTRA_DST_TYPE_7
-Void TComTrQuant::xT( UInt uiMode, Pel* piBlkResi, UInt uiStride, Long* psCoeff, Int iSize )
-#else
-Void TComTrQuant::xT( Pel* piBlkResi, UInt uiStride, Long* psCoeff, Int iSize )
-#endif
+Void TComTrQuant::xT( UInt uiMode, Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, Int iSize )
 {
-#if MATRIX_MULT  
-#if INTRA_DST_TYPE_7
-  xTr(piBlkResi,psCoeff,uiStride,(UInt)iSize,uiMode);
-#else
-  xTr(piBlkResi,psCoeff,uiStride,(UInt)iSize);
-#endif
-#else
-  Int j,k;
-  if (iSize==4)
-  {   
-    short block[4][4];   
-    short coeff[4][4];
-    for (j=0; j<4; j++)
-    {    
-      memcpy(block[j],piBlkResi+j*uiStride,4*sizeof(short));      
-    }
-#if INTRA_DST_TYPE_7
-    xTr4(block,coeff,uiMode);
+  m_afpFwdTrans[ (Int)g_aucConvertToBit[ iSize ] ]( uiMode, piBlkResi, uiStride, psCoeff );
+}
 #else
-    xTr4(block,coeff);     
-#endif
-    for (j=0; j<4; j++)
-    {    
-      for (k=0; k<4; k++)
-      {        
-        psCoeff[j*4+k] = coeff[j][k];
-      }    
-    }    
-  }
-  else if (iSize==8)
-  {
-    short block[8][8];
-    short coeff[8][8];
-
-    for (j=0; j<8; j++)
-    {    
-      memcpy(block[j],piBlkResi+j*uiStride,8*sizeof(short));
-    }
-
-    xTr8(block,coeff);       
-    for (j=0; j<8; j++)
-    {    
-      for (k=0; k<8; k++)
-      {        
-        psCoeff[j*8+k] = coeff[j][k];
-      }    
-    }
-  }
-  else if (iSize==16)
-  {   
-    short block[16][16];
-    short coeff[16][16];
-
-    for (j=0; j<16; j++)
-    {    
-      memcpy(block[j],piBlkResi+j*uiStride,16*sizeof(short));
-    }
-    xTr16(block,coeff);       
-    for (j=0; j<16; j++)
-    {    
-      for (k=0; k<16; k++)
-      {        
-        psCoeff[j*16+k] = coeff[j][k];
-      }    
-    }
-  }
-  else if (iSize==32)
-  {   
-    short block[32][32];
-    short coeff[32][32];
-
-    for (j=0; j<32; j++)
-    {    
-      memcpy(block[j],piBlkResi+j*uiStride,32*sizeof(short));
-    }
-    xTr32(block,coeff);       
-    for (j=0; j<32; j++)
-    {    
-      for (k=0; k<32; k++)
-      {        
-        psCoeff[j*32+k] = coeff[j][k];
-      }    
-    }
-  }
-#endif  
+Void TComTrQuant::xT( Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, Int iSize )
+{
+  m_afpFwdTrans[ (Int)g_aucConvertToBit[ iSize ] ]( 0, piBlkResi, uiStride, psCoeff );
 }
+#endif
 
 /** Wrapper function between HM interface and core NxN inverse transform (2D) 
  *  \param plCoef input data (transform coefficients)
  *  \param pResidual output data (residual)
  *  \param uiStride stride of input residual data
  *  \param iSize transform size (iSize x iSize)
+ *  \param iNzRows, iNzCols size of the top-left area holding the non-zero coefficients
  *  \param uiMode is Intra Prediction mode used in Mode-Dependent DCT/DST only
  */
 #if INTRA_DST_TYPE_7
-Void TComTrQuant::xIT( UInt uiMode, Long* plCoef, Pel* pResidual, UInt uiStride, Int iSize )
-#else
-Void TComTrQuant::xIT( Long* plCoef, Pel* pResidual, UInt uiStride, Int iSize )
-#endif
+/** Inverse transform, skipping the kernels for empty and DC-only blocks.
+ * \param iNzRows, iNzCols size of the top-left area holding the non-zero coefficients
+ */
+Void TComTrQuant::xIT( UInt uiMode, TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iSize, Int iNzRows, Int iNzCols )
 {
-#if MATRIX_MULT  
-#if INTRA_DST_TYPE_7
-  xITr(plCoef,pResidual,uiStride,(UInt)iSize,uiMode);
-#else
-  xITr(plCoef,pResidual,uiStride,(UInt)iSize);
-#endif
-#else
-  Int j,k;
-  if (iSize==4)
-  {    
-    short block[4][4];
-    short coeff[4][4];
-
-    for (j=0; j<4; j++)
-    {    
-      for (k=0; k<4; k++)
-      {        
-        coeff[j][k] = (short)plCoef[j*4+k];
-      }    
-    }
-#if INTRA_DST_TYPE_7
-    xITr4(coeff,block,uiMode);
-#else
-    xITr4(coeff,block);       
-#endif
-    for (j=0; j<4; j++)
-    {    
-      memcpy(pResidual+j*uiStride,block[j],4*sizeof(short));
-    }    
-  }
-  else if (iSize==8)
+  // the DST basis is not flat, a DC-only 4x4 DST block needs the transform
+  Bool bDST = iSize == 4 && uiMode != REG_DCT && ( g_aucDCTDSTMode_Vert[uiMode] || g_aucDCTDSTMode_Hor[uiMode] );
+  if ( iNzRows == 0 || ( iNzRows == 1 && iNzCols == 1 && !bDST ) )
   {
-    short block[8][8];
-    short coeff[8][8];
-
-    for (j=0; j<8; j++)
-    {    
-      for (k=0; k<8; k++)
-      {        
-        coeff[j][k] = (short)plCoef[j*8+k];
-      }    
-    }
-    xITr8(coeff,block);       
-    for (j=0; j<8; j++)
-    {    
-      memcpy(pResidual+j*uiStride,block[j],8*sizeof(short));
-    }
+    xITDC( iNzRows ? plCoef[0] : 0, pResidual, uiStride, iSize );
+    return;
   }
-  else if (iSize==16)
+  m_afpInvTrans[ (Int)g_aucConvertToBit[ iSize ] ]( uiMode, plCoef, pResidual, uiStride, iNzRows, iNzCols );
+}
+#else
+/** Inverse transform, skipping the kernels for empty and DC-only blocks.
+ * \param iNzRows, iNzCols size of the top-left area holding the non-zero coefficients
+ */
+Void TComTrQuant::xIT( TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iSize, Int iNzRows, Int iNzCols )
+{
+  if ( iNzRows == 0 || ( iNzRows == 1 && iNzCols == 1 ) )
   {
-    short block[16][16];
-    short coeff[16][16];
-
-    for (j=0; j<16; j++)
-    {    
-      for (k=0; k<16; k++)
-      {        
-        coeff[j][k] = (short)plCoef[j*16+k];
-      }    
-    }
-    xITr16(coeff,block);       
-    for (j=0; j<16; j++)
-    {    
-      memcpy(pResidual+j*uiStride,block[j],16*sizeof(short));
-    }
+    xITDC( iNzRows ? plCoef[0] : 0, pResidual, uiStride, iSize );
+    return;
   }
+  m_afpInvTrans[ (Int)g_aucConvertToBit[ iSize ] ]( 0, plCoef, pResidual, uiStride, iNzRows, iNzCols );
+}
+#endif
 
-  else if (iSize==32)
+/** Inverse transform of a block whose only non-zero coefficient is the DC one: the first basis function of the DCT is
+ *  flat (64), so both passes reduce to a rounding shift and the residual is constant.
+ * \param iCoeffDC dequantised DC coefficient
+ */
+Void TComTrQuant::xITDC( TCoeff iCoeffDC, Pel* pResidual, UInt uiStride, Int iSize )
+{
+#if FULL_NBIT
+  Int iShift2nd = SHIFT_INV_2ND - ((short)g_uiBitDepth - 8);
+#else
+  Int iShift2nd = SHIFT_INV_2ND - g_uiBitIncrement;
+#endif
+  Short sTmp = (Short)( ( 64 * iCoeffDC + ( 1 << ( SHIFT_INV_1ST - 1 ) ) ) >> SHIFT_INV_1ST );
+  Pel   iDC  = (Pel)( ( 64 * sTmp + ( 1 << ( iShift2nd - 1 ) ) ) >> iShift2nd );
+  
+  for( Int y = 0; y < iSize; y++ )
   {
-    short block[32][32];
-    short coeff[32][32];
-
-    for (j=0; j<32; j++)
-    {    
-      for (k=0; k<32; k++)
-      {        
-        coeff[j][k] = (short)plCoef[j*32+k];
-      }    
+    for( Int x = 0; x < iSize; x++ )
+    {
+      pResidual[x] = iDC;
     }
-    xITr32(coeff,block);       
-    for (j=0; j<32; j++)
-    {    
-      memcpy(pResidual+j*uiStride,block[j],32*sizeof(short));
-    }   
+    pResidual += uiStride;
   }
-#endif  
 }
 #else
 
-Void TComTrQuant::xT( Pel* piBlkResi, UInt uiStride, Long* psCoeff, Int iSize )
+Void TComTrQuant::xT( Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, Int iSize )
 {
   switch( iSize )
   {
@@ -5504,7 +5552,7 @@ Void TComTrQuant::xT( Pel* piBlkResi, UInt uiStride, Long* psCoeff, Int iSize )
   }
 }
 
-Void TComTrQuant::xIT( Long* plCoef, Pel* pResidual, UInt uiStride, Int iSize )
+Void TComTrQuant::xIT( TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iSize, Int iNzRows, Int iNzCols )
 {
   switch( iSize )
   {
@@ -5553,7 +5601,7 @@ UInt TComTrQuant::getCurrLineNum(UInt uiScanIdx, UInt uiPosX, UInt uiPosY)
  * coding engines using probability models like CABAC
  */
 Void TComTrQuant::xRateDistOptQuant                 ( TComDataCU*                     pcCU,
-                                                      Long*                           plSrcCoeff,
+                                                      TCoeff*                         plSrcCoeff,
                                                       TCoeff*&                        piDstCoeff,
                                                       UInt                            uiWidth,
                                                       UInt                            uiHeight,
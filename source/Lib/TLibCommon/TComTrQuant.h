@@ -104,7 +104,13 @@ typedef struct
 } quantLevelStruct;
 #endif
 
+#if E243_CORE_TRANSFORMS
+/// 2-D forward core transform of a strided residual block into (1 << iLog2Size)^2 coefficients, uiMode selects the 4x4 DST
+typedef Void (*FpFwdTrans)( UInt uiMode, const Pel* piResi, UInt uiStride, TCoeff* piCoeff );
 
+/// 2-D inverse core transform, coefficients outside the top-left iNzRows x iNzCols area must be zero
+typedef Void (*FpInvTrans)( UInt uiMode, const TCoeff* piCoeff, Pel* piResi, UInt uiStride, Int iNzRows, Int iNzCols );
+#endif
 
 class TEncCavlc;
 
@@ -194,14 +200,17 @@ public:
 #else
   Void init                 ( UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxTrSize, Int iSymbolMode = 0, UInt *aTable4 = NULL, UInt *aTable8 = NULL, Bool bUseRDOQ = false,  Bool bEnc = false );
 #endif
+#if E243_CORE_TRANSFORMS
+  Int  setSIMDLevel         ( Int iLevel );
+#endif
   
   // transform & inverse transform functions
   Void transformNxN         ( TComDataCU* pcCU, Pel*   pcResidual, UInt uiStride, TCoeff*& rpcCoeff, UInt uiWidth, UInt uiHeight,
                              UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx );
 #if INTRA_DST_TYPE_7
-  Void invtransformNxN      (TextType eText, UInt uiMode,Pel*& rpcResidual, UInt uiStride, TCoeff*   pcCoeff, UInt uiWidth, UInt uiHeight);
+  Void invtransformNxN      (TextType eText, UInt uiMode,Pel*& rpcResidual, UInt uiStride, TCoeff*   pcCoeff, UInt uiWidth, UInt uiHeight, Int iNzRows = -1, Int iNzCols = -1);
 #else
-  Void invtransformNxN      ( Pel*& rpcResidual, UInt uiStride, TCoeff*   pcCoeff, UInt uiWidth, UInt uiHeight );
+  Void invtransformNxN      ( Pel*& rpcResidual, UInt uiStride, TCoeff*   pcCoeff, UInt uiWidth, UInt uiHeight, Int iNzRows = -1, Int iNzCols = -1 );
 #endif
   Void invRecurTransformNxN ( TComDataCU* pcCU, UInt uiAbsPartIdx, TextType eTxt, Pel*& rpcResidual, UInt uiAddr,   UInt uiStride, UInt uiWidth, UInt uiHeight,
                              UInt uiMaxTrMode,  UInt uiTrMode, TCoeff* rpcCoeff );
@@ -209,8 +218,10 @@ public:
   // Misc functions
   Void setQPforQuant( Int iQP, Bool bLowpass, SliceType eSliceType, TextType eTxtType);
   Void setLambda(Double dLambda) { m_dLambda = dLambda;}
+  Double getLambda()             { return m_dLambda;    }
 #if QC_MOD_LCEC_RDOQ
   Void    setRDOQOffset ( UInt uiRDOQOffset ) { m_uiRDOQOffset = uiRDOQOffset; }
+  UInt    getRDOQOffset ()                    { return m_uiRDOQOffset;         }
 #endif
   estBitsSbacStruct* m_pcEstBitsSbac;
   
@@ -225,7 +236,13 @@ public:
                                      const UInt                      uiLog2BlkSize );
 #endif
 protected:
-  Long*    m_plTempCoeff;
+#if E243_CORE_TRANSFORMS
+  // core transform kernels, [log2( size ) - 2]
+  FpFwdTrans  m_afpFwdTrans[4];
+  FpInvTrans  m_afpInvTrans[4];
+#endif
+  
+  TCoeff*  m_piTempCoeff;
   UInt*    m_puiQuantMtx;
   
   QpParam  m_cQP;
@@ -245,24 +262,30 @@ protected:
 #endif
   
 private:
+#if E243_CORE_TRANSFORMS
+  // generic core transform kernels (partial butterflies)
+  template <Int iLog2Size> static Void xFwdTrans ( UInt uiMode, const Pel* piResi, UInt uiStride, TCoeff* piCoeff );
+  template <Int iLog2Size> static Void xInvTrans ( UInt uiMode, const TCoeff* piCoeff, Pel* piResi, UInt uiStride, Int iNzRows, Int iNzCols );
+#endif
+  
   // forward Transform
 #if INTRA_DST_TYPE_7
-  Void xT   ( UInt uiMode,Pel* pResidual, UInt uiStride, Long* plCoeff, Int iSize );
+  Void xT   ( UInt uiMode,Pel* pResidual, UInt uiStride, TCoeff* plCoeff, Int iSize );
 #else
-  Void xT   ( Pel* pResidual, UInt uiStride, Long* plCoeff, Int iSize );
+  Void xT   ( Pel* pResidual, UInt uiStride, TCoeff* plCoeff, Int iSize );
 #endif
-  Void xT2  ( Pel* pResidual, UInt uiStride, Long* plCoeff );
-  Void xT4  ( Pel* pResidual, UInt uiStride, Long* plCoeff );
-  Void xT8  ( Pel* pResidual, UInt uiStride, Long* plCoeff );
-  Void xT16 ( Pel* pResidual, UInt uiStride, Long* plCoeff );
-  Void xT32 ( Pel* pResidual, UInt uiStride, Long* plCoeff );
+  Void xT2  ( Pel* pResidual, UInt uiStride, TCoeff* plCoeff );
+  Void xT4  ( Pel* pResidual, UInt uiStride, TCoeff* plCoeff );
+  Void xT8  ( Pel* pResidual, UInt uiStride, TCoeff* plCoeff );
+  Void xT16 ( Pel* pResidual, UInt uiStride, TCoeff* plCoeff );
+  Void xT32 ( Pel* pResidual, UInt uiStride, TCoeff* plCoeff );
   
   // quantization
-  Void xQuant     ( TComDataCU* pcCU, Long* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx );
-  Void xQuantLTR  ( TComDataCU* pcCU, Long* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx );
-  Void xQuant2x2  ( Long* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum );
-  Void xQuant4x4  ( TComDataCU* pcCU, Long* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx );
-  Void xQuant8x8  ( TComDataCU* pcCU, Long* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx );
+  Void xQuant     ( TComDataCU* pcCU, TCoeff* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx );
+  Void xQuantLTR  ( TComDataCU* pcCU, TCoeff* pSrc, TCoeff*& pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx );
+  Void xQuant2x2  ( TCoeff* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum );
+  Void xQuant4x4  ( TComDataCU* pcCU, TCoeff* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx );
+  Void xQuant8x8  ( TComDataCU* pcCU, TCoeff* plSrcCoef, TCoeff*& pDstCoef, UInt& uiAbsSum, TextType eTType, UInt uiAbsPartIdx );
 
 
   // RDOQ functions
@@ -288,7 +311,7 @@ private:
 UInt             getCurrLineNum(UInt uiScanIdx, UInt uiPosX, UInt uiPosY);
 #endif
   Void           xRateDistOptQuant_LCEC ( TComDataCU*                     pcCU,
-                                          Long*                           plSrcCoeff,
+                                          TCoeff*                         plSrcCoeff,
                                           TCoeff*&                        piDstCoeff,
                                           UInt                            uiWidth,
                                           UInt                            uiHeight,
@@ -297,7 +320,7 @@ UInt             getCurrLineNum(UInt uiScanIdx, UInt uiPosX, UInt uiPosY);
                                           UInt                            uiAbsPartIdx );
   
   Void           xRateDistOptQuant ( TComDataCU*                     pcCU,
-                                     Long*                           plSrcCoeff,
+                                     TCoeff*                         plSrcCoeff,
                                      TCoeff*&                        piDstCoeff,
                                      UInt                            uiWidth,
                                      UInt                            uiHeight,
@@ -350,23 +373,26 @@ UInt             getCurrLineNum(UInt uiScanIdx, UInt uiPosX, UInt uiPosY);
   __inline static Long  xTrRound ( Long i, UInt uiShift ) { return ((i)>>uiShift); }
   
   // dequantization
-  Void xDeQuant         ( TCoeff* pSrc,     Long*& pDes,       Int iWidth, Int iHeight );
-  Void xDeQuantLTR      ( TCoeff* pSrc,     Long*&  pDes,      Int iWidth, Int iHeight );
-  Void xDeQuant2x2      ( TCoeff* pSrcCoef, Long*& rplDstCoef );
-  Void xDeQuant4x4      ( TCoeff* pSrcCoef, Long*& rplDstCoef );
-  Void xDeQuant8x8      ( TCoeff* pSrcCoef, Long*& rplDstCoef );
+  Void xDeQuant         ( TCoeff* pSrc,     TCoeff*& pDes,     Int iWidth, Int iHeight, Int& riNzRows, Int& riNzCols );
+  Void xDeQuantLTR      ( TCoeff* pSrc,     TCoeff*& pDes,     Int iWidth, Int iHeight, Int& riNzRows, Int& riNzCols );
+  Void xDeQuant2x2      ( TCoeff* pSrcCoef, TCoeff*& rplDstCoef );
+  Void xDeQuant4x4      ( TCoeff* pSrcCoef, TCoeff*& rplDstCoef );
+  Void xDeQuant8x8      ( TCoeff* pSrcCoef, TCoeff*& rplDstCoef );
   
   // inverse transform
 #if INTRA_DST_TYPE_7
-  Void xIT    ( UInt uiMode, Long* plCoef, Pel* pResidual, UInt uiStride, Int iSize );
+  Void xIT    ( UInt uiMode, TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iSize, Int iNzRows, Int iNzCols );
 #else
-  Void xIT    ( Long* plCoef, Pel* pResidual, UInt uiStride, Int iSize );
+  Void xIT    ( TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iSize, Int iNzRows, Int iNzCols );
+#endif
+#if E243_CORE_TRANSFORMS
+  Void xITDC  ( TCoeff iCoeffDC, Pel* pResidual, UInt uiStride, Int iSize );
 #endif
-  Void xIT2   ( Long* plCoef, Pel* pResidual, UInt uiStride );
-  Void xIT4   ( Long* plCoef, Pel* pResidual, UInt uiStride );
-  Void xIT8   ( Long* plCoef, Pel* pResidual, UInt uiStride );
-  Void xIT16  ( Long* plCoef, Pel* pResidual, UInt uiStride );
-  Void xIT32  ( Long* plCoef, Pel* pResidual, UInt uiStride );
+  Void xIT2   ( TCoeff* plCoef, Pel* pResidual, UInt uiStride );
+  Void xIT4   ( TCoeff* plCoef, Pel* pResidual, UInt uiStride );
+  Void xIT8   ( TCoeff* plCoef, Pel* pResidual, UInt uiStride );
+  Void xIT16  ( TCoeff* plCoef, Pel* pResidual, UInt uiStride );
+  Void xIT32  ( TCoeff* plCoef, Pel* pResidual, UInt uiStride );
 
 
 };// END CLASS DEFINITION TComTrQuant
@@ -0,0 +1,608 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComTrQuantSIMD.cpp
+    \brief    SSE4.1 / AVX2 core transform kernels selected at run time
+*/
+
+#include <memory.h>
+#include "TComTrQuantSIMD.h"
+
+#if E243_CORE_TRANSFORMS
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TRQUANT_SIMD      1
+#include <immintrin.h>
+#else
+#define TRQUANT_SIMD      0
+#endif
+
+// the kernels are compiled for their own instruction set, the rest of the library keeps the default target
+#if defined(__GNUC__)
+#define TARGET_SSE41  __attribute__((target("sse4.1")))
+#define TARGET_AVX2   __attribute__((target("avx2")))
+#define SIMD_INLINE   inline __attribute__((always_inline))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#define SIMD_INLINE   __forceinline
+#endif
+
+#if TRQUANT_SIMD
+
+// ====================================================================================================================
+// Tables
+// ====================================================================================================================
+
+/// core transform matrices
+enum TrMatrix
+{
+  TR_MAT_DCT4 = 0,
+  TR_MAT_DST4,
+  TR_MAT_DCT8,
+  TR_MAT_DCT16,
+  TR_MAT_DCT32,
+  TR_NUM_MAT
+};
+
+// A 1-D transform is evaluated as a matrix product with madd: two adjacent inputs packed into one 32-bit lane are
+// multiplied by the matching pair of matrix entries. All sums fit in 32 bits, so the result equals the butterflies.
+static Int s_aaiRowPairs[TR_NUM_MAT][16 * 32];  ///< [p * size + k] = ( T[k][2p], T[k][2p+1] ), forward transform
+static Int s_aaiColPairs[TR_NUM_MAT][16 * 32];  ///< [p * size + k] = ( T[2p][k], T[2p+1][k] ), inverse transform
+static Int s_aaiEOPairs [TR_NUM_MAT][16 * 32];  ///< [p * size + k] = ( T[m][k], T[m+2][k] ), m = xEORow( p ), inverse of the DCT
+
+/// pair ( a, b ) packed into one 32-bit lane for madd
+static inline Int xPair( Short sA, Short sB )
+{
+  return (Int)( (UInt)(UShort)sA | ( (UInt)(UShort)sB << 16 ) );
+}
+
+/// two adjacent 16-bit values as one 32-bit lane
+static inline Int xLoadPair( const Short* ps )
+{
+  Int iPair;
+  ::memcpy( &iPair, ps, sizeof(Int) );
+  return iPair;
+}
+
+/// first of the two rows of pair p when even and odd rows are paired separately, 0 / 1 / 4 / 5 / 8 ...
+static inline Int xEORow( Int p )
+{
+  return ( ( p >> 1 ) << 2 ) + ( p & 1 );
+}
+
+static Void xInitPairs( Int iMat, const Short* psMat, Int iSize )
+{
+  for ( Int p = 0; p < iSize / 2; p++ )
+  {
+    for ( Int k = 0; k < iSize; k++ )
+    {
+      s_aaiRowPairs[iMat][p * iSize + k] = xPair( psMat[k * iSize + 2 * p], psMat[k * iSize + 2 * p + 1] );
+      s_aaiColPairs[iMat][p * iSize + k] = xPair( psMat[2 * p * iSize + k], psMat[( 2 * p + 1 ) * iSize + k] );
+      s_aaiEOPairs [iMat][p * iSize + k] = xPair( psMat[xEORow( p ) * iSize + k], psMat[( xEORow( p ) + 2 ) * iSize + k] );
+    }
+  }
+}
+
+/// fills the pair tables once at start-up, the matrices are constant-initialised
+static struct TrPairTables
+{
+  TrPairTables()
+  {
+    xInitPairs( TR_MAT_DCT4,  g_aiT4 [0],  4 );
+#if INTRA_DST_TYPE_7
+    xInitPairs( TR_MAT_DST4,  g_as_DST_MAT_4[0], 4 );
+#endif
+    xInitPairs( TR_MAT_DCT8,  g_aiT8 [0],  8 );
+    xInitPairs( TR_MAT_DCT16, g_aiT16[0], 16 );
+    xInitPairs( TR_MAT_DCT32, g_aiT32[0], 32 );
+  }
+} s_cTrPairTables;
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+/// matrix of one direction, the 4x4 DST replaces the DCT for the intra modes flagged in the direction's table
+static inline Int xGetMatrix( Int iLog2Size, UInt uiMode, Bool bHor )
+{
+  if ( iLog2Size > 2 )
+  {
+    return iLog2Size - 1;
+  }
+#if INTRA_DST_TYPE_7
+  if ( uiMode != REG_DCT && ( bHor ? g_aucDCTDSTMode_Hor[uiMode] : g_aucDCTDSTMode_Vert[uiMode] ) )
+  {
+    return TR_MAT_DST4;
+  }
+#endif
+  return TR_MAT_DCT4;
+}
+
+static inline Void xGetFwdShift( Int iLog2Size, Int& riShift1st, Int& riShift2nd )
+{
+#if FULL_NBIT
+  riShift1st = iLog2Size - 1 + g_uiBitDepth - 8;
+#else
+  riShift1st = iLog2Size - 1 + g_uiBitIncrement;
+#endif
+  riShift2nd = iLog2Size + 6;
+}
+
+static inline Void xGetInvShift( Int& riShift1st, Int& riShift2nd )
+{
+  riShift1st = SHIFT_INV_1ST;
+#if FULL_NBIT
+  riShift2nd = SHIFT_INV_2ND - ((short)g_uiBitDepth - 8);
+#else
+  riShift2nd = SHIFT_INV_2ND - g_uiBitIncrement;
+#endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// SSE4.1
+// --------------------------------------------------------------------------------------------------------------------
+
+/// rounds sums and truncates them to 16 bits as the short stage buffers of the butterflies do, sign-extended
+TARGET_SSE41 static SIMD_INLINE __m128i xRoundTrunc( __m128i vSum, __m128i vAdd, __m128i vShift )
+{
+  vSum = _mm_sra_epi32( _mm_add_epi32( vSum, vAdd ), vShift );
+  return _mm_srai_epi32( _mm_slli_epi32( vSum, 16 ), 16 );
+}
+
+/// forward NxN transform: H = X * Th^T row by row, then C = Tv * H
+template <Int N>
+TARGET_SSE41 static SIMD_INLINE Void xFwdCore_SSE41( const Pel* piResi, UInt uiStride, TCoeff* piCoeff, const Int* piHor, const Int* piVer, Int iShift1st, Int iShift2nd )
+{
+  Int     aiTmp[N / 2 * N];
+  __m128i vMask  = _mm_set1_epi32( 0xffff );
+  __m128i vAdd   = _mm_set1_epi32( 1 << ( iShift1st - 1 ) );
+  __m128i vShift = _mm_cvtsi32_si128( iShift1st );
+  
+  // horizontal pass, rows 2p and 2p + 1 of H are kept as pairs ( H[2p][k], H[2p+1][k] ) for the vertical pass
+  for ( Int p = 0; p < N / 2; p++ )
+  {
+    const Pel* piRow0 = piResi + 2 * p * uiStride;
+    const Pel* piRow1 = piRow0 + uiStride;
+    for ( Int k = 0; k < N; k += 4 )
+    {
+      __m128i vSum0 = _mm_setzero_si128();
+      __m128i vSum1 = _mm_setzero_si128();
+      for ( Int m = 0; m < N; m += 2 )
+      {
+        __m128i vBasis = _mm_loadu_si128( (const __m128i*)&piHor[( m >> 1 ) * N + k] );
+        vSum0 = _mm_add_epi32( vSum0, _mm_madd_epi16( _mm_set1_epi32( xLoadPair( piRow0 + m ) ), vBasis ) );
+        vSum1 = _mm_add_epi32( vSum1, _mm_madd_epi16( _mm_set1_epi32( xLoadPair( piRow1 + m ) ), vBasis ) );
+      }
+      vSum0 = xRoundTrunc( vSum0, vAdd, vShift );
+      vSum1 = xRoundTrunc( vSum1, vAdd, vShift );
+      _mm_storeu_si128( (__m128i*)&aiTmp[p * N + k], _mm_or_si128( _mm_and_si128( vSum0, vMask ), _mm_slli_epi32( vSum1, 16 ) ) );
+    }
+  }
+  
+  // vertical pass
+  vAdd   = _mm_set1_epi32( 1 << ( iShift2nd - 1 ) );
+  vShift = _mm_cvtsi32_si128( iShift2nd );
+  for ( Int k = 0; k < N; k++ )
+  {
+    for ( Int n = 0; n < N; n += 4 )
+    {
+      __m128i vSum = _mm_setzero_si128();
+      for ( Int p = 0; p < N / 2; p++ )
+      {
+        vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)&aiTmp[p * N + n] ), _mm_set1_epi32( piVer[p * N + k] ) ) );
+      }
+      _mm_storeu_si128( (__m128i*)&piCoeff[k * N + n], xRoundTrunc( vSum, vAdd, vShift ) );
+    }
+  }
+}
+
+/// inverse NxN transform: V = Tv^T * C, then X = V * Th row by row; only the groups of up to 8 rows and columns covering the first iNzRows x iNzCols coefficients are read
+template <Int N>
+TARGET_SSE41 static SIMD_INLINE Void xInvCore_SSE41( const TCoeff* piCoeff, Pel* piResi, UInt uiStride, const Int* piHor, const Int* piVer, Int iShift1st, Int iShift2nd, Int iNzRows, Int iNzCols )
+{
+  if ( iNzRows == 0 )
+  {
+    for ( Int j = 0; j < N; j++ )
+    {
+      ::memset( piResi + j * uiStride, 0, N * sizeof(Pel) );
+    }
+    return;
+  }
+  
+  // the DCT pairs even and odd rows separately: the even basis functions are symmetric, the odd ones antisymmetric
+  const Bool bEO       = N > 4;
+  const Int  iRowPairs = bEO ? ( ( iNzRows + 3 ) >> 2 ) << 1 : ( iNzRows + 1 ) >> 1;
+  const Int  iColPairs = bEO ? ( ( iNzCols + 3 ) >> 2 ) << 1 : ( iNzCols + 1 ) >> 1;
+  const Int  iCols     = ( iNzCols + 3 ) & ~3;
+  Int     aiCoef[N / 2 * N];
+  Short   asTmp [N * N];
+  __m128i vMask  = _mm_set1_epi32( 0xffff );
+  __m128i vAdd   = _mm_set1_epi32( 1 << ( iShift1st - 1 ) );
+  __m128i vShift = _mm_cvtsi32_si128( iShift1st );
+  
+  // coefficient row pairs, truncated to 16 bits
+  for ( Int p = 0; p < iRowPairs; p++ )
+  {
+    const TCoeff* piRow0 = piCoeff + ( bEO ? xEORow( p ) : 2 * p ) * N;
+    const TCoeff* piRow1 = piRow0 + ( bEO ? 2 * N : N );
+    for ( Int n = 0; n < iCols; n += 4 )
+    {
+      __m128i vRow0 = _mm_loadu_si128( (const __m128i*)&piRow0[n] );
+      __m128i vRow1 = _mm_loadu_si128( (const __m128i*)&piRow1[n] );
+      _mm_storeu_si128( (__m128i*)&aiCoef[p * N + n], _mm_or_si128( _mm_and_si128( vRow0, vMask ), _mm_slli_epi32( vRow1, 16 ) ) );
+    }
+  }
+  
+  // vertical pass, columns beyond iCols of V stay unused
+  if ( bEO )
+  {
+    for ( Int j = 0; j < N / 2; j++ )
+    {
+      for ( Int n = 0; n < iCols; n += 4 )
+      {
+        __m128i vEven = _mm_setzero_si128();
+        __m128i vOdd  = _mm_setzero_si128();
+        for ( Int p = 0; p < iRowPairs; p += 2 )
+        {
+          vEven = _mm_add_epi32( vEven, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)&aiCoef[ p      * N + n] ), _mm_set1_epi32( piVer[ p      * N + j] ) ) );
+          vOdd  = _mm_add_epi32( vOdd,  _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)&aiCoef[( p + 1 ) * N + n] ), _mm_set1_epi32( piVer[( p + 1 ) * N + j] ) ) );
+        }
+        __m128i vSum0 = xRoundTrunc( _mm_add_epi32( vEven, vOdd ), vAdd, vShift );
+        __m128i vSum1 = xRoundTrunc( _mm_sub_epi32( vEven, vOdd ), vAdd, vShift );
+        _mm_storel_epi64( (__m128i*)&asTmp[          j   * N + n], _mm_packs_epi32( vSum0, vSum0 ) );
+        _mm_storel_epi64( (__m128i*)&asTmp[( N - 1 - j ) * N + n], _mm_packs_epi32( vSum1, vSum1 ) );
+      }
+    }
+  }
+  else
+  {
+    for ( Int j = 0; j < N; j++ )
+    {
+      for ( Int n = 0; n < iCols; n += 4 )
+      {
+        __m128i vSum = _mm_setzero_si128();
+        for ( Int p = 0; p < iRowPairs; p++ )
+        {
+          vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)&aiCoef[p * N + n] ), _mm_set1_epi32( piVer[p * N + j] ) ) );
+        }
+        vSum = xRoundTrunc( vSum, vAdd, vShift );
+        _mm_storel_epi64( (__m128i*)&asTmp[j * N + n], _mm_packs_epi32( vSum, vSum ) );
+      }
+    }
+  }
+  
+  // horizontal pass, the symmetry of the DCT gives the outputs k and N - 1 - k together
+  vAdd   = _mm_set1_epi32( 1 << ( iShift2nd - 1 ) );
+  vShift = _mm_cvtsi32_si128( iShift2nd );
+  for ( Int j = 0; j < N; j++ )
+  {
+    const Short* psRow = asTmp + j * N;
+    Pel*         piDst = piResi + j * uiStride;
+    if ( N == 4 )
+    {
+      __m128i vSum = _mm_setzero_si128();
+      for ( Int p = 0; p < iColPairs; p++ )
+      {
+        vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_set1_epi32( xLoadPair( psRow + 2 * p ) ), _mm_loadu_si128( (const __m128i*)&piHor[p * N] ) ) );
+      }
+      vSum = xRoundTrunc( vSum, vAdd, vShift );
+      _mm_storel_epi64( (__m128i*)piDst, _mm_packs_epi32( vSum, vSum ) );
+      continue;
+    }
+    
+    Int aiPair[N / 2];
+    for ( Int p = 0; p < iColPairs; p++ )
+    {
+      aiPair[p] = xPair( psRow[xEORow( p )], psRow[xEORow( p ) + 2] );
+    }
+    if ( N == 8 )
+    {
+      __m128i vEven = _mm_setzero_si128();
+      __m128i vOdd  = _mm_setzero_si128();
+      for ( Int p = 0; p < iColPairs; p += 2 )
+      {
+        vEven = _mm_add_epi32( vEven, _mm_madd_epi16( _mm_set1_epi32( aiPair[p    ] ), _mm_loadu_si128( (const __m128i*)&piHor[ p      * N] ) ) );
+        vOdd  = _mm_add_epi32( vOdd,  _mm_madd_epi16( _mm_set1_epi32( aiPair[p + 1] ), _mm_loadu_si128( (const __m128i*)&piHor[( p + 1 ) * N] ) ) );
+      }
+      __m128i vSum0 = xRoundTrunc( _mm_add_epi32( vEven, vOdd ), vAdd, vShift );
+      __m128i vSum1 = xRoundTrunc( _mm_sub_epi32( vEven, vOdd ), vAdd, vShift );
+      _mm_storeu_si128( (__m128i*)piDst, _mm_packs_epi32( vSum0, _mm_shuffle_epi32( vSum1, 0x1b ) ) );
+      continue;
+    }
+    for ( Int k = 0; k < N / 2; k += 8 )
+    {
+      __m128i vEvenLo = _mm_setzero_si128();
+      __m128i vEvenHi = _mm_setzero_si128();
+      __m128i vOddLo  = _mm_setzero_si128();
+      __m128i vOddHi  = _mm_setzero_si128();
+      for ( Int p = 0; p < iColPairs; p += 2 )
+      {
+        __m128i vPair = _mm_set1_epi32( aiPair[p] );
+        vEvenLo = _mm_add_epi32( vEvenLo, _mm_madd_epi16( vPair, _mm_loadu_si128( (const __m128i*)&piHor[p * N + k    ] ) ) );
+        vEvenHi = _mm_add_epi32( vEvenHi, _mm_madd_epi16( vPair, _mm_loadu_si128( (const __m128i*)&piHor[p * N + k + 4] ) ) );
+        vPair   = _mm_set1_epi32( aiPair[p + 1] );
+        vOddLo  = _mm_add_epi32( vOddLo,  _mm_madd_epi16( vPair, _mm_loadu_si128( (const __m128i*)&piHor[( p + 1 ) * N + k    ] ) ) );
+        vOddHi  = _mm_add_epi32( vOddHi,  _mm_madd_epi16( vPair, _mm_loadu_si128( (const __m128i*)&piHor[( p + 1 ) * N + k + 4] ) ) );
+      }
+      __m128i vLo0 = xRoundTrunc( _mm_add_epi32( vEvenLo, vOddLo ), vAdd, vShift );
+      __m128i vHi0 = xRoundTrunc( _mm_add_epi32( vEvenHi, vOddHi ), vAdd, vShift );
+      __m128i vLo1 = xRoundTrunc( _mm_sub_epi32( vEvenLo, vOddLo ), vAdd, vShift );
+      __m128i vHi1 = xRoundTrunc( _mm_sub_epi32( vEvenHi, vOddHi ), vAdd, vShift );
+      _mm_storeu_si128( (__m128i*)&piDst[k        ], _mm_packs_epi32( vLo0, vHi0 ) );
+      _mm_storeu_si128( (__m128i*)&piDst[N - 8 - k], _mm_packs_epi32( _mm_shuffle_epi32( vHi1, 0x1b ), _mm_shuffle_epi32( vLo1, 0x1b ) ) );
+    }
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// AVX2
+// --------------------------------------------------------------------------------------------------------------------
+
+TARGET_AVX2 static SIMD_INLINE __m256i xRoundTrunc256( __m256i vSum, __m256i vAdd, __m128i vShift )
+{
+  vSum = _mm256_sra_epi32( _mm256_add_epi32( vSum, vAdd ), vShift );
+  return _mm256_srai_epi32( _mm256_slli_epi32( vSum, 16 ), 16 );
+}
+
+/// eight 16-bit values of a truncated 32-bit vector, in order
+TARGET_AVX2 static SIMD_INLINE __m128i xPack8( __m256i v )
+{
+  return _mm256_castsi256_si128( _mm256_permute4x64_epi64( _mm256_packs_epi32( v, v ), 0x08 ) );
+}
+
+/// as xFwdCore_SSE41, eight outputs per vector, N >= 8
+template <Int N>
+TARGET_AVX2 static SIMD_INLINE Void xFwdCore_AVX2( const Pel* piResi, UInt uiStride, TCoeff* piCoeff, const Int* piHor, const Int* piVer, Int iShift1st, Int iShift2nd )
+{
+  Int     aiTmp[N / 2 * N];
+  __m256i vMask  = _mm256_set1_epi32( 0xffff );
+  __m256i vAdd   = _mm256_set1_epi32( 1 << ( iShift1st - 1 ) );
+  __m128i vShift = _mm_cvtsi32_si128( iShift1st );
+  
+  for ( Int p = 0; p < N / 2; p++ )
+  {
+    const Pel* piRow0 = piResi + 2 * p * uiStride;
+    const Pel* piRow1 = piRow0 + uiStride;
+    for ( Int k = 0; k < N; k += 8 )
+    {
+      __m256i vSum0 = _mm256_setzero_si256();
+      __m256i vSum1 = _mm256_setzero_si256();
+      for ( Int m = 0; m < N; m += 2 )
+      {
+        __m256i vBasis = _mm256_loadu_si256( (const __m256i*)&piHor[( m >> 1 ) * N + k] );
+        vSum0 = _mm256_add_epi32( vSum0, _mm256_madd_epi16( _mm256_set1_epi32( xLoadPair( piRow0 + m ) ), vBasis ) );
+        vSum1 = _mm256_add_epi32( vSum1, _mm256_madd_epi16( _mm256_set1_epi32( xLoadPair( piRow1 + m ) ), vBasis ) );
+      }
+      vSum0 = xRoundTrunc256( vSum0, vAdd, vShift );
+      vSum1 = xRoundTrunc256( vSum1, vAdd, vShift );
+      _mm256_storeu_si256( (__m256i*)&aiTmp[p * N + k], _mm256_or_si256( _mm256_and_si256( vSum0, vMask ), _mm256_slli_epi32( vSum1, 16 ) ) );
+    }
+  }
+  
+  vAdd   = _mm256_set1_epi32( 1 << ( iShift2nd - 1 ) );
+  vShift = _mm_cvtsi32_si128( iShift2nd );
+  for ( Int k = 0; k < N; k++ )
+  {
+    for ( Int n = 0; n < N; n += 8 )
+    {
+      __m256i vSum = _mm256_setzero_si256();
+      for ( Int p = 0; p < N / 2; p++ )
+      {
+        vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( _mm256_loadu_si256( (const __m256i*)&aiTmp[p * N + n] ), _mm256_set1_epi32( piVer[p * N + k] ) ) );
+      }
+      _mm256_storeu_si256( (__m256i*)&piCoeff[k * N + n], xRoundTrunc256( vSum, vAdd, vShift ) );
+    }
+  }
+}
+
+/// as xInvCore_SSE41, eight outputs per vector, N >= 8
+template <Int N>
+TARGET_AVX2 static SIMD_INLINE Void xInvCore_AVX2( const TCoeff* piCoeff, Pel* piResi, UInt uiStride, const Int* piHor, const Int* piVer, Int iShift1st, Int iShift2nd, Int iNzRows, Int iNzCols )
+{
+  if ( iNzRows == 0 )
+  {
+    for ( Int j = 0; j < N; j++ )
+    {
+      ::memset( piResi + j * uiStride, 0, N * sizeof(Pel) );
+    }
+    return;
+  }
+  
+  const Int iRowPairs = ( ( iNzRows + 3 ) >> 2 ) << 1;
+  const Int iColPairs = ( ( iNzCols + 3 ) >> 2 ) << 1;
+  const Int iCols     = ( iNzCols + 7 ) & ~7;
+  Int     aiCoef[N / 2 * N];
+  Short   asTmp [N * N];
+  __m256i vMask  = _mm256_set1_epi32( 0xffff );
+  __m256i vAdd   = _mm256_set1_epi32( 1 << ( iShift1st - 1 ) );
+  __m128i vShift = _mm_cvtsi32_si128( iShift1st );
+  
+  for ( Int p = 0; p < iRowPairs; p++ )
+  {
+    const TCoeff* piRow0 = piCoeff + xEORow( p ) * N;
+    const TCoeff* piRow1 = piRow0 + 2 * N;
+    for ( Int n = 0; n < iCols; n += 8 )
+    {
+      __m256i vRow0 = _mm256_loadu_si256( (const __m256i*)&piRow0[n] );
+      __m256i vRow1 = _mm256_loadu_si256( (const __m256i*)&piRow1[n] );
+      _mm256_storeu_si256( (__m256i*)&aiCoef[p * N + n], _mm256_or_si256( _mm256_and_si256( vRow0, vMask ), _mm256_slli_epi32( vRow1, 16 ) ) );
+    }
+  }
+  
+  for ( Int j = 0; j < N / 2; j++ )
+  {
+    for ( Int n = 0; n < iCols; n += 8 )
+    {
+      __m256i vEven = _mm256_setzero_si256();
+      __m256i vOdd  = _mm256_setzero_si256();
+      for ( Int p = 0; p < iRowPairs; p += 2 )
+      {
+        vEven = _mm256_add_epi32( vEven, _mm256_madd_epi16( _mm256_loadu_si256( (const __m256i*)&aiCoef[ p      * N + n] ), _mm256_set1_epi32( piVer[ p      * N + j] ) ) );
+        vOdd  = _mm256_add_epi32( vOdd,  _mm256_madd_epi16( _mm256_loadu_si256( (const __m256i*)&aiCoef[( p + 1 ) * N + n] ), _mm256_set1_epi32( piVer[( p + 1 ) * N + j] ) ) );
+      }
+      _mm_storeu_si128( (__m128i*)&asTmp[          j   * N + n], xPack8( xRoundTrunc256( _mm256_add_epi32( vEven, vOdd ), vAdd, vShift ) ) );
+      _mm_storeu_si128( (__m128i*)&asTmp[( N - 1 - j ) * N + n], xPack8( xRoundTrunc256( _mm256_sub_epi32( vEven, vOdd ), vAdd, vShift ) ) );
+    }
+  }
+  
+  vAdd   = _mm256_set1_epi32( 1 << ( iShift2nd - 1 ) );
+  vShift = _mm_cvtsi32_si128( iShift2nd );
+  __m128i vAdd128 = _mm256_castsi256_si128( vAdd );
+  __m256i vRev    = _mm256_setr_epi32( 7, 6, 5, 4, 3, 2, 1, 0 );
+  for ( Int j = 0; j < N; j++ )
+  {
+    const Short* psRow = asTmp + j * N;
+    Pel*         piDst = piResi + j * uiStride;
+    Int          aiPair[N / 2];
+    for ( Int p = 0; p < iColPairs; p++ )
+    {
+      aiPair[p] = xPair( psRow[xEORow( p )], psRow[xEORow( p ) + 2] );
+    }
+    if ( N == 8 )
+    {
+      __m128i vEven = _mm_setzero_si128();
+      __m128i vOdd  = _mm_setzero_si128();
+      for ( Int p = 0; p < iColPairs; p += 2 )
+      {
+        vEven = _mm_add_epi32( vEven, _mm_madd_epi16( _mm_set1_epi32( aiPair[p    ] ), _mm_loadu_si128( (const __m128i*)&piHor[ p      * N] ) ) );
+        vOdd  = _mm_add_epi32( vOdd,  _mm_madd_epi16( _mm_set1_epi32( aiPair[p + 1] ), _mm_loadu_si128( (const __m128i*)&piHor[( p + 1 ) * N] ) ) );
+      }
+      __m128i vSum0 = xRoundTrunc( _mm_add_epi32( vEven, vOdd ), vAdd128, vShift );
+      __m128i vSum1 = xRoundTrunc( _mm_sub_epi32( vEven, vOdd ), vAdd128, vShift );
+      _mm_storeu_si128( (__m128i*)piDst, _mm_packs_epi32( vSum0, _mm_shuffle_epi32( vSum1, 0x1b ) ) );
+      continue;
+    }
+    for ( Int k = 0; k < N / 2; k += 8 )
+    {
+      __m256i vEven = _mm256_setzero_si256();
+      __m256i vOdd  = _mm256_setzero_si256();
+      for ( Int p = 0; p < iColPairs; p += 2 )
+      {
+        vEven = _mm256_add_epi32( vEven, _mm256_madd_epi16( _mm256_set1_epi32( aiPair[p    ] ), _mm256_loadu_si256( (const __m256i*)&piHor[ p      * N + k] ) ) );
+        vOdd  = _mm256_add_epi32( vOdd,  _mm256_madd_epi16( _mm256_set1_epi32( aiPair[p + 1] ), _mm256_loadu_si256( (const __m256i*)&piHor[( p + 1 ) * N + k] ) ) );
+      }
+      __m256i vSum1 = xRoundTrunc256( _mm256_sub_epi32( vEven, vOdd ), vAdd, vShift );
+      _mm_storeu_si128( (__m128i*)&piDst[k        ], xPack8( xRoundTrunc256( _mm256_add_epi32( vEven, vOdd ), vAdd, vShift ) ) );
+      _mm_storeu_si128( (__m128i*)&piDst[N - 8 - k], xPack8( _mm256_permutevar8x32_epi32( vSum1, vRev ) ) );
+    }
+  }
+}
+
+#endif // TRQUANT_SIMD
+
+// ====================================================================================================================
+// Kernels
+// ====================================================================================================================
+
+#if TRQUANT_SIMD
+
+template <Int iLog2Size>
+TARGET_SSE41 Void TComTrQuantSIMD::xFwdTrans_SSE41( UInt uiMode, const Pel* piResi, UInt uiStride, TCoeff* piCoeff )
+{
+  Int iShift1st, iShift2nd;
+  xGetFwdShift( iLog2Size, iShift1st, iShift2nd );
+  xFwdCore_SSE41<1 << iLog2Size>( piResi, uiStride, piCoeff, s_aaiRowPairs[ xGetMatrix( iLog2Size, uiMode, true ) ], s_aaiRowPairs[ xGetMatrix( iLog2Size, uiMode, false ) ], iShift1st, iShift2nd );
+}
+
+template <Int iLog2Size>
+TARGET_SSE41 Void TComTrQuantSIMD::xInvTrans_SSE41( UInt uiMode, const TCoeff* piCoeff, Pel* piResi, UInt uiStride, Int iNzRows, Int iNzCols )
+{
+  Int iShift1st, iShift2nd;
+  xGetInvShift( iShift1st, iShift2nd );
+  xInvCore_SSE41<1 << iLog2Size>( piCoeff, piResi, uiStride, ( iLog2Size > 2 ? s_aaiEOPairs : s_aaiColPairs )[ xGetMatrix( iLog2Size, uiMode, true ) ], ( iLog2Size > 2 ? s_aaiEOPairs : s_aaiColPairs )[ xGetMatrix( iLog2Size, uiMode, false ) ], iShift1st, iShift2nd, iNzRows, iNzCols );
+}
+
+template <Int iLog2Size>
+TARGET_AVX2 Void TComTrQuantSIMD::xFwdTrans_AVX2( UInt uiMode, const Pel* piResi, UInt uiStride, TCoeff* piCoeff )
+{
+  Int iShift1st, iShift2nd;
+  xGetFwdShift( iLog2Size, iShift1st, iShift2nd );
+  xFwdCore_AVX2<1 << iLog2Size>( piResi, uiStride, piCoeff, s_aaiRowPairs[ xGetMatrix( iLog2Size, uiMode, true ) ], s_aaiRowPairs[ xGetMatrix( iLog2Size, uiMode, false ) ], iShift1st, iShift2nd );
+}
+
+template <Int iLog2Size>
+TARGET_AVX2 Void TComTrQuantSIMD::xInvTrans_AVX2( UInt uiMode, const TCoeff* piCoeff, Pel* piResi, UInt uiStride, Int iNzRows, Int iNzCols )
+{
+  Int iShift1st, iShift2nd;
+  xGetInvShift( iShift1st, iShift2nd );
+  xInvCore_AVX2<1 << iLog2Size>( piCoeff, piResi, uiStride, s_aaiEOPairs[ xGetMatrix( iLog2Size, uiMode, true ) ], s_aaiEOPairs[ xGetMatrix( iLog2Size, uiMode, false ) ], iShift1st, iShift2nd, iNzRows, iNzCols );
+}
+
+#endif // TRQUANT_SIMD
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Replace the generic core transform kernels by the best ones allowed by iLevel and the running CPU.
+ * \param afpFwdTrans, afpInvTrans kernel tables of TComTrQuant, [log2( size ) - 2], holding the generic kernels
+ * \param iLevel requested SIMDLevel, SIMD_AUTO for the best supported one
+ * \returns level actually used
+ */
+Int TComTrQuantSIMD::initTrQuantFunc( FpFwdTrans* afpFwdTrans, FpInvTrans* afpInvTrans, Int iLevel )
+{
+  Int iCPULevel = TComRdCostSIMD::getCPULevel();
+  if ( iLevel < 0 || iLevel > iCPULevel )
+  {
+    iLevel = iCPULevel;
+  }
+  
+#if TRQUANT_SIMD
+  if ( iLevel >= SIMD_SSE41 )
+  {
+    afpFwdTrans[0] = xFwdTrans_SSE41<2>;
+    afpFwdTrans[1] = xFwdTrans_SSE41<3>;
+    afpFwdTrans[2] = xFwdTrans_SSE41<4>;
+    afpFwdTrans[3] = xFwdTrans_SSE41<5>;
+    afpInvTrans[0] = xInvTrans_SSE41<2>;
+    afpInvTrans[1] = xInvTrans_SSE41<3>;
+    afpInvTrans[2] = xInvTrans_SSE41<4>;
+    afpInvTrans[3] = xInvTrans_SSE41<5>;
+  }
+  if ( iLevel >= SIMD_AVX2 )
+  {
+    // the 4x4 transforms keep the SSE4.1 kernels
+    afpFwdTrans[1] = xFwdTrans_AVX2<3>;
+    afpFwdTrans[2] = xFwdTrans_AVX2<4>;
+    afpFwdTrans[3] = xFwdTrans_AVX2<5>;
+    afpInvTrans[1] = xInvTrans_AVX2<3>;
+    afpInvTrans[2] = xInvTrans_AVX2<4>;
+    afpInvTrans[3] = xInvTrans_AVX2<5>;
+  }
+#endif
+  
+  return iLevel;
+}
+
+#endif // E243_CORE_TRANSFORMS
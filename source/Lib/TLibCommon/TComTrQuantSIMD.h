@@ -0,0 +1,70 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComTrQuantSIMD.h
+    \brief    SSE4.1 / AVX2 core transform kernels selected at run time (header)
+*/
+
+#ifndef __TCOMTRQUANTSIMD__
+#define __TCOMTRQUANTSIMD__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TComTrQuant.h"
+#include "TComRdCostSIMD.h"
+
+#if E243_CORE_TRANSFORMS
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// vectorised core transforms, bit-exact with the partial butterflies of TComTrQuant
+class TComTrQuantSIMD
+{
+public:
+  static Int  initTrQuantFunc ( FpFwdTrans* afpFwdTrans, FpInvTrans* afpInvTrans, Int iLevel );
+  
+private:
+  template <Int iLog2Size> static Void xFwdTrans_SSE41  ( UInt uiMode, const Pel* piResi, UInt uiStride, TCoeff* piCoeff );
+  template <Int iLog2Size> static Void xInvTrans_SSE41  ( UInt uiMode, const TCoeff* piCoeff, Pel* piResi, UInt uiStride, Int iNzRows, Int iNzCols );
+  
+  template <Int iLog2Size> static Void xFwdTrans_AVX2   ( UInt uiMode, const Pel* piResi, UInt uiStride, TCoeff* piCoeff );
+  template <Int iLog2Size> static Void xInvTrans_AVX2   ( UInt uiMode, const TCoeff* piCoeff, Pel* piResi, UInt uiStride, Int iNzRows, Int iNzCols );
+};// END CLASS DEFINITION TComTrQuantSIMD
+
+#endif // E243_CORE_TRANSFORMS
+
+#endif // __TCOMTRQUANTSIMD__
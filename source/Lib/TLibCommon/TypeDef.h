@@ -49,8 +49,10 @@
 // JCT-VC E end
 ////////////////////////////
 #define JCT_ARC 1
-#define NUM_PIC_RESOLUTIONS               2          ///< Number of picture resolutions available for coding
+#define NUM_PIC_RESOLUTIONS               4          ///< Maximum number of picture resolutions (rungs of the resolution ladder) available for coding
+#define ARC_PIC_SIZE_ALIGN                8          ///< Width and height of the scaled rungs are rounded to a multiple of this
 #define NUM_MISSING_FRAMES_AT_RES_SWITCH  4          ///< Number of frames deemed to have been lost before a resolution switch
+#define ARC_RATE_UP_MARGIN                0.8        ///< Rate-driven switching moves up a rung only if the predicted rate stays below this fraction of the cap
 
 #define HHI_DISABLE_INTER_NxN_SPLIT       1           ///< TN: disable redundant use of pu-mode NxN for CTBs larger 8x8 (inter only)
 #define HHI_RMP_SWITCH                    0
@@ -33,9 +33,19 @@
 
 #include <stdint.h>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
 #include <vector>
 #include "AnnexBread.h"
 
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 using namespace std;
 
 /**
@@ -159,3 +169,179 @@ byteStreamNALUnit(
   stats.m_numBytesInNALUnit = unsigned(nalUnit.size());
   return eof;
 }
+
+bool
+MappedInputByteStream::open(const char* filename)
+{
+  close();
+#if defined(_WIN32)
+  /* no mapping, the bytestream is read as a whole */
+  FILE* file = fopen(filename, "rb");
+  if (!file)
+    return false;
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (size > 0)
+  {
+    m_Data = new uint8_t[size];
+    m_Size = fread(m_Data, 1, size, file);
+  }
+  fclose(file);
+#else
+  int fd = ::open(filename, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) < 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  if (S_ISREG(st.st_mode) && st.st_size > 0)
+  {
+    void* data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+      madvise(data, st.st_size, MADV_SEQUENTIAL);
+      m_Data = (uint8_t*) data;
+      m_Size = st.st_size;
+      m_Mapped = true;
+    }
+  }
+  /* a pipe has no size and is read until its end, as is a file that cannot be mapped */
+  if (!m_Mapped && !readWhole(fd))
+  {
+    ::close(fd);
+    close();
+    return false;
+  }
+  ::close(fd);
+#endif
+  m_Pos = 0;
+  return true;
+}
+
+void
+MappedInputByteStream::close()
+{
+  if (m_Data)
+  {
+#if !defined(_WIN32)
+    if (m_Mapped)
+      munmap(m_Data, m_Size);
+    else
+#endif
+      delete [] m_Data;
+  }
+  m_Data = 0;
+  m_Size = 0;
+  m_Pos = 0;
+  m_Mapped = false;
+}
+
+#if !defined(_WIN32)
+/**
+ * Read the bytestream from @fd@ until its end into a buffer that is
+ * doubled whenever it is full.  Returns false on a read error.
+ */
+bool
+MappedInputByteStream::readWhole(int fd)
+{
+  size_t capacity = 1 << 20;
+  m_Data = new uint8_t[capacity];
+  for (;;)
+  {
+    if (m_Size == capacity)
+    {
+      uint8_t* data = new uint8_t[2 * capacity];
+      memcpy(data, m_Data, m_Size);
+      delete [] m_Data;
+      m_Data = data;
+      capacity *= 2;
+    }
+    ssize_t numBytes = ::read(fd, m_Data + m_Size, capacity - m_Size);
+    if (numBytes == 0)
+      return true;
+    if (numBytes < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    m_Size += numBytes;
+  }
+}
+#endif
+
+/**
+ * Find the first byte-aligned three-byte sequence equal to 0x000000,
+ * 0x000001 or 0x000002 at or after @pos@, which ends a NAL unit.
+ * Returns @size@ if the NAL unit extends to the end of the bytestream.
+ */
+static size_t
+findNALUnitEnd(const uint8_t* data, size_t pos, size_t size)
+{
+  while (size - pos >= 3)
+  {
+    /* only a zero byte can start the sequence, leave the scan to memchr */
+    const uint8_t* zero = (const uint8_t*) memchr(data + pos, 0, size - pos - 2);
+    if (!zero)
+      break;
+    pos = zero - data;
+    if (data[pos+1] == 0 && data[pos+2] <= 2)
+      return pos;
+    pos++;
+  }
+  return size;
+}
+
+/**
+ * Same parsing as the InputByteStream variant of byteStreamNALUnit(), on
+ * the bytestream in memory.
+ */
+bool
+MappedInputByteStream::readNALUnit(uint8_t*& nalUnit, unsigned& numBytes, AnnexBStats& stats)
+{
+  nalUnit = 0;
+  numBytes = 0;
+
+  /* leading_zero_8bits and zero_byte, up to the start_code_prefix_one_3bytes */
+  size_t start = m_Pos;
+  while (m_Size - m_Pos >= 3 && !isStartCode(m_Pos))
+  {
+    assert(m_Data[m_Pos] == 0);
+    m_Pos++;
+  }
+  if (m_Size - m_Pos < 3)
+  {
+    stats.m_numLeadingZero8BitsBytes += unsigned(m_Size - start);
+    m_Pos = m_Size;
+    stats.m_numBytesInNALUnit = 0;
+    return true;
+  }
+  if (m_Pos > start)
+  {
+    stats.m_numLeadingZero8BitsBytes += unsigned(m_Pos - start - 1);
+    stats.m_numZeroByteBytes++;
+  }
+  m_Pos += 3;
+  stats.m_numStartCodePrefixBytes += 3;
+
+  /* nal_unit( NumBytesInNALunit ) */
+  size_t end = findNALUnitEnd(m_Data, m_Pos, m_Size);
+  nalUnit = m_Data + m_Pos;
+  numBytes = unsigned(end - m_Pos);
+  m_Pos = end;
+
+  /* trailing_zero_8bits, up to the zero_byte or start code of the next NAL unit */
+  while (m_Pos < m_Size && !isStartCode(m_Pos) && !(m_Data[m_Pos] == 0 && isStartCode(m_Pos+1)))
+  {
+    assert(m_Data[m_Pos] == 0);
+    stats.m_numTrailingZero8BitsBytes++;
+    m_Pos++;
+  }
+
+  stats.m_numBytesInNALUnit = numBytes;
+  return m_Pos >= m_Size;
+}
@@ -172,3 +172,53 @@ struct AnnexBStats
 };
 
 bool byteStreamNALUnit(InputByteStream& bs, std::vector<uint8_t>& nalUnit, AnnexBStats& stats);
+
+/**
+ * A bytestream held in memory as a whole, mapped from a file where the
+ * platform and the file allow it, read into a buffer otherwise (e.g.
+ * from a pipe).  NAL units are handed out as spans into the
+ * mapping instead of being copied.  The mapping is private and writable,
+ * so that emulation prevention bytes can be removed in place (only the
+ * pages holding them are then copied).
+ */
+class MappedInputByteStream
+{
+public:
+  MappedInputByteStream()
+  : m_Data(0)
+  , m_Size(0)
+  , m_Pos(0)
+  , m_Mapped(false)
+  {}
+
+  ~MappedInputByteStream() { close(); }
+
+  /**
+   * Map the file @filename@, or read it as a whole if it cannot be
+   * mapped.  Returns false if it cannot be opened or read.
+   */
+  bool open(const char* filename);
+
+  /** Release the bytestream, spans handed out become invalid */
+  void close();
+
+  /**
+   * Extract the next NAL unit as the span @nalUnit@ of @numBytes@ bytes
+   * while accumulating bytestream statistics into @stats@.  The span
+   * stays valid until close().
+   *
+   * Returns true if the end of the bytestream was reached (NB, the span
+   * may be valid), otherwise false.
+   */
+  bool readNALUnit(uint8_t*& nalUnit, unsigned& numBytes, AnnexBStats& stats);
+
+private:
+  bool readWhole(int fd);
+
+  bool isStartCode(size_t pos) const { return m_Size - pos >= 3 && m_Data[pos] == 0 && m_Data[pos+1] == 0 && m_Data[pos+2] == 1; }
+
+  uint8_t* m_Data; /* start of the bytestream */
+  size_t m_Size; /* number of bytes in the bytestream */
+  size_t m_Pos; /* position of the next byte to extract */
+  bool m_Mapped; /* m_Data is a mapping rather than a buffer */
+};
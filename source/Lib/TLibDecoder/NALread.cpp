@@ -41,34 +41,42 @@
 
 using namespace std;
 
-static void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf)
+unsigned convertPayloadToRBSP(uint8_t* nalUnit, unsigned numBytes)
 {
   unsigned zeroCount = 0;
-  vector<uint8_t>::iterator it_read, it_write;
-  for (it_read = it_write = nalUnitBuf.begin(); it_read != nalUnitBuf.end(); it_read++, it_write++)
+  unsigned pos_read = 0;
+
+  /* nothing moves in front of the first emulation prevention byte, the
+   * bytes are only inspected so that unchanged memory is not written */
+  for (; pos_read < numBytes; pos_read++)
+  {
+    if (zeroCount == 2 && nalUnit[pos_read] == 0x03)
+      break;
+    zeroCount = (nalUnit[pos_read] == 0x00) ? zeroCount+1 : 0;
+  }
+
+  unsigned pos_write = pos_read;
+  for (; pos_read < numBytes; pos_read++, pos_write++)
   {
-    if (zeroCount == 2 && *it_read == 0x03)
+    if (zeroCount == 2 && nalUnit[pos_read] == 0x03)
     {
-      it_read++;
+      pos_read++;
       zeroCount = 0;
+      if (pos_read == numBytes)
+        break;
     }
-    zeroCount = (*it_read == 0x00) ? zeroCount+1 : 0;
-    *it_write = *it_read;
+    zeroCount = (nalUnit[pos_read] == 0x00) ? zeroCount+1 : 0;
+    nalUnit[pos_write] = nalUnit[pos_read];
   }
 
-  nalUnitBuf.resize(it_write - nalUnitBuf.begin());
+  return pos_write;
 }
 
 /**
- * create a NALunit structure with given header values and storage for
- * a bitstream
+ * read the NAL unit header from the start of the bitstream of @nalu@
  */
-void read(InputNALUnit& nalu, vector<uint8_t>& nalUnitBuf)
+static void readNALUnitHeader(InputNALUnit& nalu)
 {
-  /* perform anti-emulation prevention */
-  convertPayloadToRBSP(nalUnitBuf);
-
-  nalu.m_Bitstream = new TComInputBitstream(&nalUnitBuf);
   TComInputBitstream& bs = *nalu.m_Bitstream;
 
   bool forbidden_zero_bit = bs.read(1);
@@ -94,3 +102,27 @@ void read(InputNALUnit& nalu, vector<uint8_t>& nalUnitBuf)
     break;
   }
 }
+
+/**
+ * create a NALunit structure with given header values and storage for
+ * a bitstream
+ */
+void read(InputNALUnit& nalu, vector<uint8_t>& nalUnitBuf)
+{
+  /* perform anti-emulation prevention */
+  if (!nalUnitBuf.empty())
+    nalUnitBuf.resize(convertPayloadToRBSP(&nalUnitBuf[0], unsigned(nalUnitBuf.size())));
+
+  nalu.m_Bitstream = new TComInputBitstream(&nalUnitBuf);
+  readNALUnitHeader(nalu);
+}
+
+/**
+ * create a NALunit structure with given header values and a bitstream
+ * reading the RBSP of @numBytes@ bytes at @rbsp@
+ */
+void read(InputNALUnit& nalu, const uint8_t* rbsp, unsigned numBytes)
+{
+  nalu.m_Bitstream = new TComInputBitstream(rbsp, numBytes);
+  readNALUnitHeader(nalu);
+}
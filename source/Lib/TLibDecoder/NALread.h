@@ -47,3 +47,10 @@ struct InputNALUnit : public NALUnit
 };
 
 void read(InputNALUnit& nalu, std::vector<uint8_t>& nalUnitBuf);
+void read(InputNALUnit& nalu, const uint8_t* rbsp, unsigned numBytes);
+
+/**
+ * remove the emulation prevention bytes of the @numBytes@ bytes at
+ * @nalUnit@ in place, returns the number of bytes of the RBSP
+ */
+unsigned convertPayloadToRBSP(uint8_t* nalUnit, unsigned numBytes);
@@ -59,15 +59,17 @@ TDecBinCABAC::uninit()
   m_pcTComBitstream = 0;
 }
 
+/** Start decoding: read the 9 bits of the offset and the bits up to the next byte boundary.
+ * From then on the bitstream stays byte-aligned and the offset is refilled a byte at a time.
+ */
 Void
 TDecBinCABAC::start()
 {
-  m_uiRange    = 510;
-  m_uiValue    = 0;
-  for( UInt ui = 0; ui < 9; ui++ )
-  {
-    xReadBit( m_uiValue );
-  }
+  Int iNumBitsAhead = ( m_pcTComBitstream->getNumBitsUntilByteAligned() + 7 ) & 7;
+  
+  m_uiRange     = 510;
+  m_uiValue     = m_pcTComBitstream->read( 9 + iNumBitsAhead ) << ( 7 - iNumBitsAhead );
+  m_iBitsNeeded = -1 - iNumBitsAhead;
 }
 
 Void
@@ -78,35 +80,54 @@ TDecBinCABAC::finish()
 Void
 TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
 {
-  UInt  uiLPS   = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) & 3 ];
-  m_uiRange    -= uiLPS;
-  if( m_uiValue < m_uiRange )
+  UInt  uiLPS         = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) & 3 ];
+  m_uiRange          -= uiLPS;
+  UInt  uiScaledRange = m_uiRange << 7;
+  
+  if( m_uiValue < uiScaledRange )
   {
     ruiBin      = rcCtxModel.getMps();
     rcCtxModel.updateMPS();
+    // the MPS range is never below 128, one bit renormalises it
+    if( uiScaledRange < ( 256 << 7 ) )
+    {
+      m_uiRange  += m_uiRange;
+      m_uiValue  += m_uiValue;
+      if( ++m_iBitsNeeded == 0 )
+      {
+        xReadByte();
+      }
+    }
   }
   else
   {
-    m_uiValue  -= m_uiRange;
-    m_uiRange   = uiLPS;
-    ruiBin      = 1 - rcCtxModel.getMps();
+    Int iNumBits   = TComCABACTables::sm_aucRenormTable[ uiLPS >> 3 ];
+    m_uiValue      = ( m_uiValue - uiScaledRange ) << iNumBits;
+    m_uiRange      = uiLPS << iNumBits;
+    ruiBin         = 1 - rcCtxModel.getMps();
     rcCtxModel.updateLPS();
-  }
-  while( m_uiRange < 256 )
-  {
-    m_uiRange  += m_uiRange;
-    xReadBit( m_uiValue );
+    m_iBitsNeeded += iNumBits;
+    if( m_iBitsNeeded >= 0 )
+    {
+      xReadByte();
+    }
   }
 }
 
 Void
 TDecBinCABAC::decodeBinEP( UInt& ruiBin )
 {
-  xReadBit( m_uiValue );
-  if( m_uiValue >= m_uiRange )
+  m_uiValue += m_uiValue;
+  if( ++m_iBitsNeeded == 0 )
+  {
+    xReadByte();
+  }
+  
+  UInt uiScaledRange = m_uiRange << 7;
+  if( m_uiValue >= uiScaledRange )
   {
     ruiBin      = 1;
-    m_uiValue  -= m_uiRange;
+    m_uiValue  -= uiScaledRange;
   }
   else
   {
@@ -114,31 +135,87 @@ TDecBinCABAC::decodeBinEP( UInt& ruiBin )
   }
 }
 
+/** Decode bypass bins, the first one ends up in the most significant bit.
+ * \param ruiBins  decoded bins
+ * \param iNumBins number of bins, at most 32
+ */
+Void
+TDecBinCABAC::decodeBinsEP( UInt& ruiBins, Int iNumBins )
+{
+  UInt uiBins = 0;
+  
+  // whole bytes: shift in 8 bits of the offset at once and compare against the range at decreasing scales
+  while( iNumBins > 8 )
+  {
+    m_uiValue = ( m_uiValue << 8 ) + ( m_pcTComBitstream->readByte() << ( 8 + m_iBitsNeeded ) );
+    
+    UInt uiScaledRange = m_uiRange << 15;
+    for( Int i = 0; i < 8; i++ )
+    {
+      uiBins         += uiBins;
+      uiScaledRange >>= 1;
+      if( m_uiValue >= uiScaledRange )
+      {
+        uiBins++;
+        m_uiValue -= uiScaledRange;
+      }
+    }
+    iNumBins -= 8;
+  }
+  
+  m_iBitsNeeded += iNumBins;
+  m_uiValue    <<= iNumBins;
+  if( m_iBitsNeeded >= 0 )
+  {
+    xReadByte();
+  }
+  
+  UInt uiScaledRange = m_uiRange << ( iNumBins + 7 );
+  for( Int i = 0; i < iNumBins; i++ )
+  {
+    uiBins         += uiBins;
+    uiScaledRange >>= 1;
+    if( m_uiValue >= uiScaledRange )
+    {
+      uiBins++;
+      m_uiValue -= uiScaledRange;
+    }
+  }
+  
+  ruiBins = uiBins;
+}
+
 Void
 TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
 {
   m_uiRange -= 2;
-  if( m_uiValue >= m_uiRange )
+  UInt uiScaledRange = m_uiRange << 7;
+  if( m_uiValue >= uiScaledRange )
   {
     ruiBin = 1;
   }
   else
   {
     ruiBin = 0;
-    while( m_uiRange < 256 )
+    if( uiScaledRange < ( 256 << 7 ) )
     {
-      m_uiRange += m_uiRange;
-      xReadBit( m_uiValue );
+      m_uiRange  += m_uiRange;
+      m_uiValue  += m_uiValue;
+      if( ++m_iBitsNeeded == 0 )
+      {
+        xReadByte();
+      }
     }
   }
 }
 
+/** Append the next byte of the bitstream to the bits read ahead.
+ */
 Void  
-TDecBinCABAC::xReadBit( UInt& ruiVal )
+TDecBinCABAC::xReadByte()
 {
-  UInt uiBit = 0;
-  m_pcTComBitstream->read( 1, uiBit );
-  ruiVal  = ( ruiVal << 1 ) | uiBit;
+  m_uiValue     += m_pcTComBitstream->readByte() << m_iBitsNeeded;
+  m_iBitsNeeded -= 8;
 }
 
 #if E057_INTRA_PCM
@@ -147,27 +224,19 @@ TDecBinCABAC::xReadBit( UInt& ruiVal )
  */
 Void TDecBinCABAC::resetBac()
 {
-  m_uiRange    = 510;
-  m_uiValue    = 0;
-
-  for( UInt ui = 0; ui < 9; ui++ )
-  {
-    xReadBit( m_uiValue );
-  }
+  start();
 }
+
 /** Decode PCM alignment zero bits.
+ * The bitstream is byte-aligned, the alignment bits are the bits read ahead of the offset.
  * \returns Void
  */
 Void TDecBinCABAC::decodePCMAlignBits()
 {
-  Int iNum = m_pcTComBitstream->getNumBitsUntilByteAligned();
-
-  for( UInt ui = 0; ui < iNum ; ui++ )
-  {
-    UInt uiBit = 0;
-
-    m_pcTComBitstream->read( 1, uiBit );
-  }
+  assert( m_pcTComBitstream->getNumBitsUntilByteAligned() == 0 );
+  
+  m_uiValue     = 0;
+  m_iBitsNeeded = -8;
 }
 
 /** Read a PCM code.
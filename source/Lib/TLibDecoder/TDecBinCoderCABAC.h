@@ -56,6 +56,7 @@ public:
 
   Void  decodeBin         ( UInt& ruiBin, ContextModel& rcCtxModel );
   Void  decodeBinEP       ( UInt& ruiBin                           );
+  Void  decodeBinsEP      ( UInt& ruiBins, Int iNumBins            );
   Void  decodeBinTrm      ( UInt& ruiBin                           );
 
 #if E057_INTRA_PCM
@@ -65,12 +66,13 @@ public:
 #endif
 
 private:
-  Void  xReadBit          ( UInt& ruiVal );
+  Void  xReadByte         ();
 
 private:
   TComInputBitstream* m_pcTComBitstream;
   UInt                m_uiRange;
-  UInt                m_uiValue;
+  UInt                m_uiValue;          ///< offset scaled by 7 bits, followed by the bits read ahead
+  Int                 m_iBitsNeeded;      ///< -1 minus the number of bits read ahead
 };
 
 
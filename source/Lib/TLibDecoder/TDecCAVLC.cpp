@@ -38,6 +38,23 @@
 #include "TDecCAVLC.h"
 #include "SEIread.h"
 
+/// number of zero bits in front of the most significant one bit of a non-zero word
+static inline UInt xCountLeadingZeros( UInt uiWord )
+{
+  assert( uiWord );
+#if defined(__GNUC__)
+  return __builtin_clz( uiWord );
+#else
+  UInt uiCount = 0;
+  while( !( uiWord & 0x80000000 ) )
+  {
+    uiWord <<= 1;
+    uiCount++;
+  }
+  return uiCount;
+#endif
+}
+
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -124,7 +141,7 @@ Void TDecCavlc::parsePPS(TComPPS* pcPPS, const std::vector<TComSPS*>& cSPSList)
   return;
 }
 
-Void TDecCavlc::parseSPS(TComSPS* pcSPS)
+Bool TDecCavlc::parseSPS(TComSPS* pcSPS)
 {
   UInt  uiCode;
   
@@ -134,6 +151,25 @@ Void TDecCavlc::parseSPS(TComSPS* pcSPS)
   pcSPS->setMaxTLayers( uiCode+1 );
   xReadUvlc ( uiCode ); pcSPS->setNominalWidth       ( uiCode    );
   xReadUvlc ( uiCode ); pcSPS->setNominalHeight      ( uiCode    );
+#if JCT_ARC
+  // the ladder is checked before it is stored, as it sizes the planes of every picture
+  xReadUvlc ( uiCode );
+  if ( uiCode >= NUM_PIC_RESOLUTIONS || pcSPS->getNominalWidth() == 0 || pcSPS->getNominalHeight() == 0 )
+  {
+    return false;
+  }
+  pcSPS->setNumPicResolutions  ( uiCode+1  );
+  for ( UInt i = 1; i < pcSPS->getNumPicResolutions(); i++ )
+  {
+    xReadUvlc ( uiCode ); pcSPS->setPictureWidth ( i, uiCode );
+    xReadUvlc ( uiCode ); pcSPS->setPictureHeight( i, uiCode );
+    if ( pcSPS->getPictureWidth ( i ) == 0 || pcSPS->getPictureWidth ( i ) > pcSPS->getNominalWidth () ||
+         pcSPS->getPictureHeight( i ) == 0 || pcSPS->getPictureHeight( i ) > pcSPS->getNominalHeight() )
+    {
+      return false;
+    }
+  }
+#endif
 
   xReadUvlc ( uiCode ); pcSPS->setPadX        ( uiCode    );
   xReadUvlc ( uiCode ); pcSPS->setPadY        ( uiCode    );
@@ -233,7 +269,7 @@ Void TDecCavlc::parseSPS(TComSPS* pcSPS)
   xReadFlag( uiCode ); 
   pcSPS->setPCMFilterDisableFlag ( uiCode ? true : false );
 #endif
-  return;
+  return true;
 }
 
 Void TDecCavlc::parseSliceHeader (TComSlice*& rpcSlice, const std::vector<TComPPS*>& cPPSList )
@@ -2288,7 +2324,7 @@ Void TDecCavlc::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartI
   UInt uiScanning;
   
 #if CAVLC_COEF_LRG_BLK
-  static TCoeff scoeff[1024];
+  TCoeff scoeff[1024];
 #else
   TCoeff scoeff[64];
 #endif
@@ -2408,6 +2444,7 @@ Void TDecCavlc::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartI
 #endif //QC_MDCS
       }
 #endif
+      xSetNzArea( pcCU, pcCoef, uiAbsPartIdx, uiWidth, eTType );
       return;
     }
     
@@ -2452,9 +2489,33 @@ Void TDecCavlc::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartI
     piCoeff[0] = dcCoeff;
   }
   
+  xSetNzArea( pcCU, pcCoef, uiAbsPartIdx, uiWidth, eTType );
   return ;
 }
 
+/** Record the area holding the non-zero coefficients of a transform unit for the inverse transform.
+ *  The run-level buffers are written out over the whole block, so the area is found in one pass over it.
+ * \param pcCoef coefficients of the transform unit
+ * \param uiWidth size of the transform unit (limited to the maximum transform size)
+ */
+Void TDecCavlc::xSetNzArea( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartIdx, UInt uiWidth, TextType eTType )
+{
+  UInt uiNzRows = 0;
+  UInt uiNzCols = 0;
+  for( UInt uiY = 0; uiY < uiWidth; uiY++, pcCoef += uiWidth )
+  {
+    for( UInt uiX = 0; uiX < uiWidth; uiX++ )
+    {
+      if( pcCoef[ uiX ] )
+      {
+        uiNzRows = uiY + 1;
+        uiNzCols = max( uiNzCols, uiX + 1 );
+      }
+    }
+  }
+  pcCU->setNzArea( uiAbsPartIdx, eTType, uiNzRows, uiNzCols );
+}
+
 Void TDecCavlc::parseTransformSubdivFlag( UInt& ruiSubdivFlag, UInt uiLog2TransformBlockSize )
 {
   xReadFlag( ruiSubdivFlag );
@@ -2631,52 +2692,30 @@ Void TDecCavlc::xReadCode (UInt uiLength, UInt& ruiCode)
 
 Void TDecCavlc::xReadUvlc( UInt& ruiVal)
 {
-  UInt uiVal = 0;
-  UInt uiCode = 0;
-  UInt uiLength;
-  m_pcBitstream->read( 1, uiCode );
+  UInt uiBits   = m_pcBitstream->peekBits( 32 );
   
-  if( 0 == uiCode )
+  if( uiBits >= ( 1 << 16 ) )
   {
-    uiLength = 0;
-    
-    while( ! ( uiCode & 1 ))
-    {
-      m_pcBitstream->read( 1, uiCode );
-      uiLength++;
-    }
-    
-    m_pcBitstream->read( uiLength, uiVal );
-    
-    uiVal += (1 << uiLength)-1;
+    // prefix, one bit and suffix of 2*uiLength+1 bits at most 31 bits long
+    UInt uiLength = xCountLeadingZeros( uiBits );
+    m_pcBitstream->skipBits( 2 * uiLength + 1 );
+    ruiVal = ( uiBits >> ( 31 - 2 * uiLength ) ) - 1;
+  }
+  else
+  {
+    UInt uiLength = xReadZeroRun();
+    m_pcBitstream->read( uiLength, ruiVal );
+    ruiVal += ( 1 << uiLength ) - 1;
   }
-  
-  ruiVal = uiVal;
 }
 
 Void TDecCavlc::xReadSvlc( Int& riVal)
 {
-  UInt uiBits = 0;
-  m_pcBitstream->read( 1, uiBits );
-  if( 0 == uiBits )
-  {
-    UInt uiLength = 0;
-    
-    while( ! ( uiBits & 1 ))
-    {
-      m_pcBitstream->read( 1, uiBits );
-      uiLength++;
-    }
-    
-    m_pcBitstream->read( uiLength, uiBits );
-    
-    uiBits += (1 << uiLength);
-    riVal = ( uiBits & 1) ? -(Int)(uiBits>>1) : (Int)(uiBits>>1);
-  }
-  else
-  {
-    riVal = 0;
-  }
+  UInt uiBits;
+  xReadUvlc( uiBits );
+  
+  uiBits += 1;
+  riVal = ( uiBits & 1) ? -(Int)(uiBits>>1) : (Int)(uiBits>>1);
 }
 
 Void TDecCavlc::xReadFlag (UInt& ruiCode)
@@ -2684,6 +2723,27 @@ Void TDecCavlc::xReadFlag (UInt& ruiCode)
   m_pcBitstream->read( 1, ruiCode );
 }
 
+/** Read a run of zero bits and the one bit ending it.
+ * \returns number of zero bits
+ */
+UInt TDecCavlc::xReadZeroRun()
+{
+  UInt uiRun  = 0;
+  UInt uiBits = m_pcBitstream->peekBits( 32 );
+  
+  while( uiBits == 0 )
+  {
+    m_pcBitstream->skipBits( 32 );
+    uiRun += 32;
+    uiBits = m_pcBitstream->peekBits( 32 );
+  }
+  
+  UInt uiZeros = xCountLeadingZeros( uiBits );
+  m_pcBitstream->skipBits( uiZeros + 1 );
+  
+  return uiRun + uiZeros;
+}
+
 #if E057_INTRA_PCM
 /** Parse PCM alignment zero bits.
  * \returns Void
@@ -2804,79 +2864,34 @@ Int TDecCavlc::xReadVlc( Int n )
   assert( n>=0 && n<=11 );
 #endif
   
-  UInt zeroes=0, done=0, tmp;
-  UInt cw, bit;
+  UInt zeroes=0, tmp;
+  UInt cw;
   UInt val = 0;
-  UInt first;
   UInt lead = 0;
   
   if (n < 5)
   {
-    while (!done && zeroes < 6)
-    {
-      xReadFlag( bit );
-      if (bit)
-      {
-        if (n)
-        {
-          xReadCode( n, cw );
-        }
-        else
-        {
-          cw = 0;
-        }
-        done = 1;
-      }
-      else
-      {
-        zeroes++;
-      }
-    }
-    if ( done )
+    // at most 6 zeros in front of the first code word class
+    UInt uiPrefix = m_pcBitstream->peekBits( 6 );
+    zeroes = uiPrefix ? xCountLeadingZeros( uiPrefix ) - 26 : 6;
+    if ( zeroes < 6 )
     {
+      m_pcBitstream->skipBits( zeroes + 1 );
+      m_pcBitstream->read( n, cw );
       val = (zeroes<<n)+cw;
     }
     else
     {
-      lead = n;
-      while (!done)
-      {
-        xReadFlag( first );
-        if ( !first )
-        {
-          lead++;
-        }
-        else
-        {
-          if ( lead )
-          {
-            xReadCode( lead, tmp );
-          }
-          else
-          {
-            tmp = 0;
-          }
-          val = 6 * (1 << n) + (1 << lead) + tmp - (1 << n);
-          done = 1;
-        }
-      }
+      m_pcBitstream->skipBits( 6 );
+      lead = n + xReadZeroRun();
+      m_pcBitstream->read( lead, tmp );
+      val = 6 * (1 << n) + (1 << lead) + tmp - (1 << n);
     }
   }
   else if (n < 8)
   {
-    while (!done)
-    {
-      xReadFlag( bit );
-      if ( bit )
-      {
-        xReadCode( n-4, cw );
-        done = 1;
-      }
-      else
-      {
-        zeroes++;
-      }
-    }
+    zeroes = xReadZeroRun();
+    xReadCode( n-4, cw );
     val = (zeroes<<(n-4))+cw;
   }
   else if (n == 8)
@@ -2914,46 +2929,14 @@ Int TDecCavlc::xReadVlc( Int n )
     }
     else
     {
-      while (!done)
-      {
-        xReadFlag( bit );
-        if ( bit )
-        {
-          xReadCode(4, cw);
-          done = 1;
-        }
-        else
-        {
-          zeroes++;
-        }
-      }
+      zeroes = xReadZeroRun();
+      xReadCode(4, cw);
       val = (zeroes<<4)+cw+11;
     }
   }
   else if (n == 10)
   {
-    while (!done)
-    {
-      xReadFlag( first );
-      if ( !first )
-      {
-        lead++;
-      }
-      else
-      {
-        if ( !lead )
-        {
-          val = 0;
-        }
-        else
-        {
-          xReadCode(lead, val);
-          val += (1<<lead);
-          val--;
-        }
-        done = 1;
-      }
-    }
+    xReadUvlc( val );
   }
   else if (n == 11)
   {
@@ -2969,58 +2952,14 @@ Int TDecCavlc::xReadVlc( Int n )
 #if CAVLC_COEF_LRG_BLK
   else if (n == 12)
   {
-    while (!done)
-    {
-      m_pcBitstream->pseudoRead(32,val);
-      if (val)
-      {
-        tmp = 31;
-        while(!done)
-        {
-          if( val>>tmp )
-          {
-            xReadCode(32-tmp, val);
-            lead += 31-tmp;
-            xReadCode(6, val);
-            val += (lead<<6);
-            done = 1;
-          }
-          tmp--;
-        }    
-      }
-      else
-      {
-        xReadCode(32, val);
-        lead += 32;
-      }
-    }
+    lead = xReadZeroRun();
+    xReadCode(6, val);
+    val += (lead<<6);
   }
   else if (n == 13)
   {
-    while (!done)
-    {
-      m_pcBitstream->pseudoRead(32,val);
-      if (val)
-      {
-        tmp = 31;
-        while(!done)
-        {
-          if(val>>tmp)
-          {
-            xReadCode(32-tmp, cw);
-            zeroes += 31-tmp;
-            xReadCode(4, cw);
-            done = 1;
-          }
-          tmp--;
-        } 
-      }
-      else
-      {
-        xReadCode(32, val);
-        zeroes += 32;
-      }
-    }
+    zeroes = xReadZeroRun();
+    xReadCode(4, cw);
     val = (zeroes<<4)+cw;
   }
 #endif
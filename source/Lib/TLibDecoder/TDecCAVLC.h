@@ -62,6 +62,7 @@ protected:
   Void  xReadUvlc             (UInt& ruiVal);
   Void  xReadSvlc             (Int& riVal);
   Void  xReadFlag             (UInt& ruiCode);
+  UInt  xReadZeroRun          ();
   Void  xReadEpExGolomb     ( UInt& ruiSymbol, UInt uiCount );
   Void  xReadExGolombLevel  ( UInt& ruiSymbol );
   Void  xReadUnaryMaxSymbol ( UInt& ruiSymbol, UInt uiMaxSymbol );
@@ -78,6 +79,7 @@ protected:
   Void  xParseCoeff4x4      ( TCoeff* scoeff, Int iTableNumber );
   Void  xParseCoeff8x8      ( TCoeff* scoeff, Int iTableNumber );
 #endif
+  Void  xSetNzArea          ( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartIdx, UInt uiWidth, TextType eTType );
 #if QC_MOD_LCEC
   Void  xRunLevelIndInv     (LastCoeffStruct *combo, Int maxrun, UInt lrg1Pos, UInt cn);
 #if RUNLEVEL_TABLE_CUT
@@ -179,7 +181,7 @@ public:
   Void  parseAoSvlc        ( Int&  riVal  );
 #endif
   
-  Void  parseSPS            ( TComSPS* pcSPS );
+  Bool  parseSPS            ( TComSPS* pcSPS );                ///< false if the SPS is malformed, it is then not complete
   Void  parsePPS            (TComPPS* pcPPS, const std::vector<TComSPS*>& cSPSList);
   void parseSEI(SEImessages&);
   Void  parseSliceHeader    ( TComSlice*& rpcSlice, const std::vector<TComPPS*>& cPPSList );
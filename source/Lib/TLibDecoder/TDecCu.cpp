@@ -95,6 +95,10 @@ Void TDecCu::create( UInt uiMaxDepth, UInt uiMaxWidth, UInt uiMaxHeight )
 
 Void TDecCu::destroy()
 {
+  if ( m_ppcCU == NULL )
+  {
+    return;
+  }
   for ( UInt ui = 0; ui < m_uiMaxDepth-1; ui++ )
   {
     m_ppcYuvResi[ui]->destroy(); delete m_ppcYuvResi[ui]; m_ppcYuvResi[ui] = NULL;
@@ -623,9 +627,10 @@ TDecCu::xIntraRecLumaBlk( TComDataCU* pcCU,
   //===== inverse transform =====
   m_pcTrQuant->setQPforQuant  ( pcCU->getQP(0), !pcCU->getSlice()->getDepth(), pcCU->getSlice()->getSliceType(), TEXT_LUMA );
 #if INTRA_DST_TYPE_7
-  m_pcTrQuant->invtransformNxN( TEXT_LUMA, pcCU->getLumaIntraDir( uiAbsPartIdx ), piResi, uiStride, pcCoeff, uiWidth, uiHeight );
+  m_pcTrQuant->invtransformNxN( TEXT_LUMA, pcCU->getLumaIntraDir( uiAbsPartIdx ), piResi, uiStride, pcCoeff, uiWidth, uiHeight,
+                                pcCU->getNzRows( uiAbsPartIdx, TEXT_LUMA ), pcCU->getNzCols( uiAbsPartIdx, TEXT_LUMA ) );
 #else
-  m_pcTrQuant->invtransformNxN( piResi, uiStride, pcCoeff, uiWidth, uiHeight );
+  m_pcTrQuant->invtransformNxN( piResi, uiStride, pcCoeff, uiWidth, uiHeight, pcCU->getNzRows( uiAbsPartIdx, TEXT_LUMA ), pcCU->getNzCols( uiAbsPartIdx, TEXT_LUMA ) );
 #endif  
 
   
@@ -744,9 +749,9 @@ TDecCu::xIntraRecChromaBlk( TComDataCU* pcCU,
   //===== inverse transform =====
   m_pcTrQuant->setQPforQuant  ( pcCU->getQP(0), !pcCU->getSlice()->getDepth(), pcCU->getSlice()->getSliceType(), eText );
 #if INTRA_DST_TYPE_7 
-  m_pcTrQuant->invtransformNxN( eText, REG_DCT, piResi, uiStride, pcCoeff, uiWidth, uiHeight );
+  m_pcTrQuant->invtransformNxN( eText, REG_DCT, piResi, uiStride, pcCoeff, uiWidth, uiHeight, pcCU->getNzRows( uiAbsPartIdx, eText ), pcCU->getNzCols( uiAbsPartIdx, eText ) );
 #else
-  m_pcTrQuant->invtransformNxN( piResi, uiStride, pcCoeff, uiWidth, uiHeight );
+  m_pcTrQuant->invtransformNxN( piResi, uiStride, pcCoeff, uiWidth, uiHeight, pcCU->getNzRows( uiAbsPartIdx, eText ), pcCU->getNzCols( uiAbsPartIdx, eText ) );
 #endif
 
   //===== reconstruction =====
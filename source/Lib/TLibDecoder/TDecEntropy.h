@@ -64,7 +64,7 @@ public:
   virtual Void  resetEntropy          (TComSlice* pcSlice)                = 0;
   virtual Void  setBitstream          ( TComInputBitstream* p )  = 0;
 
-  virtual Void  parseSPS                  ( TComSPS* pcSPS )                                      = 0;
+  virtual Bool  parseSPS                  ( TComSPS* pcSPS )                                      = 0;
   virtual Void  parsePPS              (TComPPS* pcPPS, const std::vector<TComSPS*>& cSPSList)     = 0;
   virtual Void parseSEI(SEImessages&) = 0;
   virtual Void  parseSliceHeader          ( TComSlice*& rpcSlice, const std::vector<TComPPS*>& cPPSList ) = 0;
@@ -143,7 +143,7 @@ public:
   Void    setBitstream                ( TComInputBitstream* p ) { m_pcEntropyDecoderIf->setBitstream(p);                    }
   Void    resetEntropy                ( TComSlice* p)           { m_pcEntropyDecoderIf->resetEntropy(p);                    }
 
-  Void    decodeSPS                   ( TComSPS* pcSPS     )    { m_pcEntropyDecoderIf->parseSPS(pcSPS);                    }
+  Bool    decodeSPS                   ( TComSPS* pcSPS     )    { return m_pcEntropyDecoderIf->parseSPS(pcSPS);             }
   Void    decodePPS                   (TComPPS* pcPPS, const std::vector<TComSPS*>& cSPSList){m_pcEntropyDecoderIf->parsePPS( pcPPS, cSPSList );}
   void decodeSEI(SEImessages& seis) { m_pcEntropyDecoderIf->parseSEI(seis); }
   Void    decodeSliceHeader           ( TComSlice*& rpcSlice, const std::vector<TComPPS*>& cPPSList )  { m_pcEntropyDecoderIf->parseSliceHeader(rpcSlice, cPPSList);         }
@@ -47,7 +47,7 @@ extern bool g_md5_mismatch; ///< top level flag to signal when there is a decode
 
 #include <time.h>
 
-static void calcAndPrintMD5Status(TComPic& pic, const SEImessages* seis);
+static void printMD5Status(TComPic& pic, unsigned char digests[][16], const SEImessages* seis);
 
 // ====================================================================================================================
 // Constructor / destructor / initialization / destroy
@@ -57,6 +57,19 @@ TDecGop::TDecGop()
 {
   m_iGopSize = 0;
   m_dDecTime = 0;
+  m_pcThreadPool   = NULL;
+  m_pcRunBitstream = NULL;
+  m_pcRunPic       = NULL;
+#if PARALLEL_MERGED_DEBLK
+  m_bFilterRows    = false;
+  m_iRowsDeblocked = 0;
+  m_iRowsFiltered  = 0;
+  m_iRowsFinal     = 0;
+#endif
+#if MTK_NONCROSS_INLOOP_FILTER
+  m_uiILSliceCount     = 0;
+  m_puiILSliceStartLCU = NULL;
+#endif
 }
 
 TDecGop::~TDecGop()
@@ -72,7 +85,10 @@ Void TDecGop::create()
 
 Void TDecGop::destroy()
 {
-
+#if MTK_NONCROSS_INLOOP_FILTER
+  delete [] m_puiILSliceStartLCU;
+  m_puiILSliceStartLCU = NULL;
+#endif
 }
 
 Void TDecGop::init( TDecEntropy*            pcEntropyDecoder, 
@@ -113,29 +129,20 @@ Void TDecGop::decompressGop(TComInputBitstream* pcBitstream, TComPic*& rpcPic, B
   long iBeforeTime = clock();
   
   UInt uiStartCUAddr   = pcSlice->getEntropySliceCurStartCUAddr();
-#if MTK_NONCROSS_INLOOP_FILTER
-  static Bool  bFirst = true;
-  static UInt  uiILSliceCount;
-  static UInt* puiILSliceStartLCU;
   if (!bExecuteDeblockAndAlf)
   {
-    if(bFirst)
+#if MTK_NONCROSS_INLOOP_FILTER
+    if(!pcSlice->getSPS()->getLFCrossSliceBoundaryFlag())
     {
-      uiILSliceCount = 0;
-      if(!pcSlice->getSPS()->getLFCrossSliceBoundaryFlag())
+      if(m_puiILSliceStartLCU == NULL)
       {
-        puiILSliceStartLCU = new UInt[rpcPic->getNumCUsInFrame() +1];
+        m_puiILSliceStartLCU = new UInt[rpcPic->getNumCUsInFrame() +1];
       }
-      bFirst = false;
-    }
-    
-    if(!pcSlice->getSPS()->getLFCrossSliceBoundaryFlag())
-    {
       UInt uiSliceStartCuAddr = pcSlice->getSliceCurStartCUAddr();
       if(uiSliceStartCuAddr == uiStartCUAddr)
       {
-        puiILSliceStartLCU[uiILSliceCount] = uiSliceStartCuAddr;
-        uiILSliceCount++;
+        m_puiILSliceStartLCU[m_uiILSliceCount] = uiSliceStartCuAddr;
+        m_uiILSliceCount++;
       }
     }
 #endif //MTK_NONCROSS_INLOOP_FILTER
@@ -174,120 +181,346 @@ Void TDecGop::decompressGop(TComInputBitstream* pcBitstream, TComPic*& rpcPic, B
       }
     }
     
-    m_pcSliceDecoder->decompressSlice(pcBitstream, rpcPic);
+#if PARALLEL_MERGED_DEBLK
+    if ( uiStartCUAddr == 0 )
+    {
+      xStartRows( rpcPic );
+    }
+    if ( m_pcThreadPool && m_pcThreadPool->getNumThreads() > 1 )
+    {
+      // each CU is deblocked according to its own slice, so the rows are handed out whatever the slice setting
+      m_pcRunBitstream = pcBitstream;
+      m_pcRunPic       = rpcPic;
+      m_pcLoopFilter->stopRows( false );
+      m_pcThreadPool->run( this );
+    }
+    else if ( m_bFilterRows )
+    {
+      m_pcSliceDecoder->decompressSlice(pcBitstream, rpcPic, this);
+    }
+    else
+#endif
+    {
+      m_pcSliceDecoder->decompressSlice(pcBitstream, rpcPic);
+    }
     
     m_dDecTime += (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
   }
   else
   {
-    // deblocking filter
-    m_pcLoopFilter->setCfg(pcSlice->getLoopFilterDisable(), 0, 0);
-    m_pcLoopFilter->loopFilterPic( rpcPic );
+    filterPic( rpcPic );
+    reportPic( rpcPic );
+  }
+}
+
+/** Run the in-loop filters over a picture whose slices are all decoded and mark its reconstruction as complete.
+ * A picture decoded on another thread than the pictures predicting from it also gets its border extended, and all its
+ * LCU rows are reported as final. Its rows may have been filtered while it was decoded, see xStartRows().
+ */
+Void TDecGop::filterPic( TComPic*& rpcPic )
+{
+  Int iPicSizeIdx = rpcPic->getPictureSizeIdx();
+  TComSlice*  pcSlice = rpcPic->getSlice(rpcPic->getCurrSliceIdx());
+
+  long iBeforeTime = clock();
+
+#if PARALLEL_MERGED_DEBLK
+  // the rows of slices that were not received are filtered here
+  const Bool bRowsFiltered = m_bFilterRows;
+  if ( bRowsFiltered )
+  {
+    xFilterRows( rpcPic, rpcPic->getFrameHeightInCU() );
+  }
+  m_bFilterRows = false;
+#else
+  const Bool bRowsFiltered = false;
+#endif
+
+  // deblocking filter, skipped only when it is disabled in every slice
+  if ( !bRowsFiltered )
+  {
+    Bool bLoopFilterDisable = true;
+    for ( UInt uiSliceIdx = 0; uiSliceIdx <= rpcPic->getCurrSliceIdx(); uiSliceIdx++ )
+    {
+      bLoopFilterDisable = bLoopFilterDisable && rpcPic->getSlice(uiSliceIdx)->getLoopFilterDisable();
+    }
+    m_pcLoopFilter->setCfg(bLoopFilterDisable, 0, 0);
+    m_pcLoopFilter->loopFilterPic( rpcPic, m_pcThreadPool );
+  }
 #if MTK_SAO
+  {
+    if( rpcPic->getSlice(0)->getSPS()->getUseSAO() && !bRowsFiltered )
     {
-      if( rpcPic->getSlice(0)->getSPS()->getUseSAO())
-      {
-        m_pcSAO[iPicSizeIdx]->SAOProcess(rpcPic, &m_cSaoParam[iPicSizeIdx]);
+      m_pcSAO[iPicSizeIdx]->SAOProcess(rpcPic, &m_cSaoParam[iPicSizeIdx], m_pcThreadPool);
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-        m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcess(rpcPic);
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcess(rpcPic);
 #endif
-      }
     }
+  }
 #endif
-    // adaptive loop filter
-    if( pcSlice->getSPS()->getUseALF() )
-    {
+  // adaptive loop filter
+  if( pcSlice->getSPS()->getUseALF() )
+  {
 #if MTK_NONCROSS_INLOOP_FILTER  
-      if(pcSlice->getSPS()->getLFCrossSliceBoundaryFlag())
-      {
-        m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf(false);
-      }
-      else
+    if(pcSlice->getSPS()->getLFCrossSliceBoundaryFlag())
+    {
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf(false);
+    }
+    else
+    {
+      m_puiILSliceStartLCU[m_uiILSliceCount] = rpcPic->getNumCUsInFrame();
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf( (m_uiILSliceCount > 1) );
+      if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
       {
-        puiILSliceStartLCU[uiILSliceCount] = rpcPic->getNumCUsInFrame();
-        m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf( (uiILSliceCount > 1) );
-        if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
+        m_pcAdaptiveLoopFilter[iPicSizeIdx].setNumSlicesInPic( m_uiILSliceCount );
+        m_pcAdaptiveLoopFilter[iPicSizeIdx].createSlice();
+        for(UInt i=0; i< m_uiILSliceCount ; i++)
         {
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].setNumSlicesInPic( uiILSliceCount );
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].createSlice();
-          for(UInt i=0; i< uiILSliceCount ; i++)
-          {
-            m_pcAdaptiveLoopFilter[iPicSizeIdx][i].create(rpcPic, i, puiILSliceStartLCU[i], puiILSliceStartLCU[i+1]-1);
-          }
+          m_pcAdaptiveLoopFilter[iPicSizeIdx][i].create(rpcPic, i, m_puiILSliceStartLCU[i], m_puiILSliceStartLCU[i+1]-1);
         }
       }
+    }
 #endif
-      m_pcAdaptiveLoopFilter[iPicSizeIdx].ALFProcess(rpcPic, &m_cAlfParam);
+    if ( !bRowsFiltered )
+    {
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].ALFProcess(rpcPic, &m_cAlfParam, m_pcThreadPool);
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
       m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcess(rpcPic);
 #endif
+    }
 
 #if MTK_NONCROSS_INLOOP_FILTER
-      if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
-      {
-        m_pcAdaptiveLoopFilter[iPicSizeIdx].destroySlice();
-      }
-#endif
-      m_pcAdaptiveLoopFilter[iPicSizeIdx].freeALFParam(&m_cAlfParam);
+    if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
+    {
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].destroySlice();
     }
-    
+#endif
+    m_pcAdaptiveLoopFilter[iPicSizeIdx].freeALFParam(&m_cAlfParam);
+  }
+  
 #if AMVP_BUFFERCOMPRESS
+  if ( !bRowsFiltered )
+  {
     rpcPic->compressMotion(); 
+  }
 #endif 
-    
-    //-- For time output for each slice
-    printf("\nPOC %4d TId: %1d ( %c-SLICE, QP%3d ) ",
-          pcSlice->getPOC(),
-          pcSlice->getTLayer(),
-          pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B',
-          pcSlice->getSliceQp() );
 
-    m_dDecTime += (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-    printf ("[DT %6.3f] ", m_dDecTime );
-    m_dDecTime  = 0;
-    
-    for (Int iRefList = 0; iRefList < 2; iRefList++)
+  // the reconstruction is final, so the digest of each rung resamples it once and keeps the result for the references
+  rpcPic->setReconMark(true);
+
+  // the digest is taken before the frame memory is rounded, the status line is printed by reportPic()
+  if (m_pictureDigestEnabled)
+  {
+    calcMD5(*rpcPic->getPicYuvRec(), m_aaucDigest[0]);
+    for (Int i = 1; i < rpcPic->getNumPicResolutions(); i++)
     {
-      printf ("[L%d ", iRefList);
-      for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(RefPicList(iRefList)); iRefIndex++)
-      {
-        printf ("%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
-      }
-      printf ("] ");
+      calcMD5(*rpcPic->getPicYuvRec(i), m_aaucDigest[i]);
     }
-#if DCM_COMB_LIST
-    if(pcSlice->getNumRefIdx(REF_PIC_LIST_C)>0 && !pcSlice->getNoBackPredFlag())
+  }
+
+#if FIXED_ROUNDING_FRAME_MEMORY
+  rpcPic->getPicYuvRec()->xFixedRoundingPic();
+#endif
+
+  if ( rpcPic->getRecInProgress() )
+  {
+    if ( !bRowsFiltered )
     {
-      printf ("[LC ");
-      for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(REF_PIC_LIST_C); iRefIndex++)
-      {
-        printf ("%d ", pcSlice->getRefPOC((RefPicList)pcSlice->getListIdFromIdxOfLC(iRefIndex), pcSlice->getRefIdxFromIdxOfLC(iRefIndex)));
-      }
-      printf ("] ");
+      rpcPic->getPicYuvRec()->extendPicBorder();
     }
+    rpcPic->setRecRows( rpcPic->getFrameHeightInCU() );
+  }
+
+#if MTK_NONCROSS_INLOOP_FILTER
+  m_uiILSliceCount = 0;
 #endif
 
-    if (m_pictureDigestEnabled)
+  m_dDecTime += (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
+}
+
+/** Print the status line of a picture processed by filterPic(), with its MD5 check.
+ */
+Void TDecGop::reportPic( TComPic*& rpcPic )
+{
+  TComSlice*  pcSlice = rpcPic->getSlice(rpcPic->getCurrSliceIdx());
+
+  //-- For time output for each slice
+  printf("\nPOC %4d TId: %1d ( %c-SLICE, QP%3d ) ",
+        pcSlice->getPOC(),
+        pcSlice->getTLayer(),
+        pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B',
+        pcSlice->getSliceQp() );
+
+  printf ("[DT %6.3f] ", m_dDecTime );
+  m_dDecTime  = 0;
+  
+  for (Int iRefList = 0; iRefList < 2; iRefList++)
+  {
+    printf ("[L%d ", iRefList);
+    for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(RefPicList(iRefList)); iRefIndex++)
     {
-      calcAndPrintMD5Status(*rpcPic, rpcPic->getSEIs());
+      printf ("%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
     }
-
-#if FIXED_ROUNDING_FRAME_MEMORY
-    rpcPic->getPicYuvRec()->xFixedRoundingPic();
+    printf ("] ");
+  }
+#if DCM_COMB_LIST
+  if(pcSlice->getNumRefIdx(REF_PIC_LIST_C)>0 && !pcSlice->getNoBackPredFlag())
+  {
+    printf ("[LC ");
+    for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(REF_PIC_LIST_C); iRefIndex++)
+    {
+      printf ("%d ", pcSlice->getRefPOC((RefPicList)pcSlice->getListIdFromIdxOfLC(iRefIndex), pcSlice->getRefIdxFromIdxOfLC(iRefIndex)));
+    }
+    printf ("] ");
+  }
 #endif
 
-    rpcPic->setReconMark(true);
+  if (m_pictureDigestEnabled)
+  {
+    printMD5Status(*rpcPic, m_aaucDigest, rpcPic->getSEIs());
+  }
+}
 
-#if MTK_NONCROSS_INLOOP_FILTER
-    uiILSliceCount = 0;
+#if PARALLEL_MERGED_DEBLK
+Void TDecGop::runTask( Int iThreadIdx )
+{
+  if ( iThreadIdx == 0 )
+  {
+    m_pcSliceDecoder->decompressSlice( m_pcRunBitstream, m_pcRunPic, this );
+    m_pcLoopFilter->stopRows( true );
+  }
+  else
+  {
+    m_pcLoopFilter->runTask( iThreadIdx );
+  }
+}
+
+Void TDecGop::setRowsDecoded( TComPic* pcPic, Int iNumRows )
+{
+  if ( m_bFilterRows )
+  {
+    xFilterRows( pcPic, iNumRows );
+  }
+  else
+  {
+    m_pcLoopFilter->setRowsDecoded( pcPic, iNumRows );
+  }
+}
+
+/** Choose how the LCU rows of a picture are filtered while its first slice is decoded.
+ * With threads, the other threads deblock them. A picture decoded on another thread than the pictures predicting from
+ * it is filtered on its own thread instead, and its rows are reported final one by one, unless its ALF runs over
+ * slices, which needs all of them.
+ */
+Void TDecGop::xStartRows( TComPic* pcPic )
+{
+  Int       iPicSizeIdx = pcPic->getPictureSizeIdx();
+  TComSPS*  pcSPS       = pcPic->getSlice(0)->getSPS();
+  
+  m_bFilterRows = false;
+  if ( m_pcThreadPool && m_pcThreadPool->getNumThreads() > 1 )
+  {
+    m_pcLoopFilter->startPicRows( pcPic, m_pcThreadPool->getNumThreads() );
+    return;
+  }
+#if !FIXED_ROUNDING_FRAME_MEMORY
+  m_bFilterRows = pcPic->getRecInProgress();
+#endif
+#if MTK_NONCROSS_INLOOP_FILTER && MQT_BA_RA
+  m_bFilterRows = m_bFilterRows && ( !pcSPS->getUseALF() || pcSPS->getLFCrossSliceBoundaryFlag() );
+#else
+  m_bFilterRows = m_bFilterRows && !pcSPS->getUseALF();
 #endif
+  if ( !m_bFilterRows )
+  {
+    return;
+  }
+  
+  m_iRowsDeblocked = 0;
+  m_iRowsFiltered  = 0;
+  m_iRowsFinal     = 0;
+#if MTK_SAO
+  if ( pcSPS->getUseSAO() )
+  {
+    m_pcSAO[iPicSizeIdx]->SAOStartRows( pcPic, &m_cSaoParam[iPicSizeIdx] );
   }
+#endif
+#if MTK_NONCROSS_INLOOP_FILTER && MQT_BA_RA
+  if ( pcSPS->getUseALF() )
+  {
+    m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf( false );
+    m_pcAdaptiveLoopFilter[iPicSizeIdx].ALFStartRows( pcPic, &m_cAlfParam );
+  }
+#endif
 }
 
+/** Run the in-loop filters of filterPic() over the LCU rows that the decoding of the first iNumRows rows no longer
+ * changes, and report the rows that are final. Each filter lags behind the previous one by the rows it reads below.
+ * The last row is reported by filterPic(), once the resampled rungs of the picture can be made.
+ */
+Void TDecGop::xFilterRows( TComPic* pcPic, Int iNumRows )
+{
+  Int       iPicSizeIdx = pcPic->getPictureSizeIdx();
+  TComSPS*  pcSPS       = pcPic->getSlice(0)->getSPS();
+  const Int iHeightInCU = pcPic->getFrameHeightInCU();
+  const Int iNumFinal   = m_iRowsFinal;
+  
+  // the intra prediction of a row reads the unfiltered bottom line of the row above
+  Int iNumDeblock = iNumRows == iHeightInCU ? iNumRows : iNumRows-1;
+  while ( m_iRowsDeblocked < iNumDeblock )
+  {
+    m_pcLoopFilter->loopFilterRow( pcPic, m_iRowsDeblocked++ );
+  }
+  
+  // the horizontal edges of a row change the bottom lines of the row above
+  Int iNumFilter = m_iRowsDeblocked == iHeightInCU ? m_iRowsDeblocked : m_iRowsDeblocked-1;
+  while ( m_iRowsFiltered < iNumFilter )
+  {
+    Int iRow = m_iRowsFiltered++;
+#if AMVP_BUFFERCOMPRESS
+    pcPic->compressMotion( iRow );
+#endif
+#if MTK_SAO
+    if ( pcSPS->getUseSAO() )
+    {
+      m_pcSAO[iPicSizeIdx]->SAOProcessRow( iRow );
+#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcessRow( pcPic, iRow );
+#endif
+    }
+#endif
+    
+    Int iNumAlf = iRow+1;
+#if MTK_NONCROSS_INLOOP_FILTER && MQT_BA_RA
+    if ( pcSPS->getUseALF() )
+    {
+      iNumAlf = m_pcAdaptiveLoopFilter[iPicSizeIdx].ALFProcessRow( iRow );
+    }
+#endif
+    for ( ; m_iRowsFinal < iNumAlf; m_iRowsFinal++ )
+    {
+#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
+      if ( pcSPS->getUseALF() )
+      {
+        m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcessRow( pcPic, m_iRowsFinal );
+      }
+#endif
+      Int iPelY = m_iRowsFinal*g_uiMaxCUHeight;
+      pcPic->getPicYuvRec()->extendPicBorderRows( iPelY, min( (Int)g_uiMaxCUHeight, pcPic->getPicYuvRec()->getHeight()-iPelY ) );
+    }
+  }
+  
+  if ( min( m_iRowsFinal, iHeightInCU-1 ) > iNumFinal )
+  {
+    pcPic->setRecRows( min( m_iRowsFinal, iHeightInCU-1 ) );
+  }
+}
+#endif
+
 /**
- * Calculate and print MD5 for @pic, compare to picture_digest SEI if
+ * Print the MD5 @digests of @pic, compare to picture_digest SEI if
  * present in @seis.  @seis may be NULL.  MD5 is printed to stdout, in
  * a manner suitable for the status line. Theformat is:
  *  [MD5:xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx,(yyy)]
@@ -296,12 +529,12 @@ Void TDecGop::decompressGop(TComInputBitstream* pcBitstream, TComPic*& rpcPic, B
  *            OK          - calculated MD5 matches the SEI message
  *            ***ERROR*** - calculated MD5 does not match the SEI message
  *            unk         - no SEI message was available for comparison
+ * @digests[0] is the MD5 of the coded reconstruction, @digests[i] that
+ * of rung i of the resolution ladder for i > 0.
  */
-static void calcAndPrintMD5Status(TComPic& pic, const SEImessages* seis)
+static void printMD5Status(TComPic& pic, unsigned char digests[][16], const SEImessages* seis)
 {
-  /* calculate MD5sum for given level */
-  unsigned char recon_digest[16];
-  calcMD5(*pic.getPicYuvRec(), recon_digest);
+  unsigned char* recon_digest = digests[0];
 
   /* compare digest against received version */
   const char* md5_ok = "(unk)";
@@ -327,7 +560,9 @@ static void calcAndPrintMD5Status(TComPic& pic, const SEImessages* seis)
     printf("[rxMD5:%s] ", digestToString(seis->picture_digest->digest));
   }
 
-  calcMD5(*pic.getPicYuvRec(1), recon_digest);
-  printf("[Level 1 MD5:%s] ", digestToString(recon_digest));
+  for (Int i = 1; i < pic.getNumPicResolutions(); i++)
+  {
+    printf("[Level %d MD5:%s] ", i, digestToString(digests[i]));
+  }
 
 }
@@ -49,6 +49,7 @@
 #include "../TLibCommon/TComPic.h"
 #include "../TLibCommon/TComLoopFilter.h"
 #include "../TLibCommon/TComAdaptiveLoopFilter.h"
+#include "../TLibCommon/TComThreadPool.h"
 
 #include "TDecEntropy.h"
 #include "TDecSlice.h"
@@ -61,6 +62,9 @@
 
 /// GOP decoder class
 class TDecGop
+#if PARALLEL_MERGED_DEBLK
+: public TComThreadTask, public TDecRowListener
+#endif
 {
 private:
   Int                   m_iGopSize;
@@ -73,6 +77,15 @@ private:
   TDecCavlc*            m_pcCavlcDecoder;
   TDecSlice*            m_pcSliceDecoder;
   TComLoopFilter*       m_pcLoopFilter;
+  TComThreadPool*       m_pcThreadPool;     ///< threads deblocking the LCU rows while a slice is decoded and running ALF, NULL if none
+  TComInputBitstream*   m_pcRunBitstream;   ///< slice decoded by runTask()
+  TComPic*              m_pcRunPic;
+#if PARALLEL_MERGED_DEBLK
+  Bool                  m_bFilterRows;      ///< the LCU rows of the picture are filtered on this thread while it is decoded
+  Int                   m_iRowsDeblocked;   ///< rows deblocked
+  Int                   m_iRowsFiltered;    ///< rows through SAO and given to ALF
+  Int                   m_iRowsFinal;       ///< rows through all the filters with their border extended
+#endif
   
   // Adaptive Loop filter
   TComAdaptiveLoopFilter*       m_pcAdaptiveLoopFilter;
@@ -82,6 +95,11 @@ private:
 #endif
   ALFParam              m_cAlfParam;
   Double                m_dDecTime;
+#if MTK_NONCROSS_INLOOP_FILTER
+  UInt                  m_uiILSliceCount;       ///< number of slices of the picture that start an in-loop filter slice
+  UInt*                 m_puiILSliceStartLCU;   ///< start LCU of each of them
+#endif
+  unsigned char         m_aaucDigest[NUM_PIC_RESOLUTIONS][16];  ///< MD5 of the picture taken by filterPic()
 
   bool m_pictureDigestEnabled; ///< if true, handle picture_digest SEI messages
 
@@ -103,9 +121,22 @@ public:
   Void  create  ();
   Void  destroy ();
   Void  decompressGop(TComInputBitstream* pcBitstream, TComPic*& rpcPic, Bool bExecuteDeblockAndAlf );
+  Void  filterPic    ( TComPic*& rpcPic );   ///< in-loop filters of a decoded picture, completes its reconstruction
+  Void  reportPic    ( TComPic*& rpcPic );   ///< status line of a picture processed by filterPic()
   Void  setGopSize( Int i) { m_iGopSize = i; }
+  Void  setThreadPool( TComThreadPool* pcThreadPool ) { m_pcThreadPool = pcThreadPool; }
+#if PARALLEL_MERGED_DEBLK
+  Void  runTask ( Int iThreadIdx );   ///< thread 0 decodes the slice, the others deblock the rows it completes
+  Void  setRowsDecoded ( TComPic* pcPic, Int iNumRows );
+#endif
 
   void setPictureDigestEnabled(bool enabled) { m_pictureDigestEnabled = enabled; }
+
+private:
+#if PARALLEL_MERGED_DEBLK
+  Void  xStartRows  ( TComPic* pcPic );
+  Void  xFilterRows ( TComPic* pcPic, Int iNumRows );
+#endif
 };
 
 #endif // !defined(AFX_TDECGOP_H__29440B7A_7CC0_48C7_8DD5_1A531D3CED45__INCLUDED_)
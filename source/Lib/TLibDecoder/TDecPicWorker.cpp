@@ -0,0 +1,179 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecPicWorker.cpp
+    \brief    decoding tools of one picture in flight
+*/
+
+#include "TDecPicWorker.h"
+
+// ====================================================================================================================
+// Constructor / destructor / initialization / destroy
+// ====================================================================================================================
+
+TDecPicWorker::TDecPicWorker()
+{
+  m_pcPic = NULL;
+#if MTK_SAO
+  for (Int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+    m_cSAO[j] = NULL;
+  }
+#endif
+}
+
+TDecPicWorker::~TDecPicWorker()
+{
+}
+
+Void TDecPicWorker::init( TComThreadPool* pcThreadPool )
+{
+  m_cGopDecoder.create();
+#if MTK_SAO
+  m_cGopDecoder.  init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cAdaptiveLoopFilter[0], &m_cSAO[0]);
+#else
+  m_cGopDecoder.  init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cAdaptiveLoopFilter[0] );
+#endif
+  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder );
+  m_cEntropyDecoder.init(&m_cPrediction);
+
+  m_cGopDecoder.setThreadPool( pcThreadPool );
+}
+
+Void TDecPicWorker::destroy()
+{
+  for (size_t i=0; i<m_cSlices.size(); ++i){
+    delete m_cSlices[i];
+  }
+  m_cSlices.clear();
+
+  m_cGopDecoder.destroy();
+  m_cSliceDecoder.destroy();
+  m_cCuDecoder.destroy();
+}
+
+Void TDecPicWorker::createLoopFilter()
+{
+  m_cLoopFilter.create( g_uiMaxCUDepth );
+}
+
+/** The CU decoder also sets up the partition scan tables shared by all the pictures, so it is not created while a
+ * picture is decoded.
+ */
+Void TDecPicWorker::createCuDecoder()
+{
+  m_cCuDecoder.destroy();
+  m_cCuDecoder.create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
+}
+
+Void TDecPicWorker::createAdaptiveLoopFilter( TComPPS* pcPPS )
+{
+  Int iPicSizeIdx = pcPPS->getPictureSizeIdx();
+  m_cAdaptiveLoopFilter[iPicSizeIdx].create( pcPPS->getPictureWidth(), pcPPS->getPictureHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+#if MTK_SAO
+  if (m_cSAO[iPicSizeIdx]==NULL){
+    m_cSAO[iPicSizeIdx] = new TComSampleAdaptiveOffset;
+    m_cSAO[iPicSizeIdx]->create( pcPPS->getPictureWidth(), pcPPS->getPictureHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+  }
+#endif
+}
+
+Void TDecPicWorker::destroyLoopFilter()
+{
+  // destroy ALF temporary buffers
+  for (Int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+    m_cAdaptiveLoopFilter[j].destroy();
+  }
+
+#if MTK_SAO
+  for (Int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+    if (m_cSAO[j] != NULL ){
+      m_cSAO[j]->destroy();
+      delete m_cSAO[j];
+      m_cSAO[j] = NULL;
+    }
+  }
+#endif
+
+  m_cLoopFilter.destroy();
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Set the tools up for a new picture.
+ * \param pcPic   picture buffer the picture is reconstructed in
+ * \param pcSlice header of its first slice
+ */
+Void TDecPicWorker::initPic( TComPic* pcPic, TComSlice* pcSlice )
+{
+  m_pcPic = pcPic;
+
+  // Buffer initialize for prediction.
+  m_cPrediction.initTempBuff();
+
+  // Recursive structure
+  m_cCuDecoder.init   ( &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction );
+  m_cTrQuant.init     ( g_uiMaxCUWidth, g_uiMaxCUHeight, pcSlice->getSPS()->getMaxTrSize());
+
+  m_cSliceDecoder.create( pcSlice, pcSlice->getPPS()->getPictureWidth(), pcSlice->getPPS()->getPictureHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+}
+
+/** \param pcBitstream slice whose header has been read, owned by the worker from now on
+ */
+Void TDecPicWorker::addSlice( TComInputBitstream* pcBitstream )
+{
+  m_cSlices.push_back( pcBitstream );
+}
+
+/** Decode the slices kept by addSlice() in the order they were received, then run the in-loop filters.
+ * The slices of the picture are the slices 0, 1, ... of its picture symbol.
+ */
+Void TDecPicWorker::decompressPic()
+{
+  for (UInt i=0; i<m_cSlices.size(); ++i){
+    m_pcPic->setCurrSliceIdx( i );
+    m_cGopDecoder.decompressGop( m_cSlices[i], m_pcPic, false );
+    delete m_cSlices[i];
+  }
+  m_cSlices.clear();
+
+  m_cGopDecoder.filterPic( m_pcPic );
+}
+
+/** Release the tools of a picture that has been filtered.
+ */
+Void TDecPicWorker::finishPic()
+{
+  m_pcPic = NULL;
+}
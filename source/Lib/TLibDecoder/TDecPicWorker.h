@@ -0,0 +1,110 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecPicWorker.h
+    \brief    decoding tools of one picture in flight (header)
+*/
+
+#ifndef __TDECPICWORKER__
+#define __TDECPICWORKER__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <vector>
+
+#include "../TLibCommon/CommonDef.h"
+#include "../TLibCommon/TComPic.h"
+#include "../TLibCommon/TComPrediction.h"
+#include "../TLibCommon/TComTrQuant.h"
+#include "../TLibCommon/TComLoopFilter.h"
+#include "../TLibCommon/TComAdaptiveLoopFilter.h"
+#include "../TLibCommon/TComThreadPool.h"
+
+#include "TDecGop.h"
+#include "TDecSlice.h"
+#include "TDecCu.h"
+#include "TDecEntropy.h"
+#include "TDecSbac.h"
+#include "TDecCAVLC.h"
+#include "TDecBinCoderCABAC.h"
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the picture decoding tools, so that several pictures can be decoded at the same time
+class TDecPicWorker
+{
+private:
+  TComPrediction          m_cPrediction;
+  TComTrQuant             m_cTrQuant;
+  TDecGop                 m_cGopDecoder;
+  TDecSlice               m_cSliceDecoder;
+  TDecCu                  m_cCuDecoder;
+  TDecEntropy             m_cEntropyDecoder;
+  TDecCavlc               m_cCavlcDecoder;
+  TDecSbac                m_cSbacDecoder;
+  TDecBinCABAC            m_cBinCABAC;
+  TComLoopFilter          m_cLoopFilter;
+  TComAdaptiveLoopFilter  m_cAdaptiveLoopFilter[NUM_PIC_RESOLUTIONS];  ///< adaptive loop filter class for each resolution
+#if MTK_SAO
+  TComSampleAdaptiveOffset* m_cSAO[NUM_PIC_RESOLUTIONS];              ///< SAO class for each resolution
+#endif
+
+  TComPic*                m_pcPic;                    ///< picture decoded with these tools
+  std::vector<TComInputBitstream*> m_cSlices;         ///< slices of m_pcPic received and not decoded yet
+
+public:
+  TDecPicWorker();
+  virtual ~TDecPicWorker();
+
+  Void  init                  ( TComThreadPool* pcThreadPool );   ///< pcThreadPool runs the loop filters of a picture, NULL if none
+  Void  destroy               ();
+
+  Void  createLoopFilter      ();                                  ///< on reception of an SPS
+  Void  createCuDecoder       ();                                  ///< on reception of an SPS, for its LCU size
+  Void  createAdaptiveLoopFilter( TComPPS* pcPPS );               ///< on reception of a PPS, for its resolution
+  Void  destroyLoopFilter     ();
+
+  Void  initPic               ( TComPic* pcPic, TComSlice* pcSlice );   ///< first slice of a picture received
+  Void  addSlice              ( TComInputBitstream* pcBitstream );     ///< keep a slice to be decoded by decompressPic()
+  Void  decompressPic         ();                                      ///< decode the kept slices and filter the picture
+  Void  finishPic             ();
+
+  TComPic*  getPic            ()  { return m_pcPic;         }
+  TDecGop*  getGopDecoder     ()  { return &m_cGopDecoder;  }
+};
+
+#endif // __TDECPICWORKER__
@@ -291,10 +291,10 @@ Void TDecSbac::xReadEpExGolomb( UInt& ruiSymbol, UInt uiCount )
   }
   
   uiCount--;
-  while( uiCount-- )
+  if( uiCount )
   {
-    m_pcTDecBinIf->decodeBinEP( uiBit );
-    uiSymbol += uiBit << uiCount;
+    m_pcTDecBinIf->decodeBinsEP( uiBit, uiCount );
+    uiSymbol += uiBit;
   }
   
   ruiSymbol = uiSymbol;
@@ -349,12 +349,13 @@ Void TDecSbac::xReadGoRiceExGolomb( UInt &ruiSymbol, UInt &ruiGoRiceParam )
   uiCodeWord  = 1 - uiCodeWord;
   uiQuotient -= uiCodeWord;
 
-  for( UInt ui = 0; ui < ruiGoRiceParam; ui++ )
+  if( ruiGoRiceParam )
   {
-    m_pcTDecBinIf->decodeBinEP( uiCodeWord );
-    if( uiCodeWord )
+    m_pcTDecBinIf->decodeBinsEP( uiCodeWord, ruiGoRiceParam );
+    // the remainder is sent least significant bit first
+    for( UInt ui = 0; ui < ruiGoRiceParam; ui++ )
     {
-      uiRemainder += 1 << ui;
+      uiRemainder = ( uiRemainder << 1 ) | ( ( uiCodeWord >> ui ) & 1 );
     }
   }
 
@@ -1434,6 +1435,7 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
     default: uiCTXIdx = 0; break;
   }
   
+  const TextType eTTypeArea = eTType;
   eTType = eTType == TEXT_LUMA ? TEXT_LUMA : ( eTType == TEXT_NONE ? TEXT_NONE : TEXT_CHROMA );
   
   //----- parse significance map -----
@@ -1454,6 +1456,9 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
     parseLastSignificantXY( uiPosLastX, uiPosLastY, uiWidth, eTType, uiCTXIdx, uiScanIdx );
     UInt uiBlkPosLast      = uiPosLastX + (uiPosLastY<<uiLog2BlockSize);
     pcCoef[ uiBlkPosLast ] = 1;
+    // area holding the significant coefficients, for the inverse transform
+    UInt uiNzRows = uiPosLastY + 1;
+    UInt uiNzCols = uiPosLastX + 1;
 
     //===== decode significance flags =====
     for( UInt uiScanPos = 0; uiScanPos < uiMaxNumCoeffM1; uiScanPos++ )
@@ -1484,9 +1489,17 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
       m_pcTDecBinIf->decodeBin( uiSig, m_cCUSigSCModel.get( uiCTXIdx, eTType, uiCtxSig ) );
 #endif
       pcCoef[ uiBlkPos ] = uiSig;
+      if( uiSig )
+      {
+        uiNzRows = max( uiNzRows, uiPosY + 1 );
+        uiNzCols = max( uiNzCols, uiPosX + 1 );
+      }
     }
 
 #else
+  // area holding the significant coefficients, for the inverse transform
+  UInt uiNzRows = 0;
+  UInt uiNzCols = 0;
   for( UInt uiScanPos = 0; uiScanPos < uiMaxNumCoeffM1; uiScanPos++ )
   {
 #if QC_MDCS
@@ -1515,6 +1528,8 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
     if( uiSig )
     {
       pcCoef[ uiBlkPos ] = 1;
+      uiNzRows = max( uiNzRows, uiPosY + 1 );
+      uiNzCols = max( uiNzCols, uiPosX + 1 );
       
       //===== code last flag =====
       UInt  uiLast     = 0;
@@ -1531,6 +1546,8 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
   if( !bLastReceived )
   {
     pcCoef[ uiMaxNumCoeffM1 ] = 1;
+    uiNzRows = uiWidth;
+    uiNzCols = uiWidth;
   }
 #endif
   
@@ -1660,6 +1677,9 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
           }
         }
         
+        // signs of the sub-block in one go, the first one in the most significant bit
+        m_pcTDecBinIf->decodeBinsEP( uiSign, uiSubNumSig );
+        
         for( UInt uiScanPos = 0; uiScanPos < 16; uiScanPos++ )
         {
           UInt  uiBlkPos  = g_auiFrameScanXY[ 1 ][ 15 - uiScanPos ];
@@ -1671,8 +1691,8 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
           
           if( uiLevel )
           {
-            m_pcTDecBinIf->decodeBinEP( uiSign );
-            pcCoef[ uiIndex ] = ( uiSign ? -(Int)uiLevel : (Int)uiLevel );
+            uiSubNumSig--;
+            pcCoef[ uiIndex ] = ( ( uiSign >> uiSubNumSig ) & 1 ? -(Int)uiLevel : (Int)uiLevel );
           }
         }
       }
@@ -1742,6 +1762,16 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
       }
     }
     
+    UInt uiNumSig = 0;
+    for( UInt uiIndex = 0; uiIndex < 16; uiIndex++ )
+    {
+      if( pcCoef[ uiIndex ] )
+      {
+        uiNumSig++;
+      }
+    }
+    m_pcTDecBinIf->decodeBinsEP( uiSign, uiNumSig );
+    
     for( UInt uiScanPos = 0; uiScanPos < 16; uiScanPos++ )
     {
       UInt uiIndex = g_auiFrameScanXY[ 1 ][ 15 - uiScanPos ];
@@ -1749,12 +1779,13 @@ Void TDecSbac::parseCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartId
       
       if( uiLevel )
       {
-        m_pcTDecBinIf->decodeBinEP( uiSign );
-        pcCoef[ uiIndex ] = ( uiSign ? -(Int)uiLevel : (Int)uiLevel );
+        uiNumSig--;
+        pcCoef[ uiIndex ] = ( ( uiSign >> uiNumSig ) & 1 ? -(Int)uiLevel : (Int)uiLevel );
       }
     }
   }
   
+  pcCU->setNzArea( uiAbsPartIdx, eTTypeArea, uiNzRows, uiNzCols );
   return;
 }
 
@@ -1784,11 +1815,8 @@ Void TDecSbac::parseAlfFlagNum( UInt& ruiVal, UInt minValue, UInt depth )
   UInt uiBit;
   if(uiLength)
   {
-    while( uiLength-- )
-    {
-      m_pcTDecBinIf->decodeBinEP( uiBit );
-      ruiVal += uiBit << uiLength;
-    }
+    m_pcTDecBinIf->decodeBinsEP( uiBit, uiLength );
+    ruiVal = uiBit;
   }
   else
   {
@@ -72,7 +72,7 @@ public:
   Void  setAlfCtrl                ( Bool bAlfCtrl          ) { m_bAlfCtrl = bAlfCtrl;                   }
   Void  setMaxAlfCtrlDepth        ( UInt uiMaxAlfCtrlDepth ) { m_uiMaxAlfCtrlDepth = uiMaxAlfCtrlDepth; }
   
-  Void  parseSPS                  ( TComSPS* pcSPS         ) {}
+  Bool  parseSPS                  ( TComSPS* pcSPS         ) { return true; }
   Void  parsePPS                  (TComPPS* pcPPS, const std::vector<TComSPS*>& cSPSList) {}
   void parseSEI(SEImessages&) {}
   Void  parseSliceHeader          ( TComSlice*& rpcSlice, const std::vector<TComPPS*>& cPPSList ) {}
@@ -63,7 +63,12 @@ Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder)
   m_pcCuDecoder       = pcCuDecoder;
 }
 
-Void TDecSlice::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic)
+/**
+ \param pcBitstream    bitstream of the slice
+ \param rpcPic         picture being decoded
+ \param pcRowListener  told about each LCU row completely reconstructed, NULL if none
+ */
+Void TDecSlice::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic, TDecRowListener* pcRowListener)
 {
   TComDataCU* pcCU;
   UInt        uiIsLast = 0;
@@ -107,6 +112,12 @@ Void TDecSlice::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPi
 #if SUB_LCU_DQP
     uhLastQP = pcCU->getLastCodedQP();
 #endif
+#if PARALLEL_MERGED_DEBLK
+    if ( pcRowListener && ( iCUAddr+1 ) % rpcPic->getFrameWidthInCU() == 0 )
+    {
+      pcRowListener->setRowsDecoded( rpcPic, ( iCUAddr+1 ) / rpcPic->getFrameWidthInCU() );
+    }
+#endif
     
 #if ENC_DEC_TRACE
     g_bJustDoIt = g_bEncDecTraceDisable;
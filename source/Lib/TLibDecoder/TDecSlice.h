@@ -52,6 +52,14 @@
 // Class definition
 // ====================================================================================================================
 
+/// told by the slice decoder about the LCU rows it completes, see TDecSlice::decompressSlice()
+class TDecRowListener
+{
+public:
+  virtual ~TDecRowListener() {}
+  virtual Void setRowsDecoded ( TComPic* pcPic, Int iNumRows ) = 0;   ///< iNumRows LCU rows are completely reconstructed
+};
+
 /// slice decoder class
 class TDecSlice
 {
@@ -69,7 +77,7 @@ public:
   Void  create            ( TComSlice* pcSlice, Int iWidth, Int iHeight, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth );
   Void  destroy           ();
   
-  Void  decompressSlice   ( TComInputBitstream* pcBitstream, TComPic*& rpcPic );
+  Void  decompressSlice   ( TComInputBitstream* pcBitstream, TComPic*& rpcPic, TDecRowListener* pcRowListener = NULL );
 
 };
 
@@ -57,6 +57,16 @@ TDecTop::TDecTop()
   m_uiPOCRA = MAX_UINT;          
 #endif
   m_uiPrevPOC               = UInt(-1);
+  m_iLoopFilterThreads      = 0;
+  m_iFrameThreads           = 0;
+  m_pcPicWorkers            = NULL;
+  m_iNumPicWorkers          = 0;
+  m_iFirstPicInFlight       = 0;
+  m_iNumPicsInFlight        = 0;
+  m_iNumPicsStarted         = 0;
+  m_pbPicDecoded            = NULL;
+  m_bStopThreads            = false;
+  m_pcPicWorker             = NULL;
   m_bFirstSliceInPicture    = true;
   m_bFirstSliceInSequence   = true;
 }
@@ -70,7 +80,6 @@ TDecTop::~TDecTop()
 
 Void TDecTop::create()
 {
-  m_cGopDecoder.create();
   m_apcSlicePilot = new TComSlice;
   m_uiSliceIdx = m_uiLastSliceIdx = 0;
 }
@@ -84,12 +93,28 @@ Void TDecTop::destroy()
     delete m_cPPS[i];
   }
 
-  m_cGopDecoder.destroy();
-  
   delete m_apcSlicePilot;
   m_apcSlicePilot = NULL;
   
-  m_cSliceDecoder.destroy();
+  if ( m_iFrameThreads > 1 )
+  {
+    m_cPicsMutex.lock();
+    m_bStopThreads = true;
+    m_cPicsChanged.broadcast();
+    m_cPicsMutex.unlock();
+    m_cThreadPool.wait();
+  }
+  m_cThreadPool.destroy();
+
+  for ( Int i = 0; i < m_iNumPicWorkers; i++ )
+  {
+    m_pcPicWorkers[i].destroy();
+  }
+  delete [] m_pcPicWorkers;
+  delete [] m_pbPicDecoded;
+  m_pcPicWorkers   = NULL;
+  m_pbPicDecoded   = NULL;
+  m_iNumPicWorkers = 0;
 }
 
 Void TDecTop::init()
@@ -97,17 +122,38 @@ Void TDecTop::init()
   // initialize ROM
   initROM();
 
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
-    m_cSAO[j] = NULL;
+  // every picture in flight is decoded with its own tools, there are more of them than threads so that the next
+  // pictures are queued while the threads are busy
+  m_iNumPicWorkers = m_iFrameThreads > 1 ? 2*m_iFrameThreads : 1;
+  m_pcPicWorkers   = new TDecPicWorker[ m_iNumPicWorkers ];
+  m_pbPicDecoded   = new Bool[ m_iNumPicWorkers ];
+  m_pcPicWorker    = &m_pcPicWorkers[0];
+
+  // with one picture at a time, the deblocking of the LCU rows starts while the rest of the picture is decoded
+  TComThreadPool* pcLoopFilterPool = NULL;
+  if ( m_iFrameThreads > 1 )
+  {
+    // the calling thread receives the pictures, the other ones decode them until destroy()
+    m_cThreadPool.create( m_iFrameThreads + 1 );
+    m_cThreadPool.start( this );
   }
+  else if ( m_iLoopFilterThreads > 1 )
+  {
+    m_cThreadPool.create( m_iLoopFilterThreads );
+    pcLoopFilterPool = &m_cThreadPool;
+  }
+  for ( Int i = 0; i < m_iNumPicWorkers; i++ )
+  {
+    m_pcPicWorkers[i].init( pcLoopFilterPool );
+  }
+}
 
-#if MTK_SAO
-  m_cGopDecoder.  init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cAdaptiveLoopFilter[0], &m_cSAO[0]);
-#else
-  m_cGopDecoder.  init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cAdaptiveLoopFilter[0] );
-#endif
-  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder );
-  m_cEntropyDecoder.init(&m_cPrediction);
+Void TDecTop::setPictureDigestEnabled(bool enabled)
+{
+  for ( Int i = 0; i < m_iNumPicWorkers; i++ )
+  {
+    m_pcPicWorkers[i].getGopDecoder()->setPictureDigestEnabled( enabled );
+  }
 }
 
 Void TDecTop::deletePicBuffer ( )
@@ -124,21 +170,11 @@ Void TDecTop::deletePicBuffer ( )
     pcPic = NULL;
   }
   
-  // destroy ALF temporary buffers
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
-    m_cAdaptiveLoopFilter[j].destroy();
-  }
-
-#if MTK_SAO
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
-    if (m_cSAO[j] != NULL ){
-      m_cSAO[j]->destroy();
-      delete m_cSAO[j];
-    }
+  // destroy loop filter buffers
+  for ( Int i = 0; i < m_iNumPicWorkers; i++ )
+  {
+    m_pcPicWorkers[i].destroyLoopFilter();
   }
-#endif
-  
-  m_cLoopFilter.        destroy();
   
   // destroy ROM
   destroyROM();
@@ -151,7 +187,10 @@ Void TDecTop::xUpdateGopSize (TComSlice* pcSlice)
     m_iGopSize    = pcSlice->getPOC();
     m_bGopSizeSet = true;
     
-    m_cGopDecoder.setGopSize(m_iGopSize);
+    for ( Int i = 0; i < m_iNumPicWorkers; i++ )
+    {
+      m_pcPicWorkers[i].getGopDecoder()->setGopSize( m_iGopSize );
+    }
   }
 }
 
@@ -161,10 +200,11 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
   
   m_iMaxRefPicNum = max(m_iMaxRefPicNum, max(max(2, pcSlice->getNumRefIdx(REF_PIC_LIST_0)+1), m_iGopSize/2 + 2 + pcSlice->getNumRefIdx(REF_PIC_LIST_0)));
   
-  if (m_cListPic.size() < (UInt)m_iMaxRefPicNum)
+  // the pictures in flight hold their buffers until they are decoded
+  if (m_cListPic.size() < (UInt)(m_iMaxRefPicNum + m_iNumPicsInFlight))
   {
     rpcPic = new TComPic();
-    rpcPic->create ( pcSlice->getSPS()->getNominalWidth(), pcSlice->getSPS()->getNominalHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0, true);
+    rpcPic->create ( pcSlice->getSPS(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0, true);
     m_cListPic.pushBack( rpcPic );
     
     return;
@@ -175,6 +215,10 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
   while (iterPic != m_cListPic.end())
   {
     rpcPic = *(iterPic++);
+    if ( xIsUsedByPicsInFlight( rpcPic ) )
+    {
+      continue;
+    }
     if ( rpcPic->getReconMark() == false )
     {
       bBufferIsAvailable = true;
@@ -194,16 +238,66 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
   {
     pcSlice->sortPicList(m_cListPic);
     iterPic = m_cListPic.begin();
+    while ( iterPic != m_cListPic.end() && xIsUsedByPicsInFlight( *iterPic ) )
+    {
+      iterPic++;
+    }
+    if ( iterPic == m_cListPic.end() )
+    {
+      rpcPic = new TComPic();
+      rpcPic->create ( pcSlice->getSPS(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0, true);
+      m_cListPic.pushBack( rpcPic );
+      return;
+    }
     rpcPic = *(iterPic);
     rpcPic->destroy();
-    rpcPic->create ( pcSlice->getSPS()->getNominalWidth(), pcSlice->getSPS()->getNominalHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0, true);
+    rpcPic->create ( pcSlice->getSPS(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0, true);
     rpcPic->setReconMark(false);
   } else {
     rpcPic->resetRecData();
   }
 }
 
-Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic, Int& iSkipFrame, Int& iPOCLastDisplay)
+/** Check whether a buffer is still needed by the pictures in flight.
+ * Besides the pictures not reported yet, this covers their references, which a later refresh or temporal layer switch
+ * may already have marked as unused.
+ */
+Bool TDecTop::xIsUsedByPicsInFlight( TComPic* pcPic )
+{
+  if ( pcPic->getRecInProgress() )
+  {
+    return true;
+  }
+  for ( Int i = 0; i < m_iNumPicsInFlight; i++ )
+  {
+    TComPic* pcPicInFlight = m_pcPicWorkers[ ( m_iFirstPicInFlight + i ) % m_iNumPicWorkers ].getPic();
+    if ( pcPicInFlight == pcPic )
+    {
+      return true;
+    }
+    for ( UInt uiSliceIdx = 0; uiSliceIdx < pcPicInFlight->getNumAllocatedSlice(); uiSliceIdx++ )
+    {
+      TComSlice* pcSlice = pcPicInFlight->getSlice( uiSliceIdx );
+      if ( pcSlice->isIntra() )
+      {
+        continue;
+      }
+      for ( Int iList = 0; iList < 2; iList++ )
+      {
+        for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( RefPicList( iList ) ); iRefIdx++ )
+        {
+          if ( pcSlice->getRefPic( RefPicList( iList ), iRefIdx ) == pcPic )
+          {
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
+Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic, Int& iSkipFrame, Int& iPOCLastDisplay, Bool bFlush)
 {
   if (!m_pcPic)
     /* nothing to deblock */
@@ -211,8 +305,33 @@ Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic
 
   TComPic*&   pcPic         = m_pcPic;
 
+  if ( m_iFrameThreads > 1 )
+  {
+    if ( !m_bFirstSliceInPicture )
+    {
+      xQueuePic();
+    }
+    // a worker is kept free for the next picture, the pictures still in flight are waited for at the end
+    xReportPics( bFlush ? 0 : m_iNumPicWorkers-1 );
+
+    // the application writes the reconstructed pictures, but must not release those the threads still use
+    TComSlice::sortPicList( m_cListPic ); // sorting for application output
+    m_cListPicOutput.clear();
+    for ( TComList<TComPic*>::iterator iterPic = m_cListPic.begin(); iterPic != m_cListPic.end(); iterPic++ )
+    {
+      TComPic* pcPicOutput = *iterPic;
+      if ( !pcPicOutput->getRecInProgress() && ( pcPicOutput->getSlice(0)->isReferenced() || !xIsUsedByPicsInFlight( pcPicOutput ) ) )
+      {
+        m_cListPicOutput.pushBack( pcPicOutput );
+      }
+    }
+    ruiPOC              = pcPic->getPOC();
+    rpcListPic          = &m_cListPicOutput;
+    return;
+  }
+
   // Execute Deblock and ALF only + Cleanup
-  m_cGopDecoder.decompressGop(NULL, pcPic, true);
+  m_pcPicWorker->getGopDecoder()->decompressGop(NULL, pcPic, true);
 
   // Apply decoder picture marking at the end of coding
   pcPic->getSlice( 0 )->decodingTLayerSwitchingMarking( m_cListPic );
@@ -220,12 +339,87 @@ Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic
   TComSlice::sortPicList( m_cListPic ); // sorting for application output
   ruiPOC              = pcPic->getSlice(m_uiSliceIdx-1)->getPOC();
   rpcListPic          = &m_cListPic;
-  m_cCuDecoder.destroy();
+  m_pcPicWorker->finishPic();
   m_bFirstSliceInPicture  = true;
 
   return;
 }
 
+/** Close the picture whose slices have all been received and hand it to the next free thread.
+ */
+Void TDecTop::xQueuePic()
+{
+  // Apply decoder picture marking at the end of coding
+  m_pcPic->getSlice( 0 )->decodingTLayerSwitchingMarking( m_cListPic );
+
+  m_cPicsMutex.lock();
+  m_pbPicDecoded[ m_pcPicWorker - m_pcPicWorkers ] = false;
+  m_iNumPicsInFlight++;
+  m_cPicsChanged.broadcast();
+  m_cPicsMutex.unlock();
+  m_bFirstSliceInPicture  = true;
+}
+
+/** Report the decoded pictures in decoding order and release their workers.
+ * \param iNumKept the oldest pictures are waited for until no more than iNumKept pictures are in flight
+ */
+Void TDecTop::xReportPics( Int iNumKept )
+{
+  m_cPicsMutex.lock();
+  while ( m_iNumPicsInFlight > 0 )
+  {
+    Int iWorker = m_iFirstPicInFlight;
+    if ( !m_pbPicDecoded[iWorker] )
+    {
+      if ( m_iNumPicsInFlight <= iNumKept )
+      {
+        break;
+      }
+      m_cPicsChanged.wait( m_cPicsMutex );
+      continue;
+    }
+    m_iFirstPicInFlight = ( iWorker + 1 ) % m_iNumPicWorkers;
+    m_iNumPicsInFlight--;
+    m_iNumPicsStarted--;
+    m_cPicsMutex.unlock();
+
+    TComPic* pcPic = m_pcPicWorkers[iWorker].getPic();
+    m_pcPicWorkers[iWorker].getGopDecoder()->reportPic( pcPic );
+    m_pcPicWorkers[iWorker].finishPic();
+
+    m_cPicsMutex.lock();
+  }
+  m_cPicsMutex.unlock();
+}
+
+/** Decode the pictures in flight in decoding order, each on the first thread that is free.
+ * A picture only waits for the reference rows of the pictures before it, which are all taken by a thread already.
+ */
+Void TDecTop::runTask( Int iThreadIdx )
+{
+  m_cPicsMutex.lock();
+  for (;;)
+  {
+    while ( m_iNumPicsStarted == m_iNumPicsInFlight && !m_bStopThreads )
+    {
+      m_cPicsChanged.wait( m_cPicsMutex );
+    }
+    if ( m_iNumPicsStarted == m_iNumPicsInFlight )
+    {
+      break;
+    }
+    Int iWorker = ( m_iFirstPicInFlight + m_iNumPicsStarted++ ) % m_iNumPicWorkers;
+    m_cPicsMutex.unlock();
+
+    m_pcPicWorkers[iWorker].decompressPic();
+
+    m_cPicsMutex.lock();
+    m_pbPicDecoded[iWorker] = true;
+    m_cPicsChanged.broadcast();
+  }
+  m_cPicsMutex.unlock();
+}
+
 Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
 {
   TComPic*&   pcPic         = m_pcPic;
@@ -237,8 +431,17 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
   {
     case NAL_UNIT_SPS:
     {
+      // the parameters and the tools of the pictures in flight are replaced
+      xReportPics( 0 );
+
       TComSPS* pNewSPS = new TComSPS();
-      m_cEntropyDecoder.decodeSPS( pNewSPS );
+      if ( !m_cEntropyDecoder.decodeSPS( pNewSPS ) )
+      {
+        // the parameter sets referring to its id keep the SPS received before with that id, if any
+        fprintf( stderr, "Warning: SPS with an invalid resolution ladder ignored\n" );
+        delete pNewSPS;
+        return false;
+      }
       // create ALF temporary buffer
       bool bRecSPSBefore = false;
       for (size_t s=0; s<m_cSPS.size(); ++s){
@@ -250,13 +453,19 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
       if (!bRecSPSBefore){
         m_cSPS.push_back( pNewSPS );
       }
-      m_cLoopFilter.        create( g_uiMaxCUDepth );
+      for ( Int i = 0; i < m_iNumPicWorkers; i++ )
+      {
+        m_pcPicWorkers[i].createLoopFilter();
+        m_pcPicWorkers[i].createCuDecoder();
+      }
       m_uiValidPS |= 1;
       
       return false;
     }
     case NAL_UNIT_PPS:
     {
+      xReportPics( 0 );
+
       TComPPS* pNewPPS = new TComPPS();
       m_cEntropyDecoder.decodePPS( pNewPPS , m_cSPS );
       bool bRecPPSBefore = false;
@@ -270,14 +479,10 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
         m_cPPS.push_back( pNewPPS );
       }
 
-      Int iPicSizeIdx = m_cPPS[m_cPPS.size()-1]->getPictureSizeIdx();
-      m_cAdaptiveLoopFilter[iPicSizeIdx].create( m_cPPS[m_cPPS.size()-1]->getPictureWidth(), m_cPPS[m_cPPS.size()-1]->getPictureHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
-#if MTK_SAO
-      if (m_cSAO[iPicSizeIdx]==NULL){
-        m_cSAO[iPicSizeIdx] = new TComSampleAdaptiveOffset;
-        m_cSAO[iPicSizeIdx]->create( m_cPPS[m_cPPS.size()-1]->getPictureWidth(), m_cPPS[m_cPPS.size()-1]->getPictureHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+      for ( Int i = 0; i < m_iNumPicWorkers; i++ )
+      {
+        m_pcPicWorkers[i].createAdaptiveLoopFilter( m_cPPS[m_cPPS.size()-1] );
       }
-#endif
 
       m_uiValidPS |= 2;
       return false;
@@ -334,17 +539,16 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
       
       if (m_bFirstSliceInPicture)
       {
-        // Buffer initialize for prediction.
-        m_cPrediction.initTempBuff();
         //  Get a new picture buffer
         xGetNewPicBuffer (m_apcSlicePilot, pcPic);
 
-        // Recursive structure
-        m_cCuDecoder.create ( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
-        m_cCuDecoder.init   ( &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction );
-        m_cTrQuant.init     ( g_uiMaxCUWidth, g_uiMaxCUHeight, m_apcSlicePilot->getSPS()->getMaxTrSize());
-        
-        m_cSliceDecoder.create( m_apcSlicePilot, m_apcSlicePilot->getPPS()->getPictureWidth(), m_apcSlicePilot->getPPS()->getPictureHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+        // the picture is decoded with the tools of the next free worker
+        m_pcPicWorker = &m_pcPicWorkers[ ( m_iFirstPicInFlight + m_iNumPicsInFlight ) % m_iNumPicWorkers ];
+        m_pcPicWorker->initPic( pcPic, m_apcSlicePilot );
+        if ( m_iFrameThreads > 1 )
+        {
+          pcPic->startRecRows();
+        }
 
 	pcPic->setPictureSizeIdx( m_apcSlicePilot->getPPS()->getPictureSizeIdx() );
         
@@ -371,6 +575,8 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
       assert(pcPic->getNumAllocatedSlice() == (m_uiSliceIdx + 1));
       m_apcSlicePilot = pcPic->getPicSym()->getSlice(m_uiSliceIdx);
       pcPic->getPicSym()->setSlice(pcSlice, m_uiSliceIdx);
+      // the POC of the picture is read from the slice being received until it is decoded
+      pcPic->setCurrSliceIdx(m_uiSliceIdx);
 
       pcPic->setTLayer(nalu.m_TemporalID);
 
@@ -455,11 +661,18 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
             }
           }
       }
-      
-      pcPic->setCurrSliceIdx(m_uiSliceIdx);
 
       //  Decode a picture
-      m_cGopDecoder.decompressGop(nalu.m_Bitstream, pcPic, false);
+      if ( m_iFrameThreads > 1 )
+      {
+        // the slice is decoded with the other pictures in flight, its bytes stay in the input buffer until then
+        m_pcPicWorker->addSlice( nalu.m_Bitstream );
+        nalu.m_Bitstream = NULL;
+      }
+      else
+      {
+        m_pcPicWorker->getGopDecoder()->decompressGop(nalu.m_Bitstream, pcPic, false);
+      }
 
       m_bFirstSliceInPicture = false;
       m_uiSliceIdx++;
@@ -44,8 +44,10 @@
 #include "../TLibCommon/TComPic.h"
 #include "../TLibCommon/TComTrQuant.h"
 #include "../TLibCommon/SEI.h"
+#include "../TLibCommon/TComThreadPool.h"
 
 #include "TDecGop.h"
+#include "TDecPicWorker.h"
 #include "TDecEntropy.h"
 #include "TDecSbac.h"
 #include "TDecCAVLC.h"
@@ -57,7 +59,7 @@ struct InputNALUnit;
 // ====================================================================================================================
 
 /// decoder class
-class TDecTop
+class TDecTop : public TComThreadTask
 {
 private:
   Int                     m_iGopSize;
@@ -72,6 +74,7 @@ private:
 
   UInt                    m_uiValidPS;
   TComList<TComPic*>      m_cListPic;         //  Dynamic buffer
+  TComList<TComPic*>      m_cListPicOutput;   //  pictures of m_cListPic handed to the application, see executeDeblockAndAlf()
   std::vector<TComSPS*>   m_cSPS;             //  List of SPSs in use
   std::vector<TComPPS*>   m_cPPS;             //  List of PPSs in use
   TComSlice*              m_apcSlicePilot;
@@ -79,20 +82,21 @@ private:
   SEImessages *m_SEIs; ///< "all" SEI messages.  If not NULL, we own the object.
 
   // functional classes
-  TComPrediction          m_cPrediction;
-  TComTrQuant             m_cTrQuant;
-  TDecGop                 m_cGopDecoder;
-  TDecSlice               m_cSliceDecoder;
-  TDecCu                  m_cCuDecoder;
-  TDecEntropy             m_cEntropyDecoder;
+  TDecEntropy             m_cEntropyDecoder;          ///< reads the parameter sets and slice headers
   TDecCavlc               m_cCavlcDecoder;
-  TDecSbac                m_cSbacDecoder;
-  TDecBinCABAC            m_cBinCABAC;
-  TComLoopFilter          m_cLoopFilter;
-  TComAdaptiveLoopFilter  m_cAdaptiveLoopFilter[NUM_PIC_RESOLUTIONS];  ///< adaptive loop filter class for each resolution
-#if MTK_SAO
-  TComSampleAdaptiveOffset* m_cSAO[NUM_PIC_RESOLUTIONS]; ///< SAO class for each resolution
-#endif
+  Int                     m_iLoopFilterThreads;       ///< number of threads running the deblocking filter and ALF
+  Int                     m_iFrameThreads;            ///< number of pictures decoded at the same time, 0 or 1: one after the other
+  TComThreadPool          m_cThreadPool;
+  TDecPicWorker*          m_pcPicWorkers;             ///< decoding tools of each picture that can be in flight
+  Int                     m_iNumPicWorkers;
+  Int                     m_iFirstPicInFlight;        ///< worker of the oldest picture in flight, the next ones follow in decoding order
+  Int                     m_iNumPicsInFlight;         ///< pictures received completely and not reported yet
+  Int                     m_iNumPicsStarted;          ///< pictures in flight taken by a thread, the oldest ones
+  Bool*                   m_pbPicDecoded;             ///< for each worker, its picture in flight is decoded and filtered
+  Bool                    m_bStopThreads;
+  TComMutex               m_cPicsMutex;               ///< guards the state of the pictures in flight
+  TComCondition           m_cPicsChanged;             ///< signalled when a picture is queued or decoded, or the threads stop
+  TDecPicWorker*          m_pcPicWorker;              ///< tools of the picture being received
 
   Bool isRandomAccessSkipPicture(Int& iSkipFrame,  Int& iPOCLastDisplay);
   TComPic*                m_pcPic;
@@ -109,7 +113,9 @@ public:
   Void  create  ();
   Void  destroy ();
 
-  void setPictureDigestEnabled(bool enabled) { m_cGopDecoder.setPictureDigestEnabled(enabled); }
+  void setPictureDigestEnabled(bool enabled);
+  Void  setLoopFilterThreads  ( Int i )       { m_iLoopFilterThreads = i; }
+  Void  setFrameThreads       ( Int i )       { m_iFrameThreads = i; }
   
   Void  init();
   Bool  decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay);
@@ -118,11 +124,16 @@ public:
   
   Void  deletePicBuffer();
 
-  Void executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic, Int& iSkipFrame,  Int& iPOCLastDisplay);
+  Void executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic, Int& iSkipFrame,  Int& iPOCLastDisplay, Bool bFlush);
+
+  Void  runTask ( Int iThreadIdx );   ///< each thread but the receiving one decodes the pictures in flight in turn
 
 protected:
   Void  xGetNewPicBuffer  (TComSlice* pcSlice, TComPic*& rpcPic);
   Void  xUpdateGopSize    (TComSlice* pcSlice);
+  Void  xQueuePic         ();
+  Void  xReportPics       ( Int iNumKept );
+  Bool  xIsUsedByPicsInFlight ( TComPic* pcPic );
   
 };// END CLASS DEFINITION TDecTop
 
@@ -45,6 +45,7 @@
 // ====================================================================================================================
 
 #define ALF_NUM_OF_REDESIGN 3
+#define ALF_CORR_ACC_SIZE   (MAX_SQR_FILT_LENGTH*MAX_SQR_FILT_LENGTH + MAX_SQR_FILT_LENGTH + 1)  ///< Int64 E, y and pixAcc of one class
 
 // ====================================================================================================================
 // Tables
@@ -176,6 +177,14 @@ TEncAdaptiveLoopFilter::TEncAdaptiveLoopFilter()
 #if MQT_BA_RA && MQT_ALF_NPASS
   m_aiFilterCoeffSaved = NULL;
 #endif
+  m_piCorrAcc = NULL;
+  m_piCorrPart = NULL;
+  m_iCorrNumThreads = 0;
+  m_iCorrCacheTap = 0;
+  m_maskImgCache = NULL;
+  m_ECache = NULL;
+  m_yCache = NULL;
+  m_pixAccCache = NULL;
 }
 
 // ====================================================================================================================
@@ -276,6 +285,12 @@ Void TEncAdaptiveLoopFilter::startALFEnc( TComPic* pcPic, TEncEntropy* pcEntropy
 #endif
   get_mem2Dpel(&m_maskImg, m_im_height, m_im_width);
   
+  get_mem2Dpel(&m_maskImgCache, m_im_height, m_im_width);
+  initMatrix3D_double(&m_ECache, NO_VAR_BINS, MAX_SQR_FILT_LENGTH, MAX_SQR_FILT_LENGTH);
+  initMatrix_double(&m_yCache, NO_VAR_BINS, MAX_SQR_FILT_LENGTH);
+  m_pixAccCache = (double *) calloc(NO_VAR_BINS, sizeof(double));
+  m_iCorrCacheTap = 0;
+  
   initMatrix_double(&m_E_temp, MAX_SQR_FILT_LENGTH, MAX_SQR_FILT_LENGTH);//
   m_y_temp = (double *) calloc(MAX_SQR_FILT_LENGTH, sizeof(double));//
   initMatrix3D_double(&m_E_merged, NO_VAR_BINS, MAX_SQR_FILT_LENGTH, MAX_SQR_FILT_LENGTH);//
@@ -329,6 +344,15 @@ Void TEncAdaptiveLoopFilter::endALFEnc()
 #endif
   free_mem2Dpel(m_maskImg);
   
+  free_mem2Dpel(m_maskImgCache);
+  destroyMatrix3D_double(m_ECache, NO_VAR_BINS);
+  destroyMatrix_double(m_yCache);
+  free(m_pixAccCache);
+  m_maskImgCache = NULL;
+  m_ECache = NULL;
+  m_yCache = NULL;
+  m_pixAccCache = NULL;
+  
   destroyMatrix3D_double(m_E_merged, NO_VAR_BINS);
   destroyMatrix_double(m_y_merged);
   destroyMatrix_double(m_E_temp);
@@ -363,8 +387,9 @@ Void TEncAdaptiveLoopFilter::endALFEnc()
  \retval ruiDist             distortion
  \retval ruiBits             required bits
  \retval ruiMaxAlfCtrlDepth  optimal partition depth
+ \param pcThreadPool         threads accumulating the correlations, NULL to use the calling thread only
  */
-Void TEncAdaptiveLoopFilter::ALFProcess( ALFParam* pcAlfParam, Double dLambda, UInt64& ruiDist, UInt64& ruiBits, UInt& ruiMaxAlfCtrlDepth )
+Void TEncAdaptiveLoopFilter::ALFProcess( ALFParam* pcAlfParam, Double dLambda, UInt64& ruiDist, UInt64& ruiBits, UInt& ruiMaxAlfCtrlDepth, TComThreadPool* pcThreadPool )
 {
   Int tap, num_coef;
   
@@ -381,6 +406,14 @@ Void TEncAdaptiveLoopFilter::ALFProcess( ALFParam* pcAlfParam, Double dLambda, U
   // set lambda
   m_dLambdaLuma   = dLambda;
   m_dLambdaChroma = dLambda;
+  
+  // one set of correlation accumulators per thread
+  m_pcThreadPool    = pcThreadPool;
+  m_iCorrNumThreads = ( pcThreadPool ? pcThreadPool->getNumThreads() : 1 );
+  m_piCorrAcc       = new Int64[ m_iCorrNumThreads * NO_VAR_BINS * ALF_CORR_ACC_SIZE ];
+  m_piCorrPart      = new Int  [ m_iCorrNumThreads * NO_VAR_BINS * ALF_CORR_ACC_SIZE ];
+  ::memset( m_piCorrPart, 0, sizeof(Int) * m_iCorrNumThreads * NO_VAR_BINS * ALF_CORR_ACC_SIZE );
+  m_iCorrCacheTap   = 0;
  
   TComPicYuv* pcPicOrg = m_pcPic->getPicYuvOrg();
   
@@ -479,6 +512,12 @@ Void TEncAdaptiveLoopFilter::ALFProcess( ALFParam* pcAlfParam, Double dLambda, U
   
   // store best depth
   ruiMaxAlfCtrlDepth = m_pcEntropyCoder->getMaxAlfCtrlDepth();
+  
+  delete[] m_piCorrAcc;
+  delete[] m_piCorrPart;
+  m_piCorrAcc     = NULL;
+  m_piCorrPart    = NULL;
+  m_pcThreadPool  = NULL;
 }
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
@@ -787,9 +826,16 @@ Void TEncAdaptiveLoopFilter::xCalcCorrelationFunc(Pel* pOrg, Pel* pCmp, Int iTap
       break;
   }
   
-  Pel* pTerm = new Pel[N];
+  // the sums of integer products are kept in 64-bit integers and added to m_ppdAlfCorr once, exactly
+  Int   aiTerm[ALF_MAX_NUM_COEF];
+  Int64 aaiCorr[ALF_MAX_NUM_COEF][ALF_MAX_NUM_COEF+1];
   
   Int i, j;
+  for(j=0; j<=N; j++)
+  {
+    ::memset(aaiCorr[j], 0, sizeof(Int64)*(N+2));
+  }
+  
 #if MTK_NONCROSS_INLOOP_FILTER
   for (Int y = ypos; y < ypos + iHeight; y++)
   {
@@ -802,7 +848,7 @@ Void TEncAdaptiveLoopFilter::xCalcCorrelationFunc(Pel* pOrg, Pel* pCmp, Int iTap
     {
 #endif
       i = 0;
-      ::memset(pTerm, 0, sizeof(Pel)*N);
+      ::memset(aiTerm, 0, sizeof(Int)*N);
 #if TI_ALF_MAX_VSIZE_7
       for (Int yy = y - offsetV; yy <= y + offsetV; yy++)
 #else
@@ -811,28 +857,39 @@ Void TEncAdaptiveLoopFilter::xCalcCorrelationFunc(Pel* pOrg, Pel* pCmp, Int iTap
       {
         for(Int xx=x-offset; xx<=x+offset; xx++)
         {
-          pTerm[pFiltPos[i]] += pCmp[xx + yy*iCmpStride];
+          aiTerm[pFiltPos[i]] += pCmp[xx + yy*iCmpStride];
           i++;
         }
       }
       
+      Int iOrg = pOrg[x+y*iOrgStride];
       for(j=0; j<N; j++)
       {
-        m_ppdAlfCorr[j][j] += pTerm[j]*pTerm[j];
-        for(i=j+1; i<N; i++)
-          m_ppdAlfCorr[j][i] += pTerm[j]*pTerm[i];
+        Int64* piCorr = aaiCorr[j];
+        Int    iTerm  = aiTerm[j];
+        for(i=j; i<N; i++)
+          piCorr[i] += iTerm*aiTerm[i];
         
         // DC offset
-        m_ppdAlfCorr[j][N]   += pTerm[j];
-        m_ppdAlfCorr[j][N+1] += pOrg[x+y*iOrgStride]*pTerm[j];
+        piCorr[N]   += iTerm;
+        piCorr[N+1] += iOrg*iTerm;
       }
       // DC offset
       for(i=0; i<N; i++)
-        m_ppdAlfCorr[N][i] += pTerm[i];
-      m_ppdAlfCorr[N][N]   += 1;
-      m_ppdAlfCorr[N][N+1] += pOrg[x+y*iOrgStride];
+        aaiCorr[N][i] += aiTerm[i];
+      aaiCorr[N][N]   += 1;
+      aaiCorr[N][N+1] += iOrg;
     }
   }
+  
+  for(j=0; j<N; j++)
+  {
+    for(i=j; i<N+2; i++)
+      m_ppdAlfCorr[j][i] += (Double)aaiCorr[j][i];
+  }
+  for(i=0; i<N+2; i++)
+    m_ppdAlfCorr[N][i] += (Double)aaiCorr[N][i];
+  
 #if MTK_NONCROSS_INLOOP_FILTER
   if(bSymmCopyBlockMatrix)
   {
@@ -845,9 +902,6 @@ Void TEncAdaptiveLoopFilter::xCalcCorrelationFunc(Pel* pOrg, Pel* pCmp, Int iTap
 #if MTK_NONCROSS_INLOOP_FILTER
   }
 #endif
-
-  delete[] pTerm;
-  pTerm = NULL;
 }
 
 #if IBDI_DISTORTION
@@ -2090,15 +2144,7 @@ Void   TEncAdaptiveLoopFilter::xEncALFLuma_qc ( TComPicYuv* pcPicOrg, TComPicYuv
 
 Void   TEncAdaptiveLoopFilter::xFirstFilteringFrameLuma(imgpel* ImgOrg, imgpel* ImgDec, imgpel* ImgRest, ALFParam* ALFp, Int tap, Int Stride)
 {
-#if MTK_NONCROSS_INLOOP_FILTER
-  if(!m_bUseNonCrossALF)
-    xstoreInBlockMatrix(0, 0, m_im_height, m_im_width, true, true, ImgOrg, ImgDec, tap, Stride);
-  else
-    xstoreInBlockMatrixforSlices(ImgOrg, ImgDec, tap, Stride);
-#else
-  xstoreInBlockMatrix(ImgOrg, ImgDec, tap, Stride);
-#endif
-
+  xStoreCorrelation(ImgOrg, ImgDec, tap, Stride);
 
   xFilteringFrameLuma_qc(ImgOrg, ImgDec, ImgRest, ALFp, tap, Stride);
 }
@@ -2110,23 +2156,13 @@ Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrix(Int ypos, Int xpos, Int iheig
 Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride)
 #endif
 {
-#if MQT_BA_RA
-  Int var_step_size_w = VAR_SIZE_W;
-  Int var_step_size_h = VAR_SIZE_H;
-#endif
-
-  Int i,j,k,l,varInd,ii,jj;
-  Int fl =tap/2;
+  Int i,j,k,l,varInd;
 #if TI_ALF_MAX_VSIZE_7
-  Int flV = TComAdaptiveLoopFilter::ALFFlHToFlV(fl);
   Int sqrFiltLength = TComAdaptiveLoopFilter::ALFTapHToNumCoeff(tap);
 #else
   Int sqrFiltLength=(((tap*tap)/4 + 1) + 1);
 #endif
   Int fl2=9/2; //extended size at each side of the frame
-  Int ELocal[MAX_SQR_FILT_LENGTH];
-  Int yLocal;
-  Int *p_pattern;
   Int filtNo =2; 
   double **E,*yy;
 #if MTK_NONCROSS_INLOOP_FILTER
@@ -2143,8 +2179,6 @@ Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDe
   imgpel regionOfInterested = (m_iDesignCurrentFilter ==1)?(1):(0);
 #endif
 
-  p_pattern= m_patternTab[filtNo];
-  
 #if MTK_NONCROSS_INLOOP_FILTER
   if(bResetBlockMatrix)
   {
@@ -2177,105 +2211,332 @@ Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDe
   }
 #endif
 
-  {
-#if MTK_NONCROSS_INLOOP_FILTER
-    for (i= ypos; i< ypos + iheight; i++)
-    {
-      for (j= xpos; j< xpos + iwidth; j++)
+  // accumulate in 64-bit integers on the LCU rows, one set of sums per thread
+#if !MTK_NONCROSS_INLOOP_FILTER
+  Int ypos = 0, xpos = 0, iheight = m_im_height, iwidth = m_im_width;
+#endif
+  m_pCorrOrg        = ImgOrg;
+  m_pRowDec         = ImgDec;
+  m_iRowStride      = Stride;
+  m_iCorrTap        = tap;
+  m_iCorrCountValid = count_valid;
+  m_iCorrYPos       = ypos;
+  m_iCorrXPos       = xpos;
+  m_iCorrHeight     = iheight;
+  m_iCorrWidth      = iwidth;
+  ::memset(m_piCorrAcc, 0, sizeof(Int64)*m_iCorrNumThreads*NO_VAR_BINS*ALF_CORR_ACC_SIZE);
+  
+  xRunRows( ROW_JOB_CORRELATION );
+  
+  // the sums are integers below 2^53, so adding them up in double precision gives the same result in any order
+  for (Int t=0; t<m_iCorrNumThreads; t++)
+  {
+    for (varInd=0; varInd<NO_VAR_BINS; varInd++)
+    {
+      Int64* piAcc = m_piCorrAcc + (t*NO_VAR_BINS + varInd)*ALF_CORR_ACC_SIZE;
+      Int64* piy   = piAcc + MAX_SQR_FILT_LENGTH*MAX_SQR_FILT_LENGTH;
+      E  = m_EGlobalSym[filtNo][varInd];
+      yy = m_yGlobalSym[filtNo][varInd];
+      
+      for (k=0; k<sqrFiltLength; k++)
       {
-#else
-    for (i=0; i<m_im_height; i++)
+        for (l=k; l<sqrFiltLength; l++)
+          E[k][l]+=(double)piAcc[k*MAX_SQR_FILT_LENGTH + l];
+        yy[k]+=(double)piy[k];
+      }
+      m_pixAcc[varInd]+=(double)piy[MAX_SQR_FILT_LENGTH];
+    }
+  }
+
+#if MTK_NONCROSS_INLOOP_FILTER
+  if(bSymmCopyBlockMatrix)
+  {
+#endif
+
+  // Matrix EGlobalSeq is symmetric, only part of it is calculated
+  for (varInd=0; varInd<NO_VAR_BINS; varInd++)
+  {
+    double **pE = m_EGlobalSym[filtNo][varInd];
+    for (k=1; k<sqrFiltLength; k++)
     {
-      for (j=0; j<m_im_width; j++)
+      for (l=0; l<k; l++)
       {
+        pE[k][l]=pE[l][k];
+      }
+    }
+  }
+#if MTK_NONCROSS_INLOOP_FILTER
+  }
 #endif
-#if MQT_ALF_NPASS
-#if MQT_BA_RA
-        if (m_maskImg[i][j] != regionOfInterested && count_valid > 0)
-        {
 
-        }
-        else
-        {
+}
 
-#else
-        Int condition = (m_maskImg[i][j] == 1);
-        if (m_iDesignCurrentFilter)
-        {
-          condition = (m_maskImg[i][j] == 0 && count_valid > 0);
-        }
-        if(!condition)
-        {
+/** Accumulate the correlations of one block of the luma picture set up by xstoreInBlockMatrix().
+ * \param ypos, xpos top-left sample of the block
+ * \param iheight, iwidth size of the block
+ * \param piAcc integer statistics of the calling thread, ALF_CORR_ACC_SIZE per class
+ * \param piPart 32-bit partial sums of the calling thread, all zero on entry and on return
+ */
+Void TEncAdaptiveLoopFilter::xStoreCorrBlock(Int ypos, Int xpos, Int iheight, Int iwidth, Int64* piAcc, Int* piPart)
+{
+#if MQT_BA_RA
+  Int var_step_size_w = VAR_SIZE_W;
+  Int var_step_size_h = VAR_SIZE_H;
 #endif
 
+  Int i,j,k,l,varInd,ii,jj;
+  Int tap = m_iCorrTap;
+  Int fl =tap/2;
+#if TI_ALF_MAX_VSIZE_7
+  Int flV = TComAdaptiveLoopFilter::ALFFlHToFlV(fl);
+  Int sqrFiltLength = TComAdaptiveLoopFilter::ALFTapHToNumCoeff(tap);
 #else
-        if (m_maskImg[i][j] == 0 && count_valid > 0)
-        {
+  Int sqrFiltLength=(((tap*tap)/4 + 1) + 1);
+#endif
+  Int ELocal[MAX_SQR_FILT_LENGTH];
+  Int yLocal;
+  Int *p_pattern;
+  Int filtNo =2; 
+  Int count_valid = m_iCorrCountValid;
+  imgpel* ImgOrg = m_pCorrOrg;
+  imgpel* ImgDec = m_pRowDec;
+  Int Stride = m_iRowStride;
+  if (tap==9)
+    filtNo =0;
+  else if (tap==7)
+    filtNo =1;
+  
+#if MQT_ALF_NPASS && MQT_BA_RA
+  imgpel regionOfInterested = (m_iDesignCurrentFilter ==1)?(1):(0);
+#endif
 
-        }
-        else
-        {
+  p_pattern= m_patternTab[filtNo];
+  
+  // a product is below 2^(18+2*g_uiBitIncrement), the 32-bit sums of each class are flushed before they can overflow
+  Int aiNumPart[NO_VAR_BINS];
+  Int iMaxNumPart = 1 << max<Int>(0, 12 - 2*(Int)g_uiBitIncrement);
+  ::memset(aiNumPart, 0, sizeof(aiNumPart));
+  
+  for (i= ypos; i< ypos + iheight; i++)
+  {
+    for (j= xpos; j< xpos + iwidth; j++)
+    {
+#if MQT_ALF_NPASS
+#if MQT_BA_RA
+      if (m_maskImg[i][j] != regionOfInterested && count_valid > 0)
+      {
+        continue;
+      }
+#else
+      Int condition = (m_maskImg[i][j] == 1);
+      if (m_iDesignCurrentFilter)
+      {
+        condition = (m_maskImg[i][j] == 0 && count_valid > 0);
+      }
+      if(condition)
+      {
+        continue;
+      }
+#endif
+#else
+      if (m_maskImg[i][j] == 0 && count_valid > 0)
+      {
+        continue;
+      }
 #endif
 #if MQT_BA_RA
-          varInd = m_varImg[i/var_step_size_h][j/var_step_size_w];
+      varInd = m_varImg[i/var_step_size_h][j/var_step_size_w];
 #else
-          varInd=min(m_varImg[i][j], NO_VAR_BINS-1);
+      varInd=min(m_varImg[i][j], NO_VAR_BINS-1);
 #endif
-          k=0; 
-          memset(ELocal, 0, sqrFiltLength*sizeof(int));
+      k=0; 
+      memset(ELocal, 0, sqrFiltLength*sizeof(int));
 #if TI_ALF_MAX_VSIZE_7
-          for (ii = -flV; ii < 0; ii++)
+      for (ii = -flV; ii < 0; ii++)
 #else
-          for (ii=-fl; ii<0; ii++)
+      for (ii=-fl; ii<0; ii++)
 #endif
-          {
-            for (jj=-fl-ii; jj<=fl+ii; jj++)
-            {  
-              ELocal[p_pattern[k++]]+=(ImgDec[(i+ii)*Stride + (j+jj)]+ImgDec[(i-ii)*Stride + (j-jj)]);
-            }
-          }
-          for (jj=-fl; jj<0; jj++)
-            ELocal[p_pattern[k++]]+=(ImgDec[(i)*Stride + (j+jj)]+ImgDec[(i)*Stride + (j-jj)]);
-          ELocal[p_pattern[k++]]+=ImgDec[(i)*Stride + (j)];
-          ELocal[sqrFiltLength-1]=1;
-          yLocal=ImgOrg[(i)*Stride + (j)];
+      {
+        for (jj=-fl-ii; jj<=fl+ii; jj++)
+        {  
+          ELocal[p_pattern[k++]]+=(ImgDec[(i+ii)*Stride + (j+jj)]+ImgDec[(i-ii)*Stride + (j-jj)]);
+        }
+      }
+      for (jj=-fl; jj<0; jj++)
+        ELocal[p_pattern[k++]]+=(ImgDec[(i)*Stride + (j+jj)]+ImgDec[(i)*Stride + (j-jj)]);
+      ELocal[p_pattern[k++]]+=ImgDec[(i)*Stride + (j)];
+      ELocal[sqrFiltLength-1]=1;
+      yLocal=ImgOrg[(i)*Stride + (j)];
 
-          m_pixAcc[varInd]+=(yLocal*yLocal);
-          E= m_EGlobalSym[filtNo][varInd];
-          yy= m_yGlobalSym[filtNo][varInd];
+      Int* pE = piPart + varInd*ALF_CORR_ACC_SIZE;
+      Int* py = pE + MAX_SQR_FILT_LENGTH*MAX_SQR_FILT_LENGTH;
+      py[MAX_SQR_FILT_LENGTH] += yLocal*yLocal;
 
-          for (k=0; k<sqrFiltLength; k++)
-          {
-            for (l=k; l<sqrFiltLength; l++)
-              E[k][l]+=(double)(ELocal[k]*ELocal[l]);
-            yy[k]+=(double)(ELocal[k]*yLocal);
-          }
-        }
+      for (k=0; k<sqrFiltLength; k++)
+      {
+        Int* pEk = pE + k*MAX_SQR_FILT_LENGTH;
+        Int  iE  = ELocal[k];
+        for (l=k; l<sqrFiltLength; l++)
+          pEk[l] += iE*ELocal[l];
+        py[k] += iE*yLocal;
+      }
+      
+      if (++aiNumPart[varInd] == iMaxNumPart)
+      {
+        xFlushCorrPart(piAcc + varInd*ALF_CORR_ACC_SIZE, pE, sqrFiltLength);
+        aiNumPart[varInd] = 0;
       }
     }
   }
+  
+  for (varInd=0; varInd<NO_VAR_BINS; varInd++)
+  {
+    if (aiNumPart[varInd])
+    {
+      xFlushCorrPart(piAcc + varInd*ALF_CORR_ACC_SIZE, piPart + varInd*ALF_CORR_ACC_SIZE, sqrFiltLength);
+    }
+  }
+}
 
-#if MTK_NONCROSS_INLOOP_FILTER
-  if(bSymmCopyBlockMatrix)
+/** Add 32-bit partial correlations of one class to the 64-bit ones and clear them.
+ * \param piAcc 64-bit statistics of the class
+ * \param piPart 32-bit partial sums of the class
+ * \param sqrFiltLength number of filter coefficients including the DC offset
+ */
+Void TEncAdaptiveLoopFilter::xFlushCorrPart(Int64* piAcc, Int* piPart, Int sqrFiltLength)
+{
+  for (Int k=0; k<sqrFiltLength; k++)
   {
+    Int64* piAcck  = piAcc  + k*MAX_SQR_FILT_LENGTH;
+    Int*   piPartk = piPart + k*MAX_SQR_FILT_LENGTH;
+    for (Int l=k; l<sqrFiltLength; l++)
+    {
+      piAcck[l] += piPartk[l];
+      piPartk[l] = 0;
+    }
+  }
+  Int64* piy     = piAcc  + MAX_SQR_FILT_LENGTH*MAX_SQR_FILT_LENGTH;
+  Int*   piyPart = piPart + MAX_SQR_FILT_LENGTH*MAX_SQR_FILT_LENGTH;
+  for (Int k=0; k<=MAX_SQR_FILT_LENGTH; k++)
+  {
+    piy[k]    += piyPart[k];
+    piyPart[k] = 0;
+  }
+}
+
+/** Accumulate the luma correlations of the LCU rows handed out by m_cRows.
+ * \param iThreadIdx index of the thread, selects its accumulators in m_piCorrAcc
+ */
+Void TEncAdaptiveLoopFilter::runTask( Int iThreadIdx )
+{
+  if ( m_eRowJob != ROW_JOB_CORRELATION )
+  {
+    TComAdaptiveLoopFilter::runTask( iThreadIdx );
+    return;
+  }
+  
+  Int64* piAcc  = m_piCorrAcc  + iThreadIdx*NO_VAR_BINS*ALF_CORR_ACC_SIZE;
+  Int*   piPart = m_piCorrPart + iThreadIdx*NO_VAR_BINS*ALF_CORR_ACC_SIZE;
+  Int    iRow;
+  while ( ( iRow = m_cRows.claimRow() ) >= 0 )
+  {
+    Int iPelY = iRow * m_uiLCUHeight;
+#if MTK_NONCROSS_INLOOP_FILTER
+    if ( m_pcRowSlice )
+    {
+      for ( UInt i = 0; i < m_pcRowSlice->getNumLCUs(); i++ )
+      {
+        CAlfCU* pcAlfCU = &( (*m_pcRowSlice)[i] );
+        if ( pcAlfCU->getCU()->getCUPelY() == iPelY )
+        {
+          xStoreCorrBlock( iPelY, pcAlfCU->getCU()->getCUPelX(), pcAlfCU->getHeight(), pcAlfCU->getWidth(), piAcc, piPart );
+        }
+      }
+      continue;
+    }
 #endif
+    Int iStartY = max<Int>( iPelY, m_iCorrYPos );
+    Int iEndY   = min<Int>( iPelY + m_uiLCUHeight, m_iCorrYPos + m_iCorrHeight );
+    if ( iStartY < iEndY )
+    {
+      xStoreCorrBlock( iStartY, m_iCorrXPos, iEndY - iStartY, m_iCorrWidth, piAcc, piPart );
+    }
+  }
+}
 
-  // Matrix EGlobalSeq is symmetric, only part of it is calculated
-  for (varInd=0; varInd<NO_VAR_BINS; varInd++)
+/** Store the luma correlations of the picture for a tap x tap filter in m_EGlobalSym, m_yGlobalSym and m_pixAcc.
+ * The last correlations are kept and reused as long as the pictures, the classes and the mask do not change, those of
+ * the largest filter also serve the smaller ones.
+ */
+Void TEncAdaptiveLoopFilter::xStoreCorrelation(imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride)
+{
+  Int filtNo = (tap==9) ? 0 : ((tap==7) ? 1 : 2);
+#if TI_ALF_MAX_VSIZE_7
+  Int sqrFiltLength = TComAdaptiveLoopFilter::ALFTapHToNumCoeff(tap);
+#else
+  Int sqrFiltLength = tap*tap/4 + 2;
+#endif
+  
+  Bool bCached = ( m_iCorrCacheTap == tap
+#if MQT_ALF_NPASS
+                || m_iCorrCacheTap == ALF_MAX_NUM_TAP
+#endif
+                 );
+  bCached = bCached && m_pCorrCacheOrg == ImgOrg && m_pCorrCacheDec == ImgDec && m_varImgCache == m_varImg;
+#if MQT_ALF_NPASS
+  bCached = bCached && m_iCorrCacheDesign == m_iDesignCurrentFilter;
+#endif
+  bCached = bCached && ::memcmp( m_maskImgCache[0], m_maskImg[0], sizeof(imgpel)*m_im_height*m_im_width ) == 0;
+  
+  if ( bCached )
   {
-    double **pE = m_EGlobalSym[filtNo][varInd];
-    for (k=1; k<sqrFiltLength; k++)
+    if ( m_iCorrCacheTap == tap )
     {
-      for (l=0; l<k; l++)
+      for (Int varInd=0; varInd<NO_VAR_BINS; varInd++)
       {
-        pE[k][l]=pE[l][k];
+        for (Int k=0; k<sqrFiltLength; k++)
+        {
+          ::memcpy( m_EGlobalSym[filtNo][varInd][k], m_ECache[varInd][k], sizeof(double)*sqrFiltLength );
+        }
+        ::memcpy( m_yGlobalSym[filtNo][varInd], m_yCache[varInd], sizeof(double)*sqrFiltLength );
       }
     }
+#if MQT_ALF_NPASS
+    else
+    {
+      xretriveBlockMatrix( sqrFiltLength, m_iTapPosTabIn9x9Sym[filtNo], m_ECache, m_EGlobalSym[filtNo], m_yCache, m_yGlobalSym[filtNo] );
+    }
+#endif
+    ::memcpy( m_pixAcc, m_pixAccCache, sizeof(double)*NO_VAR_BINS );
+    return;
   }
+  
 #if MTK_NONCROSS_INLOOP_FILTER
-  }
+  if(!m_bUseNonCrossALF)
+    xstoreInBlockMatrix(0, 0, m_im_height, m_im_width, true, true, ImgOrg, ImgDec, tap, Stride);
+  else
+    xstoreInBlockMatrixforSlices(ImgOrg, ImgDec, tap, Stride);
+#else
+  xstoreInBlockMatrix(ImgOrg, ImgDec, tap, Stride);
 #endif
-
+  
+  m_iCorrCacheTap    = tap;
+  m_pCorrCacheOrg    = ImgOrg;
+  m_pCorrCacheDec    = ImgDec;
+  m_varImgCache      = m_varImg;
+#if MQT_ALF_NPASS
+  m_iCorrCacheDesign = m_iDesignCurrentFilter;
+#endif
+  ::memcpy( m_maskImgCache[0], m_maskImg[0], sizeof(imgpel)*m_im_height*m_im_width );
+  for (Int varInd=0; varInd<NO_VAR_BINS; varInd++)
+  {
+    for (Int k=0; k<sqrFiltLength; k++)
+    {
+      ::memcpy( m_ECache[varInd][k], m_EGlobalSym[filtNo][varInd][k], sizeof(double)*sqrFiltLength );
+    }
+    ::memcpy( m_yCache[varInd], m_yGlobalSym[filtNo][varInd], sizeof(double)*sqrFiltLength );
+  }
+  ::memcpy( m_pixAccCache, m_pixAcc, sizeof(double)*NO_VAR_BINS );
 }
 
 Void   TEncAdaptiveLoopFilter::xFilteringFrameLuma_qc(imgpel* ImgOrg, imgpel* imgY_pad, imgpel* ImgFilt, ALFParam* ALFp, Int tap, Int Stride)
@@ -2343,6 +2604,19 @@ Void TEncAdaptiveLoopFilter::xfilterFrame_en(imgpel* ImgDec, imgpel* ImgRest,int
 #endif
   sqrFiltLength=MAX_SQR_FILT_LENGTH;  fl=FILTER_LENGTH/2;
   
+#if MQT_BA_RA && MTK_NONCROSS_INLOOP_FILTER
+  if ( m_fpFilter && ( xpos % var_step_size_w ) == 0 && ( iwidth % var_step_size_w ) == 0 )
+  {
+    ALFFilterKernel cKernel;
+    xInitLumaKernel( &cKernel, filtNo, Stride );
+    if ( cKernel.bValid )
+    {
+      m_fpFilter( (Pel*)ImgDec + ypos*Stride + xpos, Stride, (Pel*)ImgRest + ypos*Stride + xpos, Stride, iwidth, iheight, &cKernel, m_varImg, xpos, ypos );
+      return;
+    }
+  }
+#endif
+  
 #if MTK_NONCROSS_INLOOP_FILTER
   for (y= ypos, i = fl+ ypos; i < ypos+ iheight+ fl; i++, y++)
   {
@@ -3013,6 +3287,20 @@ Void TEncAdaptiveLoopFilter::xFilterTapDecision_qc(TComPicYuv* pcPicOrg, TComPic
   {
     xCopyTmpAlfCtrlFlagsFrom();
   }
+#if MQT_ALF_NPASS
+  else
+  {
+    // all tap lengths then use the whole picture, the correlations of the largest filter serve the smaller ones
+    for (Int i=0; i<m_im_height; i++)
+    {
+      for (Int j=0; j<m_im_width; j++)
+      {
+        m_maskImg[i][j] = 1;
+      }
+    }
+    xStoreCorrelation((imgpel*)pcPicOrg->getLumaAddr(), (imgpel*)pcPicDec->getLumaAddr(), ALF_MAX_NUM_TAP, pcPicOrg->getStride());
+  }
+#endif
   
   Bool bChanged = false;
   for (Int iTap = ALF_MIN_NUM_TAP; iTap <= ALF_MAX_NUM_TAP; iTap += 2)
@@ -4603,29 +4891,15 @@ Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrixforOneSlice(CAlfSlice* pSlice,
                                                               Bool bLastSlice
                                                               )
 {
-
-
-  UInt uiNumLCUs = pSlice->getNumLCUs();
-
-  Int iHeight, iWidth;
-  Int ypos, xpos;
-  Bool bFirstLCU, bLastLCU;
-
-  for(UInt i=0; i< uiNumLCUs; i++)
+  if(pSlice->getNumLCUs() == 0)
   {
-    bFirstLCU = (i==0);
-    bLastLCU  = (i== uiNumLCUs -1);
-
-    CAlfCU* pcAlfCU = &((*pSlice)[i]);
-    ypos    = pcAlfCU->getCU()->getCUPelY();
-    xpos    = pcAlfCU->getCU()->getCUPelX();
-    iHeight = pcAlfCU->getHeight();
-    iWidth  = pcAlfCU->getWidth();
-
-    xstoreInBlockMatrix(ypos, xpos, iHeight, iWidth, 
-      (bFirstSlice && bFirstLCU),(bLastSlice && bLastLCU),
-      ImgOrg, ImgDec,tap, iStride);
+    return;
   }
+
+  // the LCU rows only take the LCUs of pSlice
+  m_pcRowSlice = pSlice;
+  xstoreInBlockMatrix(0, 0, m_im_height, m_im_width, bFirstSlice, bLastSlice, ImgOrg, ImgDec, tap, iStride);
+  m_pcRowSlice = NULL;
 }
 
 
@@ -5394,8 +5668,9 @@ Void TEncSampleAdaptiveOffset::xGetQAOStats(TComPicYuv* pcPicYuvOrg, TComPicYuv*
 
 /** Sample adaptive offset Process
  * \param dLambda
+ * \param pcThreadPool threads sharing the LCU rows when the offsets are applied, NULL to run on the calling thread
  */
-Void TEncSampleAdaptiveOffset::SAOProcess( Double dLambda)
+Void TEncSampleAdaptiveOffset::SAOProcess( Double dLambda, TComThreadPool* pcThreadPool )
 {
   // set lambda
   TComPicYuv* pcPicYuvOrg = m_pcPic->getPicYuvOrg();
@@ -5427,7 +5702,9 @@ Void TEncSampleAdaptiveOffset::SAOProcess( Double dLambda)
 
   if(m_bSaoFlag)
   {
-    xProcessQuadTreeAo( 0, pcPicYuvRec,  pcPicYuvExt);
+    m_pcThreadPool = pcThreadPool;
+    xRunRows();
+    m_pcThreadPool = NULL;
   }
 
 }
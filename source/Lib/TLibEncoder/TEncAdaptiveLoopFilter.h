@@ -75,7 +75,7 @@ private:
 public:
   Void startSaoEnc( TComPic* pcPic, TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder);
   Void endSaoEnc();
-  Void SAOProcess(Double dLambda);
+  Void SAOProcess(Double dLambda, TComThreadPool* pcThreadPool = NULL);
   Void xQuadTreeDecisionFunc(Int iPartIdx, TComPicYuv* pcPicOrg, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, Double &dCostFinal);
   Void xQAOOnePart(SAOQTPart* pQAOOnePart, Int iPartIdx);
   Void xPartTreeDisable(Int iPartIdx);
@@ -171,6 +171,29 @@ private:
   TComPicYuv* m_pcSliceYuvTmp;
 #endif
 
+  // luma correlations accumulated on the LCU rows by runTask()
+  Int64*    m_piCorrAcc;                  ///< integer statistics of each thread, ALF_CORR_ACC_SIZE per class
+  Int*      m_piCorrPart;                 ///< 32-bit partial sums of each thread, added to m_piCorrAcc before they can overflow
+  Int       m_iCorrNumThreads;
+  imgpel*   m_pCorrOrg;
+  Int       m_iCorrTap;
+  Int       m_iCorrCountValid;            ///< number of samples in the region of interest of the mask
+  Int       m_iCorrYPos;
+  Int       m_iCorrXPos;
+  Int       m_iCorrHeight;
+  Int       m_iCorrWidth;
+
+  // luma correlations of the last xStoreCorrelation(), reused while the inputs do not change
+  Int       m_iCorrCacheTap;              ///< 0 if nothing is cached
+  imgpel*   m_pCorrCacheOrg;
+  imgpel*   m_pCorrCacheDec;
+  imgpel**  m_varImgCache;
+  Int       m_iCorrCacheDesign;
+  imgpel**  m_maskImgCache;
+  double*** m_ECache;
+  double**  m_yCache;
+  double*   m_pixAccCache;
+
 private:
   // init / uninit internal variables
   Void xInitParam      ();
@@ -247,6 +270,10 @@ private:
 #endif
 
 
+  Void xStoreCorrelation   (imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride);
+  Void xStoreCorrBlock     (Int ypos, Int xpos, Int iheight, Int iwidth, Int64* piAcc, Int* piPart);
+  Void xFlushCorrPart      (Int64* piAcc, Int* piPart, Int sqrFiltLength);
+
 #if MTK_NONCROSS_INLOOP_FILTER
   Void xstoreInBlockMatrixforSlices  (imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int iStride);
   Void xstoreInBlockMatrixforOneSlice(CAlfSlice* pSlice, imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int iStride, Bool bFirstSlice, Bool bLastSlice);
@@ -275,7 +302,10 @@ public:
   Void endALFEnc();
   
   /// estimate ALF parameters
-  Void ALFProcess(ALFParam* pcAlfParam, Double dLambda, UInt64& ruiDist, UInt64& ruiBits, UInt& ruiMaxAlfCtrlDepth );
+  Void ALFProcess(ALFParam* pcAlfParam, Double dLambda, UInt64& ruiDist, UInt64& ruiBits, UInt& ruiMaxAlfCtrlDepth, TComThreadPool* pcThreadPool = NULL );
+  
+  /// accumulate the correlations of the LCU rows handed out by m_cRows, other row jobs are left to TComAdaptiveLoopFilter
+  Void runTask   ( Int iThreadIdx );
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
   Void PCMLFDisableProcess (TComPic* pcPic);
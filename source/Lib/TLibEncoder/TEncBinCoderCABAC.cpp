@@ -37,10 +37,15 @@
 
 #include "TEncBinCoderCABAC.h"
 
+extern Int entropyBits[128];
+
 
 TEncBinCABAC::TEncBinCABAC()
 : m_pcTComBitIf( 0 )
 , m_bBinCountingEnabled(0)
+, m_uiFracBits( 0 )
+, m_pcBinStore( NULL )
+, m_pcBinStoreCtxBase( NULL )
 {
 }
 
@@ -68,6 +73,7 @@ TEncBinCABAC::start()
   m_uiBitsToFollow  = 0;
   m_uiByte          = 0;
   m_uiBitsLeft      = 9;
+  m_uiFracBits      = 0;
 }
 
 Void
@@ -88,6 +94,10 @@ TEncBinCABAC::finish()
  */
 Void TEncBinCABAC::resetBac()
 {
+  if( m_pcBinStore )
+  {
+    m_pcBinStore->push_back( BIN_STORE_RESET_BAC );
+  }
   m_uiLow           = 0;
   m_uiRange         = 510;
   m_uiBitsToFollow  = 0;
@@ -100,6 +110,10 @@ Void TEncBinCABAC::resetBac()
  */
 Void TEncBinCABAC::encodePCMAlignBits()
 {
+  if( m_pcBinStore )
+  {
+    m_pcBinStore->push_back( BIN_STORE_PCM_ALIGN );
+  }
   xWriteBitAndBitsToFollow( ( m_uiLow >> 9 ) & 1 );
   xWriteBit               ( ( m_uiLow >> 8 ) & 1 );
   xWriteBit               ( 1 ); // stop bit
@@ -120,6 +134,11 @@ Void TEncBinCABAC::encodePCMAlignBits()
  */
 Void  TEncBinCABAC::xWritePCMCode(UInt uiCode, UInt uiLength)
 {
+  if( m_pcBinStore )
+  {
+    m_pcBinStore->push_back( ( uiLength << 4 ) | BIN_STORE_PCM_CODE );
+    m_pcBinStore->push_back( uiCode );
+  }
   m_pcTComBitIf->write  (uiCode, uiLength);
 }
 #endif
@@ -133,6 +152,18 @@ TEncBinCABAC::copyState( TEncBinIf* pcTEncBinIf )
   m_uiBitsToFollow  = pcTEncBinCABAC->m_uiBitsToFollow;
   m_uiByte          = pcTEncBinCABAC->m_uiByte;
   m_uiBitsLeft      = pcTEncBinCABAC->m_uiBitsLeft;
+  m_uiFracBits      = pcTEncBinCABAC->m_uiFracBits;
+}
+
+Void
+TEncBinCABAC::setBinStore( TEncBinStore* pcStore, ContextModel* pcCtxBase )
+{
+  m_pcBinStore        = pcStore;
+  m_pcBinStoreCtxBase = pcCtxBase;
+  if( m_pcBinStore )
+  {
+    m_pcBinStore->clear();
+  }
 }
 
 Void  
@@ -165,6 +196,10 @@ TEncBinCABAC::encodeBin( UInt uiBin, ContextModel &rcCtxModel )
   {
     m_uiBinsCoded++;
   }
+  if( m_pcBinStore )
+  {
+    m_pcBinStore->push_back( ( UInt( &rcCtxModel - m_pcBinStoreCtxBase ) << 4 ) | ( uiBin << 3 ) | BIN_STORE_CTX );
+  }
   UInt  uiLPS   = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) & 3 ];
   m_uiRange    -= uiLPS;
   if( uiBin != rcCtxModel.getMps() )
@@ -211,6 +246,10 @@ TEncBinCABAC::encodeBinEP( UInt uiBin )
   {
     m_uiBinsCoded++;
   }
+  if( m_pcBinStore )
+  {
+    m_pcBinStore->push_back( ( uiBin ? 8 : 0 ) | BIN_STORE_EP );
+  }
   m_uiLow <<= 1;
   if( uiBin )
   {
@@ -239,6 +278,10 @@ TEncBinCABAC::encodeBinTrm( UInt uiBin )
   {
     m_uiBinsCoded++;
   }
+  if( m_pcBinStore )
+  {
+    m_pcBinStore->push_back( ( uiBin ? 8 : 0 ) | BIN_STORE_TRM );
+  }
   m_uiRange -= 2;
   if( uiBin )
   {
@@ -289,3 +332,101 @@ TEncBinCABAC::xWriteBitAndBitsToFollow( UInt uiBit )
     xWriteBit( uiBit );
   }
 }
+
+// ====================================================================================================================
+// TEncBinCABACCounter
+// ====================================================================================================================
+
+TEncBinCABACCounter::TEncBinCABACCounter()
+{
+}
+
+TEncBinCABACCounter::~TEncBinCABACCounter()
+{
+}
+
+Void
+TEncBinCABACCounter::finish()
+{
+  m_uiFracBits += 2 << 15;
+}
+
+#if E057_INTRA_PCM
+/** Count the termination of the arithmetic code before PCM samples, alignment excluded.
+ * \returns Void
+ */
+Void TEncBinCABACCounter::encodePCMAlignBits()
+{
+  m_uiFracBits += 3 << 15;
+}
+
+/** Count a PCM code.
+ * \param uiCode code value
+ * \param uiLength code bit-depth
+ * \returns Void
+ */
+Void TEncBinCABACCounter::xWritePCMCode(UInt uiCode, UInt uiLength)
+{
+  m_uiFracBits += uiLength << 15;
+}
+#endif
+
+Void
+TEncBinCABACCounter::resetBits()
+{
+  m_uiFracBits &= 32767;
+}
+
+UInt
+TEncBinCABACCounter::getNumWrittenBits()
+{
+  return UInt( m_uiFracBits >> 15 );
+}
+
+/** Add the entropy of a bin for the current state of its context, and update the context.
+ * \param uiBin bin value
+ * \param rcCtxModel context model of the bin
+ * \returns Void
+ */
+Void
+TEncBinCABACCounter::encodeBin( UInt uiBin, ContextModel &rcCtxModel )
+{
+  if (m_bBinCountingEnabled) 
+  {
+    m_uiBinsCoded++;
+  }
+  if( uiBin != rcCtxModel.getMps() )
+  {
+    m_uiFracBits += entropyBits[ 64 + rcCtxModel.getState() ];
+    rcCtxModel.updateLPS();
+  }
+  else
+  {
+    m_uiFracBits += entropyBits[ 63 - rcCtxModel.getState() ];
+    rcCtxModel.updateMPS();
+  }
+}
+
+Void
+TEncBinCABACCounter::encodeBinEP( UInt uiBin )
+{
+  if (m_bBinCountingEnabled)
+  {
+    m_uiBinsCoded++;
+  }
+  m_uiFracBits += 32768;
+}
+
+/** Add the entropy of a terminating bin, whose probability is that of the most probable state.
+ * \param uiBin bin value
+ * \returns Void
+ */
+Void
+TEncBinCABACCounter::encodeBinTrm( UInt uiBin )
+{
+  if (m_bBinCountingEnabled)
+  {
+    m_uiBinsCoded++;
+  }
+  m_uiFracBits += entropyBits[ uiBin ? 127 : 0 ];
+}
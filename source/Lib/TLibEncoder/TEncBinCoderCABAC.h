@@ -38,9 +38,23 @@
 #ifndef __TENC_BIN_CODER_CABAC__
 #define __TENC_BIN_CODER_CABAC__
 
+#include <vector>
 #include "../TLibCommon/TComCABACTables.h"
 #include "TEncBinCoder.h"
 
+/// bins of one LCU recorded by TEncBinCABAC, replayed by TEncSbac::replayBins()
+typedef std::vector<UInt> TEncBinStore;
+
+/// kind of a TEncBinStore entry, in its three low bits
+enum BinStoreKind
+{
+  BIN_STORE_CTX       = 0,  ///< context-coded bin: bin value in bit 3, context index in the coder from bit 4
+  BIN_STORE_EP        = 1,  ///< bypass bin, value in bit 3
+  BIN_STORE_TRM       = 2,  ///< terminating bin, value in bit 3
+  BIN_STORE_PCM_CODE  = 3,  ///< PCM code: length from bit 4, code in the next entry
+  BIN_STORE_PCM_ALIGN = 4,  ///< alignment before PCM samples
+  BIN_STORE_RESET_BAC = 5   ///< arithmetic coder reset after PCM samples
+};
 
 class TEncBinCABAC : public TEncBinIf
 {
@@ -74,11 +88,13 @@ public:
   UInt  getBinsCoded              ()              { return m_uiBinsCoded;           }
   Void  setBinCountingEnableFlag  ( Bool bFlag )  { m_bBinCountingEnabled = bFlag;  }
   Bool  getBinCountingEnableFlag  ()              { return m_bBinCountingEnabled;   }
+  
+  /// record the coded bins in pcStore (cleared first), with context indices relative to pcCtxBase; NULL stops recording
+  Void  setBinStore               ( TEncBinStore* pcStore, ContextModel* pcCtxBase );
 protected:
   Void  xWriteBit               ( UInt uiBit );
   Void  xWriteBitAndBitsToFollow( UInt uiBit );
   
-private:
   TComBitIf*          m_pcTComBitIf;
   UInt                m_uiLow;
   UInt                m_uiRange;
@@ -87,6 +103,31 @@ private:
   UInt                m_uiBitsLeft;
   UInt                m_uiBinsCoded;
   Bool                m_bBinCountingEnabled;
+  UInt64              m_uiFracBits;             ///< estimated bits of TEncBinCABACCounter, in 1/32768 bit
+  TEncBinStore*       m_pcBinStore;             ///< bins being recorded, NULL if not recording
+  ContextModel*       m_pcBinStoreCtxBase;      ///< first context model of the coder using this bin coder
+};
+
+/// bin coder of the RD search: adds up the estimated bits of the bins instead of encoding them
+class TEncBinCABACCounter : public TEncBinCABAC
+{
+public:
+  TEncBinCABACCounter ();
+  virtual ~TEncBinCABACCounter();
+  
+  Void  finish            ();
+  
+#if E057_INTRA_PCM
+  Void  encodePCMAlignBits();
+  Void  xWritePCMCode     (UInt uiCode, UInt uiLength);
+#endif
+
+  Void  resetBits         ();
+  UInt  getNumWrittenBits ();
+  
+  Void  encodeBin         ( UInt  uiBin,  ContextModel& rcCtxModel );
+  Void  encodeBinEP       ( UInt  uiBin                            );
+  Void  encodeBinTrm      ( UInt  uiBin                            );
 };
 
 
@@ -261,6 +261,14 @@ Void TEncCavlc::codeSPS( TComSPS* pcSPS )
   // Structure
   xWriteUvlc  ( pcSPS->getNominalWidth () );
   xWriteUvlc  ( pcSPS->getNominalHeight() );
+#if JCT_ARC
+  xWriteUvlc  ( pcSPS->getNumPicResolutions() - 1 );
+  for ( UInt i = 1; i < pcSPS->getNumPicResolutions(); i++ )
+  {
+    xWriteUvlc( pcSPS->getPictureWidth (i) );
+    xWriteUvlc( pcSPS->getPictureHeight(i) );
+  }
+#endif
   
   xWriteUvlc  ( pcSPS->getPad (0) );
   xWriteUvlc  ( pcSPS->getPad (1) );
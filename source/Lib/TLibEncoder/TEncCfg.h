@@ -67,6 +67,11 @@ protected:
 #endif
   UInt      m_uiResSwitchFrameNum;
   UInt      m_uiResSwitchType;
+  UInt      m_uiResSwitchLevel;                 ///< ladder rung used as the low resolution of the switch
+  Int       m_iResSwitchMaxBitrate;             ///< bitrate cap (bits per second) of the rate-driven switching, 0: off
+  Int       m_iNumPicResolutions;               ///< number of rungs of the resolution ladder
+  Int       m_aiPicResolutionNum[NUM_PIC_RESOLUTIONS];  ///< scaling ratio numerator of each rung
+  Int       m_aiPicResolutionDen[NUM_PIC_RESOLUTIONS];  ///< scaling ratio denominator of each rung
   Int       m_iGOPSize;
   Int       m_iRateGOPSize;
   Int       m_iNumOfReference;
@@ -134,6 +139,8 @@ protected:
   Bool      m_bUseNRF;
   Bool      m_bUseBQP;
   Bool      m_bUseFastEnc;
+  Int       m_iEarlyTerm;                       ///< early termination of the CU decisions in inter slices, 0: off, 1, 2: faster
+  Bool      m_bUseFastIntra;                    ///< hierarchical search of the luma intra modes, fewer RD checks
   Bool      m_bUseMRG; // SOPH:
 #if LM_CHROMA 
   Bool      m_bUseLMChroma; 
@@ -160,6 +167,12 @@ protected:
   //====== Entropy Slice ========
   Int       m_iEntropySliceMode;
   Int       m_iEntropySliceArgument;
+  //====== Wavefront ========
+  Int       m_iWaveFrontThreads;                ///< threads compressing LCU rows in wavefront order, 0: off
+  Int       m_iFrameThreads;                    ///< threads compressing independent pictures of a GOP at the same time, 0: off
+  Int       m_iSIMDLevel;                       ///< instruction set of the distortion, interpolation and transform kernels, -1: best supported
+  Bool      m_bUseSubPelCache;                  ///< interpolate the quarter-pel planes of reference pictures for fractional ME
+  Bool      m_bCacheBins;                       ///< write the LCU bins recorded during compression instead of coding the CUs again
 #if MTK_NONCROSS_INLOOP_FILTER
   Bool      m_bLFCrossSliceBoundaryFlag;
 #endif
@@ -173,6 +186,12 @@ protected:
 #endif
   bool m_pictureDigestEnabled; ///< enable(1)/disable(0) md5 computation and SEI signalling
 
+  Int       xScalePicSize ( Int iSize, Int i )
+  {
+    Int iScaled = ( iSize * m_aiPicResolutionNum[i] + ( m_aiPicResolutionDen[i] >> 1 ) ) / m_aiPicResolutionDen[i];
+    return std::max<Int>( ARC_PIC_SIZE_ALIGN, ( iScaled + ( ARC_PIC_SIZE_ALIGN >> 1 ) ) / ARC_PIC_SIZE_ALIGN * ARC_PIC_SIZE_ALIGN );
+  }
+
 public:
   TEncCfg()          {}
   virtual ~TEncCfg() {}
@@ -188,6 +207,18 @@ public:
   Void      setResSwitchType                ( UInt  u )      { m_uiResSwitchType = u; }
   UInt      getResSwitchFrameNum            ()               { return m_uiResSwitchFrameNum; }
   UInt      getResSwitchType                ()               { return m_uiResSwitchType; }
+  Void      setResSwitchLevel               ( UInt  u )      { m_uiResSwitchLevel = u; }
+  UInt      getResSwitchLevel               ()               { return m_uiResSwitchLevel; }
+  Void      setResSwitchMaxBitrate          ( Int   i )      { m_iResSwitchMaxBitrate = i; }
+  Int       getResSwitchMaxBitrate          ()               { return m_iResSwitchMaxBitrate; }
+  Void      setNumPicResolutions            ( Int   i )      { assert( i > 0 && i <= NUM_PIC_RESOLUTIONS ); m_iNumPicResolutions = i; }
+  Int       getNumPicResolutions            ()               { return m_iNumPicResolutions; }
+  Void      setPicResolution                ( Int i, Int iNum, Int iDen ) { m_aiPicResolutionNum[i] = iNum; m_aiPicResolutionDen[i] = iDen; }
+  Int       getPicResolutionNum             ( Int i )        { return m_aiPicResolutionNum[i]; }
+  Int       getPicResolutionDen             ( Int i )        { return m_aiPicResolutionDen[i]; }
+  /// picture width of ladder rung i, rounded to a multiple of ARC_PIC_SIZE_ALIGN (rung 0 is the source size)
+  Int       getPicResolutionWidth           ( Int i )        { return i==0 ? m_iSourceWidth  : xScalePicSize( m_iSourceWidth,  i ); }
+  Int       getPicResolutionHeight          ( Int i )        { return i==0 ? m_iSourceHeight : xScalePicSize( m_iSourceHeight, i ); }
   Void      setIntraPeriod                  ( Int   i )      { m_uiIntraPeriod = (UInt)i; }
 #if DCM_DECODING_REFRESH
   Void      setDecodingRefreshType          ( Int   i )      { m_uiDecodingRefreshType = (UInt)i; }
@@ -282,6 +313,7 @@ public:
   //==== Motion search ========
   Int       getFastSearch                   ()      { return  m_iFastSearch; }
   Int       getSearchRange                  ()      { return  m_iSearchRange; }
+  Int       getBipredSearchRange            ()      { return  m_bipredSearchRange; }
   Int       getMaxDeltaQP                   ()      { return  m_iMaxDeltaQP; }
 #if SUB_LCU_DQP
   Int       getMaxCuDQPDepth                ()      { return  m_iMaxCuDQPDepth; }
@@ -303,6 +335,8 @@ public:
   Void      setUseNRF                       ( Bool  b )     { m_bUseNRF     = b; }
   Void      setUseBQP                       ( Bool  b )     { m_bUseBQP     = b; }
   Void      setUseFastEnc                   ( Bool  b )     { m_bUseFastEnc = b; }
+  Void      setEarlyTerm                    ( Int   i )     { m_iEarlyTerm = i; }
+  Void      setUseFastIntra                 ( Bool  b )     { m_bUseFastIntra = b; }
   Void      setUseMRG                       ( Bool  b )     { m_bUseMRG     = b; } // SOPH:
 #if CONSTRAINED_INTRA_PRED
   Void      setUseConstrainedIntraPred      ( Bool  b )     { m_bUseConstrainedIntraPred = b; }
@@ -337,6 +371,8 @@ public:
   Bool      getUseNRF                       ()      { return m_bUseNRF;     }
   Bool      getUseBQP                       ()      { return m_bUseBQP;     }
   Bool      getUseFastEnc                   ()      { return m_bUseFastEnc; }
+  Int       getEarlyTerm                    ()      { return m_iEarlyTerm;  }
+  Bool      getUseFastIntra                 ()      { return m_bUseFastIntra; }
   Bool      getUseMRG                       ()      { return m_bUseMRG;     } // SOPH:
 #if CONSTRAINED_INTRA_PRED
   Bool      getUseConstrainedIntraPred      ()      { return m_bUseConstrainedIntraPred; }
@@ -376,6 +412,17 @@ public:
   Void  setEntropySliceArgument        ( Int  i )      { m_iEntropySliceArgument = i;   }
   Int   getEntropySliceMode            ()              { return m_iEntropySliceMode;    }
   Int   getEntropySliceArgument        ()              { return m_iEntropySliceArgument;}
+  //====== Wavefront ========
+  Void  setWaveFrontThreads            ( Int  i )      { m_iWaveFrontThreads = i;       }
+  Int   getWaveFrontThreads            ()              { return m_iWaveFrontThreads;    }
+  Void  setFrameThreads                ( Int  i )      { m_iFrameThreads = i;           }
+  Int   getFrameThreads                ()              { return m_iFrameThreads;        }
+  Void  setSIMDLevel                   ( Int  i )      { m_iSIMDLevel = i;              }
+  Int   getSIMDLevel                   ()              { return m_iSIMDLevel;           }
+  Void  setUseSubPelCache              ( Bool b )      { m_bUseSubPelCache = b;         }
+  Bool  getUseSubPelCache              ()              { return m_bUseSubPelCache;      }
+  Void  setCacheBins                   ( Bool b )      { m_bCacheBins = b;              }
+  Bool  getCacheBins                   ()              { return m_bCacheBins;           }
 #if MTK_NONCROSS_INLOOP_FILTER
   Void      setLFCrossSliceBoundaryFlag     ( Bool   bValue  )    { m_bLFCrossSliceBoundaryFlag = bValue; }
   Bool      getLFCrossSliceBoundaryFlag     ()                    { return m_bLFCrossSliceBoundaryFlag;   }
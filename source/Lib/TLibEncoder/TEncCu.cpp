@@ -54,6 +54,9 @@ Void TEncCu::create(UChar uhTotalDepth, UInt uiMaxWidth, UInt uiMaxHeight)
   Int i;
   
   m_uhTotalDepth   = uhTotalDepth + 1;
+  ::memset( m_afCost, 0, sizeof( m_afCost ) );
+  ::memset( m_aiNum,  0, sizeof( m_aiNum  ) );
+  
   m_ppcBestCU      = new TComDataCU*[m_uhTotalDepth-1];
   m_ppcTempCU      = new TComDataCU*[m_uhTotalDepth-1];
   
@@ -190,21 +193,37 @@ Void TEncCu::destroy()
  */
 Void TEncCu::init( TEncTop* pcEncTop )
 {
-  m_pcEncCfg           = pcEncTop;
-  m_pcPredSearch       = pcEncTop->getPredSearch();
-  m_pcTrQuant          = pcEncTop->getTrQuant();
-  m_pcBitCounter       = pcEncTop->getBitCounter();
-  m_pcRdCost           = pcEncTop->getRdCost();
+  init( pcEncTop, pcEncTop->getPredSearch(), pcEncTop->getTrQuant(), pcEncTop->getBitCounter(), pcEncTop->getRdCost(),
+        pcEncTop->getEntropyCoder(), pcEncTop->getRDSbacCoder(), pcEncTop->getRDGoOnSbacCoder() );
   
-  m_pcEntropyCoder     = pcEncTop->getEntropyCoder();
   m_pcCavlcCoder       = pcEncTop->getCavlcCoder();
   m_pcSbacCoder       = pcEncTop->getSbacCoder();
   m_pcBinCABAC         = pcEncTop->getBinCABAC();
+}
+
+/** Set the tools used for the analysis.
+ * This lets each wavefront thread run its own CU encoder on a private set of coding tools.
+ */
+Void TEncCu::init( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter,
+                   TComRdCost* pcRdCost, TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder )
+{
+  m_pcEncCfg           = pcEncCfg;
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
+  m_pcBitCounter       = pcBitCounter;
+  m_pcRdCost           = pcRdCost;
+  
+  m_pcEntropyCoder     = pcEntropyCoder;
+  m_pcCavlcCoder       = NULL;
+  m_pcSbacCoder       = NULL;
+  m_pcBinCABAC         = NULL;
   
-  m_pppcRDSbacCoder   = pcEncTop->getRDSbacCoder();
-  m_pcRDGoOnSbacCoder = pcEncTop->getRDGoOnSbacCoder();
+  m_pppcRDSbacCoder   = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder = pcRDGoOnSbacCoder;
   
-  m_bUseSBACRD        = pcEncTop->getUseSBACRD();
+  m_bUseSBACRD        = pcEncCfg->getUseSBACRD();
+  
+  m_cEarlyTerm.init( pcEncCfg->getEarlyTerm() );
 }
 
 // ====================================================================================================================
@@ -215,6 +234,12 @@ Void TEncCu::init( TEncTop* pcEncTop )
  */
 Void TEncCu::compressCU( TComDataCU*& rpcCU )
 {
+  // the early termination statistics are kept per LCU row
+  if ( rpcCU->getAddr() % rpcCU->getPic()->getFrameWidthInCU() == 0 )
+  {
+    m_cEarlyTerm.resetStatistics();
+  }
+  
   // single-QP coding mode
   if ( rpcCU->getSlice()->getSPS()->getUseDQP() == false )
   {
@@ -317,6 +342,15 @@ Void TEncCu::compressCU( TComDataCU*& rpcCU )
 /** \param  pcCU  pointer of CU data class, bForceTerminate when set to true terminates slice (default is false).
  */
 Void TEncCu::encodeCU ( TComDataCU* pcCU, Bool bForceTerminate )
+{
+  encodeCUData( pcCU );
+  encodeCUTerminatingBit( pcCU, bForceTerminate );
+}
+
+/** Encode the syntax of an LCU, without the terminating bit.
+ * \param  pcCU  pointer of CU data class
+ */
+Void TEncCu::encodeCUData ( TComDataCU* pcCU )
 {
 #if SNY_DQP  
   if ( pcCU->getSlice()->getSPS()->getUseDQP() )
@@ -357,7 +391,13 @@ Void TEncCu::encodeCU ( TComDataCU* pcCU, Bool bForceTerminate )
     }
   }
 #endif//SNY_DQP
-  
+}
+
+/** Write the terminating bit after an LCU, and finish the slice after its last LCU.
+ * \param  pcCU  pointer of CU data class, bForceTerminate when set to true terminates slice (default is false).
+ */
+Void TEncCu::encodeCUTerminatingBit ( TComDataCU* pcCU, Bool bForceTerminate )
+{
   //--- write terminating bit ---
   Bool bTerminateSlice = bForceTerminate;
   UInt uiCUAddr = pcCU->getAddr();
@@ -393,13 +433,10 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
   Bool    bTrySplit    = true;
   Double  fRD_Skip    = MAX_DOUBLE;
   
-  static  Double  afCost[ MAX_CU_DEPTH ];
-  static  Int      aiNum [ MAX_CU_DEPTH ];
-  
   if ( rpcBestCU->getAddr() == 0 )
   {
-    ::memset( afCost, 0, sizeof( afCost ) );
-    ::memset( aiNum,  0, sizeof( aiNum  ) );
+    ::memset( m_afCost, 0, sizeof( m_afCost ) );
+    ::memset( m_aiNum,  0, sizeof( m_aiNum  ) );
   }
   
   Bool bBoundary = false;
@@ -431,12 +468,16 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
       if ( m_pcEncCfg->getUseFastEnc() )
       {
         Int iIdx = g_aucConvertToBit[ rpcBestCU->getWidth(0) ];
-        if ( aiNum [ iIdx ] > 5 && fRD_Skip < EARLY_SKIP_THRES*afCost[ iIdx ]/aiNum[ iIdx ] )
+        if ( m_aiNum [ iIdx ] > 5 && fRD_Skip < EARLY_SKIP_THRES*m_afCost[ iIdx ]/m_aiNum[ iIdx ] )
         {
           bEarlySkip = true;
           bTrySplit  = false;
         }
       }
+      if ( m_cEarlyTerm.isEarlySkip( rpcBestCU, uiDepth ) )
+      {
+        bEarlySkip = true;
+      }
 
       // 2Nx2N, NxN
       if ( !bEarlySkip )
@@ -454,7 +495,9 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
       }
       
 #if HHI_RMP_SWITCH
-      if( pcPic->getSlice(0)->getSPS()->getUseRMP() )
+      if( pcPic->getSlice(0)->getSPS()->getUseRMP() && !m_cEarlyTerm.skipRectModes( rpcBestCU ) )
+#else
+      if( !m_cEarlyTerm.skipRectModes( rpcBestCU ) )
 #endif
       { // 2NxN, Nx2N
         xCheckRDCostInter( rpcBestCU, rpcTempCU, SIZE_Nx2N  );  rpcTempCU->initEstData();
@@ -516,10 +559,17 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
       if ( rpcBestCU->isSkipped(0) )
       {
         Int iIdx = g_aucConvertToBit[ rpcBestCU->getWidth(0) ];
-        afCost[ iIdx ] += rpcBestCU->getTotalCost();
-        aiNum [ iIdx ] ++;
+        m_afCost[ iIdx ] += rpcBestCU->getTotalCost();
+        m_aiNum [ iIdx ] ++;
       }
     }
+    
+    // early termination of the split trial
+    m_cEarlyTerm.addUnsplitBest( rpcBestCU, uiDepth );
+    if ( bTrySplit && uiDepth < g_uiMaxCUDepth - g_uiAddCUDepth && m_cEarlyTerm.skipSplit( rpcBestCU, uiDepth ) )
+    {
+      bTrySplit = false;
+    }
   }
   else
   {
@@ -574,7 +624,12 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
     }
     
     xCheckBestMode( rpcBestCU, rpcTempCU );                                          // RD compare current larger prediction
-  }                                                                                  // with sub partitioned prediction.
+                                                                                     // with sub partitioned prediction.
+    if( !bBoundary )
+    {
+      m_cEarlyTerm.addSplitResult( rpcBestCU, uiDepth );
+    }
+  }
   
   rpcBestCU->copyToPic(uiDepth);                                                     // Copy Best data to Picture for next partition prediction.
   
@@ -612,13 +667,10 @@ Void TEncCu::xCompressCUDQP( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UIn
   Double  fRD_Skip    = MAX_DOUBLE;
   Bool    bTrySplitDQP  = true;
 
-  static  Double  afCost[ MAX_CU_DEPTH ];
-  static  Int      aiNum [ MAX_CU_DEPTH ];
-
   if ( rpcBestCU->getAddr() == 0 )
   {
-    ::memset( afCost, 0, sizeof( afCost ) );
-    ::memset( aiNum,  0, sizeof( aiNum  ) );
+    ::memset( m_afCost, 0, sizeof( m_afCost ) );
+    ::memset( m_aiNum,  0, sizeof( m_aiNum  ) );
   }
 
   Bool bBoundary = false;
@@ -676,7 +728,7 @@ Void TEncCu::xCompressCUDQP( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UIn
         if ( m_pcEncCfg->getUseFastEnc() )
         {
           Int iIdx = g_aucConvertToBit[ rpcBestCU->getWidth(0) ];
-          if ( aiNum [ iIdx ] > 5 && fRD_Skip < EARLY_SKIP_THRES*afCost[ iIdx ]/aiNum[ iIdx ] )
+          if ( m_aiNum [ iIdx ] > 5 && fRD_Skip < EARLY_SKIP_THRES*m_afCost[ iIdx ]/m_aiNum[ iIdx ] )
           {
             bEarlySkip = true;
             bTrySplit  = false;
@@ -779,8 +831,8 @@ Void TEncCu::xCompressCUDQP( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UIn
       if ( rpcBestCU->isSkipped(0) )
       {
         Int iIdx = g_aucConvertToBit[ rpcBestCU->getWidth(0) ];
-        afCost[ iIdx ] += rpcBestCU->getTotalCost();
-        aiNum [ iIdx ] ++;
+        m_afCost[ iIdx ] += rpcBestCU->getTotalCost();
+        m_aiNum [ iIdx ] ++;
       }
     }
   }
@@ -48,6 +48,7 @@
 
 #include "TEncEntropy.h"
 #include "TEncSearch.h"
+#include "TEncEarlyTerm.h"
 
 class TEncTop;
 class TEncSbac;
@@ -77,6 +78,9 @@ private:
   
   //  Data : encoder control
   Int                     m_iQp;            ///< Last QP
+  Double                  m_afCost[ MAX_CU_DEPTH ]; ///< Accumulated cost of CUs coded unsplit, per CU size (fast encoder)
+  Int                     m_aiNum [ MAX_CU_DEPTH ]; ///< Number of CUs coded unsplit, per CU size (fast encoder)
+  TEncEarlyTerm           m_cEarlyTerm;     ///< early termination of the mode and split decisions
   
   //  Access channel
   TEncCfg*                m_pcEncCfg;
@@ -100,6 +104,10 @@ public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
   
+  /// use the given tools instead of the ones of the encoder class
+  Void  init                ( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter,
+                              TComRdCost* pcRdCost, TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder );
+  
   /// create internal buffers
   Void  create              ( UChar uhTotalDepth, UInt iMaxWidth, UInt iMaxHeight );
   
@@ -112,6 +120,10 @@ public:
   /// CU encoding function
   Void  encodeCU            ( TComDataCU*    pcCU, Bool bForceTerminate = false  );
   
+  /// the two parts of encodeCU(): syntax of the LCU, and terminating bit
+  Void  encodeCUData        ( TComDataCU*    pcCU );
+  Void  encodeCUTerminatingBit( TComDataCU*  pcCU, Bool bForceTerminate = false  );
+  
   /// set QP value
   Void  setQpLast           ( Int iQp ) { m_iQp = iQp; }
   
@@ -0,0 +1,161 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncCuWorker.cpp
+    \brief    CU-level coding tools of one encoder thread
+*/
+
+#include "TEncCuWorker.h"
+#include "TEncTop.h"
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncCuWorker::TEncCuWorker()
+{
+  m_pppcRDSbacCoder   = NULL;
+  m_pppcBinCoderCABAC = NULL;
+  m_uiBitsCoded       = 0;
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+  m_cSbacCoder      .init( &m_cBinCoderCABAC );
+}
+
+TEncCuWorker::~TEncCuWorker()
+{
+}
+
+Void TEncCuWorker::create()
+{
+  m_cCuEncoder.create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
+
+  m_pppcRDSbacCoder   = new TEncSbac** [g_uiMaxCUDepth+1];
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [g_uiMaxCUDepth+1];
+
+  for ( Int iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    m_pppcRDSbacCoder[iDepth]   = new TEncSbac* [CI_NUM];
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABAC* [CI_NUM];
+
+    for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+    {
+      m_pppcRDSbacCoder  [iDepth][iCIIdx] = new TEncSbac;
+      if ( iDepth == 0 && iCIIdx == CI_CURR_BEST )
+      {
+        m_pppcBinCoderCABAC[iDepth][iCIIdx] = new TEncBinCABAC;
+      }
+      else
+      {
+        m_pppcBinCoderCABAC[iDepth][iCIIdx] = new TEncBinCABACCounter;
+      }
+      m_pppcRDSbacCoder  [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC[iDepth][iCIIdx] );
+    }
+  }
+}
+
+Void TEncCuWorker::destroy()
+{
+  m_cCuEncoder.destroy();
+
+  if ( m_pppcRDSbacCoder )
+  {
+    for ( Int iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+    {
+      for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+      {
+        delete m_pppcRDSbacCoder  [iDepth][iCIIdx];
+        delete m_pppcBinCoderCABAC[iDepth][iCIIdx];
+      }
+      delete [] m_pppcRDSbacCoder  [iDepth];
+      delete [] m_pppcBinCoderCABAC[iDepth];
+    }
+    delete [] m_pppcRDSbacCoder;
+    delete [] m_pppcBinCoderCABAC;
+    m_pppcRDSbacCoder   = NULL;
+    m_pppcBinCoderCABAC = NULL;
+  }
+}
+
+/** Set the tools up the same way TEncTop::init() sets up the shared ones.
+ * \param pcEncTop encoder holding the configuration and the CAVLC tables
+ */
+Void TEncCuWorker::init( TEncTop* pcEncTop )
+{
+  TEncCavlc* pcCavlcCoder = pcEncTop->getCavlcCoder();
+  UInt* aTable4 = pcCavlcCoder->GetLP4Table();
+#if !CAVLC_COEF_LRG_BLK
+  UInt* aTable8 = pcCavlcCoder->GetLP8Table();
+#else
+  UInt* aTable8 = NULL;
+#endif
+#if QC_MOD_LCEC
+  m_cTrQuant.init( g_uiMaxCUWidth, g_uiMaxCUHeight, 1 << pcEncTop->getQuadtreeTULog2MaxSize(), pcEncTop->getSymbolMode(), aTable4, aTable8,
+                   pcCavlcCoder->GetLastPosVlcIndexTable(), pcEncTop->getUseRDOQ(), true );
+#else
+  m_cTrQuant.init( g_uiMaxCUWidth, g_uiMaxCUHeight, 1 << pcEncTop->getQuadtreeTULog2MaxSize(), pcEncTop->getSymbolMode(), aTable4, aTable8,
+                   pcEncTop->getUseRDOQ(), true );
+#endif
+
+  m_cTrQuant.setSIMDLevel( pcEncTop->getSIMDLevel() );
+  m_cRdCost.setSIMDLevel( pcEncTop->getSIMDLevel() );
+  m_cSearch.setSIMDLevel( pcEncTop->getSIMDLevel() );
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getFastSearch(), 0,
+                  &m_cEntropyCoder, &m_cRdCost, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cBitCounter, &m_cRdCost, &m_cEntropyCoder,
+                     m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+Void TEncCuWorker::initSlice( TComRdCost* pcRdCost, TComTrQuant* pcTrQuant, TEncSearch* pcSearch )
+{
+  m_cRdCost .setLambda     ( pcRdCost->getLambda() );
+  m_cRdCost .setFrameLambda( pcRdCost->getFrameLambda() );
+  m_cTrQuant.setLambda     ( pcTrQuant->getLambda() );
+#if QC_MOD_LCEC_RDOQ
+  m_cTrQuant.setRDOQOffset ( pcTrQuant->getRDOQOffset() );
+#endif
+
+  for ( Int iDir = 0; iDir < 2; iDir++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < 33; iRefIdx++ )
+    {
+      m_cSearch.setAdaptiveSearchRange( iDir, iRefIdx, pcSearch->getAdaptiveSearchRange( iDir, iRefIdx ) );
+    }
+  }
+
+  m_uiBitsCoded = 0;
+}
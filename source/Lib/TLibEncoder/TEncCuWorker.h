@@ -0,0 +1,103 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncCuWorker.h
+    \brief    CU-level coding tools of one encoder thread (header)
+*/
+
+#ifndef __TENCCUWORKER__
+#define __TENCCUWORKER__
+
+// Include files
+#include "../TLibCommon/CommonDef.h"
+#include "../TLibCommon/TComTrQuant.h"
+#include "../TLibCommon/TComRdCost.h"
+#include "../TLibCommon/TComBitCounter.h"
+
+#include "TEncCu.h"
+#include "TEncSearch.h"
+#include "TEncEntropy.h"
+#include "TEncSbac.h"
+#include "TEncBinCoderCABAC.h"
+
+class TEncTop;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the CU analysis tools, so that several LCU rows or pictures can be compressed at the same time
+class TEncCuWorker
+{
+private:
+  TEncCu                  m_cCuEncoder;                   ///< CU encoder
+  TEncSearch              m_cSearch;                      ///< encoder search class
+  TComTrQuant             m_cTrQuant;                     ///< transform & quantization class
+  TComRdCost              m_cRdCost;                      ///< RD cost computation class
+  TEncEntropy             m_cEntropyCoder;                ///< entropy encoder
+  TComBitCounter          m_cBitCounter;                  ///< bit counter for RD optimization
+  TEncSbac***             m_pppcRDSbacCoder;              ///< temporal storage for RD computation
+  TEncBinCABAC***         m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
+  TEncSbac                m_cRDGoOnSbacCoder;             ///< going on SBAC model for RD stage
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+  TEncSbac                m_cSbacCoder;                   ///< slice-initial SBAC model of a picture compressed by this thread
+  TEncBinCABAC            m_cBinCoderCABAC;               ///< bin coder CABAC of m_cSbacCoder
+  UInt64                  m_uiBitsCoded;                  ///< RD bits of the LCUs compressed since initSlice()
+
+public:
+  TEncCuWorker();
+  virtual ~TEncCuWorker();
+
+  Void    create          ();
+  Void    destroy         ();
+  Void    init            ( TEncTop* pcEncTop );
+
+  /// take over the slice-level lambda, RDOQ and search range settings of the shared tools
+  Void    initSlice       ( TComRdCost* pcRdCost, TComTrQuant* pcTrQuant, TEncSearch* pcSearch );
+
+  TEncCu*         getCuEncoder      ()  { return &m_cCuEncoder;       }
+  TEncSearch*     getPredSearch     ()  { return &m_cSearch;          }
+  TComTrQuant*    getTrQuant        ()  { return &m_cTrQuant;         }
+  TComRdCost*     getRdCost         ()  { return &m_cRdCost;          }
+  TEncEntropy*    getEntropyCoder   ()  { return &m_cEntropyCoder;    }
+  TComBitCounter* getBitCounter     ()  { return &m_cBitCounter;      }
+  TEncSbac***     getRDSbacCoder    ()  { return m_pppcRDSbacCoder;   }
+  TEncSbac*       getRDGoOnSbacCoder()  { return &m_cRDGoOnSbacCoder; }
+  TEncSbac*       getSbacCoder      ()  { return &m_cSbacCoder;       }
+  TEncBinCABAC*   getBinCABAC       ()  { return &m_cBinCoderCABAC;   }
+
+  Void            addBitsCoded      ( UInt uiBits ) { m_uiBitsCoded += uiBits; }
+  UInt64          getBitsCoded      ()  { return m_uiBitsCoded;       }
+};
+
+#endif // __TENCCUWORKER__
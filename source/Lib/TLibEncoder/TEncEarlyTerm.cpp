@@ -0,0 +1,207 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncEarlyTerm.cpp
+    \brief    early termination of the CU mode and split decisions
+*/
+
+#include "TEncEarlyTerm.h"
+
+// ====================================================================================================================
+// Constructor / destructor / initialization
+// ====================================================================================================================
+
+TEncEarlyTerm::TEncEarlyTerm()
+{
+  m_iLevel = 0;
+  resetStatistics();
+}
+
+TEncEarlyTerm::~TEncEarlyTerm()
+{
+}
+
+Void TEncEarlyTerm::init( Int iLevel )
+{
+  m_iLevel = iLevel;
+  resetStatistics();
+}
+
+Void TEncEarlyTerm::resetStatistics()
+{
+  ::memset( m_adSkipCost, 0, sizeof( m_adSkipCost ) );
+  ::memset( m_aiSkipNum,  0, sizeof( m_aiSkipNum  ) );
+  ::memset( m_adLeafCost, 0, sizeof( m_adLeafCost ) );
+  ::memset( m_adLeafDist, 0, sizeof( m_adLeafDist ) );
+  ::memset( m_aiLeafNum,  0, sizeof( m_aiLeafNum  ) );
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Check after the skip/merge trial whether the remaining PU trials can be left out.
+ * \param pcBestCU  best mode so far
+ * \param uiDepth   CU depth
+ * \returns true if the best mode is skip and cheaper than the skipped CUs of this depth on average
+ */
+Bool TEncEarlyTerm::isEarlySkip( TComDataCU* pcBestCU, UInt uiDepth )
+{
+  if ( m_iLevel == 0 || pcBestCU->getSlice()->isIntra() || !pcBestCU->isSkipped( 0 ) || m_aiSkipNum[ uiDepth ] < EARLY_TERM_MIN_NUM )
+  {
+    return false;
+  }
+  Double dThres = m_iLevel >= 2 ? EARLY_SKIP_THRES : 1.0;
+  return pcBestCU->getTotalCost() < dThres * m_adSkipCost[ uiDepth ] / m_aiSkipNum[ uiDepth ];
+}
+
+/** Check after the 2Nx2N trials whether the 2NxN and Nx2N trials can be left out.
+ * \param pcBestCU  best mode so far
+ * \returns true if the best mode is an inter 2Nx2N without residual
+ */
+Bool TEncEarlyTerm::skipRectModes( TComDataCU* pcBestCU )
+{
+  if ( m_iLevel == 0 || pcBestCU->getSlice()->isIntra() || pcBestCU->getTotalCost() == MAX_DOUBLE )
+  {
+    return false;
+  }
+  return pcBestCU->getPredictionMode( 0 ) != MODE_INTRA && pcBestCU->getPartitionSize( 0 ) == SIZE_2Nx2N && !pcBestCU->getQtRootCbf( 0 );
+}
+
+/** Check before the recursion whether the split trial can be left out.
+ * \param pcBestCU  best unsplit mode
+ * \param uiDepth   CU depth
+ * \returns true if the CU is unlikely to be split
+ */
+Bool TEncEarlyTerm::skipSplit( TComDataCU* pcBestCU, UInt uiDepth )
+{
+  if ( m_iLevel == 0 || pcBestCU->getSlice()->isIntra() || pcBestCU->getTotalCost() == MAX_DOUBLE )
+  {
+    return false;
+  }
+  
+  if ( m_iLevel >= 2 && pcBestCU->isSkipped( 0 ) )
+  {
+    return true;
+  }
+  
+  UInt uiNeighbourDepth = xGetNeighbourDepth( pcBestCU );
+  if ( uiNeighbourDepth > uiDepth )
+  {
+    return false;
+  }
+  if ( pcBestCU->isSkipped( 0 ) )
+  {
+    return true;
+  }
+  
+  // a CU with lower cost and distortion than the CUs of its depth that stayed unsplit
+  if ( m_iLevel >= 2 && m_aiLeafNum[ uiDepth ] >= EARLY_TERM_MIN_NUM )
+  {
+    return pcBestCU->getTotalCost()       * m_aiLeafNum[ uiDepth ] < m_adLeafCost[ uiDepth ]
+        && pcBestCU->getTotalDistortion() * (Double)m_aiLeafNum[ uiDepth ] < m_adLeafDist[ uiDepth ];
+  }
+  return false;
+}
+
+/** Accumulate the cost of the best unsplit mode if it is skip.
+ * \param pcBestCU  best unsplit mode, split flag bits included
+ * \param uiDepth   CU depth
+ */
+Void TEncEarlyTerm::addUnsplitBest( TComDataCU* pcBestCU, UInt uiDepth )
+{
+  if ( m_iLevel == 0 || !pcBestCU->isSkipped( 0 ) )
+  {
+    return;
+  }
+  m_adSkipCost[ uiDepth ] += pcBestCU->getTotalCost();
+  m_aiSkipNum [ uiDepth ]++;
+}
+
+/** Accumulate the cost and distortion of a CU that stayed unsplit after the split trial.
+ * Only CUs whose split was actually tried are counted, so that the statistics do not follow the early terminations.
+ * \param pcBestCU  best of the unsplit and split modes
+ * \param uiDepth   CU depth
+ */
+Void TEncEarlyTerm::addSplitResult( TComDataCU* pcBestCU, UInt uiDepth )
+{
+  if ( m_iLevel == 0 || pcBestCU->getDepth( 0 ) != uiDepth )
+  {
+    return;
+  }
+  m_adLeafCost[ uiDepth ] += pcBestCU->getTotalCost();
+  m_adLeafDist[ uiDepth ] += pcBestCU->getTotalDistortion();
+  m_aiLeafNum [ uiDepth ]++;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Largest depth of the left and above CUs and of the co-located CU area in the first reference picture.
+ * \param pcCU  current CU
+ * \returns depth
+ */
+UInt TEncEarlyTerm::xGetNeighbourDepth( TComDataCU* pcCU )
+{
+  UInt uiAbsPartIdx = pcCU->getZorderIdxInCU();
+  UInt uiDepth      = 0;
+  UInt uiPartIdx;
+  
+  TComDataCU* pcCULeft = pcCU->getPULeft( uiPartIdx, uiAbsPartIdx );
+  if ( pcCULeft )
+  {
+    uiDepth = max<UInt>( uiDepth, pcCULeft->getDepth( uiPartIdx ) );
+  }
+  TComDataCU* pcCUAbove = pcCU->getPUAbove( uiPartIdx, uiAbsPartIdx );
+  if ( pcCUAbove )
+  {
+    uiDepth = max<UInt>( uiDepth, pcCUAbove->getDepth( uiPartIdx ) );
+  }
+  
+  // the CU data of a reference picture is only kept at its own rung
+  TComSlice* pcSlice = pcCU->getSlice();
+  if ( pcSlice->getNumRefIdx( REF_PIC_LIST_0 ) > 0 )
+  {
+    TComPic* pcRefPic = pcSlice->getRefPic( REF_PIC_LIST_0, 0 );
+    if ( pcRefPic->getPictureSizeIdx() == (Int)pcSlice->getPPS()->getPictureSizeIdx() )
+    {
+      TComDataCU* pcCUCol = pcRefPic->getCU( pcCU->getAddr() );
+      for ( UInt ui = 0; ui < pcCU->getTotalNumPart(); ui++ )
+      {
+        uiDepth = max<UInt>( uiDepth, pcCUCol->getDepth( uiAbsPartIdx + ui ) );
+      }
+    }
+  }
+  return uiDepth;
+}
@@ -0,0 +1,93 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncEarlyTerm.h
+    \brief    early termination of the CU mode and split decisions (header)
+*/
+
+#ifndef __TENCEARLYTERM__
+#define __TENCEARLYTERM__
+
+// Include files
+#include "../TLibCommon/CommonDef.h"
+#include "../TLibCommon/TComDataCU.h"
+#include "../TLibCommon/TComPic.h"
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// content-adaptive early termination of the CU analysis in inter slices
+/** The decisions use the RD cost of the skip/merge candidate, the depth of the left, above and co-located CUs and the
+ *  distortion of the best unsplit mode, compared with statistics of the CUs of the same depth in the current LCU row.
+ *  The statistics are reset at the start of each LCU row, so that wavefront analysis gives the same result.
+ *  - level 0: off
+ *  - level 1: skip the PU trials of a CU cheaper than the average skipped CU, skip 2NxN/Nx2N after a 2Nx2N without
+ *             residual, do not split a skipped CU whose neighbours are not deeper
+ *  - level 2: as level 1 with the EARLY_SKIP_THRES margin, never split a skipped CU, and do not split a CU whose cost
+ *             and distortion are below those of the unsplit CUs of its depth when its neighbours are not deeper
+ */
+class TEncEarlyTerm
+{
+private:
+  Int     m_iLevel;                             ///< 0: off, 1: conservative, 2: aggressive
+  
+  Double  m_adSkipCost[ MAX_CU_DEPTH ];         ///< accumulated cost of CUs whose best unsplit mode is skip, per depth
+  Int     m_aiSkipNum [ MAX_CU_DEPTH ];         ///< number of those CUs, per depth
+  Double  m_adLeafCost[ MAX_CU_DEPTH ];         ///< accumulated cost of CUs coded unsplit after trying the split, per depth
+  Double  m_adLeafDist[ MAX_CU_DEPTH ];         ///< accumulated distortion of those CUs, per depth
+  Int     m_aiLeafNum [ MAX_CU_DEPTH ];         ///< number of those CUs, per depth
+  
+  UInt    xGetNeighbourDepth  ( TComDataCU* pcCU );
+  
+public:
+  TEncEarlyTerm();
+  virtual ~TEncEarlyTerm();
+  
+  Void    init                ( Int iLevel );
+  Int     getLevel            ()  { return m_iLevel; }
+  
+  /// clear the statistics, called at the start of each LCU row
+  Void    resetStatistics     ();
+  
+  /// decisions, pcBestCU being the best mode so far at uiDepth
+  Bool    isEarlySkip         ( TComDataCU* pcBestCU, UInt uiDepth );
+  Bool    skipRectModes       ( TComDataCU* pcBestCU );
+  Bool    skipSplit           ( TComDataCU* pcBestCU, UInt uiDepth );
+  
+  /// statistics update with the best unsplit mode, and with the result of the split trial
+  Void    addUnsplitBest      ( TComDataCU* pcBestCU, UInt uiDepth );
+  Void    addSplitResult      ( TComDataCU* pcBestCU, UInt uiDepth );
+};
+
+#endif // __TENCEARLYTERM__
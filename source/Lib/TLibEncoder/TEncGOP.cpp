@@ -77,13 +77,20 @@ TEncGOP::TEncGOP()
   m_uiPOCCDR            = 0;
 #endif
 
-  m_uiStoredStartCUAddrForEncodingSlice = NULL;
-  m_uiStoredStartCUAddrForEncodingEntropySlice = NULL;
+  m_pcPicsInFlight     = NULL;
+  m_iMaxPicsInFlight   = 0;
+  m_iNumPicsInFlight   = 0;
+  m_pcThreadPool       = NULL;
 
   for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
     m_dLevelTime[j] = 0.0;
   }
 
+  m_iAutoPicSizeIdx     = 0;
+  m_auiGOPBits[0]       = m_auiGOPBits[1]  = 0;
+  m_aiGOPNumPic[0]      = m_aiGOPNumPic[1] = 0;
+  m_dGOPPSNRSum         = 0.0;
+
   return;
 }
 
@@ -91,29 +98,38 @@ TEncGOP::~TEncGOP()
 {
 }
 
-/** Create list to contain pointers to LCU start addresses of slice.
+/** Create lists to contain pointers to LCU start addresses of slice, for each picture that can be in flight.
  * \param iWidth, iHeight are picture width, height. iMaxCUWidth, iMaxCUHeight are LCU width, height.
+ * \param iMaxPicsInFlight is the number of pictures that can be compressed at the same time.
  */
-Void  TEncGOP::create( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight )
+Void  TEncGOP::create( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight, Int iMaxPicsInFlight )
 {
   UInt uiWidthInCU       = ( iWidth %iMaxCUWidth  ) ? iWidth /iMaxCUWidth  + 1 : iWidth /iMaxCUWidth;
   UInt uiHeightInCU      = ( iHeight%iMaxCUHeight ) ? iHeight/iMaxCUHeight + 1 : iHeight/iMaxCUHeight;
   UInt uiNumCUsInFrame   = uiWidthInCU * uiHeightInCU;
 
-  if (m_uiStoredStartCUAddrForEncodingSlice!=NULL){
-    delete[] m_uiStoredStartCUAddrForEncodingSlice;
+  if (m_pcPicsInFlight!=NULL){
+    destroy();
   }
-  if (m_uiStoredStartCUAddrForEncodingEntropySlice!=NULL){
-    delete[] m_uiStoredStartCUAddrForEncodingEntropySlice;
+  m_iMaxPicsInFlight = iMaxPicsInFlight;
+  m_pcPicsInFlight   = new TEncGOPPic [m_iMaxPicsInFlight];
+  for (Int i=0; i<m_iMaxPicsInFlight; i++){
+    m_pcPicsInFlight[i].pcSliceEncoder = NULL;
+    m_pcPicsInFlight[i].puiStoredStartCUAddrForEncodingSlice = new UInt [uiNumCUsInFrame+1];
+    m_pcPicsInFlight[i].puiStoredStartCUAddrForEncodingEntropySlice = new UInt [uiNumCUsInFrame+1];
+    m_pcPicsInFlight[i].pcBinStores = new TEncBinStore [uiNumCUsInFrame];
   }
-  m_uiStoredStartCUAddrForEncodingSlice = new UInt [uiNumCUsInFrame+1];
-  m_uiStoredStartCUAddrForEncodingEntropySlice = new UInt [uiNumCUsInFrame+1];
 }
 
 Void  TEncGOP::destroy()
 {
-  delete [] m_uiStoredStartCUAddrForEncodingSlice; m_uiStoredStartCUAddrForEncodingSlice = NULL;
-  delete [] m_uiStoredStartCUAddrForEncodingEntropySlice; m_uiStoredStartCUAddrForEncodingEntropySlice = NULL;
+  for (Int i=0; i<m_iMaxPicsInFlight; i++){
+    delete [] m_pcPicsInFlight[i].puiStoredStartCUAddrForEncodingSlice;
+    delete [] m_pcPicsInFlight[i].puiStoredStartCUAddrForEncodingEntropySlice;
+    delete [] m_pcPicsInFlight[i].pcBinStores;
+  }
+  delete [] m_pcPicsInFlight; m_pcPicsInFlight = NULL;
+  m_iMaxPicsInFlight = 0;
 }
 
 Void TEncGOP::init ( TEncTop* pcTEncTop )
@@ -129,6 +145,12 @@ Void TEncGOP::init ( TEncTop* pcTEncTop )
   m_pcBinCABAC           = pcTEncTop->getBinCABAC();
   m_pcLoopFilter         = pcTEncTop->getLoopFilter();
   m_pcBitCounter         = pcTEncTop->getBitCounter();
+  m_pcThreadPool         = pcTEncTop->getThreadPool();
+  
+  // with picture-parallel analysis each picture in flight has its own slice encoder
+  for (Int i=0; i<m_iMaxPicsInFlight; i++){
+    m_pcPicsInFlight[i].pcSliceEncoder = m_pcCfg->getFrameThreads() > 0 ? &pcTEncTop->getSliceEncoders()[i] : m_pcSliceEncoder;
+  }
   
   // Adaptive Loop filter
   m_pcAdaptiveLoopFilter = pcTEncTop->getAdaptiveLoopFilter();
@@ -150,13 +172,15 @@ Void TEncGOP::init ( TEncTop* pcTEncTop )
 
 Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, list<AccessUnit>& accessUnitsInGOP)
 {
-  TComPic*        pcPic;
-  TComPicYuv*     pcPicYuvRecOut;
-  TComSlice*      pcSlice;
-  
   xInitGOP( iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut );
   
-  m_iNumPicCoded = 0;
+  if ( m_pcCfg->getResSwitchMaxBitrate() > 0 )
+  {
+    xUpdateAutoPicSizeIdx();
+  }
+
+  m_iNumPicCoded     = 0;
+  m_iNumPicsInFlight = 0;
   for ( Int iDepth = 0; iDepth < m_iHrchDepth; iDepth++ )
   {
     Int iTimeOffset = ( 1 << (m_iHrchDepth - 1 - iDepth) );
@@ -173,560 +197,42 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     
     for ( ; iTimeOffset <= iNumPicRcvd; iTimeOffset += iStep )
     {
-      //-- For time output for each slice
-      long iBeforeTime = clock();
-      
       // generalized B info.
       if ( (m_pcCfg->getHierarchicalCoding() == false) && (iDepth != 0) && (iTimeOffset == m_iGopSize) && (iPOCLast != 0) )
       {
         continue;
       }
       
-      /////////////////////////////////////////////////////////////////////////////////////////////////// Initial to start encoding
-      UInt  uiPOCCurr = iPOCLast - (iNumPicRcvd - iTimeOffset);
-      
-      /* start a new access unit: create an entry in the list of output
-       * access units */
-      accessUnitsInGOP.push_back(AccessUnit());
-      AccessUnit& accessUnit = accessUnitsInGOP.back();
-      xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, uiPOCCurr );
-
-      const Int iPicSizeIdx = ( uiPOCCurr >= m_pcEncTop->getResSwitchFrameNum() ? ( m_pcEncTop->getResSwitchType()&0x01 ) : ( 1-(m_pcEncTop->getResSwitchType()&0x01) ));
-      pcPic->setPictureSizeIdx(iPicSizeIdx);
-
-      //  Slice data initialization
-      pcPic->clearSliceBuffer();
-      assert(pcPic->getNumAllocatedSlice() == 1);
-      m_pcSliceEncoder->setSliceIdx(0);
-      pcPic->setCurrSliceIdx(0);
-
-      if (m_pcEncTop->getResSwitchType() < 2 || uiPOCCurr < m_pcEncTop->getResSwitchFrameNum() ){
-        m_pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, uiPOCCurr, iNumPicRcvd, iTimeOffset, iDepth, pcSlice, m_pcEncTop->getSPS(), m_pcEncTop->getPPS()[iPicSizeIdx] );
-      } else {
-        // Inserting an IDR and restarting prediction structure at m_pcEncTop->getResSwitchFrameNum()
-        m_pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, uiPOCCurr-m_pcEncTop->getResSwitchFrameNum(), iNumPicRcvd, iTimeOffset, iDepth, pcSlice, m_pcEncTop->getSPS(), m_pcEncTop->getPPS()[iPicSizeIdx] );
-      }
-      pcSlice->setSliceIdx(0);
-
-#if DCM_DECODING_REFRESH
-      // Set the nal unit type
-      pcSlice->setNalUnitType(getNalUnitType(uiPOCCurr));
-      // Do decoding refresh marking if any 
-      pcSlice->decodingRefreshMarking(m_uiPOCCDR, m_bRefreshPending, rcListPic);
-#endif
-
-      // TODO: We need a common sliding mechanism used by both the encoder and decoder
-      // Below is a temporay solution to mark pictures that will be taken off the decoder's ref pic buffer (due to limit on the buffer size) as unused
-      Int iMaxRefPicNum = m_pcCfg->getMaxRefPicNum();
-      pcSlice->decodingMarking( rcListPic, m_pcCfg->getGOPSize(), iMaxRefPicNum ); 
-      m_pcCfg->setMaxRefPicNum( iMaxRefPicNum );
-
-      //  Set reference list
-      pcSlice->setRefPicList ( rcListPic );
-      
-      //  Slice info. refinement
-      if ( (pcSlice->getSliceType() == B_SLICE) && (pcSlice->getNumRefIdx(REF_PIC_LIST_1) == 0) )
-      {
-        pcSlice->setSliceType ( P_SLICE );
-        pcSlice->setDRBFlag   ( true );
-      }
-      
-      // Generalized B
-      if ( m_pcCfg->getUseGPB() )
-      {
-        if (pcSlice->getSliceType() == P_SLICE)
-        {
-          pcSlice->setSliceType( B_SLICE ); // Change slice type by force
-          
-#if DCM_COMB_LIST
-          if(pcSlice->getSPS()->getUseLComb() && (m_pcCfg->getNumOfReferenceB_L1() < m_pcCfg->getNumOfReferenceB_L0()) && (pcSlice->getNumRefIdx(REF_PIC_LIST_0)>1))
-          {
-            pcSlice->setNumRefIdx( REF_PIC_LIST_1, m_pcCfg->getNumOfReferenceB_L1() );
-
-            for (Int iRefIdx = 0; iRefIdx < m_pcCfg->getNumOfReferenceB_L1(); iRefIdx++)
-            {
-              pcSlice->setRefPic(pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx), REF_PIC_LIST_1, iRefIdx);
-            }
-          }
-          else
-          {
-#endif
-          Int iNumRefIdx = pcSlice->getNumRefIdx(REF_PIC_LIST_0);
-          pcSlice->setNumRefIdx( REF_PIC_LIST_1, iNumRefIdx );
-          
-          for (Int iRefIdx = 0; iRefIdx < iNumRefIdx; iRefIdx++)
-          {
-            pcSlice->setRefPic(pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx), REF_PIC_LIST_1, iRefIdx);
-          }
-#if DCM_COMB_LIST
-          }
-#endif
-        }
-      }
-
-#if DCM_COMB_LIST
-      if (pcSlice->getSliceType() != B_SLICE || !pcSlice->getSPS()->getUseLComb())
-      {
-        pcSlice->setNumRefIdx(REF_PIC_LIST_C, 0);
-        pcSlice->setRefPicListCombinationFlag(false);
-        pcSlice->setRefPicListModificationFlagLC(false);
-      }
-      else
-      {
-        pcSlice->setRefPicListCombinationFlag(pcSlice->getSPS()->getUseLComb());
-        pcSlice->setRefPicListModificationFlagLC(pcSlice->getSPS()->getLCMod());
-        pcSlice->setNumRefIdx(REF_PIC_LIST_C, pcSlice->getNumRefIdx(REF_PIC_LIST_0));
-      }
-#endif
-      
-      if (pcSlice->getSliceType() == B_SLICE)
-      {
-        pcSlice->setColDir(uiColDir);
-      }
-      
+      TEncGOPPic& rcGOPPic = m_pcPicsInFlight[ m_iNumPicsInFlight++ ];
+      xInitPic( iPOCLast, iNumPicRcvd, iDepth, iTimeOffset, uiColDir, rcListPic, rcListPicYuvRecOut, accessUnitsInGOP, rcGOPPic );
       uiColDir = 1-uiColDir;
       
-      //-------------------------------------------------------------
-      pcSlice->setRefPOCList();
-      
-      pcSlice->setNoBackPredFlag( false );
-#if DCM_COMB_LIST
-      if ( pcSlice->getSliceType() == B_SLICE && !pcSlice->getRefPicListCombinationFlag())
-#else
-      if ( pcSlice->getSliceType() == B_SLICE )
-#endif
-      {
-        if ( pcSlice->getNumRefIdx(RefPicList( 0 ) ) == pcSlice->getNumRefIdx(RefPicList( 1 ) ) )
-        {
-          pcSlice->setNoBackPredFlag( true );
-          int i;
-          for ( i=0; i < pcSlice->getNumRefIdx(RefPicList( 1 ) ); i++ )
-          {
-            if ( pcSlice->getRefPOC(RefPicList(1), i) != pcSlice->getRefPOC(RefPicList(0), i) ) 
-            {
-              pcSlice->setNoBackPredFlag( false );
-              break;
-            }
-          }
-        }
-      }
-
-#if DCM_COMB_LIST
-      if(pcSlice->getNoBackPredFlag())
-      {
-        pcSlice->setNumRefIdx(REF_PIC_LIST_C, 0);
-      }
-      pcSlice->generateCombinedList();
-#endif
-      
-      /////////////////////////////////////////////////////////////////////////////////////////////////// Compress a slice
-      //  Slice compression
-      if (m_pcCfg->getUseASR())
-      {
-        m_pcSliceEncoder->setSearchRange(pcSlice);
-      }
-#ifdef ROUNDING_CONTROL_BIPRED
-      Bool b = true;
-      if (m_pcCfg->getUseRoundingControlBipred())
-      {
-        if (m_pcCfg->getGOPSize()==1)
-          b = ((pcSlice->getPOC()&1)==0);
-        else
-          b = (pcSlice->isReferenced() == 0);
-      }
-
-#if HIGH_ACCURACY_BI
-      pcSlice->setRounding(false);
-#else
-      pcSlice->setRounding(b);
-#endif
-#endif
-
-      UInt uiStartCUAddrSliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEncodingSlice" containing locations of slice boundaries
-      UInt uiStartCUAddrSlice    = 0; // used to keep track of current slice's starting CU addr.
-      pcSlice->setSliceCurStartCUAddr( uiStartCUAddrSlice ); // Setting "start CU addr" for current slice
-      memset(m_uiStoredStartCUAddrForEncodingSlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
-
-      UInt uiStartCUAddrEntropySliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEntropyEncodingSlice" containing locations of slice boundaries
-      UInt uiStartCUAddrEntropySlice    = 0; // used to keep track of current Entropy slice's starting CU addr.
-      pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice ); // Setting "start CU addr" for current Entropy slice
-      memset(m_uiStoredStartCUAddrForEncodingEntropySlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
-
-      UInt uiNextCUAddr = 0;
-      m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = uiNextCUAddr;
-      m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiNextCUAddr;
-
-      while(uiNextCUAddr<pcPic->getPicSym()->getNumberOfCUsInFrame()) // determine slice boundaries
-      {
-        pcSlice->setNextSlice       ( false );
-        pcSlice->setNextEntropySlice( false );
-        assert(pcPic->getNumAllocatedSlice() == uiStartCUAddrSliceIdx);
-        m_pcSliceEncoder->precompressSlice( pcPic );
-        m_pcSliceEncoder->compressSlice   ( pcPic );
-
-        Bool bNoBinBitConstraintViolated = (!pcSlice->isNextSlice() && !pcSlice->isNextEntropySlice());
-        if (pcSlice->isNextSlice() || (bNoBinBitConstraintViolated && m_pcCfg->getSliceMode()==AD_HOC_SLICES_FIXED_NUMBER_OF_LCU_IN_SLICE))
-        {
-          uiStartCUAddrSlice                                              = pcSlice->getSliceCurEndCUAddr();
-          // Reconstruction slice
-          m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]  = uiStartCUAddrSlice;
-          // Entropy slice
-          if (uiStartCUAddrEntropySliceIdx>0 && m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx-1] != uiStartCUAddrSlice)
-          {
-            m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrSlice;
-          }
-          
-          if (uiStartCUAddrSlice < pcPic->getPicSym()->getNumberOfCUsInFrame())
-          {
-            pcPic->allocateNewSlice();          
-            pcPic->setCurrSliceIdx                  ( uiStartCUAddrSliceIdx-1 );
-            m_pcSliceEncoder->setSliceIdx           ( uiStartCUAddrSliceIdx-1 );
-            pcSlice = pcPic->getSlice               ( uiStartCUAddrSliceIdx-1 );
-            pcSlice->copySliceInfo                  ( pcPic->getSlice(0)      );
-            pcSlice->setSliceIdx                    ( uiStartCUAddrSliceIdx-1 );
-            pcSlice->setSliceCurStartCUAddr         ( uiStartCUAddrSlice      );
-            pcSlice->setEntropySliceCurStartCUAddr  ( uiStartCUAddrSlice      );
-            pcSlice->setSliceBits(0);
-          }
-        }
-        else if (pcSlice->isNextEntropySlice() || (bNoBinBitConstraintViolated && m_pcCfg->getEntropySliceMode()==SHARP_FIXED_NUMBER_OF_LCU_IN_ENTROPY_SLICE))
-        {
-          uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
-          m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrEntropySlice;
-          pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice );
-        }
-        else
-        {
-          uiStartCUAddrSlice                                                            = pcSlice->getSliceCurEndCUAddr();
-          uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
-        }        
-
-        uiNextCUAddr = (uiStartCUAddrSlice > uiStartCUAddrEntropySlice) ? uiStartCUAddrSlice : uiStartCUAddrEntropySlice;
-      }
-      m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = pcSlice->getSliceCurEndCUAddr();
-      m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = pcSlice->getSliceCurEndCUAddr();
-      
-      pcSlice = pcPic->getSlice(0);
-#if MTK_SAO  // PRE_DF
-      SAOParam cSaoParam;
-#endif
-
-      //-- Loop filter
-      m_pcLoopFilter->setCfg(pcSlice->getLoopFilterDisable(), m_pcCfg->getLoopFilterAlphaC0Offget(), m_pcCfg->getLoopFilterBetaOffget());
-      m_pcLoopFilter->loopFilterPic( pcPic );
-
-#if MTK_NONCROSS_INLOOP_FILTER
-      pcSlice = pcPic->getSlice(0);
-
-      if(pcSlice->getSPS()->getUseALF())
-      {
-        if(pcSlice->getSPS()->getLFCrossSliceBoundaryFlag())
-        {
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf(false);
-        }
-        else
-        {
-          UInt uiNumSlices = uiStartCUAddrSliceIdx-1;
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf( (uiNumSlices > 1)  );
-          if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
-          {
-            m_pcAdaptiveLoopFilter[iPicSizeIdx].setNumSlicesInPic( uiNumSlices );
-            m_pcAdaptiveLoopFilter[iPicSizeIdx].createSlice();
-
-            //set the startLCU and endLCU addr. to ALF slices
-            for(UInt i=0; i< uiNumSlices ; i++)
-            {
-              m_pcAdaptiveLoopFilter[iPicSizeIdx][i].create(pcPic, i, 
-                                                  m_uiStoredStartCUAddrForEncodingSlice[i], 
-                                                  m_uiStoredStartCUAddrForEncodingSlice[i+1]-1
-                                                  );
-
-            }
-          }
-        }
-      }
-#endif
-      /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
-      // Set entropy coder
-      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
-
-      /* write various header sets. */
-      if (m_bSPSSent == false)
-      {
-        OutputNALUnit nalu(NAL_UNIT_SPS, NAL_REF_IDC_PRIORITY_HIGHEST);
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeSPS(pcSlice->getSPS());
-        writeRBSPTrailingBits(nalu.m_Bitstream);
-        accessUnit.push_back(new NALUnitEBSP(nalu));
-
-        m_bSPSSent = true;
-      }
-
-      if ( m_bPPSSent[iPicSizeIdx] == false)
-      {
-        OutputNALUnit nalu(NAL_UNIT_PPS, NAL_REF_IDC_PRIORITY_HIGHEST);
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodePPS(pcSlice->getPPS());
-        writeRBSPTrailingBits(nalu.m_Bitstream);
-        accessUnit.push_back(new NALUnitEBSP(nalu));
-
-        m_bPPSSent[ iPicSizeIdx ] = true;
-      }
-
-      /* use the main bitstream buffer for storing the marshalled picture */
-      m_pcEntropyCoder->setBitstream(NULL);
-
-      uiStartCUAddrSliceIdx = 0;
-      uiStartCUAddrSlice    = 0; 
-
-      uiStartCUAddrEntropySliceIdx = 0;
-      uiStartCUAddrEntropySlice    = 0; 
-      uiNextCUAddr                 = 0;
-      pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
-      while (uiNextCUAddr < pcPic->getPicSym()->getNumberOfCUsInFrame()) // Iterate over all slices
-      {
-        pcSlice->setNextSlice       ( false );
-        pcSlice->setNextEntropySlice( false );
-        if (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx])
-        {
-          pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
-          pcPic->setCurrSliceIdx(uiStartCUAddrSliceIdx);
-          m_pcSliceEncoder->setSliceIdx(uiStartCUAddrSliceIdx);
-          assert(uiStartCUAddrSliceIdx == pcSlice->getSliceIdx());
-          // Reconstruction slice
-          pcSlice->setSliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
-          pcSlice->setSliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx+1 ] );
-          // Entropy slice
-          pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
-          pcSlice->setEntropySliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
-
-          pcSlice->setNextSlice       ( true );
-
-          uiStartCUAddrSliceIdx++;
-          uiStartCUAddrEntropySliceIdx++;
-        } 
-        else if (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx])
-        {
-          // Entropy slice
-          pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
-          pcSlice->setEntropySliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
-
-          pcSlice->setNextEntropySlice( true );
-
-          uiStartCUAddrEntropySliceIdx++;
-        }
-
-        // Get ready for writing slice header (other than the first one in the picture)
-        if (uiNextCUAddr!=0)
-        {
-          m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
-          m_pcEntropyCoder->resetEntropy      ();
-        }
-
-        /* start slice NALunit */
-#if DCM_DECODING_REFRESH
-        OutputNALUnit nalu(pcSlice->getNalUnitType(), NAL_REF_IDC_PRIORITY_HIGHEST, pcSlice->getTLayer(), true);
-#else
-        OutputNALUnit nalu(NAL_UNIT_CODED_SLICE, NAL_REF_IDC_PRIORITY_HIGHEST);
-#endif
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeSliceHeader(pcSlice);
-
-      // is it needed?
-      if ( pcSlice->getSymbolMode() )
-      {
-        m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
-        m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
-        m_pcEntropyCoder->resetEntropy    ();
-      }
-      
-      if (uiNextCUAddr==0)  // Compute ALF params and write only for first slice header
-      {
-        // set entropy coder for RD
-        if ( pcSlice->getSymbolMode() )
-        {
-          m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder(), pcSlice );
-        }
-        else
-        {
-          m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
-        }
-
-#if MTK_SAO
-        if ( pcSlice->getSPS()->getUseSAO() )
-        {
-          m_pcEntropyCoder->resetEntropy    ();
-          m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
-          m_pcSAO[iPicSizeIdx].startSaoEnc(pcPic, m_pcEntropyCoder, m_pcEncTop->getRDSbacCoder(), m_pcCfg->getUseSBACRD() ?  m_pcEncTop->getRDGoOnSbacCoder() : NULL);
-          m_pcSAO[iPicSizeIdx].SAOProcess(pcPic->getSlice(0)->getLambda());
-          m_pcSAO[iPicSizeIdx].copyQaoData(&cSaoParam);
-          m_pcSAO[iPicSizeIdx].endSaoEnc();
-
-#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcess(pcPic);
-#endif
-        }
-
-#endif
-        // adaptive loop filter
-        ALFParam cAlfParam;
-        UInt uiMaxAlfCtrlDepth;
-        UInt64 uiDist, uiBits;
-
-        if ( pcSlice->getSPS()->getUseALF())
-        {
-          m_pcEntropyCoder->resetEntropy    ();
-          m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
-#if TSB_ALF_HEADER
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].setNumCUsInFrame(pcPic);
-#endif
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].allocALFParam(&cAlfParam);
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].startALFEnc(pcPic, m_pcEntropyCoder );
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits, uiMaxAlfCtrlDepth );
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].endALFEnc();
-
-#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcess(pcPic);
-#endif
-        }
-
-        // set entropy coder for writing
-        m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
-        if ( pcSlice->getSymbolMode() )
-        {
-          m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
-        }
-        else
-        {
-          m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
-        }
-        m_pcEntropyCoder->resetEntropy    ();
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-
-#if MTK_SAO
-        if (pcSlice->getSPS()->getUseSAO())
-        {
-          m_pcEntropyCoder->encodeSaoParam(&cSaoParam);
-        }
-#endif
-
-        if (pcSlice->getSPS()->getUseALF())
-        {
-          if (cAlfParam.cu_control_flag)
-          {
-            m_pcEntropyCoder->setAlfCtrl( true );
-            m_pcEntropyCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth);
-            if (pcSlice->getSymbolMode() == 0)
-            {
-              m_pcCavlcCoder->setAlfCtrl(true);
-              m_pcCavlcCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth); //D0201
-            }
-          }
-          else
-          {
-            m_pcEntropyCoder->setAlfCtrl(false);
-          }
-          m_pcEntropyCoder->encodeAlfParam(&cAlfParam);
-
-#if TSB_ALF_HEADER
-          if(cAlfParam.cu_control_flag)
-          {
-            m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam);
-          }
-#endif
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].freeALFParam(&cAlfParam);
-        }
-      }
-        
-        // File writing
-        m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream);
-        writeRBSPTrailingBits(nalu.m_Bitstream);
-        accessUnit.push_back(new NALUnitEBSP(nalu));
-        
-        UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
-        uiBoundingAddrSlice        = m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
-        uiBoundingAddrEntropySlice = m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
-        uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
-      } // end iteration over slices
-      
-      
-#if MTK_NONCROSS_INLOOP_FILTER
-      if(pcSlice->getSPS()->getUseALF())
-      {
-        if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
-          m_pcAdaptiveLoopFilter[iPicSizeIdx].destroySlice();
-      }
-#endif 
-      
-#if AMVP_BUFFERCOMPRESS
-      pcPic->compressMotion(); 
-#endif 
-      
-      // Mark higher temporal layer pictures after switching point as unused
-      pcSlice->decodingTLayerSwitchingMarking( rcListPic );
-
-      //-- For time output for each slice
-      Double dEncTime = (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-      m_dLevelTime[pcPic->getPictureSizeIdx()] += dEncTime;
-
-      const char* digestStr = NULL;
-      if (m_pcCfg->getPictureDigestEnabled())
+      // the next picture may be compressed together with the pictures set up so far only if it cannot reference them,
+      // i.e. they are all non-referenced, otherwise they are compressed and written first
+      TComSlice* pcSlice = rcGOPPic.pcPic->getSlice(0);
+      if ( m_iNumPicsInFlight == m_iMaxPicsInFlight || pcSlice->isReferenced() || pcSlice->getTLayerSwitchingFlag() )
       {
-        /* calculate MD5sum for entire reconstructed picture */
-        SEIpictureDigest sei_recon_picture_digest;
-        sei_recon_picture_digest.method = SEIpictureDigest::MD5;
-        calcMD5(*pcPic->getPicYuvRec(), sei_recon_picture_digest.digest);
-        digestStr = digestToString(sei_recon_picture_digest.digest);
-
-        OutputNALUnit nalu(NAL_UNIT_SEI, NAL_REF_IDC_PRIORITY_LOWEST);
-
-        /* write the SEI messages */
-        m_pcEntropyCoder->setEntropyCoder(m_pcCavlcCoder, pcSlice);
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeSEI(sei_recon_picture_digest);
-        writeRBSPTrailingBits(nalu.m_Bitstream);
-
-        /* insert the SEI message NALUnit before any Slice NALUnits */
-        AccessUnit::iterator it = find_if(accessUnit.begin(), accessUnit.end(), mem_fun(&NALUnit::isSlice));
-        accessUnit.insert(it, new NALUnitEBSP(nalu));
+        xCompressAndWritePics( rcListPic );
       }
-
-      xCalculateAddPSNR( pcPic, accessUnit, dEncTime );
-      if (m_pcCfg->getPictureDigestEnabled())
-      {
-        SEIpictureDigest sei_recon_picture_digest;
-        sei_recon_picture_digest.method = SEIpictureDigest::MD5;
-        if (digestStr)
-          printf(" [MD5:%s]", digestStr);
-
-        digestStr = NULL;
-      }
-
-
-#if FIXED_ROUNDING_FRAME_MEMORY
-      /* TODO: this should happen after copyToPic(pcPicYuvRecOut) */
-      pcPic->getPicYuvRec(0)->xFixedRoundingPic();
-#endif
-      pcPic->getPicYuvRec(0)->copyToPic(pcPicYuvRecOut);
-      
-      pcPic->setReconMark   ( true );
-      
-      m_bFirst = false;
-      m_iNumPicCoded++;
-
-      /* logging: insert a newline at end of picture period */
-      printf("\n");
-      fflush(stdout);
     }
     
     // generalized B info.
     if ( m_pcCfg->getHierarchicalCoding() == false && iDepth != 0 )
       break;
   }
+  xCompressAndWritePics( rcListPic );
   
   assert ( m_iNumPicCoded == iNumPicRcvd );
 }
 
+Void TEncGOP::runTask( Int iThreadIdx )
+{
+  if ( iThreadIdx < m_iNumPicsInFlight )
+  {
+    xCompressPic( m_pcPicsInFlight[iThreadIdx] );
+  }
+}
+
 Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded)
 {
   assert (uiNumAllPicCoded == m_gcAnalyzeAll.getNumPic());
@@ -768,7 +274,7 @@ Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded)
 #endif
 
   //-- Each resolution type
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+  for (int j=0; j<m_pcCfg->getNumPicResolutions(); ++j){
     printf( "\n\nRESOLUTION %u SUMMARY -------------------------------------------\n",j );
     m_gcAnalyzeAllMultiRes[j].printOut('a');
   
@@ -783,12 +289,12 @@ Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded)
   }
 
 #if RVM_VCEGAM10
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+  for (int j=0; j<m_pcCfg->getNumPicResolutions(); ++j){
     printf("\nLevel %d RVM: %.3lf" , j, xCalculateRVM(j));
   }
   printf("\nCombined RVM: %.3lf\n" , xCalculateRVMTotal());
 #endif
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+  for (int j=0; j<m_pcCfg->getNumPicResolutions(); ++j){
     printf("Level %d Time: %.3lf\n" , j, m_dLevelTime[j]);
   }
 
@@ -839,6 +345,627 @@ Void TEncGOP::preLoopFilterPicAll( TComPic* pcPic, UInt64& ruiDist, UInt64& ruiB
 // Protected member functions
 // ====================================================================================================================
 
+/** Compress the pictures set up so far, at the same time if there are several of them, then write them in coding order.
+ * \param rcListPic list of pictures
+ */
+Void TEncGOP::xCompressAndWritePics( TComList<TComPic*>& rcListPic )
+{
+  if ( m_iNumPicsInFlight > 1 )
+  {
+    // the pictures read by several threads are resampled beforehand
+    for ( Int i = 0; i < m_iNumPicsInFlight; i++ )
+    {
+      m_pcPicsInFlight[i].pcSliceEncoder->resamplePictureData( m_pcPicsInFlight[i].pcPic );
+    }
+    m_pcThreadPool->run( this );
+  }
+  else if ( m_iNumPicsInFlight == 1 )
+  {
+    xCompressPic( m_pcPicsInFlight[0] );
+  }
+  
+  for ( Int i = 0; i < m_iNumPicsInFlight; i++ )
+  {
+    xWritePic( m_pcPicsInFlight[i], rcListPic );
+  }
+  m_iNumPicsInFlight = 0;
+}
+
+/** Set a picture of the GOP up for compression: slice parameters, reference picture marking and lists.
+ * \param iPOCLast           POC of the last picture of the GOP
+ * \param iNumPicRcvd        number of pictures in the GOP
+ * \param iDepth             hierarchical depth of the picture
+ * \param iTimeOffset        position of the picture in the GOP
+ * \param uiColDir           direction of the co-located picture of a B picture
+ * \param rcListPic          list of pictures
+ * \param rcListPicYuvRecOut list of reconstructed pictures to output
+ * \param accessUnitsInGOP   access units of the GOP, the access unit of the picture is appended
+ * \param rcGOPPic           picture set up, its slice encoder must be set
+ */
+Void TEncGOP::xInitPic( Int iPOCLast, Int iNumPicRcvd, Int iDepth, Int iTimeOffset, UInt uiColDir, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, list<AccessUnit>& accessUnitsInGOP, TEncGOPPic& rcGOPPic )
+{
+  TComPic*        pcPic          = NULL;
+  TComPicYuv*     pcPicYuvRecOut = NULL;
+  TComSlice*      pcSlice;
+  TEncSlice*      pcSliceEncoder = rcGOPPic.pcSliceEncoder;
+  
+  //-- For time output for each slice
+  rcGOPPic.iBeforeTime = clock();
+  
+  /////////////////////////////////////////////////////////////////////////////////////////////////// Initial to start encoding
+  UInt  uiPOCCurr = iPOCLast - (iNumPicRcvd - iTimeOffset);
+  
+  /* start a new access unit: create an entry in the list of output
+   * access units */
+  accessUnitsInGOP.push_back(AccessUnit());
+  rcGOPPic.pcAccessUnit = &accessUnitsInGOP.back();
+  xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, uiPOCCurr );
+
+  const Int iPicSizeIdx = xGetPictureSizeIdx( uiPOCCurr );
+  pcPic->setPictureSizeIdx(iPicSizeIdx);
+
+  //  Slice data initialization
+  pcPic->clearSliceBuffer();
+  assert(pcPic->getNumAllocatedSlice() == 1);
+  pcSliceEncoder->setSliceIdx(0);
+  pcPic->setCurrSliceIdx(0);
+
+  if (m_pcEncTop->getResSwitchType() < 2 || uiPOCCurr < m_pcEncTop->getResSwitchFrameNum() ){
+    pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, uiPOCCurr, iNumPicRcvd, iTimeOffset, iDepth, pcSlice, m_pcEncTop->getSPS(), m_pcEncTop->getPPS()[iPicSizeIdx] );
+  } else {
+    // Inserting an IDR and restarting prediction structure at m_pcEncTop->getResSwitchFrameNum()
+    pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, uiPOCCurr-m_pcEncTop->getResSwitchFrameNum(), iNumPicRcvd, iTimeOffset, iDepth, pcSlice, m_pcEncTop->getSPS(), m_pcEncTop->getPPS()[iPicSizeIdx] );
+  }
+  pcSlice->setSliceIdx(0);
+
+#if DCM_DECODING_REFRESH
+  // Set the nal unit type
+  pcSlice->setNalUnitType(getNalUnitType(uiPOCCurr));
+  // Do decoding refresh marking if any 
+  pcSlice->decodingRefreshMarking(m_uiPOCCDR, m_bRefreshPending, rcListPic);
+#endif
+
+  // TODO: We need a common sliding mechanism used by both the encoder and decoder
+  // Below is a temporay solution to mark pictures that will be taken off the decoder's ref pic buffer (due to limit on the buffer size) as unused
+  Int iMaxRefPicNum = m_pcCfg->getMaxRefPicNum();
+  pcSlice->decodingMarking( rcListPic, m_pcCfg->getGOPSize(), iMaxRefPicNum ); 
+  m_pcCfg->setMaxRefPicNum( iMaxRefPicNum );
+
+  //  Set reference list
+  pcSlice->setRefPicList ( rcListPic );
+  
+  //  Slice info. refinement
+  if ( (pcSlice->getSliceType() == B_SLICE) && (pcSlice->getNumRefIdx(REF_PIC_LIST_1) == 0) )
+  {
+    pcSlice->setSliceType ( P_SLICE );
+    pcSlice->setDRBFlag   ( true );
+  }
+  
+  // Generalized B
+  if ( m_pcCfg->getUseGPB() )
+  {
+    if (pcSlice->getSliceType() == P_SLICE)
+    {
+      pcSlice->setSliceType( B_SLICE ); // Change slice type by force
+      
+#if DCM_COMB_LIST
+      if(pcSlice->getSPS()->getUseLComb() && (m_pcCfg->getNumOfReferenceB_L1() < m_pcCfg->getNumOfReferenceB_L0()) && (pcSlice->getNumRefIdx(REF_PIC_LIST_0)>1))
+      {
+        pcSlice->setNumRefIdx( REF_PIC_LIST_1, m_pcCfg->getNumOfReferenceB_L1() );
+
+        for (Int iRefIdx = 0; iRefIdx < m_pcCfg->getNumOfReferenceB_L1(); iRefIdx++)
+        {
+          pcSlice->setRefPic(pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx), REF_PIC_LIST_1, iRefIdx);
+        }
+      }
+      else
+      {
+#endif
+      Int iNumRefIdx = pcSlice->getNumRefIdx(REF_PIC_LIST_0);
+      pcSlice->setNumRefIdx( REF_PIC_LIST_1, iNumRefIdx );
+      
+      for (Int iRefIdx = 0; iRefIdx < iNumRefIdx; iRefIdx++)
+      {
+        pcSlice->setRefPic(pcSlice->getRefPic(REF_PIC_LIST_0, iRefIdx), REF_PIC_LIST_1, iRefIdx);
+      }
+#if DCM_COMB_LIST
+      }
+#endif
+    }
+  }
+
+#if DCM_COMB_LIST
+  if (pcSlice->getSliceType() != B_SLICE || !pcSlice->getSPS()->getUseLComb())
+  {
+    pcSlice->setNumRefIdx(REF_PIC_LIST_C, 0);
+    pcSlice->setRefPicListCombinationFlag(false);
+    pcSlice->setRefPicListModificationFlagLC(false);
+  }
+  else
+  {
+    pcSlice->setRefPicListCombinationFlag(pcSlice->getSPS()->getUseLComb());
+    pcSlice->setRefPicListModificationFlagLC(pcSlice->getSPS()->getLCMod());
+    pcSlice->setNumRefIdx(REF_PIC_LIST_C, pcSlice->getNumRefIdx(REF_PIC_LIST_0));
+  }
+#endif
+  
+  if (pcSlice->getSliceType() == B_SLICE)
+  {
+    pcSlice->setColDir(uiColDir);
+  }
+  
+  //-------------------------------------------------------------
+  pcSlice->setRefPOCList();
+  
+  pcSlice->setNoBackPredFlag( false );
+#if DCM_COMB_LIST
+  if ( pcSlice->getSliceType() == B_SLICE && !pcSlice->getRefPicListCombinationFlag())
+#else
+  if ( pcSlice->getSliceType() == B_SLICE )
+#endif
+  {
+    if ( pcSlice->getNumRefIdx(RefPicList( 0 ) ) == pcSlice->getNumRefIdx(RefPicList( 1 ) ) )
+    {
+      pcSlice->setNoBackPredFlag( true );
+      int i;
+      for ( i=0; i < pcSlice->getNumRefIdx(RefPicList( 1 ) ); i++ )
+      {
+        if ( pcSlice->getRefPOC(RefPicList(1), i) != pcSlice->getRefPOC(RefPicList(0), i) ) 
+        {
+          pcSlice->setNoBackPredFlag( false );
+          break;
+        }
+      }
+    }
+  }
+
+#if DCM_COMB_LIST
+  if(pcSlice->getNoBackPredFlag())
+  {
+    pcSlice->setNumRefIdx(REF_PIC_LIST_C, 0);
+  }
+  pcSlice->generateCombinedList();
+#endif
+  
+  /////////////////////////////////////////////////////////////////////////////////////////////////// Compress a slice
+  //  Slice compression
+  if (m_pcCfg->getUseASR())
+  {
+    pcSliceEncoder->setSearchRange(pcSlice);
+  }
+#ifdef ROUNDING_CONTROL_BIPRED
+  Bool b = true;
+  if (m_pcCfg->getUseRoundingControlBipred())
+  {
+    if (m_pcCfg->getGOPSize()==1)
+      b = ((pcSlice->getPOC()&1)==0);
+    else
+      b = (pcSlice->isReferenced() == 0);
+  }
+
+#if HIGH_ACCURACY_BI
+  pcSlice->setRounding(false);
+#else
+  pcSlice->setRounding(b);
+#endif
+#endif
+
+  rcGOPPic.pcPic          = pcPic;
+  rcGOPPic.pcPicYuvRecOut = pcPicYuvRecOut;
+  rcGOPPic.iPicSizeIdx    = iPicSizeIdx;
+}
+
+/** Analysis of a picture set up by xInitPic(), slice by slice.
+ * \param rcGOPPic picture to compress
+ */
+Void TEncGOP::xCompressPic( TEncGOPPic& rcGOPPic )
+{
+  TComPic*   pcPic          = rcGOPPic.pcPic;
+  TComSlice* pcSlice        = pcPic->getSlice(0);
+  TEncSlice* pcSliceEncoder = rcGOPPic.pcSliceEncoder;
+  UInt*      puiStoredStartCUAddrForEncodingSlice        = rcGOPPic.puiStoredStartCUAddrForEncodingSlice;
+  UInt*      puiStoredStartCUAddrForEncodingEntropySlice = rcGOPPic.puiStoredStartCUAddrForEncodingEntropySlice;
+  
+  UInt uiStartCUAddrSliceIdx = 0; // used to index "puiStoredStartCUAddrForEncodingSlice" containing locations of slice boundaries
+  UInt uiStartCUAddrSlice    = 0; // used to keep track of current slice's starting CU addr.
+  pcSlice->setSliceCurStartCUAddr( uiStartCUAddrSlice ); // Setting "start CU addr" for current slice
+  memset(puiStoredStartCUAddrForEncodingSlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
+
+  UInt uiStartCUAddrEntropySliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEntropyEncodingSlice" containing locations of slice boundaries
+  UInt uiStartCUAddrEntropySlice    = 0; // used to keep track of current Entropy slice's starting CU addr.
+  pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice ); // Setting "start CU addr" for current Entropy slice
+  memset(puiStoredStartCUAddrForEncodingEntropySlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
+
+  pcSliceEncoder->setBinStores( m_pcCfg->getCacheBins() ? rcGOPPic.pcBinStores : NULL );
+
+  UInt uiNextCUAddr = 0;
+  puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = uiNextCUAddr;
+  puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiNextCUAddr;
+
+  while(uiNextCUAddr<pcPic->getPicSym()->getNumberOfCUsInFrame()) // determine slice boundaries
+  {
+    pcSlice->setNextSlice       ( false );
+    pcSlice->setNextEntropySlice( false );
+    assert(pcPic->getNumAllocatedSlice() == uiStartCUAddrSliceIdx);
+    pcSliceEncoder->precompressSlice( pcPic );
+    pcSliceEncoder->compressSlice   ( pcPic );
+
+    Bool bNoBinBitConstraintViolated = (!pcSlice->isNextSlice() && !pcSlice->isNextEntropySlice());
+    if (pcSlice->isNextSlice() || (bNoBinBitConstraintViolated && m_pcCfg->getSliceMode()==AD_HOC_SLICES_FIXED_NUMBER_OF_LCU_IN_SLICE))
+    {
+      uiStartCUAddrSlice                                              = pcSlice->getSliceCurEndCUAddr();
+      // Reconstruction slice
+      puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]  = uiStartCUAddrSlice;
+      // Entropy slice
+      if (uiStartCUAddrEntropySliceIdx>0 && puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx-1] != uiStartCUAddrSlice)
+      {
+        puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrSlice;
+      }
+      
+      if (uiStartCUAddrSlice < pcPic->getPicSym()->getNumberOfCUsInFrame())
+      {
+        pcPic->allocateNewSlice();          
+        pcPic->setCurrSliceIdx                  ( uiStartCUAddrSliceIdx-1 );
+        pcSliceEncoder->setSliceIdx           ( uiStartCUAddrSliceIdx-1 );
+        pcSlice = pcPic->getSlice               ( uiStartCUAddrSliceIdx-1 );
+        pcSlice->copySliceInfo                  ( pcPic->getSlice(0)      );
+        pcSlice->setSliceIdx                    ( uiStartCUAddrSliceIdx-1 );
+        pcSlice->setSliceCurStartCUAddr         ( uiStartCUAddrSlice      );
+        pcSlice->setEntropySliceCurStartCUAddr  ( uiStartCUAddrSlice      );
+        pcSlice->setSliceBits(0);
+      }
+    }
+    else if (pcSlice->isNextEntropySlice() || (bNoBinBitConstraintViolated && m_pcCfg->getEntropySliceMode()==SHARP_FIXED_NUMBER_OF_LCU_IN_ENTROPY_SLICE))
+    {
+      uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
+      puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrEntropySlice;
+      pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice );
+    }
+    else
+    {
+      uiStartCUAddrSlice                                                            = pcSlice->getSliceCurEndCUAddr();
+      uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
+    }        
+
+    uiNextCUAddr = (uiStartCUAddrSlice > uiStartCUAddrEntropySlice) ? uiStartCUAddrSlice : uiStartCUAddrEntropySlice;
+  }
+  puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = pcSlice->getSliceCurEndCUAddr();
+  puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = pcSlice->getSliceCurEndCUAddr();
+  rcGOPPic.uiNumSlices = uiStartCUAddrSliceIdx-1;
+}
+
+/** In-loop filtering and writing of a compressed picture.
+ * \param rcGOPPic  picture compressed by xCompressPic()
+ * \param rcListPic list of pictures
+ */
+Void TEncGOP::xWritePic( TEncGOPPic& rcGOPPic, TComList<TComPic*>& rcListPic )
+{
+  TComPic*    pcPic          = rcGOPPic.pcPic;
+  TComPicYuv* pcPicYuvRecOut = rcGOPPic.pcPicYuvRecOut;
+  AccessUnit& accessUnit     = *rcGOPPic.pcAccessUnit;
+  const Int   iPicSizeIdx    = rcGOPPic.iPicSizeIdx;
+  UInt*       puiStoredStartCUAddrForEncodingSlice        = rcGOPPic.puiStoredStartCUAddrForEncodingSlice;
+  UInt*       puiStoredStartCUAddrForEncodingEntropySlice = rcGOPPic.puiStoredStartCUAddrForEncodingEntropySlice;
+  
+  TComSlice* pcSlice = pcPic->getSlice(0);
+#if MTK_SAO  // PRE_DF
+  SAOParam cSaoParam;
+#endif
+
+  //-- Loop filter, the pictures are written one at a time so all threads can take part
+  m_pcLoopFilter->setCfg(pcSlice->getLoopFilterDisable(), m_pcCfg->getLoopFilterAlphaC0Offget(), m_pcCfg->getLoopFilterBetaOffget());
+  m_pcLoopFilter->loopFilterPic( pcPic, m_pcThreadPool );
+
+#if MTK_NONCROSS_INLOOP_FILTER
+  pcSlice = pcPic->getSlice(0);
+
+  if(pcSlice->getSPS()->getUseALF())
+  {
+    if(pcSlice->getSPS()->getLFCrossSliceBoundaryFlag())
+    {
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf(false);
+    }
+    else
+    {
+      UInt uiNumSlices = rcGOPPic.uiNumSlices;
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].setUseNonCrossAlf( (uiNumSlices > 1)  );
+      if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
+      {
+        m_pcAdaptiveLoopFilter[iPicSizeIdx].setNumSlicesInPic( uiNumSlices );
+        m_pcAdaptiveLoopFilter[iPicSizeIdx].createSlice();
+
+        //set the startLCU and endLCU addr. to ALF slices
+        for(UInt i=0; i< uiNumSlices ; i++)
+        {
+          m_pcAdaptiveLoopFilter[iPicSizeIdx][i].create(pcPic, i, 
+                                              puiStoredStartCUAddrForEncodingSlice[i], 
+                                              puiStoredStartCUAddrForEncodingSlice[i+1]-1
+                                              );
+
+        }
+      }
+    }
+  }
+#endif
+  /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
+  // Set entropy coder
+  m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
+
+  /* write various header sets. */
+  if (m_bSPSSent == false)
+  {
+    OutputNALUnit nalu(NAL_UNIT_SPS, NAL_REF_IDC_PRIORITY_HIGHEST);
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodeSPS(pcSlice->getSPS());
+    writeRBSPTrailingBits(nalu.m_Bitstream);
+    accessUnit.push_back(new NALUnitEBSP(nalu));
+
+    m_bSPSSent = true;
+  }
+
+  if ( m_bPPSSent[iPicSizeIdx] == false)
+  {
+    OutputNALUnit nalu(NAL_UNIT_PPS, NAL_REF_IDC_PRIORITY_HIGHEST);
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodePPS(pcSlice->getPPS());
+    writeRBSPTrailingBits(nalu.m_Bitstream);
+    accessUnit.push_back(new NALUnitEBSP(nalu));
+
+    m_bPPSSent[ iPicSizeIdx ] = true;
+  }
+
+  /* use the main bitstream buffer for storing the marshalled picture */
+  m_pcEntropyCoder->setBitstream(NULL);
+  m_pcSliceEncoder->setBinStores( m_pcCfg->getCacheBins() ? rcGOPPic.pcBinStores : NULL );
+
+  UInt uiStartCUAddrSliceIdx        = 0;
+  UInt uiStartCUAddrEntropySliceIdx = 0;
+  UInt uiNextCUAddr                 = 0;
+  pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
+  while (uiNextCUAddr < pcPic->getPicSym()->getNumberOfCUsInFrame()) // Iterate over all slices
+  {
+    pcSlice->setNextSlice       ( false );
+    pcSlice->setNextEntropySlice( false );
+    if (uiNextCUAddr == puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx])
+    {
+      pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
+      pcPic->setCurrSliceIdx(uiStartCUAddrSliceIdx);
+      m_pcSliceEncoder->setSliceIdx(uiStartCUAddrSliceIdx);
+      assert(uiStartCUAddrSliceIdx == pcSlice->getSliceIdx());
+      // Reconstruction slice
+      pcSlice->setSliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
+      pcSlice->setSliceCurEndCUAddr  ( puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx+1 ] );
+      // Entropy slice
+      pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
+      pcSlice->setEntropySliceCurEndCUAddr  ( puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
+
+      pcSlice->setNextSlice       ( true );
+
+      uiStartCUAddrSliceIdx++;
+      uiStartCUAddrEntropySliceIdx++;
+    } 
+    else if (uiNextCUAddr == puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx])
+    {
+      // Entropy slice
+      pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
+      pcSlice->setEntropySliceCurEndCUAddr  ( puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
+
+      pcSlice->setNextEntropySlice( true );
+
+      uiStartCUAddrEntropySliceIdx++;
+    }
+
+    // Get ready for writing slice header (other than the first one in the picture)
+    if (uiNextCUAddr!=0)
+    {
+      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
+      m_pcEntropyCoder->resetEntropy      ();
+    }
+
+    /* start slice NALunit */
+#if DCM_DECODING_REFRESH
+    OutputNALUnit nalu(pcSlice->getNalUnitType(), NAL_REF_IDC_PRIORITY_HIGHEST, pcSlice->getTLayer(), true);
+#else
+    OutputNALUnit nalu(NAL_UNIT_CODED_SLICE, NAL_REF_IDC_PRIORITY_HIGHEST);
+#endif
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodeSliceHeader(pcSlice);
+
+  // is it needed?
+  if ( pcSlice->getSymbolMode() )
+  {
+    m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
+    m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
+    m_pcEntropyCoder->resetEntropy    ();
+  }
+  
+  if (uiNextCUAddr==0)  // Compute ALF params and write only for first slice header
+  {
+    // set entropy coder for RD
+    if ( pcSlice->getSymbolMode() )
+    {
+      m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder(), pcSlice );
+    }
+    else
+    {
+      m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
+    }
+
+#if MTK_SAO
+    if ( pcSlice->getSPS()->getUseSAO() )
+    {
+      m_pcEntropyCoder->resetEntropy    ();
+      m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
+      m_pcSAO[iPicSizeIdx].startSaoEnc(pcPic, m_pcEntropyCoder, m_pcEncTop->getRDSbacCoder(), m_pcCfg->getUseSBACRD() ?  m_pcEncTop->getRDGoOnSbacCoder() : NULL);
+      m_pcSAO[iPicSizeIdx].SAOProcess(pcPic->getSlice(0)->getLambda(), m_pcThreadPool);
+      m_pcSAO[iPicSizeIdx].copyQaoData(&cSaoParam);
+      m_pcSAO[iPicSizeIdx].endSaoEnc();
+
+#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcess(pcPic);
+#endif
+    }
+
+#endif
+    // adaptive loop filter
+    ALFParam cAlfParam;
+    UInt uiMaxAlfCtrlDepth;
+    UInt64 uiDist, uiBits;
+
+    if ( pcSlice->getSPS()->getUseALF())
+    {
+      m_pcEntropyCoder->resetEntropy    ();
+      m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
+#if TSB_ALF_HEADER
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].setNumCUsInFrame(pcPic);
+#endif
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].allocALFParam(&cAlfParam);
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].startALFEnc(pcPic, m_pcEntropyCoder );
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits, uiMaxAlfCtrlDepth, m_pcThreadPool );
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].endALFEnc();
+
+#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].PCMLFDisableProcess(pcPic);
+#endif
+    }
+
+    // set entropy coder for writing
+    m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
+    if ( pcSlice->getSymbolMode() )
+    {
+      m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
+    }
+    else
+    {
+      m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
+    }
+    m_pcEntropyCoder->resetEntropy    ();
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+
+#if MTK_SAO
+    if (pcSlice->getSPS()->getUseSAO())
+    {
+      m_pcEntropyCoder->encodeSaoParam(&cSaoParam);
+    }
+#endif
+
+    if (pcSlice->getSPS()->getUseALF())
+    {
+      if (cAlfParam.cu_control_flag)
+      {
+        m_pcEntropyCoder->setAlfCtrl( true );
+        m_pcEntropyCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth);
+        if (pcSlice->getSymbolMode() == 0)
+        {
+          m_pcCavlcCoder->setAlfCtrl(true);
+          m_pcCavlcCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth); //D0201
+        }
+      }
+      else
+      {
+        m_pcEntropyCoder->setAlfCtrl(false);
+      }
+      m_pcEntropyCoder->encodeAlfParam(&cAlfParam);
+
+#if TSB_ALF_HEADER
+      if(cAlfParam.cu_control_flag)
+      {
+        m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam);
+      }
+#endif
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].freeALFParam(&cAlfParam);
+    }
+  }
+    
+    // File writing
+    m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream);
+    writeRBSPTrailingBits(nalu.m_Bitstream);
+    accessUnit.push_back(new NALUnitEBSP(nalu));
+    
+    UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
+    uiBoundingAddrSlice        = puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
+    uiBoundingAddrEntropySlice = puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
+    uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
+  } // end iteration over slices
+  
+  
+#if MTK_NONCROSS_INLOOP_FILTER
+  if(pcSlice->getSPS()->getUseALF())
+  {
+    if(m_pcAdaptiveLoopFilter[iPicSizeIdx].getUseNonCrossAlf())
+      m_pcAdaptiveLoopFilter[iPicSizeIdx].destroySlice();
+  }
+#endif 
+  
+#if AMVP_BUFFERCOMPRESS
+  pcPic->compressMotion(); 
+#endif 
+  
+  // Mark higher temporal layer pictures after switching point as unused
+  pcSlice->decodingTLayerSwitchingMarking( rcListPic );
+
+  //-- For time output for each slice
+  Double dEncTime = (double)(clock()-rcGOPPic.iBeforeTime) / CLOCKS_PER_SEC;
+  m_dLevelTime[pcPic->getPictureSizeIdx()] += dEncTime;
+
+  // the reconstruction is final, so the PSNR and the output resample each other rung of it once
+  pcPic->setReconMark   ( true );
+
+  const char* digestStr = NULL;
+  if (m_pcCfg->getPictureDigestEnabled())
+  {
+    /* calculate MD5sum for entire reconstructed picture */
+    SEIpictureDigest sei_recon_picture_digest;
+    sei_recon_picture_digest.method = SEIpictureDigest::MD5;
+    calcMD5(*pcPic->getPicYuvRec(), sei_recon_picture_digest.digest);
+    digestStr = digestToString(sei_recon_picture_digest.digest);
+
+    OutputNALUnit nalu(NAL_UNIT_SEI, NAL_REF_IDC_PRIORITY_LOWEST);
+
+    /* write the SEI messages */
+    m_pcEntropyCoder->setEntropyCoder(m_pcCavlcCoder, pcSlice);
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodeSEI(sei_recon_picture_digest);
+    writeRBSPTrailingBits(nalu.m_Bitstream);
+
+    /* insert the SEI message NALUnit before any Slice NALUnits */
+    AccessUnit::iterator it = find_if(accessUnit.begin(), accessUnit.end(), mem_fun(&NALUnit::isSlice));
+    accessUnit.insert(it, new NALUnitEBSP(nalu));
+  }
+
+  xCalculateAddPSNR( pcPic, accessUnit, dEncTime );
+  if (m_pcCfg->getPictureDigestEnabled())
+  {
+    SEIpictureDigest sei_recon_picture_digest;
+    sei_recon_picture_digest.method = SEIpictureDigest::MD5;
+    if (digestStr)
+      printf(" [MD5:%s]", digestStr);
+
+    digestStr = NULL;
+  }
+
+
+#if FIXED_ROUNDING_FRAME_MEMORY
+  /* TODO: this should happen after copyToPic(pcPicYuvRecOut) */
+  pcPic->getPicYuvRec(0)->xFixedRoundingPic();
+#endif
+  pcPic->getPicYuvRec(0)->copyToPic(pcPicYuvRecOut);
+  
+  // the reconstruction is final, interpolate it once for the fractional ME of the pictures referencing it
+  if ( m_pcCfg->getUseSubPelCache() && pcSlice->isReferenced() )
+  {
+    pcPic->getPicYuvRec()->extendPicBorder();
+    m_pcEncTop->getPredSearch()->interpolateSubPelPlanes( pcPic->getPicYuvRec() );
+  }
+  
+  m_bFirst = false;
+  m_iNumPicCoded++;
+
+  /* logging: insert a newline at end of picture period */
+  printf("\n");
+  fflush(stdout);
+}
+
 Void TEncGOP::xInitGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut )
 {
   assert( iNumPicRcvd > 0 );
@@ -1002,6 +1129,76 @@ static const char* nalUnitTypeToString(NalUnitType type)
 }
 #endif
 
+/** Select the rung of the resolution ladder for a picture.
+ * Odd switch types start at full resolution and move to the ResSwitchLevel rung at the switch frame,
+ * even switch types go the other way round.
+ */
+Int TEncGOP::xGetPictureSizeIdx( UInt uiPOCCurr )
+{
+  if ( m_pcCfg->getResSwitchMaxBitrate() > 0 )
+  {
+    return m_iAutoPicSizeIdx;
+  }
+
+  const Int  iLowLevel = (Int)m_pcCfg->getResSwitchLevel();
+  const Bool bDown     = ( m_pcCfg->getResSwitchType() & 0x01 ) != 0;
+
+  if ( uiPOCCurr >= m_pcCfg->getResSwitchFrameNum() )
+  {
+    return bDown ? iLowLevel : 0;
+  }
+  return bDown ? 0 : iLowLevel;
+}
+
+/** Rate-driven rung selection, called at the start of each GOP.
+ * The rate is measured over a window of max(GOPSize, RateGOPSize) inter pictures so that the QP cascade averages out;
+ * intra pictures are only counted in all-intra coding, as the cost of a refresh says little about the scene. Above the
+ * cap the encoder drops one rung. Below it, the rate of the rung above is predicted by scaling the measured rate with
+ * the ratio of the picture areas, and the encoder moves up if that stays below ARC_RATE_UP_MARGIN times the cap.
+ */
+Void TEncGOP::xUpdateAutoPicSizeIdx()
+{
+  const Int iType   = m_pcCfg->getIntraPeriod() == 1 ? 1 : 0;
+  const Int iWindow = max( m_pcCfg->getGOPSize(), m_pcCfg->getRateGOPSize() );
+  if ( m_aiGOPNumPic[iType] < iWindow )
+  {
+    return;
+  }
+
+  const Int    iNumPic  = m_aiGOPNumPic[0] + m_aiGOPNumPic[1];
+  const Double dPSNR    = m_dGOPPSNRSum / iNumPic;
+  const Double dRate    = (Double)m_auiGOPBits[iType] / m_aiGOPNumPic[iType] * m_pcCfg->getFrameRate();
+  const Double dMaxRate = (Double)m_pcCfg->getResSwitchMaxBitrate();
+
+  m_auiGOPBits[0]  = m_auiGOPBits[1]  = 0;
+  m_aiGOPNumPic[0] = m_aiGOPNumPic[1] = 0;
+  m_dGOPPSNRSum    = 0.0;
+
+  const Int iPrevIdx = m_iAutoPicSizeIdx;
+  if ( dRate > dMaxRate )
+  {
+    if ( m_iAutoPicSizeIdx < m_pcCfg->getNumPicResolutions() - 1 )
+    {
+      m_iAutoPicSizeIdx++;
+    }
+  }
+  else if ( m_iAutoPicSizeIdx > 0 )
+  {
+    const Int    iUp      = m_iAutoPicSizeIdx - 1;
+    const Double dAreaCur = (Double)m_pcCfg->getPicResolutionWidth( m_iAutoPicSizeIdx ) * m_pcCfg->getPicResolutionHeight( m_iAutoPicSizeIdx );
+    const Double dAreaUp  = (Double)m_pcCfg->getPicResolutionWidth( iUp ) * m_pcCfg->getPicResolutionHeight( iUp );
+    if ( dRate * dAreaUp / dAreaCur < ARC_RATE_UP_MARGIN * dMaxRate )
+    {
+      m_iAutoPicSizeIdx = iUp;
+    }
+  }
+
+  if ( m_iAutoPicSizeIdx != iPrevIdx )
+  {
+    printf("Resolution switch from rung %d to %d ( %.2f kbps, Y %6.4lf dB over the last %d pictures )\n", iPrevIdx, m_iAutoPicSizeIdx, dRate / 1000.0, dPSNR, iNumPic );
+  }
+}
+
 Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, const AccessUnit& accessUnit, Double dEncTime )
 {
   Int     x, y;
@@ -1013,8 +1210,15 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, const AccessUnit& accessUnit, D
   Double  dUPSNR[NUM_PIC_RESOLUTIONS]  = {0.0};
   Double  dVPSNR[NUM_PIC_RESOLUTIONS]  = {0.0};
   
+  Int iPicSizeIdx = pcPic->getPictureSizeIdx();
+
   //===== calculate PSNR =====
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+  // only the top level and the coded level are reported, other rungs would need an extra resampling each
+  for (int j=0; j<m_pcCfg->getNumPicResolutions(); ++j){
+    if ( j != 0 && j != iPicSizeIdx )
+    {
+      continue;
+    }
     Pel*  pOrg    = pcPic ->getPicYuvOrg(j)->getLumaAddr();
     Pel*  pRec    = pcPic->getPicYuvRec(j)->getLumaAddr();
     Int   iStride = pcPic->getPicYuvRec(j)->getStride();
@@ -1022,8 +1226,8 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, const AccessUnit& accessUnit, D
     Int   iWidth;
     Int   iHeight;
   
-    iWidth  = pcPic->getPicYuvRec(j)->getWidth () - (m_pcEncTop->getPad(0) >> j);
-    iHeight = pcPic->getPicYuvRec(j)->getHeight() - (m_pcEncTop->getPad(1) >> j);
+    iWidth  = pcPic->getPicYuvRec(j)->getWidth () - m_pcEncTop->getPad(0) * m_pcCfg->getPicResolutionNum(j) / m_pcCfg->getPicResolutionDen(j);
+    iHeight = pcPic->getPicYuvRec(j)->getHeight() - m_pcEncTop->getPad(1) * m_pcCfg->getPicResolutionNum(j) / m_pcCfg->getPicResolutionDen(j);
   
     Int   iSize   = iWidth*iHeight;
   
@@ -1093,13 +1297,17 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, const AccessUnit& accessUnit, D
   }
 
   unsigned uibits = numRBSPBytes * 8;
+
+  // feedback for the rate-driven resolution switching
+  const Int iType = pcPic->getSlice(0)->isIntra() ? 1 : 0;
+  m_auiGOPBits[iType] += uibits;
+  m_aiGOPNumPic[iType]++;
+  m_dGOPPSNRSum += dYPSNR[0];
 #if RVM_VCEGAM10
   m_vRVM_RP[pcPic->getPictureSizeIdx()].push_back( uibits );
   m_vRVM_RPTotal.push_back( uibits );
 #endif
 
-  Int iPicSizeIdx = pcPic->getPictureSizeIdx();
-
   //===== add PSNR =====
   m_gcAnalyzeAll.addResult (dYPSNR[0], dUPSNR[0], dVPSNR[0], (Double)uibits);
   m_gcAnalyzeAllMultiRes[iPicSizeIdx].addResult (dYPSNR[iPicSizeIdx], dUPSNR[iPicSizeIdx], dVPSNR[iPicSizeIdx], (Double)uibits);
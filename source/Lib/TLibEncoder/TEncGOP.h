@@ -47,6 +47,7 @@
 #include "../TLibCommon/TComBitCounter.h"
 #include "../TLibCommon/TComLoopFilter.h"
 #include "../TLibCommon/AccessUnit.h"
+#include "../TLibCommon/TComThreadPool.h"
 #include "TEncAdaptiveLoopFilter.h"
 #include "TEncSlice.h"
 #include "TEncEntropy.h"
@@ -65,8 +66,23 @@ class TEncTop;
 // Class definition
 // ====================================================================================================================
 
+/// picture of the GOP between its set-up and its writing
+struct TEncGOPPic
+{
+  TComPic*                pcPic;
+  TComPicYuv*             pcPicYuvRecOut;
+  AccessUnit*             pcAccessUnit;
+  TEncSlice*              pcSliceEncoder;                         ///< slice encoder compressing the picture
+  Int                     iPicSizeIdx;
+  long                    iBeforeTime;                            ///< clock() at the set-up
+  UInt*                   puiStoredStartCUAddrForEncodingSlice;
+  UInt*                   puiStoredStartCUAddrForEncodingEntropySlice;
+  UInt                    uiNumSlices;
+  TEncBinStore*           pcBinStores;                            ///< bins of each LCU recorded by the analysis
+};
+
 /// GOP encoder class
-class TEncGOP
+class TEncGOP : public TComThreadTask
 {
 private:
   //  Data
@@ -104,8 +120,12 @@ private:
   Bool                    m_bRefreshPending;
   UInt                    m_uiPOCCDR;
 #endif
-  UInt*                   m_uiStoredStartCUAddrForEncodingSlice;
-  UInt*                   m_uiStoredStartCUAddrForEncodingEntropySlice;
+  
+  // picture-parallel analysis
+  TEncGOPPic*             m_pcPicsInFlight;                       ///< pictures set up and not written yet
+  Int                     m_iMaxPicsInFlight;
+  Int                     m_iNumPicsInFlight;
+  TComThreadPool*         m_pcThreadPool;                         ///< threads compressing the pictures in flight
 
 // #if MTK_NONCROSS_INLOOP_FILTER
 //   UInt                    m_uiILSliceCount;
@@ -122,15 +142,22 @@ private:
   Bool                   m_bSPSSent;
 
   double                 m_dLevelTime[NUM_PIC_RESOLUTIONS];
+
+  // rate-driven resolution switching
+  Int                    m_iAutoPicSizeIdx;                      ///< rung chosen for the current GOP
+  UInt64                 m_auiGOPBits[2];                        ///< bits of the measurement window, 0: inter / 1: intra pictures
+  Int                    m_aiGOPNumPic[2];                       ///< number of pictures of the measurement window, 0: inter / 1: intra
+  Double                 m_dGOPPSNRSum;                          ///< sum of the full resolution luma PSNR of the measurement window
 public:
   TEncGOP();
   virtual ~TEncGOP();
   
-  Void  create      ( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight );
+  Void  create      ( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight, Int iMaxPicsInFlight );
   Void  destroy     ();
   
   Void  init        ( TEncTop* pcTEncTop );
   Void  compressGOP ( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRec, std::list<AccessUnit>& accessUnitsInGOP );
+  Void  runTask     ( Int iThreadIdx );                   ///< thread compressing one of the pictures in flight
   
   Int   getGOPSize()          { return  m_iGopSize;  }
   Int   getRateGOPSize()      { return  m_iRateGopSize;  }
@@ -147,6 +174,12 @@ public:
 protected:
   Void  xInitGOP          ( Int iPOC, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut );
   Void  xGetBuffer        ( TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, UInt uiPOCCurr );
+  Void  xInitPic          ( Int iPOCLast, Int iNumPicRcvd, Int iDepth, Int iTimeOffset, UInt uiColDir, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP, TEncGOPPic& rcGOPPic );
+  Void  xCompressPic      ( TEncGOPPic& rcGOPPic );
+  Void  xWritePic         ( TEncGOPPic& rcGOPPic, TComList<TComPic*>& rcListPic );
+  Void  xCompressAndWritePics( TComList<TComPic*>& rcListPic );
+  Int   xGetPictureSizeIdx( UInt uiPOCCurr );         ///< rung of the resolution ladder used to code picture uiPOCCurr
+  Void  xUpdateAutoPicSizeIdx();                      ///< choose the rung of the next GOP from the measured rate
   
 #if DCM_DECODING_REFRESH
   NalUnitType getNalUnitType( UInt uiPOCCurr );
@@ -55,49 +55,52 @@ TEncSbac::TEncSbac()
 , m_bAlfCtrl                  ( false )
 , m_uiCoeffCost               ( 0 )
 , m_uiMaxAlfCtrlDepth         ( 0 )
-, m_cCUSplitFlagSCModel       ( 1,             1,               NUM_SPLIT_FLAG_CTX            )
-, m_cCUSkipFlagSCModel        ( 1,             1,               NUM_SKIP_FLAG_CTX             )
-, m_cCUMergeFlagExtSCModel    ( 1,             1,               NUM_MERGE_FLAG_EXT_CTX        )
-, m_cCUMergeIdxExtSCModel     ( 1,             1,               NUM_MERGE_IDX_EXT_CTX         )
-, m_cCUPartSizeSCModel        ( 1,             1,               NUM_PART_SIZE_CTX             )
-, m_cCUPredModeSCModel        ( 1,             1,               NUM_PRED_MODE_CTX             )
-, m_cCUAlfCtrlFlagSCModel     ( 1,             1,               NUM_ALF_CTRL_FLAG_CTX         )
-, m_cCUIntraPredSCModel       ( 1,             1,               NUM_ADI_CTX                   )
+, m_iNumContextModels         ( 0 )
+, m_cCUSplitFlagSCModel       ( 1,             1,               NUM_SPLIT_FLAG_CTX,         m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUSkipFlagSCModel        ( 1,             1,               NUM_SKIP_FLAG_CTX,          m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUMergeFlagExtSCModel    ( 1,             1,               NUM_MERGE_FLAG_EXT_CTX,     m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUMergeIdxExtSCModel     ( 1,             1,               NUM_MERGE_IDX_EXT_CTX,      m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUPartSizeSCModel        ( 1,             1,               NUM_PART_SIZE_CTX,          m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUPredModeSCModel        ( 1,             1,               NUM_PRED_MODE_CTX,          m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUIntraPredSCModel       ( 1,             1,               NUM_ADI_CTX,                m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #if ADD_PLANAR_MODE
-, m_cPlanarFlagSCModel        ( 1,             1,               NUM_PLANARFLAG_CTX            )
+, m_cPlanarFlagSCModel        ( 1,             1,               NUM_PLANARFLAG_CTX,         m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #endif
-, m_cCUChromaPredSCModel      ( 1,             1,               NUM_CHROMA_PRED_CTX           )
-, m_cCUDeltaQpSCModel         ( 1,             1,               NUM_DELTA_QP_CTX              )
-, m_cCUInterDirSCModel        ( 1,             1,               NUM_INTER_DIR_CTX             )
-, m_cCURefPicSCModel          ( 1,             1,               NUM_REF_NO_CTX                )
-, m_cCUMvdSCModel             ( 1,             2,               NUM_MV_RES_CTX                )
-, m_cCUQtCbfSCModel           ( 1,             3,               NUM_QT_CBF_CTX                )
-, m_cCUTransSubdivFlagSCModel ( 1,             1,               NUM_TRANS_SUBDIV_FLAG_CTX     )
-, m_cCUQtRootCbfSCModel       ( 1,             1,               NUM_QT_ROOT_CBF_CTX           )
+, m_cCUChromaPredSCModel      ( 1,             1,               NUM_CHROMA_PRED_CTX,        m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUDeltaQpSCModel         ( 1,             1,               NUM_DELTA_QP_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUInterDirSCModel        ( 1,             1,               NUM_INTER_DIR_CTX,          m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCURefPicSCModel          ( 1,             1,               NUM_REF_NO_CTX,             m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUMvdSCModel             ( 1,             2,               NUM_MV_RES_CTX,             m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUQtCbfSCModel           ( 1,             3,               NUM_QT_CBF_CTX,             m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUTransSubdivFlagSCModel ( 1,             1,               NUM_TRANS_SUBDIV_FLAG_CTX,  m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUQtRootCbfSCModel       ( 1,             1,               NUM_QT_ROOT_CBF_CTX,        m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #if SIMPLE_CONTEXT_SIG
-, m_cCUSigSCModel             ( 4,             2,               NUM_SIG_FLAG_CTX              )
+, m_cCUSigSCModel             ( 4,             2,               NUM_SIG_FLAG_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #else
-, m_cCUSigSCModel             ( MAX_CU_DEPTH,  2,               NUM_SIG_FLAG_CTX              )
+, m_cCUSigSCModel             ( MAX_CU_DEPTH,  2,               NUM_SIG_FLAG_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #endif
 #if PCP_SIGMAP_SIMPLE_LAST
-, m_cCuCtxLastX               ( 1,             2,               NUM_CTX_LAST_FLAG_XY          )
-, m_cCuCtxLastY               ( 1,             2,               NUM_CTX_LAST_FLAG_XY          )
+, m_cCuCtxLastX               ( 1,             2,               NUM_CTX_LAST_FLAG_XY,       m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCuCtxLastY               ( 1,             2,               NUM_CTX_LAST_FLAG_XY,       m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #else
-, m_cCULastSCModel            ( MAX_CU_DEPTH,  2,               NUM_LAST_FLAG_CTX             )
+, m_cCULastSCModel            ( MAX_CU_DEPTH,  2,               NUM_LAST_FLAG_CTX,          m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #endif
-, m_cCUOneSCModel             ( 1,             2,               NUM_ONE_FLAG_CTX              )
-, m_cCUAbsSCModel             ( 1,             2,               NUM_ABS_FLAG_CTX              )
-, m_cMVPIdxSCModel            ( 1,             1,               NUM_MVP_IDX_CTX               )
-, m_cALFFlagSCModel           ( 1,             1,               NUM_ALF_FLAG_CTX              )
-, m_cALFUvlcSCModel           ( 1,             1,               NUM_ALF_UVLC_CTX              )
-, m_cALFSvlcSCModel           ( 1,             1,               NUM_ALF_SVLC_CTX              )
+, m_cCUOneSCModel             ( 1,             2,               NUM_ONE_FLAG_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUAbsSCModel             ( 1,             2,               NUM_ABS_FLAG_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cMVPIdxSCModel            ( 1,             1,               NUM_MVP_IDX_CTX,            m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cCUAlfCtrlFlagSCModel     ( 1,             1,               NUM_ALF_CTRL_FLAG_CTX,      m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cALFFlagSCModel           ( 1,             1,               NUM_ALF_FLAG_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cALFUvlcSCModel           ( 1,             1,               NUM_ALF_UVLC_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cALFSvlcSCModel           ( 1,             1,               NUM_ALF_SVLC_CTX,           m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #if MTK_SAO
-, m_cAOFlagSCModel            ( 1,             1,               NUM_AO_FLAG_CTX              )
-, m_cAOUvlcSCModel            ( 1,             1,               NUM_AO_UVLC_CTX              )
-, m_cAOSvlcSCModel            ( 1,             1,               NUM_AO_SVLC_CTX              )
+, m_cAOFlagSCModel            ( 1,             1,               NUM_AO_FLAG_CTX,            m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cAOUvlcSCModel            ( 1,             1,               NUM_AO_UVLC_CTX,            m_acContextModels + m_iNumContextModels, m_iNumContextModels )
+, m_cAOSvlcSCModel            ( 1,             1,               NUM_AO_SVLC_CTX,            m_acContextModels + m_iNumContextModels, m_iNumContextModels )
 #endif
 {
-  
+  assert( m_iNumContextModels <= MAX_NUM_CTX_MOD );
+  // the contexts saved and restored in RD end where the ones of the ALF control flags begin
+  m_iNumRDContextModels = Int( m_cCUAlfCtrlFlagSCModel.get( 0 ) - m_acContextModels );
 }
 
 TEncSbac::~TEncSbac()
@@ -353,6 +356,55 @@ Void  TEncSbac::store( TEncSbac* pDest)
 }
 
 
+/** Record the bins coded from now on in pcStore, with the CABAC engine of the coder; NULL stops recording.
+ * \param pcStore bins of the LCU being coded
+ */
+Void TEncSbac::setBinStore( TEncBinStore* pcStore )
+{
+  m_pcBinIf->getTEncBinCABAC()->setBinStore( pcStore, m_acContextModels );
+}
+
+/** Code bins recorded by setBinStore() in another coder, with the contexts of this coder.
+ * \param rcStore recorded bins
+ */
+Void TEncSbac::replayBins( const TEncBinStore& rcStore )
+{
+  const UInt* puiEntry = rcStore.empty() ? NULL : &rcStore[0];
+  const UInt* puiEnd   = puiEntry + rcStore.size();
+  
+  for( ; puiEntry < puiEnd; puiEntry++ )
+  {
+    UInt uiEntry = *puiEntry;
+    switch( uiEntry & 7 )
+    {
+      case BIN_STORE_CTX:
+        m_pcBinIf->encodeBin( ( uiEntry >> 3 ) & 1, m_acContextModels[ uiEntry >> 4 ] );
+        break;
+      case BIN_STORE_EP:
+        m_pcBinIf->encodeBinEP( ( uiEntry >> 3 ) & 1 );
+        break;
+      case BIN_STORE_TRM:
+        m_pcBinIf->encodeBinTrm( ( uiEntry >> 3 ) & 1 );
+        break;
+#if E057_INTRA_PCM
+      case BIN_STORE_PCM_CODE:
+        puiEntry++;
+        m_pcBinIf->xWritePCMCode( *puiEntry, uiEntry >> 4 );
+        break;
+      case BIN_STORE_PCM_ALIGN:
+        m_pcBinIf->encodePCMAlignBits();
+        break;
+      case BIN_STORE_RESET_BAC:
+        m_pcBinIf->resetBac();
+        break;
+#endif
+      default:
+        assert( 0 );
+        break;
+    }
+  }
+}
+
 Void TEncSbac::xCopyFrom( TEncSbac* pSrc )
 {
   m_pcBinIf->copyState( pSrc->m_pcBinIf );
@@ -360,34 +412,7 @@ Void TEncSbac::xCopyFrom( TEncSbac* pSrc )
   this->m_uiCoeffCost = pSrc->m_uiCoeffCost;
   this->m_uiLastQp    = pSrc->m_uiLastQp;
   
-  this->m_cCUSplitFlagSCModel      .copyFrom( &pSrc->m_cCUSplitFlagSCModel       );
-  this->m_cCUSkipFlagSCModel       .copyFrom( &pSrc->m_cCUSkipFlagSCModel        );
-  this->m_cCUMergeFlagExtSCModel  .copyFrom( &pSrc->m_cCUMergeFlagExtSCModel);
-  this->m_cCUMergeIdxExtSCModel   .copyFrom( &pSrc->m_cCUMergeIdxExtSCModel);
-  this->m_cCUPartSizeSCModel       .copyFrom( &pSrc->m_cCUPartSizeSCModel        );
-  this->m_cCUPredModeSCModel       .copyFrom( &pSrc->m_cCUPredModeSCModel        );
-  this->m_cCUIntraPredSCModel      .copyFrom( &pSrc->m_cCUIntraPredSCModel       );
-#if ADD_PLANAR_MODE
-  this->m_cPlanarFlagSCModel       .copyFrom( &pSrc->m_cPlanarFlagSCModel        );
-#endif
-  this->m_cCUChromaPredSCModel     .copyFrom( &pSrc->m_cCUChromaPredSCModel      );
-  this->m_cCUDeltaQpSCModel        .copyFrom( &pSrc->m_cCUDeltaQpSCModel         );
-  this->m_cCUInterDirSCModel       .copyFrom( &pSrc->m_cCUInterDirSCModel        );
-  this->m_cCURefPicSCModel         .copyFrom( &pSrc->m_cCURefPicSCModel          );
-  this->m_cCUMvdSCModel            .copyFrom( &pSrc->m_cCUMvdSCModel             );
-  this->m_cCUQtCbfSCModel          .copyFrom( &pSrc->m_cCUQtCbfSCModel           );
-  this->m_cCUTransSubdivFlagSCModel.copyFrom( &pSrc->m_cCUTransSubdivFlagSCModel );
-  this->m_cCUQtRootCbfSCModel      .copyFrom( &pSrc->m_cCUQtRootCbfSCModel       );
-  this->m_cCUSigSCModel            .copyFrom( &pSrc->m_cCUSigSCModel             );
-#if PCP_SIGMAP_SIMPLE_LAST
-  this->m_cCuCtxLastX              .copyFrom( &pSrc->m_cCuCtxLastX               );
-  this->m_cCuCtxLastY              .copyFrom( &pSrc->m_cCuCtxLastY               );
-#else
-  this->m_cCULastSCModel           .copyFrom( &pSrc->m_cCULastSCModel            );
-#endif
-  this->m_cCUOneSCModel            .copyFrom( &pSrc->m_cCUOneSCModel             );
-  this->m_cCUAbsSCModel            .copyFrom( &pSrc->m_cCUAbsSCModel             );
-  this->m_cMVPIdxSCModel           .copyFrom( &pSrc->m_cMVPIdxSCModel            );
+  ::memcpy( this->m_acContextModels, pSrc->m_acContextModels, sizeof(ContextModel) * m_iNumRDContextModels );
 }
 
 Void TEncSbac::codeMVPIdx ( TComDataCU* pcCU, UInt uiAbsPartIdx, RefPicList eRefList )
@@ -85,6 +85,10 @@ public:
   Void  resetBits              ()                { m_pcBinIf->resetBits(); m_pcBitIf->resetBits(); }
   UInt  getNumberOfWrittenBits ()                { return m_pcBinIf->getNumWrittenBits(); }
   //--SBAC RD
+  
+  // bins cached during compression
+  Void  setBinStore            ( TEncBinStore* pcStore );
+  Void  replayBins             ( const TEncBinStore& rcStore );
 
   Void  codeSPS                 ( TComSPS* pcSPS     );
   Void  codePPS                 ( TComPPS* pcPPS     );
@@ -192,13 +196,18 @@ public:
   TEncBinIf* getEncBinIf()  { return m_pcBinIf; }
 private:
   UInt                 m_uiLastQp;
+
+  // all context models of the coder, the ones of the CU syntax first: they are the ones saved and restored in RD
+  ContextModel         m_acContextModels[MAX_NUM_CTX_MOD];
+  Int                  m_iNumContextModels;
+  Int                  m_iNumRDContextModels;
+
   ContextModel3DBuffer m_cCUSplitFlagSCModel;
   ContextModel3DBuffer m_cCUSkipFlagSCModel;
   ContextModel3DBuffer m_cCUMergeFlagExtSCModel;
   ContextModel3DBuffer m_cCUMergeIdxExtSCModel;
   ContextModel3DBuffer m_cCUPartSizeSCModel;
   ContextModel3DBuffer m_cCUPredModeSCModel;
-  ContextModel3DBuffer m_cCUAlfCtrlFlagSCModel;
   ContextModel3DBuffer m_cCUIntraPredSCModel;
 #if ADD_PLANAR_MODE
   ContextModel3DBuffer m_cPlanarFlagSCModel;
@@ -224,6 +233,7 @@ private:
   
   ContextModel3DBuffer m_cMVPIdxSCModel;
   
+  ContextModel3DBuffer m_cCUAlfCtrlFlagSCModel;
   ContextModel3DBuffer m_cALFFlagSCModel;
   ContextModel3DBuffer m_cALFUvlcSCModel;
   ContextModel3DBuffer m_cALFSvlcSCModel;
@@ -222,16 +222,43 @@ const Bool bStarRefinementStop      = 0;
 const UInt uiStarRefinementRounds   = 2;  /* star refinement stop X rounds after best match (must be >=1) */  \
 
 
+/// evaluate one position at once
 __inline Void TEncSearch::xTZSearchHelp( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
 {
+  xTZSearchAdd  ( pcPatternKey, rcStruct, iSearchX, iSearchY, ucPointNr, uiDistance );
+  xTZSearchFlush( pcPatternKey, rcStruct );
+}
+
+/// queue one position, the queue is evaluated by xTZSearchFlush (or here once it is full)
+__inline Void TEncSearch::xTZSearchAdd( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
+{
+  if ( rcStruct.iNumCand == ME_MAX_CANDIDATES )
+  {
+    xTZSearchFlush( pcPatternKey, rcStruct );
+  }
+  Int i = rcStruct.iNumCand++;
+  rcStruct.aiCandX        [i] = iSearchX;
+  rcStruct.aiCandY        [i] = iSearchY;
+  rcStruct.aiCandOffset   [i] = iSearchY * rcStruct.iYStride + iSearchX;
+  rcStruct.aucCandPointNr [i] = ucPointNr;
+  rcStruct.auiCandDistance[i] = uiDistance;
+}
+
+/** Evaluate the queued positions with one multi-candidate SAD call.
+ * The best point is updated in queue order, so the result is the same as testing the positions one by one.
+ */
+Void TEncSearch::xTZSearchFlush( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct )
+{
+  UInt  auiSad[ME_MAX_CANDIDATES];
   UInt  uiSad;
   
-  Pel*  piRefSrch;
-  
-  piRefSrch = rcStruct.piRefY + iSearchY * rcStruct.iYStride + iSearchX;
+  if ( rcStruct.iNumCand == 0 )
+  {
+    return;
+  }
   
   //-- jclee for using the SAD function pointer
-  m_pcRdCost->setDistParam( pcPatternKey, piRefSrch, rcStruct.iYStride,  m_cDistParam );
+  m_pcRdCost->setDistParam( pcPatternKey, rcStruct.piRefY, rcStruct.iYStride,  m_cDistParam );
   
   // fast encoder decision: use subsampled SAD when rows > 8 for integer ME
   if ( m_pcEncCfg->getUseFastEnc() )
@@ -243,20 +270,24 @@ __inline Void TEncSearch::xTZSearchHelp( TComPattern* pcPatternKey, IntTZSearchS
   }
   
   // distortion
-  uiSad = m_cDistParam.DistFunc( &m_cDistParam );
+  m_cDistParam.DistFuncMulti( &m_cDistParam, rcStruct.aiCandOffset, rcStruct.iNumCand, auiSad );
   
-  // motion cost
-  uiSad += m_pcRdCost->getCost( iSearchX, iSearchY );
-  
-  if( uiSad < rcStruct.uiBestSad )
+  for ( Int i = 0; i < rcStruct.iNumCand; i++ )
   {
-    rcStruct.uiBestSad      = uiSad;
-    rcStruct.iBestX         = iSearchX;
-    rcStruct.iBestY         = iSearchY;
-    rcStruct.uiBestDistance = uiDistance;
-    rcStruct.uiBestRound    = 0;
-    rcStruct.ucPointNr      = ucPointNr;
+    // motion cost
+    uiSad = auiSad[i] + m_pcRdCost->getCost( rcStruct.aiCandX[i], rcStruct.aiCandY[i] );
+    
+    if( uiSad < rcStruct.uiBestSad )
+    {
+      rcStruct.uiBestSad      = uiSad;
+      rcStruct.iBestX         = rcStruct.aiCandX[i];
+      rcStruct.iBestY         = rcStruct.aiCandY[i];
+      rcStruct.uiBestDistance = rcStruct.auiCandDistance[i];
+      rcStruct.uiBestRound    = 0;
+      rcStruct.ucPointNr      = rcStruct.aucCandPointNr[i];
+    }
   }
+  rcStruct.iNumCand = 0;
 }
 
 __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB )
@@ -277,11 +308,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
     {
       if ( (iStartX - 1) >= iSrchRngHorLeft )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY, 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX - 1, iStartY, 0, 2 );
       }
       if ( (iStartY - 1) >= iSrchRngVerTop )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
       }
     }
       break;
@@ -291,11 +322,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
       {
         if ( (iStartX - 1) >= iSrchRngHorLeft )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
         }
         if ( (iStartX + 1) <= iSrchRngHorRight )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
         }
       }
     }
@@ -304,11 +335,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
     {
       if ( (iStartY - 1) >= iSrchRngVerTop )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
       }
       if ( (iStartX + 1) <= iSrchRngHorRight )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
       }
     }
       break;
@@ -318,11 +349,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
       {
         if ( (iStartY + 1) <= iSrchRngVerBottom )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
         }
         if ( (iStartY - 1) >= iSrchRngVerTop )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
         }
       }
     }
@@ -333,11 +364,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
       {
         if ( (iStartY - 1) >= iSrchRngVerTop )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
         }
         if ( (iStartY + 1) <= iSrchRngVerBottom )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
         }
       }
     }
@@ -346,11 +377,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
     {
       if ( (iStartX - 1) >= iSrchRngHorLeft )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY , 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX - 1, iStartY , 0, 2 );
       }
       if ( (iStartY + 1) <= iSrchRngVerBottom )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
       }
     }
       break;
@@ -360,11 +391,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
       {
         if ( (iStartX - 1) >= iSrchRngHorLeft )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
         }
         if ( (iStartX + 1) <= iSrchRngHorRight )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
         }
       }
     }
@@ -373,11 +404,11 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
     {
       if ( (iStartX + 1) <= iSrchRngHorRight )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
       }
       if ( (iStartY + 1) <= iSrchRngVerBottom )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
       }
     }
       break;
@@ -387,6 +418,8 @@ __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearc
     }
       break;
   } // switch( rcStruct.ucPointNr )
+  
+  xTZSearchFlush( pcPatternKey, rcStruct );
 }
 
 __inline Void TEncSearch::xTZ8PointSquareSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist )
@@ -410,38 +443,40 @@ __inline Void TEncSearch::xTZ8PointSquareSearch( TComPattern* pcPatternKey, IntT
   {
     if ( iLeft >= iSrchRngHorLeft ) // check top left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
     }
     // top middle
-    xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+    xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
     
     if ( iRight <= iSrchRngHorRight ) // check top right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
     }
   } // check top
   if ( iLeft >= iSrchRngHorLeft ) // check middle left
   {
-    xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+    xTZSearchAdd( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
   }
   if ( iRight <= iSrchRngHorRight ) // check middle right
   {
-    xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+    xTZSearchAdd( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
   }
   if ( iBottom <= iSrchRngVerBottom ) // check bottom
   {
     if ( iLeft >= iSrchRngHorLeft ) // check bottom left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
     }
     // check bottom middle
-    xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+    xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
     
     if ( iRight <= iSrchRngHorRight ) // check bottom right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
     }
   } // check bottom
+  
+  xTZSearchFlush( pcPatternKey, rcStruct );
 }
 
 __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist )
@@ -465,19 +500,19 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
   {
     if ( iTop >= iSrchRngVerTop ) // check top
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
     }
     if ( iLeft >= iSrchRngHorLeft ) // check middle left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
     }
     if ( iRight <= iSrchRngHorRight ) // check middle right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
     }
     if ( iBottom <= iSrchRngVerBottom ) // check bottom
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+      xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
     }
   }
   else // if (iDist != 1)
@@ -492,54 +527,54 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
       if (  iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iTop,      2, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,    iStartY,   4, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,   iStartY,   5, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iBottom,   7, iDist    );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX,  iTop,      2, iDist    );
+        xTZSearchAdd( pcPatternKey, rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iLeft,    iStartY,   4, iDist    );
+        xTZSearchAdd( pcPatternKey, rcStruct, iRight,   iStartY,   5, iDist    );
+        xTZSearchAdd( pcPatternKey, rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX,  iBottom,   7, iDist    );
       }
       else // check border
       {
         if ( iTop >= iSrchRngVerTop ) // check top
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
         }
         if ( iTop_2 >= iSrchRngVerTop ) // check half top
         {
           if ( iLeft_2 >= iSrchRngHorLeft ) // check half left
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
+            xTZSearchAdd( pcPatternKey, rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
           }
           if ( iRight_2 <= iSrchRngHorRight ) // check half right
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
+            xTZSearchAdd( pcPatternKey, rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
           }
         } // check half top
         if ( iLeft >= iSrchRngHorLeft ) // check left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
         }
         if ( iRight <= iSrchRngHorRight ) // check right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
         }
         if ( iBottom_2 <= iSrchRngVerBottom ) // check half bottom
         {
           if ( iLeft_2 >= iSrchRngHorLeft ) // check half left
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
+            xTZSearchAdd( pcPatternKey, rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
           }
           if ( iRight_2 <= iSrchRngHorRight ) // check half right
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
+            xTZSearchAdd( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
           }
         } // check half bottom
         if ( iBottom <= iSrchRngVerBottom ) // check bottom
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
         }
       } // check border
     }
@@ -548,39 +583,39 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
       if ( iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop,    0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,   iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,  iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iTop,    0, iDist );
+        xTZSearchAdd( pcPatternKey, rcStruct, iLeft,   iStartY, 0, iDist );
+        xTZSearchAdd( pcPatternKey, rcStruct, iRight,  iStartY, 0, iDist );
+        xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
         for ( Int index = 1; index < 4; index++ )
         {
           Int iPosYT = iTop    + ((iDist>>2) * index);
           Int iPosYB = iBottom - ((iDist>>2) * index);
           Int iPosXL = iStartX - ((iDist>>2) * index);
           Int iPosXR = iStartX + ((iDist>>2) * index);
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
         }
       }
       else // check border
       {
         if ( iTop >= iSrchRngVerTop ) // check top
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iTop, 0, iDist );
         }
         if ( iLeft >= iSrchRngHorLeft ) // check left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iLeft, iStartY, 0, iDist );
         }
         if ( iRight <= iSrchRngHorRight ) // check right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iRight, iStartY, 0, iDist );
         }
         if ( iBottom <= iSrchRngVerBottom ) // check bottom
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
+          xTZSearchAdd( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
         }
         for ( Int index = 1; index < 4; index++ )
         {
@@ -593,28 +628,30 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
           {
             if ( iPosXL >= iSrchRngHorLeft ) // check left
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
+              xTZSearchAdd( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
             }
             if ( iPosXR <= iSrchRngHorRight ) // check right
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
+              xTZSearchAdd( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
             }
           } // check top
           if ( iPosYB <= iSrchRngVerBottom ) // check bottom
           {
             if ( iPosXL >= iSrchRngHorLeft ) // check left
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
+              xTZSearchAdd( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
             }
             if ( iPosXR <= iSrchRngHorRight ) // check right
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
+              xTZSearchAdd( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
             }
           } // check bottom
         } // for ...
       } // check border
     } // iDist <= 8
   } // iDist == 1
+  
+  xTZSearchFlush( pcPatternKey, rcStruct );
 }
 
 #ifdef ROUNDING_CONTROL_BIPRED
@@ -686,6 +723,42 @@ UInt TEncSearch::xPatternRefinement    ( TComPattern* pcPatternKey, Pel* piRef,
   return uiDistBest;
 }
 
+/** Same as xPatternRefinement(), reading the candidates from the sub-pel planes of the reference picture.
+ * \param piRefY  integer position of the block in the reference picture (zero motion)
+ * \param iFrac   2 for the half-pel step, 1 for the quarter-pel step; rcMvFrac * iFrac is in quarter-pel units
+ */
+UInt TEncSearch::xPatternRefinementCache( TComPattern* pcPatternKey, TComPicYuv* pcPicYuvRef, Pel* piRefY, Int iRefStride, Int iFrac, TComMv& rcMvFrac )
+{
+  UInt  uiDist;
+  UInt  uiDistBest  = MAX_UINT;
+  UInt  uiDirecBest = 0;
+  
+  m_pcRdCost->setDistParam( pcPatternKey, piRefY, iRefStride, 1, m_cDistParam, m_pcEncCfg->getUseHADME() );
+  
+  TComMv* pcMvRefine = (iFrac == 2 ? s_acMvRefineH : s_acMvRefineQ);
+  
+  for (UInt i = 0; i < 9; i++)
+  {
+    TComMv cMvTest = pcMvRefine[i];
+    cMvTest += rcMvFrac;
+    Int iQx = cMvTest.getHor() * iFrac;
+    Int iQy = cMvTest.getVer() * iFrac;
+    m_cDistParam.pCur = pcPicYuvRef->getSubPelLumaAddr( ( ( iQy & 3 ) << 2 ) + ( iQx & 3 ), piRefY + ( iQx >> 2 ) + ( iQy >> 2 ) * iRefStride );
+    uiDist = m_cDistParam.DistFunc( &m_cDistParam );
+    uiDist += m_pcRdCost->getCost( cMvTest.getHor(), cMvTest.getVer() );
+    
+    if ( uiDist < uiDistBest )
+    {
+      uiDistBest  = uiDist;
+      uiDirecBest = i;
+    }
+  }
+  
+  rcMvFrac = pcMvRefine[uiDirecBest];
+  
+  return uiDistBest;
+}
+
 Void
 TEncSearch::xEncSubdivCbfQT( TComDataCU*  pcCU,
                             UInt         uiTrDepth,
@@ -1713,32 +1786,29 @@ TEncSearch::estIntraPredQT( TComDataCU* pcCU,
     }
     CandNum = 0;
     
-#if ADD_PLANAR_MODE
-    UInt uiHdModeList[NUM_INTRA_MODE];
-    uiHdModeList[0] = PLANAR_IDX;
-    for( Int i=1; i < uiMaxMode; i++) uiHdModeList[i] = i-1;
-
-    for( Int iMode = Int(uiMaxModeFast); iMode < Int(uiMaxMode); iMode++ )
+    if ( m_pcEncCfg->getUseFastIntra() && uiMaxModeFast == 0 && g_aucIntraModeNumAng[uiWidthBit] > 5 )
     {
-      UInt uiMode = uiHdModeList[iMode];
-#else
-    for( UInt uiMode = uiMaxModeFast; uiMode < uiMaxMode; uiMode++ )
+      CandNum = xPreselectIntraModes( pcCU, uiPU, uiPartOffset, uiDepth, uiInitTrDepth, piOrg, piPred, uiStride, uiWidth, uiHeight,
+                                      bAboveAvail, bLeftAvail, uiFastCandNum, CandModeList, CandCostList );
+    }
+    else
     {
-#endif
-#if (!REFERENCE_SAMPLE_PADDING)
-      if ( !predIntraLumaDirAvailable( uiMode, uiWidthBit, bAboveAvail, bLeftAvail ) )
-        continue;
-#endif
-
-      predIntraLumaAng( pcCU->getPattern(), uiMode, piPred, uiStride, uiWidth, uiHeight, pcCU, bAboveAvail, bLeftAvail );
-      
-      // use hadamard transform here
-      UInt uiSad = m_pcRdCost->calcHAD( piOrg, uiStride, piPred, uiStride, uiWidth, uiHeight );
-      
-      UInt   iModeBits = xModeBitsIntra( pcCU, uiMode, uiPU, uiPartOffset, uiDepth, uiInitTrDepth );
-      Double cost      = (Double)uiSad + (Double)iModeBits * m_pcRdCost->getSqrtLambda();
+#if ADD_PLANAR_MODE
+      UInt uiHdModeList[NUM_INTRA_MODE];
+      uiHdModeList[0] = PLANAR_IDX;
+      for( Int i=1; i < uiMaxMode; i++) uiHdModeList[i] = i-1;
       
-      CandNum += xUpdateCandList( uiMode, cost, uiFastCandNum, CandModeList, CandCostList );
+      for( Int iMode = Int(uiMaxModeFast); iMode < Int(uiMaxMode); iMode++ )
+      {
+        UInt uiMode = uiHdModeList[iMode];
+#else
+      for( UInt uiMode = uiMaxModeFast; uiMode < uiMaxMode; uiMode++ )
+      {
+#endif
+        Double cost = xGetIntraModeCostHAD( pcCU, uiMode, uiPU, uiPartOffset, uiDepth, uiInitTrDepth, piOrg, piPred, uiStride, uiWidth, uiHeight, bAboveAvail, bLeftAvail );
+        
+        CandNum += xUpdateCandList( uiMode, cost, uiFastCandNum, CandModeList, CandCostList );
+      }
     }
     UInt uiRdModeList[FAST_UDI_MAX_RDMODE_NUM];
     UInt uiNewMaxMode;
@@ -1747,6 +1817,16 @@ TEncSearch::estIntraPredQT( TComDataCU* pcCU,
     if(uiFastCandNum!=uiMaxMode)
     {
       uiNewMaxMode = min( uiFastCandNum, CandNum );
+      if ( m_pcEncCfg->getUseFastIntra() )
+      {
+        // only the candidates close to the best one go to the RD check
+        UInt uiNumClose = min<UInt>( 1, uiNewMaxMode );
+        while ( uiNumClose < uiNewMaxMode && CandCostList[ uiNumClose ] <= FAST_INTRA_RD_THRES * CandCostList[ 0 ] )
+        {
+          uiNumClose++;
+        }
+        uiNewMaxMode = uiNumClose;
+      }
       for( Int i = 0; i < uiNewMaxMode; i++)
       {
         uiRdModeList[i] = CandModeList[i];
@@ -3492,8 +3572,9 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
                             pcYuv->getStride(),
                             0, 0, 0, 0 );
   
-  Pel*        piRefY      = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->getPicYuvRec(iPicSizeIdx)->getLumaAddr( pcCU->getAddr(), pcCU->getZorderIdxInCU() + uiPartAddr );
-  Int         iRefStride  = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->getPicYuvRec(iPicSizeIdx)->getStride();
+  TComPicYuv* pcPicYuvRef = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->getPicYuvRec(iPicSizeIdx);
+  Pel*        piRefY      = pcPicYuvRef->getLumaAddr( pcCU->getAddr(), pcCU->getZorderIdxInCU() + uiPartAddr );
+  Int         iRefStride  = pcPicYuvRef->getStride();
   
   TComMv      cMvPred = *pcMvPred;
   
@@ -3547,6 +3628,11 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   }
   else
 #endif
+  if ( pcPicYuvRef->getSubPelValid() )
+  {
+    xPatternSearchFracCache( pcPatternKey, pcPicYuvRef, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost );
+  }
+  else
   {
     xPatternSearchFracDIF( pcCU, pcPatternKey, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost );
   }
@@ -3651,7 +3737,8 @@ Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRe
   Int   iBestX = 0;
   Int   iBestY = 0;
   
-  Pel*  piRefSrch;
+  Int   aiOffset[ME_MAX_CANDIDATES];
+  UInt  auiSad  [ME_MAX_CANDIDATES];
   
   //-- jclee for using the SAD function pointer
   m_pcRdCost->setDistParam( pcPatternKey, piRefY, iRefStride,  m_cDistParam );
@@ -3668,21 +3755,29 @@ Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRe
   piRefY += (iSrchRngVerTop * iRefStride);
   for ( Int y = iSrchRngVerTop; y <= iSrchRngVerBottom; y++ )
   {
-    for ( Int x = iSrchRngHorLeft; x <= iSrchRngHorRight; x++ )
+    // evaluate the row in groups of up to ME_MAX_CANDIDATES positions
+    m_cDistParam.pCur = piRefY;
+    for ( Int x0 = iSrchRngHorLeft; x0 <= iSrchRngHorRight; x0 += ME_MAX_CANDIDATES )
     {
-      //  find min. distortion position
-      piRefSrch = piRefY + x;
-      m_cDistParam.pCur = piRefSrch;
-      uiSad = m_cDistParam.DistFunc( &m_cDistParam );
-      
-      // motion cost
-      uiSad += m_pcRdCost->getCost( x, y );
+      Int iNumCand = min( ME_MAX_CANDIDATES, iSrchRngHorRight - x0 + 1 );
+      for ( Int i = 0; i < iNumCand; i++ )
+      {
+        aiOffset[i] = x0 + i;
+      }
+      m_cDistParam.DistFuncMulti( &m_cDistParam, aiOffset, iNumCand, auiSad );
       
-      if ( uiSad < uiSadBest )
+      //  find min. distortion position
+      for ( Int i = 0; i < iNumCand; i++ )
       {
-        uiSadBest = uiSad;
-        iBestX    = x;
-        iBestY    = y;
+        // motion cost
+        uiSad = auiSad[i] + m_pcRdCost->getCost( x0 + i, y );
+        
+        if ( uiSad < uiSadBest )
+        {
+          uiSadBest = uiSad;
+          iBestX    = x0 + i;
+          iBestY    = y;
+        }
       }
     }
     piRefY += iRefStride;
@@ -3728,6 +3823,7 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
   cStruct.iYStride    = iRefStride;
   cStruct.piRefY      = piRefY;
   cStruct.uiBestSad   = MAX_UINT;
+  cStruct.iNumCand    = 0;
   
   // set rcMv (Median predictor) as start point and as best point
   xTZSearchHelp( pcPatternKey, cStruct, rcMv.getHor(), rcMv.getVer(), 0, 0 );
@@ -3806,9 +3902,10 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
     {
       for ( iStartX = iSrchRngHorLeft; iStartX <= iSrchRngHorRight; iStartX += iRaster )
       {
-        xTZSearchHelp( pcPatternKey, cStruct, iStartX, iStartY, 0, iRaster );
+        xTZSearchAdd( pcPatternKey, cStruct, iStartX, iStartY, 0, iRaster );
       }
     }
+    xTZSearchFlush( pcPatternKey, cStruct );
   }
   
   // raster refinement
@@ -3961,6 +4058,23 @@ Void TEncSearch::xPatternSearchFracDIF( TComDataCU* pcCU, TComPattern* pcPattern
   
 }
 
+/** Half and quarter-pel refinement on the sub-pel planes of the reference picture, same decisions as
+ *  xPatternSearchFracDIF() without interpolating around the block.
+ */
+Void TEncSearch::xPatternSearchFracCache( TComPattern* pcPatternKey, TComPicYuv* pcPicYuvRef, Pel* piRefY, Int iRefStride, TComMv* pcMvInt, TComMv& rcMvHalf, TComMv& rcMvQter, UInt& ruiCost )
+{
+  //  Half-pel refinement
+  rcMvHalf = *pcMvInt;   rcMvHalf <<= 1;    // for mv-cost
+  ruiCost = xPatternRefinementCache( pcPatternKey, pcPicYuvRef, piRefY, iRefStride, 2, rcMvHalf );
+  
+  m_pcRdCost->setCostScale( 0 );
+  
+  //  Quater-pel refinement
+  rcMvQter = *pcMvInt;   rcMvQter <<= 1;    // for mv-cost
+  rcMvQter += rcMvHalf;  rcMvQter <<= 1;
+  ruiCost = xPatternRefinementCache( pcPatternKey, pcPicYuvRef, piRefY, iRefStride, 1, rcMvQter );
+}
+
 Void TEncSearch::predInterSkipSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*& rpcPredYuv, TComYuv*& rpcResiYuv, TComYuv*& rpcRecoYuv )
 {
   SliceType eSliceType = pcCU->getSlice()->getSliceType();
@@ -4861,6 +4975,146 @@ UInt TEncSearch::xUpdateCandList( UInt uiMode, Double uiCost, UInt uiFastCandNum
   return 0;
 }
 
+/** Hadamard cost of a luma intra mode, which ranks the modes before the RD check.
+ * The reference samples prepared by initAdiPattern() for the PU are shared by all modes.
+ * \returns cost, MAX_DOUBLE if the mode is not available
+ */
+Double TEncSearch::xGetIntraModeCostHAD( TComDataCU* pcCU, UInt uiMode, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth,
+                                         Pel* piOrg, Pel* piPred, UInt uiStride, UInt uiWidth, UInt uiHeight, Bool bAboveAvail, Bool bLeftAvail )
+{
+#if (!REFERENCE_SAMPLE_PADDING)
+  if ( !predIntraLumaDirAvailable( uiMode, pcCU->getIntraSizeIdx(0), bAboveAvail, bLeftAvail ) )
+    return MAX_DOUBLE;
+#endif
+  
+  predIntraLumaAng( pcCU->getPattern(), uiMode, piPred, uiStride, uiWidth, uiHeight, pcCU, bAboveAvail, bLeftAvail );
+  
+  // use hadamard transform here
+  UInt uiSad = m_pcRdCost->calcHAD( piOrg, uiStride, piPred, uiStride, uiWidth, uiHeight );
+  
+  UInt   iModeBits = xModeBitsIntra( pcCU, uiMode, uiPU, uiPartOffset, uiDepth, uiInitTrDepth );
+  return (Double)uiSad + (Double)iModeBits * m_pcRdCost->getSqrtLambda();
+}
+
+/** Hierarchical selection of the luma intra modes for the RD check.
+ * Planar, DC, the most probable modes and every 4th angle (every 2nd for 4x4) are checked first, then the angles at
+ * half the distance around the best angle so far, down to the direct neighbours.
+ * \returns number of candidates in CandModeList
+ */
+UInt TEncSearch::xPreselectIntraModes( TComDataCU* pcCU, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth,
+                                       Pel* piOrg, Pel* piPred, UInt uiStride, UInt uiWidth, UInt uiHeight, Bool bAboveAvail, Bool bLeftAvail,
+                                       UInt uiFastCandNum, UInt* CandModeList, Double* CandCostList )
+{
+  UInt    uiNumAngModes = g_aucIntraModeNumAng[ pcCU->getIntraSizeIdx(0) ];
+  UInt    uiCandNum     = 0;
+  Bool    abChecked[ NUM_INTRA_MODE ];
+  Int     aiAngIdx [ NUM_INTRA_MODE ];
+  ::memset( abChecked, 0, sizeof( abChecked ) );
+  
+  //--- angular modes sorted by angle, from HOR+8 over HOR-7 and VER-8 to VER+8 ---
+  Int     aiAngMode[ 33 ];
+  Double  adAngCost[ 33 ];
+  Int     iNumAng = 0;
+  {
+    Int aiModeAtPos[ 33 ];
+    for ( Int i = 0; i < 33; i++ )
+    {
+      aiModeAtPos[ i ] = -1;
+    }
+    for ( UInt uiMode = 0; uiMode < uiNumAngModes; uiMode++ )
+    {
+      UInt uiOrder = g_aucAngIntraModeOrder[ uiMode ];
+      if ( uiOrder > 0 )
+      {
+        aiModeAtPos[ uiOrder >= 18 ? 33 - uiOrder : 15 + uiOrder ] = uiMode;
+      }
+    }
+    for ( Int i = 0; i < NUM_INTRA_MODE; i++ )
+    {
+      aiAngIdx[ i ] = -1;
+    }
+    for ( Int i = 0; i < 33; i++ )
+    {
+      if ( aiModeAtPos[ i ] >= 0 )
+      {
+        aiAngIdx [ aiModeAtPos[ i ] ] = iNumAng;
+        aiAngMode[ iNumAng ] = aiModeAtPos[ i ];
+        adAngCost[ iNumAng ] = MAX_DOUBLE;
+        iNumAng++;
+      }
+    }
+  }
+  
+  //--- coarse pass ---
+  Int     iStep = iNumAng > 16 ? 4 : 2;
+  UInt    auiModes[ NUM_INTRA_MODE ];
+  UInt    uiNumModes = 0;
+  Int     aiPreds[2] = { -1, -1 };
+  Int     iNumPreds  = pcCU->getIntraDirLumaPredictor( uiPartOffset, aiPreds );
+  
+  auiModes[ uiNumModes++ ] = PLANAR_IDX;
+  auiModes[ uiNumModes++ ] = 2;
+  for ( Int j = 0; j < iNumPreds; j++ )
+  {
+    if ( aiPreds[ j ] >= 0 && aiPreds[ j ] < (Int)uiNumAngModes )
+    {
+      auiModes[ uiNumModes++ ] = aiPreds[ j ];
+    }
+  }
+  for ( Int i = 0; i < iNumAng; i += iStep )
+  {
+    auiModes[ uiNumModes++ ] = aiAngMode[ i ];
+  }
+  auiModes[ uiNumModes++ ] = aiAngMode[ iNumAng-1 ];
+  
+  while ( true )
+  {
+    for ( UInt ui = 0; ui < uiNumModes; ui++ )
+    {
+      UInt uiMode = auiModes[ ui ];
+      if ( abChecked[ uiMode ] )
+      {
+        continue;
+      }
+      abChecked[ uiMode ] = true;
+      
+      Double dCost = xGetIntraModeCostHAD( pcCU, uiMode, uiPU, uiPartOffset, uiDepth, uiInitTrDepth, piOrg, piPred, uiStride, uiWidth, uiHeight, bAboveAvail, bLeftAvail );
+      uiCandNum   += xUpdateCandList( uiMode, dCost, uiFastCandNum, CandModeList, CandCostList );
+      if ( aiAngIdx[ uiMode ] >= 0 )
+      {
+        adAngCost[ aiAngIdx[ uiMode ] ] = dCost;
+      }
+    }
+    
+    iStep >>= 1;
+    if ( iStep == 0 )
+    {
+      break;
+    }
+    
+    //--- refinement around the best angle ---
+    Int iBest = 0;
+    for ( Int i = 1; i < iNumAng; i++ )
+    {
+      if ( adAngCost[ i ] < adAngCost[ iBest ] )
+      {
+        iBest = i;
+      }
+    }
+    uiNumModes = 0;
+    if ( iBest - iStep >= 0 )
+    {
+      auiModes[ uiNumModes++ ] = aiAngMode[ iBest - iStep ];
+    }
+    if ( iBest + iStep < iNumAng )
+    {
+      auiModes[ uiNumModes++ ] = aiAngMode[ iBest + iStep ];
+    }
+  }
+  
+  return uiCandNum;
+}
+
 /** add inter-prediction syntax elements for a CU block
  * \param pcCU
  * \param uiQp
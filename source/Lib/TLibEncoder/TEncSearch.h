@@ -52,6 +52,12 @@
 
 class TEncCu;
 
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+#define ME_MAX_CANDIDATES           16          ///< integer ME positions evaluated by one multi-candidate SAD call
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -126,6 +132,7 @@ protected:
 #endif
   
   UInt  xPatternRefinement( TComPattern* pcPatternKey, Pel* piRef, Int iRefStride, Int iIntStep, Int iFrac, TComMv& rcMvFrac );
+  UInt  xPatternRefinementCache( TComPattern* pcPatternKey, TComPicYuv* pcPicYuvRef, Pel* piRefY, Int iRefStride, Int iFrac, TComMv& rcMvFrac );
   
 #if (!REFERENCE_SAMPLE_PADDING)
   Bool predIntraLumaDirAvailable( UInt uiMode, UInt uiWidthBit, Bool bAboveAvail, Bool bLeftAvail);
@@ -141,10 +148,19 @@ protected:
     UInt  uiBestDistance;
     UInt  uiBestSad;
     UChar ucPointNr;
+    // candidates waiting for xTZSearchFlush
+    Int   iNumCand;
+    Int   aiCandX       [ME_MAX_CANDIDATES];
+    Int   aiCandY       [ME_MAX_CANDIDATES];
+    Int   aiCandOffset  [ME_MAX_CANDIDATES];
+    UChar aucCandPointNr[ME_MAX_CANDIDATES];
+    UInt  auiCandDistance[ME_MAX_CANDIDATES];
   } IntTZSearchStruct;
   
   // sub-functions for ME
   __inline Void xTZSearchHelp         ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  __inline Void xTZSearchAdd          ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  Void          xTZSearchFlush        ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct );
   __inline Void xTZ2PointSearch       ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB );
   __inline Void xTZ8PointSquareSearch ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
   __inline Void xTZ8PointDiamondSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
@@ -196,6 +212,7 @@ public:
   
   /// set ME search range
   Void setAdaptiveSearchRange   ( Int iDir, Int iRefIdx, Int iSearchRange) { m_aaiAdaptSR[iDir][iRefIdx] = iSearchRange; }
+  Int  getAdaptiveSearchRange   ( Int iDir, Int iRefIdx )                  { return m_aaiAdaptSR[iDir][iRefIdx]; }
   
 #if E057_INTRA_PCM
   Void xEncPCM    (TComDataCU* pcCU, UInt uiAbsPartIdx, Pel* piOrg, Pel* piPCM, Pel* piPred, Pel* piResi, Pel* piReco, UInt uiStride, UInt uiWidth, UInt uiHeight, TextType eText);
@@ -414,6 +431,15 @@ protected:
                                     UInt&         ruiCost 
                                    );
   
+  Void xPatternSearchFracCache    ( TComPattern*  pcPatternKey,
+                                    TComPicYuv*   pcPicYuvRef,
+                                    Pel*          piRefY,
+                                    Int           iRefStride,
+                                    TComMv*       pcMvInt,
+                                    TComMv&       rcMvHalf,
+                                    TComMv&       rcMvQter,
+                                    UInt&         ruiCost );
+  
   Void xExtDIFUpSamplingH         ( TComPattern*  pcPattern, TComYuv* pcYuvExt  );
   
   Void xExtDIFUpSamplingQ         ( TComPattern* pcPatternKey,
@@ -440,6 +466,13 @@ protected:
   
   UInt  xModeBitsIntra ( TComDataCU* pcCU, UInt uiMode, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth );
   UInt  xUpdateCandList( UInt uiMode, Double uiCost, UInt uiFastCandNum, UInt * CandModeList, Double * CandCostList );
+  Double xGetIntraModeCostHAD( TComDataCU* pcCU, UInt uiMode, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth,
+                               Pel* piOrg, Pel* piPred, UInt uiStride, UInt uiWidth, UInt uiHeight, Bool bAboveAvail, Bool bLeftAvail );
+  
+  /// fast intra mode decision, the RD candidates of a PU from a hierarchical search over the angles
+  UInt  xPreselectIntraModes( TComDataCU* pcCU, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth,
+                              Pel* piOrg, Pel* piPred, UInt uiStride, UInt uiWidth, UInt uiHeight, Bool bAboveAvail, Bool bLeftAvail,
+                              UInt uiFastCandNum, UInt* CandModeList, Double* CandCostList );
   
   // -------------------------------------------------------------------------------------------------------------------
   // compute symbol bits
@@ -52,28 +52,33 @@ TEncSlice::TEncSlice()
   m_pdRdPicLambda = NULL;
   m_pdRdPicQp     = NULL;
   m_piRdPicQp     = NULL;
+  
+  m_pcThreadPool        = NULL;
+  m_pcCuWorkers         = NULL;
+  m_pcRowSbacCoders     = NULL;
+  m_pcRowBinCoderCABACs = NULL;
+  m_pcWavefrontPic      = NULL;
+  m_pcBinStores         = NULL;
 }
 
 TEncSlice::~TEncSlice()
 {
 }
 
-Void TEncSlice::create( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth )
+Void TEncSlice::create( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth, Int iPicSizeIdx )
 {
   // create prediction picture
-  for (int i=0; i<NUM_PIC_RESOLUTIONS; ++i){
-    if ( m_apcPicYuvPred[i] == NULL )
-    {
-      m_apcPicYuvPred[i]  = new TComPicYuv;
-      m_apcPicYuvPred[i]->create( iWidth >> i, iHeight >> i, iMaxCUWidth, iMaxCUHeight, uhTotalDepth );
-    }
-  
-    // create residual picture
-    if( m_apcPicYuvResi[i] == NULL )
-    {
-      m_apcPicYuvResi[i]  = new TComPicYuv;
-      m_apcPicYuvResi[i]->create( iWidth >> i, iHeight >> i, iMaxCUWidth, iMaxCUHeight, uhTotalDepth );
-    }
+  if ( m_apcPicYuvPred[iPicSizeIdx] == NULL )
+  {
+    m_apcPicYuvPred[iPicSizeIdx]  = new TComPicYuv;
+    m_apcPicYuvPred[iPicSizeIdx]->create( iWidth, iHeight, iMaxCUWidth, iMaxCUHeight, uhTotalDepth );
+  }
+
+  // create residual picture
+  if( m_apcPicYuvResi[iPicSizeIdx] == NULL )
+  {
+    m_apcPicYuvResi[iPicSizeIdx]  = new TComPicYuv;
+    m_apcPicYuvResi[iPicSizeIdx]->create( iWidth, iHeight, iMaxCUWidth, iMaxCUHeight, uhTotalDepth );
   }
 }
 
@@ -101,6 +106,11 @@ Void TEncSlice::destroy()
   if ( m_pdRdPicLambda ) { xFree( m_pdRdPicLambda ); m_pdRdPicLambda = NULL; }
   if ( m_pdRdPicQp     ) { xFree( m_pdRdPicQp     ); m_pdRdPicQp     = NULL; }
   if ( m_piRdPicQp     ) { xFree( m_piRdPicQp     ); m_piRdPicQp     = NULL; }
+  
+  // free wavefront row contexts
+  if ( m_pcRowSbacCoders     ) { delete [] m_pcRowSbacCoders;     m_pcRowSbacCoders     = NULL; }
+  if ( m_pcRowBinCoderCABACs ) { delete [] m_pcRowBinCoderCABACs; m_pcRowBinCoderCABACs = NULL; }
+  m_cWavefront.destroy();
 }
 
 Void TEncSlice::init( TEncTop* pcEncTop )
@@ -127,6 +137,49 @@ Void TEncSlice::init( TEncTop* pcEncTop )
   m_pdRdPicLambda     = (Double*)xMalloc( Double, m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_pdRdPicQp         = (Double*)xMalloc( Double, m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_piRdPicQp         = (Int*   )xMalloc( Int,    m_pcCfg->getDeltaQpRD() * 2 + 1 );
+  
+  // row contexts for wavefront-parallel analysis, sized for the largest rung
+  m_pcThreadPool      = pcEncTop->getThreadPool();
+  m_pcCuWorkers       = pcEncTop->getCuWorkers();
+  if ( m_pcCfg->getWaveFrontThreads() > 0 )
+  {
+    Int iMaxRows = 0;
+    for ( Int i = 0; i < m_pcCfg->getNumPicResolutions(); i++ )
+    {
+      iMaxRows = max( iMaxRows, (Int)( ( m_pcCfg->getPicResolutionHeight(i) + g_uiMaxCUHeight - 1 ) / g_uiMaxCUHeight ) );
+    }
+    m_cWavefront.create( iMaxRows );
+    m_pcRowSbacCoders     = new TEncSbac    [ iMaxRows ];
+    m_pcRowBinCoderCABACs = new TEncBinCABAC[ iMaxRows ];
+    for ( Int i = 0; i < iMaxRows; i++ )
+    {
+      m_pcRowSbacCoders[i].init( &m_pcRowBinCoderCABACs[i] );
+    }
+  }
+}
+
+/** Set the slice encoder up to compress pictures with the tools of a worker instead of the shared ones.
+ * Pictures analysed this way are written by the slice encoder of pcEncTop.
+ * \param pcEncTop  encoder holding the configuration
+ * \param pcWorker  CU analysis tools owned by this slice encoder
+ */
+Void TEncSlice::init( TEncTop* pcEncTop, TEncCuWorker* pcWorker )
+{
+  init( pcEncTop );
+  
+  m_pcCuEncoder       = pcWorker->getCuEncoder();
+  m_pcPredSearch      = pcWorker->getPredSearch();
+  
+  m_pcEntropyCoder    = pcWorker->getEntropyCoder();
+  m_pcCavlcCoder      = NULL;
+  m_pcSbacCoder       = pcWorker->getSbacCoder();
+  m_pcBinCABAC        = pcWorker->getBinCABAC();
+  m_pcTrQuant         = pcWorker->getTrQuant();
+  
+  m_pcBitCounter      = pcWorker->getBitCounter();
+  m_pcRdCost          = pcWorker->getRdCost();
+  m_pppcRDSbacCoder   = pcWorker->getRDSbacCoder();
+  m_pcRDGoOnSbacCoder = pcWorker->getRDGoOnSbacCoder();
 }
 
 /**
@@ -443,6 +496,25 @@ Void TEncSlice::setSearchRange( TComSlice* pcSlice )
   }
 }
 
+/** Resample the original and the reference motion the analysis of a picture would otherwise resample on first use.
+ * Afterwards compressSlice() only reads pictures other than pcPic, so that they can be shared between threads.
+ * \param pcPic  picture whose reference lists are set
+ */
+Void TEncSlice::resamplePictureData( TComPic* pcPic )
+{
+  TComSlice* pcSlice     = pcPic->getSlice(0);
+  Int        iPicSizeIdx = pcSlice->getPPS()->getPictureSizeIdx();
+  
+  pcPic->getPicYuvOrg();
+  for ( Int iDir = 0; iDir < 2; iDir++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( (RefPicList)iDir ); iRefIdx++ )
+    {
+      pcSlice->getRefPic( (RefPicList)iDir, iRefIdx )->getMotionCU( 0, iPicSizeIdx );
+    }
+  }
+}
+
 /**
  - multi-loop slice encoding for different slice QP
  .
@@ -549,6 +621,12 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   m_pcEntropyCoder->setAlfCtrl(false);
   m_pcEntropyCoder->setMaxAlfCtrlDepth(0); //unnecessary
   
+  if ( m_pcCfg->getWaveFrontThreads() > 0 )
+  {
+    xCompressSliceWavefront( rpcPic, uiStartCUAddr, uiBoundingCUAddr );
+    return;
+  }
+  
   // for every CU in slice
 #if SUB_LCU_DQP
   UChar uhLastQP = pcSlice->getSliceQp();
@@ -584,7 +662,7 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
       // restore last QP
       pcCU->setLastCodedQP( uhLastQP );
 #endif
-      m_pcCuEncoder->encodeCU( pcCU );
+      xEncodeCU( m_pcCuEncoder, m_pppcRDSbacCoder[0][CI_CURR_BEST], pcCU );
 
       pppcRDSbacCoder->setBinCountingEnableFlag( false );
       uiBitsCoded += m_pcBitCounter->getNumberOfWrittenBits();
@@ -663,6 +741,129 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + uiBitsCoded) );
 }
 
+/**
+ - analysis of the slice with LCU rows in wavefront order, one row per thread at a time
+ - an LCU is compressed once its above-right neighbour is done, each row starts from the CABAC contexts left by the
+   second LCU of the row above, so the result does not depend on the number of threads
+ .
+ \param pcPic             picture class
+ \param uiStartCUAddr     first LCU of the slice, must be the first LCU of the picture
+ \param uiBoundingCUAddr  LCU following the slice, must be the end of the picture
+ */
+Void TEncSlice::xCompressSliceWavefront( TComPic* pcPic, UInt uiStartCUAddr, UInt uiBoundingCUAddr )
+{
+  TComSlice* pcSlice     = pcPic->getSlice(getSliceIdx());
+  assert( uiStartCUAddr == 0 && uiBoundingCUAddr == pcPic->getNumCUsInFrame() );
+  
+  // the rows only read the resampled data
+  resamplePictureData( pcPic );
+  
+  for ( Int i = 0; i < m_pcThreadPool->getNumThreads(); i++ )
+  {
+    m_pcCuWorkers[i].initSlice( m_pcRdCost, m_pcTrQuant, m_pcPredSearch );
+  }
+  
+  m_pcWavefrontPic = pcPic;
+  m_cWavefront.init( pcPic->getFrameHeightInCU() );
+  m_pcThreadPool->run( this );
+  m_pcWavefrontPic = NULL;
+  
+  // sum up in raster order, so that the totals do not depend on the number of threads either
+  UInt64 uiBitsCoded = 0;
+  for ( Int i = 0; i < m_pcThreadPool->getNumThreads(); i++ )
+  {
+    uiBitsCoded += m_pcCuWorkers[i].getBitsCoded();
+  }
+  for ( UInt uiCUAddr = uiStartCUAddr; uiCUAddr < uiBoundingCUAddr; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    m_uiPicTotalBits += pcCU->getTotalBits();
+    m_dPicRdCost     += pcCU->getTotalCost();
+    m_uiPicDist      += pcCU->getTotalDistortion();
+  }
+  pcSlice->setSliceCurEndCUAddr( uiBoundingCUAddr );
+  pcSlice->setEntropySliceCurEndCUAddr( uiBoundingCUAddr );
+  pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + uiBitsCoded) );
+}
+
+Void TEncSlice::runTask( Int iThreadIdx )
+{
+  Int iRow;
+  while ( ( iRow = m_cWavefront.claimRow() ) >= 0 )
+  {
+    xCompressRow( &m_pcCuWorkers[iThreadIdx], iRow );
+  }
+}
+
+/** Analysis of one LCU row with the tools of one thread.
+ * \param pcWorker  CU analysis tools of the calling thread
+ * \param iRow      LCU row
+ */
+Void TEncSlice::xCompressRow( TEncCuWorker* pcWorker, Int iRow )
+{
+  TComPic*      pcPic           = m_pcWavefrontPic;
+  TComSlice*    pcSlice         = pcPic->getSlice(getSliceIdx());
+  Int           iWidthInCU      = pcPic->getFrameWidthInCU();
+  Int           iSyncCol        = min( 1, iWidthInCU-1 );
+  TEncCu*       pcCuEncoder     = pcWorker->getCuEncoder();
+  TEncEntropy*  pcEntropyCoder  = pcWorker->getEntropyCoder();
+  TEncSbac*     pcRDSbacCoder   = pcWorker->getRDSbacCoder()[0][CI_CURR_BEST];
+#if SUB_LCU_DQP
+  UChar uhLastQP = pcSlice->getSliceQp();
+#endif
+  
+  for ( Int iCol = 0; iCol < iWidthInCU; iCol++ )
+  {
+    // wait for the above-right LCU
+    if ( iRow > 0 )
+    {
+      m_cWavefront.waitProgress( iRow-1, min( iCol+2, iWidthInCU ) );
+    }
+    if ( iCol == 0 )
+    {
+      pcRDSbacCoder->load( iRow == 0 ? m_pcSbacCoder : &m_pcRowSbacCoders[iRow-1] );
+    }
+    
+    UInt uiCUAddr = iRow*iWidthInCU + iCol;
+    
+    // set QP
+    pcCuEncoder->setQpLast( pcSlice->getSliceQp() );
+    // initialize CU encoder
+    TComDataCU*& pcCU = pcPic->getCU( uiCUAddr );
+    pcCU->initCU( pcPic, uiCUAddr );
+#if SUB_LCU_DQP
+    pcCU->setLastCodedQP( uhLastQP );
+#endif
+    
+    // run CU encoder with the go-on entropy coder
+    pcEntropyCoder->setEntropyCoder ( pcWorker->getRDGoOnSbacCoder(), pcSlice );
+    pcEntropyCoder->setBitstream    ( pcWorker->getBitCounter() );
+    pcCuEncoder->compressCU( pcCU );
+    
+    // update the row contexts with the chosen coding
+    pcEntropyCoder->setEntropyCoder ( pcRDSbacCoder, pcSlice );
+    pcEntropyCoder->setBitstream    ( pcWorker->getBitCounter() );
+#if SUB_LCU_DQP
+    pcCU->setLastCodedQP( uhLastQP );
+#endif
+    xEncodeCU( pcCuEncoder, pcRDSbacCoder, pcCU );
+    pcWorker->addBitsCoded( pcWorker->getBitCounter()->getNumberOfWrittenBits() );
+#if SUB_LCU_DQP
+    uhLastQP = pcCU->getLastCodedQP();
+#endif
+    
+    if ( iCol == iSyncCol )
+    {
+      m_pcRowSbacCoders[iRow].load( pcRDSbacCoder );
+    }
+    if ( uiCUAddr == pcPic->getNumCUsInFrame()-1 )
+    {
+      m_pppcRDSbacCoder[0][CI_CURR_BEST]->load( pcRDSbacCoder );
+    }
+    m_cWavefront.setProgress( iRow, iCol+1 );
+  }
+}
+
 /**
  \param  rpcPic        picture class
  \retval rpcBitstream  bitstream class
@@ -706,6 +907,8 @@ Void TEncSlice::encodeSlice   ( TComPic*& rpcPic, TComOutputBitstream* pcBitstre
 #if SUB_LCU_DQP
   UChar uhLastQP = pcSlice->getSliceQp();
 #endif
+  // the LCUs were coded the same way at the end of their compression
+  Bool bReplayBins = iSymbolMode && xUseBinStores( pcSlice );
   for(  uiCUAddr = uiStartCUAddr; uiCUAddr<uiBoundingCUAddr; uiCUAddr++  )
   {
     m_pcCuEncoder->setQpLast( pcSlice->getSliceQp() );
@@ -716,13 +919,21 @@ Void TEncSlice::encodeSlice   ( TComPic*& rpcPic, TComOutputBitstream* pcBitstre
 #if SUB_LCU_DQP
     pcCU->setLastCodedQP( uhLastQP );
 #endif
+    if ( bReplayBins )
+    {
+      m_pcSbacCoder->replayBins( m_pcBinStores[uiCUAddr] );
+    }
+    else
+    {
+      m_pcCuEncoder->encodeCUData( pcCU );
+    }
     if ( (m_pcCfg->getSliceMode()!=0 || m_pcCfg->getEntropySliceMode()!=0) && uiCUAddr==uiBoundingCUAddr-1 )
     {
-      m_pcCuEncoder->encodeCU( pcCU, true );
+      m_pcCuEncoder->encodeCUTerminatingBit( pcCU, true );
     }
     else
     {
-      m_pcCuEncoder->encodeCU( pcCU );
+      m_pcCuEncoder->encodeCUTerminatingBit( pcCU );
     }
 #if SUB_LCU_DQP
     uhLastQP = pcCU->getLastCodedQP();
@@ -733,6 +944,36 @@ Void TEncSlice::encodeSlice   ( TComPic*& rpcPic, TComOutputBitstream* pcBitstre
   }
 }
 
+/** Check whether the LCU bins are recorded at the end of their compression for encodeSlice().
+ * This needs the same CU syntax coded with CABAC in both stages: the QP of an LCU coded with dQP depends on the LCUs
+ * coded before it, which compressSlice() does not track.
+ * \param pcSlice slice being compressed or encoded
+ */
+Bool TEncSlice::xUseBinStores( TComSlice* pcSlice )
+{
+  return m_pcBinStores && m_pcCfg->getUseSBACRD() && !pcSlice->getSPS()->getUseDQP();
+}
+
+/** Code an LCU with the coder that follows the chosen coding, recording its bins if they are cached.
+ * \param pcCuEncoder CU encoder that compressed the LCU
+ * \param pcSbacCoder coder following the chosen coding
+ * \param pcCU        LCU
+ */
+Void TEncSlice::xEncodeCU( TEncCu* pcCuEncoder, TEncSbac* pcSbacCoder, TComDataCU* pcCU )
+{
+  if ( xUseBinStores( pcCU->getSlice() ) )
+  {
+    pcSbacCoder->setBinStore( &m_pcBinStores[ pcCU->getAddr() ] );
+    pcCuEncoder->encodeCUData( pcCU );
+    pcSbacCoder->setBinStore( NULL );
+    pcCuEncoder->encodeCUTerminatingBit( pcCU );
+  }
+  else
+  {
+    pcCuEncoder->encodeCU( pcCU );
+  }
+}
+
 /** Determines the starting and bounding LCU address of current slice / entropy slice
  * \param bEncodeSlice Identifies if the calling function is compressSlice() [false] or encodeSlice() [true]
  * \returns Updates uiStartCUAddr, uiBoundingCUAddr with appropriate LCU address
@@ -43,7 +43,9 @@
 #include "../TLibCommon/TComList.h"
 #include "../TLibCommon/TComPic.h"
 #include "../TLibCommon/TComPicYuv.h"
+#include "../TLibCommon/TComThreadPool.h"
 #include "TEncCu.h"
+#include "TEncCuWorker.h"
 
 class TEncTop;
 class TEncGOP;
@@ -53,7 +55,7 @@ class TEncGOP;
 // ====================================================================================================================
 
 /// slice encoder class
-class TEncSlice
+class TEncSlice : public TComThreadTask
 {
 private:
   // encoder configuration
@@ -90,14 +92,32 @@ private:
   Double*                 m_pdRdPicQp;                          ///< array of picture QP candidates (double-type for lambda)
   Int*                    m_piRdPicQp;                          ///< array of picture QP candidates (int-type)
   
+  // wavefront-parallel analysis
+  TComThreadPool*         m_pcThreadPool;                       ///< threads compressing LCU rows
+  TEncCuWorker*           m_pcCuWorkers;                        ///< CU analysis tools of each thread
+  TComWavefront           m_cWavefront;                         ///< progress of the LCU rows
+  TEncSbac*               m_pcRowSbacCoders;                    ///< contexts after the second LCU of each row
+  TEncBinCABAC*           m_pcRowBinCoderCABACs;                ///< bin coders of m_pcRowSbacCoders
+  TComPic*                m_pcWavefrontPic;                     ///< picture compressed by runTask()
+  
+  // bins cached during compression
+  TEncBinStore*           m_pcBinStores;                        ///< bins of each LCU of the picture, NULL if not cached
+  
   UInt                    m_uiSliceIdx;
+  
+  Void    xCompressSliceWavefront ( TComPic* pcPic, UInt uiStartCUAddr, UInt uiBoundingCUAddr );
+  Void    xCompressRow        ( TEncCuWorker* pcWorker, Int iRow );
+  Bool    xUseBinStores       ( TComSlice* pcSlice );
+  Void    xEncodeCU           ( TEncCu* pcCuEncoder, TEncSbac* pcSbacCoder, TComDataCU* pcCU );
+  
 public:
   TEncSlice();
   virtual ~TEncSlice();
   
-  Void    create              ( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth );
+  Void    create              ( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth, Int iPicSizeIdx );
   Void    destroy             ();
   Void    init                ( TEncTop* pcEncTop );
+  Void    init                ( TEncTop* pcEncTop, TEncCuWorker* pcWorker );             ///< analysis with the tools of one worker
   
   /// preparation of slice encoding (reference marking, QP and lambda)
   Void    initEncSlice        ( TComPic*  pcPic, Int iPOCLast, UInt uiPOCCurr, Int iNumPicRcvd,
@@ -107,6 +127,9 @@ public:
   Void    precompressSlice    ( TComPic*& rpcPic                                );      ///< precompress slice for multi-loop opt.
   Void    compressSlice       ( TComPic*& rpcPic                                );      ///< analysis stage of slice
   Void    encodeSlice         ( TComPic*& rpcPic, TComOutputBitstream* rpcBitstream  );      ///< entropy coding of slice
+  Void    runTask             ( Int iThreadIdx );                                       ///< wavefront thread of compressSlice
+  Void    resamplePictureData ( TComPic* pcPic );                                       ///< resampling the analysis would do on first use
+  Void    setBinStores        ( TEncBinStore* pcStores ) { m_pcBinStores = pcStores; }  ///< LCU bins recorded by compressSlice() for encodeSlice()
   
   // misc. functions
   Void    setSearchRange      ( TComSlice* pcSlice  );                                  ///< set ME range adaptively
@@ -49,6 +49,8 @@ TEncTop::TEncTop()
   m_uiNumAllPicCoded  =  0;
   m_pppcRDSbacCoder   =  NULL;
   m_pppcBinCoderCABAC =  NULL;
+  m_pcCuWorkers       =  NULL;
+  m_pcSliceEncoders   =  NULL;
   m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
 #if ENC_DEC_TRACE
   g_hTrace = fopen( "TraceEnc.txt", "wb" );
@@ -82,27 +84,29 @@ Void TEncTop::create ()
   initROM();
  
   // create processing unit classes
-  m_cGOPEncoder.        create( getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight );
-  m_cSliceEncoder.      create( getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+  m_cGOPEncoder.        create( getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, max( 1, m_iFrameThreads ) );
+  for (int j=0; j<m_iNumPicResolutions; ++j){
+    m_cSliceEncoder.    create( getPicResolutionWidth(j), getPicResolutionHeight(j), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, j );
+  }
   m_cCuEncoder.         create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
 #if MTK_SAO
   if (m_bUseSAO)
   {
-    for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
-      m_cEncSAO[j].create( getSourceWidth()>>j, getSourceHeight()>>j, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+    for (int j=0; j<m_iNumPicResolutions; ++j){
+      m_cEncSAO[j].create( getPicResolutionWidth(j), getPicResolutionHeight(j), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
       m_cEncSAO[j].createEncBuffer();
     }
   }
 #endif
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
-    m_cAdaptiveLoopFilter[j].create( getSourceWidth()>>j, getSourceHeight()>>j, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+  for (int j=0; j<m_iNumPicResolutions; ++j){
+    m_cAdaptiveLoopFilter[j].create( getPicResolutionWidth(j), getPicResolutionHeight(j), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
   }
   m_cLoopFilter.create( g_uiMaxCUDepth );
 
 #if MQT_BA_RA && MQT_ALF_NPASS
   if(m_bUseALF)
   {
-    for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+    for (int j=0; j<m_iNumPicResolutions; ++j){
       m_cAdaptiveLoopFilter[j].setGOPSize( getGOPSize() );
       m_cAdaptiveLoopFilter[j].createAlfGlobalBuffers(m_iALFEncodePassReduction);
     }
@@ -123,11 +127,40 @@ Void TEncTop::create ()
       for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
       {
         m_pppcRDSbacCoder[iDepth][iCIIdx] = new TEncSbac;
-        m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABAC;
+        // only the coder that re-encodes each compressed LCU produces real bits, the RD search just counts them
+        if ( iDepth == 0 && iCIIdx == CI_CURR_BEST )
+        {
+          m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABAC;
+        }
+        else
+        {
+          m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABACCounter;
+        }
         m_pppcRDSbacCoder   [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC [iDepth][iCIIdx] );
       }
     }
   }
+  
+  // wavefront- or picture-parallel analysis: one set of CU analysis tools per thread
+  if ( xGetNumWorkers() > 0 )
+  {
+    m_cThreadPool.create( xGetNumWorkers() );
+    m_pcCuWorkers = new TEncCuWorker[ xGetNumWorkers() ];
+    for ( Int i = 0; i < xGetNumWorkers(); i++ )
+    {
+      m_pcCuWorkers[i].create();
+    }
+  }
+  if ( m_iFrameThreads > 0 )
+  {
+    m_pcSliceEncoders = new TEncSlice[ m_iFrameThreads ];
+    for ( Int i = 0; i < m_iFrameThreads; i++ )
+    {
+      for (int j=0; j<m_iNumPicResolutions; ++j){
+        m_pcSliceEncoders[i].create( getPicResolutionWidth(j), getPicResolutionHeight(j), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, j );
+      }
+    }
+  }
 }
 
 Void TEncTop::destroy ()
@@ -135,12 +168,33 @@ Void TEncTop::destroy ()
 #if MQT_BA_RA && MQT_ALF_NPASS
   if(m_bUseALF)
   {
-    for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+    for (int j=0; j<m_iNumPicResolutions; ++j){
       m_cAdaptiveLoopFilter[j].destroyAlfGlobalBuffers();
     }
   }
 #endif
 
+  // destroy worker threads and their tools
+  m_cThreadPool.destroy();
+  if ( m_pcSliceEncoders )
+  {
+    for ( Int i = 0; i < m_iFrameThreads; i++ )
+    {
+      m_pcSliceEncoders[i].destroy();
+    }
+    delete [] m_pcSliceEncoders;
+    m_pcSliceEncoders = NULL;
+  }
+  if ( m_pcCuWorkers )
+  {
+    for ( Int i = 0; i < xGetNumWorkers(); i++ )
+    {
+      m_pcCuWorkers[i].destroy();
+    }
+    delete [] m_pcCuWorkers;
+    m_pcCuWorkers = NULL;
+  }
+  
   // destroy processing unit classes
   m_cGOPEncoder.        destroy();
   m_cSliceEncoder.      destroy();
@@ -148,13 +202,13 @@ Void TEncTop::destroy ()
 #if MTK_SAO
   if (m_pcSPS[0]->getUseSAO())
   {
-    for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+    for (int j=0; j<m_iNumPicResolutions; ++j){
       m_cEncSAO[j].destroy();
       m_cEncSAO[j].destroyEncBuffer();
     }
   }
 #endif
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+  for (int j=0; j<m_iNumPicResolutions; ++j){
     m_cAdaptiveLoopFilter[j].destroy();
   }
   m_cLoopFilter.        destroy();
@@ -196,7 +250,7 @@ Void TEncTop::init()
 #endif
   // initialize SPS and PPS
   xInitSPS();
-  for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+  for (int j=0; j<m_iNumPicResolutions; ++j){
     xInitPPS(j);
   }
   
@@ -221,17 +275,37 @@ Void TEncTop::init()
   m_cTrQuant.init( g_uiMaxCUWidth, g_uiMaxCUHeight, 1 << m_uiQuadtreeTULog2MaxSize, m_iSymbolMode, aTable4, aTable8, m_bUseRDOQ, true );
 #endif
   
+  m_cTrQuant.setSIMDLevel( m_iSIMDLevel );
+  
   // initialize encoder search class
+  m_cRdCost.setSIMDLevel( m_iSIMDLevel );
+  m_cSearch.setSIMDLevel( m_iSIMDLevel );
   m_cSearch.init( this, &m_cTrQuant, m_iSearchRange, m_bipredSearchRange, m_iFastSearch, 0, &m_cEntropyCoder, &m_cRdCost, getRDSbacCoder(), getRDGoOnSbacCoder() );
+  
+  for ( Int i = 0; i < xGetNumWorkers(); i++ )
+  {
+    m_pcCuWorkers[i].init( this );
+  }
+  for ( Int i = 0; i < m_iFrameThreads; i++ )
+  {
+    m_pcSliceEncoders[i].init( this, &m_pcCuWorkers[i] );
+  }
 
 #if MQT_ALF_NPASS
   if(m_bUseALF)
   {
-    for (int j=0; j<NUM_PIC_RESOLUTIONS; ++j){
+    for (int j=0; j<m_iNumPicResolutions; ++j){
       m_cAdaptiveLoopFilter[j].setALFEncodePassReduction( m_iALFEncodePassReduction );
     }
   }
 #endif
+  for ( Int j = 0; j < m_iNumPicResolutions; j++ )
+  {
+    m_cAdaptiveLoopFilter[j].setSIMDLevel( m_iSIMDLevel );
+#if MTK_SAO
+    m_cEncSAO[j].setSIMDLevel( m_iSIMDLevel );
+#endif
+  }
 
   m_iMaxRefPicNum = 0;
 }
@@ -324,7 +398,7 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
       if ( abs(rpcPic->getPOC() - m_iPOCLast) <= m_iGOPSize )
       {
         rpcPic = new TComPic;
-        rpcPic->create( m_iSourceWidth, m_iSourceHeight, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0 , false );
+        rpcPic->create( m_pcSPS[0], g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0 , false );
       }
       else
       {
@@ -336,7 +410,7 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
   else
   {
     rpcPic = new TComPic;
-    rpcPic->create( m_iSourceWidth, m_iSourceHeight, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0, false );
+    rpcPic->create( m_pcSPS[0], g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, 0, false );
   }
   
   m_cListPic.pushBack( rpcPic );
@@ -354,6 +428,12 @@ Void TEncTop::xInitSPS()
 {
   m_pcSPS[0]->setNominalWidth  ( m_iSourceWidth      );
   m_pcSPS[0]->setNominalHeight ( m_iSourceHeight     );
+  m_pcSPS[0]->setNumPicResolutions( m_iNumPicResolutions );
+  for ( Int j = 1; j < m_iNumPicResolutions; j++ )
+  {
+    m_pcSPS[0]->setPictureWidth ( j, getPicResolutionWidth (j) );
+    m_pcSPS[0]->setPictureHeight( j, getPicResolutionHeight(j) );
+  }
   m_pcSPS[0]->setSPSId( 0 );
   m_pcSPS[0]->setPad           ( m_aiPad             );
   m_pcSPS[0]->setMaxCUWidth    ( g_uiMaxCUWidth      );
@@ -43,6 +43,7 @@
 #include "../TLibCommon/TComPrediction.h"
 #include "../TLibCommon/TComTrQuant.h"
 #include "../TLibCommon/AccessUnit.h"
+#include "../TLibCommon/TComThreadPool.h"
 
 #include "../TLibVideoIO/TVideoIOYuv.h"
 
@@ -53,6 +54,7 @@
 #include "TEncCavlc.h"
 #include "TEncSbac.h"
 #include "TEncSearch.h"
+#include "TEncCuWorker.h"
 #include "TEncAdaptiveLoopFilter.h"
 
 // ====================================================================================================================
@@ -99,9 +101,15 @@ private:
   TEncSbac***             m_pppcRDSbacCoder;              ///< temporal storage for RD computation
   TEncSbac                m_cRDGoOnSbacCoder;             ///< going on SBAC model for RD stage
   TEncBinCABAC***         m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
-  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+  
+  // wavefront- or picture-parallel analysis
+  TComThreadPool          m_cThreadPool;                  ///< threads compressing LCU rows or pictures
+  TEncCuWorker*           m_pcCuWorkers;                  ///< CU analysis tools of each thread
+  TEncSlice*              m_pcSliceEncoders;              ///< slice encoder of each thread for picture-parallel analysis
   
 protected:
+  Int   xGetNumWorkers    ()  { return max( m_iWaveFrontThreads, m_iFrameThreads ); }
   Void  xGetNewPicBuffer  ( TComPic*& rpcPic );           ///< get picture buffer which will be processed
   Void  xInitSPS          ();                             ///< initialize SPS from encoder options
   Void  xInitPPS          (Int i);                        ///< initialize PPS from encoder options for resolution index i
@@ -140,6 +148,9 @@ public:
   TComRdCost*             getRdCost             () { return  &m_cRdCost;              }
   TEncSbac***             getRDSbacCoder        () { return  m_pppcRDSbacCoder;       }
   TEncSbac*               getRDGoOnSbacCoder    () { return  &m_cRDGoOnSbacCoder;     }
+  TComThreadPool*         getThreadPool         () { return  &m_cThreadPool;          }
+  TEncCuWorker*           getCuWorkers          () { return  m_pcCuWorkers;           }
+  TEncSlice*              getSliceEncoders      () { return  m_pcSliceEncoders;       }
   
   TComSPS*                getSPS                () { return  m_pcSPS[0];                 }
   TComPPS**               getPPS                () { return  m_pcPPS;                 }